@@ -0,0 +1,180 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "visatype.h"
+
+#include "pm_capture.h"
+#include "pm_lod.h"
+#include "pm_stats.h"
+#include "pm_zcapture.h"
+
+//Compressed capture (PM103_fast_stream_engine -zcapture): decode every block once for the
+//statistics, the overview comes from the per-block min/max of the index without decoding.
+static int readCompressed(PMZCaptureReader *reader, uint32_t pixels)
+{
+	const PMZCaptureHeader *hdr = &reader->header;
+	time_t        startSec = (time_t)(hdr->startTimeUs / 1000000);
+	PMSampleBlock block;
+	PMStats       total;
+	ViStatus      stat;
+
+	printf("Device:      %s S/N %s, channel %u\n", hdr->device, hdr->serial, (unsigned int)hdr->channel);
+	printf("Unit:        %s\n", hdr->unit);
+	printf("Start:       %s", ctime(&startSec));
+	printf("Sample rate: %u Hz\n", (unsigned int)hdr->sampleRate);
+	printf("Samples:     %llu in %llu compressed blocks (%s)\n", (unsigned long long)reader->samples,
+			(unsigned long long)reader->blocks, reader->closed ? "complete" : "not closed, index rebuilt");
+	printf("--------------\n");
+
+	if((stat = PMBlock_init(&block, hdr->blockSamples, 1)) != VI_SUCCESS)
+		return 1;
+	PMStats_reset(&total);
+
+	for(uint64_t b = 0; b < reader->blocks; b++)
+	{
+		PMStats part;
+
+		if((stat = PMZCaptureReader_readBlock(reader, b, &block)) != VI_SUCCESS)
+		{
+			printf("Block %llu failed (0x%08X)\n", (unsigned long long)b, (unsigned int)stat);
+			break;
+		}
+		PMStats_block(&part, block.channel[0], block.count);
+		PMStats_merge(&total, &part);
+	}
+	PMBlock_free(&block);
+
+	if(total.count > 0)
+		printf("Min %f, max %f, mean %f, rms %f, std dev %f %s\n", total.min, total.max, total.mean,
+				PMStats_rms(&total), PMStats_stdDev(&total), hdr->unit);
+	if(reader->decoded > 0)
+		printf("Decoded %llu samples at %.1f ns/sample\n", (unsigned long long)reader->decoded,
+				(double)reader->decodeNs / (double)reader->decoded);
+
+	if(pixels > reader->blocks)
+		pixels = (uint32_t)reader->blocks;
+	if(pixels > 0)
+		printf("--------------\n");
+	for(uint32_t i = 0; i < pixels; i++)
+	{
+		uint64_t first = reader->blocks * i / pixels;
+		uint64_t last  = reader->blocks * (i + 1) / pixels;
+		ViReal32 min = reader->index[first].min, max = reader->index[first].max;
+
+		for(uint64_t b = first + 1; b < last; b++)
+		{
+			if(reader->index[b].min < min) min = reader->index[b].min;
+			if(reader->index[b].max > max) max = reader->index[b].max;
+		}
+		printf("%4u: %10.6f s, min %f, max %f\n", (unsigned int)i, (double)reader->index[first].firstTimeUs * 1e-6, min, max);
+	}
+	return 0;
+}
+
+//Reads a capture file written by PM103_fast_stream_engine -capture or -zcapture without loading it into RAM.
+//Only one chunk is mapped at a time, so files larger than the address space work as well.
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream capture reader\n");
+	printf("======================================================\n");
+
+	if(argc < 2)
+	{
+		printf("Usage: %s <capture file> [plot pixels]\n", argv[0]);
+		return 1;
+	}
+
+	PMZCaptureReader zreader;
+	if(PMZCaptureReader_open(&zreader, argv[1]) == VI_SUCCESS)
+	{
+		int result = readCompressed(&zreader, (argc > 2) ? (uint32_t)atoi(argv[2]) : 0);
+		PMZCaptureReader_close(&zreader);
+		return result;
+	}
+
+	PMCaptureReader reader;
+	ViStatus stat = PMCaptureReader_open(&reader, argv[1]);
+	if(stat != VI_SUCCESS)
+	{
+		printf("Failed to open capture file '%s' (0x%08X)\n", argv[1], (unsigned int)stat);
+		return 1;
+	}
+
+	const PMCaptureHeader *hdr = reader.header;
+	time_t startSec = (time_t)(hdr->startTimeUs / 1000000);
+	uint64_t samples = PMCaptureReader_sampleCount(&reader);
+
+	printf("Device:      %s S/N %s, channel %u\n", hdr->device, hdr->serial, (unsigned int)hdr->channel);
+	printf("Unit:        %s\n", hdr->unit);
+	printf("Start:       %s", ctime(&startSec));
+	printf("Sample rate: %u Hz\n", (unsigned int)hdr->sampleRate);
+	printf("Samples:     %llu (%s)\n", (unsigned long long)samples, hdr->closed ? "complete" : "still recording");
+
+	//Recorded interruptions, e.g. reconnects of a supervised acquisition
+	uint32_t gaps = hdr->gapCount;
+	printf("Gaps:        %u%s\n", (unsigned int)gaps, hdr->gapOverflows ? " (table full, more not recorded)" : "");
+	for(uint32_t g = 0; g < gaps; g++)
+	{
+		const PMCaptureGap *gap = &hdr->gaps[g];
+
+		if(gap->sampleIndex == PM_CAPTURE_GAP_PENDING)
+			printf("  before sample (pending)");
+		else
+			printf("  before sample %llu", (unsigned long long)gap->sampleIndex);
+		printf(": %u us without samples, cause %u, status 0x%08X\n",
+				(unsigned int)(gap->firstTimestamp - gap->lastTimestamp), (unsigned int)gap->cause, (unsigned int)gap->status);
+	}
+	printf("--------------\n");
+
+	PMStats total;
+	PMStats_reset(&total);
+
+	for(uint64_t c = 0; c < PMCaptureReader_chunkCount(&reader); c++)
+	{
+		const ViUInt32 *timestamps;
+		const ViReal32 *values;
+		uint32_t count;
+
+		if((stat = PMCaptureReader_getChunk(&reader, c, &timestamps, &values, &count)) != VI_SUCCESS)
+			break;
+
+		PMStats chunk;
+		PMStats_block(&chunk, values, count);
+		PMStats_merge(&total, &chunk);
+
+		printf("Chunk %llu: %u samples, first timestamp %010lu, mean %f, std dev %f\n", (unsigned long long)c,
+				(unsigned int)count, (unsigned long)timestamps[0], chunk.mean, PMStats_stdDev(&chunk));
+	}
+
+	if(total.count > 0)
+		printf("Min %f, max %f, mean %f, rms %f, std dev %f %s\n", total.min, total.max, total.mean,
+				PMStats_rms(&total), PMStats_stdDev(&total), hdr->unit);
+
+	//Plot overview: build the min/max pyramid once, then any zoom level is O(pixels)
+	uint32_t pixels = (argc > 2) ? (uint32_t)atoi(argv[2]) : 0;
+	if(pixels > 0)
+	{
+		PMLod       lod;
+		PMLodBucket *plot = (PMLodBucket*)malloc(pixels * sizeof(PMLodBucket));
+		uint32_t    filled = 0;
+
+		if(plot != NULL && (stat = PMLod_init(&lod, PM_LOD_DEFAULT_BASE)) == VI_SUCCESS)
+		{
+			if((stat = PMLod_appendCapture(&lod, &reader)) == VI_SUCCESS && PMLod_available(&lod) > 0)
+				stat = PMLod_query(&lod, 0, PMLod_available(&lod), pixels, plot, &filled);
+
+			printf("--------------\n");
+			for(uint32_t i = 0; i < filled; i++)
+				printf("%4u: min %f, mean %f, max %f\n", (unsigned int)i, plot[i].min, plot[i].mean, plot[i].max);
+			if(stat != VI_SUCCESS)
+				printf("Plot failed (0x%08X)\n", (unsigned int)stat);
+			PMLod_free(&lod);
+		}
+		free(plot);
+	}
+
+	PMCaptureReader_close(&reader);
+	return 0;
+}
@@ -6,9 +6,12 @@
 #include "TLPM.h"
 #include "visatype.h"
 
+//Build with PM_TRACE defined and pm_trace.c/pm_platform.c added to get driver call latency histograms
+#include "pm_trace.h"
+
 #define FAST_MEAS_BUF_SIZE		10000
 
-ViUInt32 time[FAST_MEAS_BUF_SIZE];
+ViUInt32 tstamp[FAST_MEAS_BUF_SIZE];
 ViReal32 val[FAST_MEAS_BUF_SIZE];
 
 static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
@@ -36,6 +39,10 @@ int main(void)
 	printf("Thorlabs Powermeter fast measure stream sample code\n");
 	printf("===================================================\n");
 
+#ifdef PM_TRACE
+	PMTrace_enable(VI_TRUE);
+#endif
+
 	ViStatus stat;
 	ViUInt32 resourceCount = 0;
 	stat = TLPM_findRsrc (0, &resourceCount);
@@ -61,23 +68,24 @@ int main(void)
 	//		   WINDOWS IS NO REALTIME OPERATING SYSTEM
 
 	//Do not limit bandwidth
-	stat = TLPM_setInputFilterState(instrHandle, VI_FALSE);
+	PM_TRACE_CALL(PM_TRACE_CONFIG, stat, TLPM_setInputFilterState(instrHandle, VI_FALSE));
 	if(stat != VI_SUCCESS)
 		return returnErr(instrHandle, stat, "Failed to set filter to full bandwidth.\n");
 
 	//enable auto ranging: Keep in mind changing the range will interrupt the entire measurement for multiple milliseconds to
 	//					   stabilize amplifier hardware in the powermeter.
-	stat = TLPM_setPowerAutoRange(instrHandle, VI_FALSE);
+	PM_TRACE_CALL(PM_TRACE_CONFIG, stat, TLPM_setPowerAutoRange(instrHandle, VI_FALSE));
 	if(stat != VI_SUCCESS)
 		return returnErr(instrHandle, stat, "Failed to disable autoranging.\n");
 
 	//Configure the fast measure stream for power.
 	//Invalidates old device measure stream buffer.
-	stat = TLPM_confPowerFastArrayMeasurement(instrHandle);
+	PM_TRACE_CALL(PM_TRACE_CONFIG, stat, TLPM_confPowerFastArrayMeasurement(instrHandle));
 	if(stat != VI_SUCCESS)
 		return returnErr(instrHandle, stat, "Failed to configure fast measure stream.\n");
 
 	//This needs to run fast. Do nothing else within the loop to keep query speed at its maximum
+	uint64_t loopNs = 0;
 	for(uint32_t totalCnt = 0; totalCnt < FAST_MEAS_BUF_SIZE;)
 	{
 		//Use temporary buffers to prevent reading out of bounds.
@@ -85,7 +93,9 @@ int main(void)
 		static ViReal32 values[202];
 
 		ViUInt16 count = 0;
-		stat = TLPM_getNextFastArrayMeasurement(instrHandle, &count, timestamps, values);
+		PM_TRACE_INTERVAL(PM_TRACE_POLL_LOOP, loopNs);
+		PM_TRACE_CALL(PM_TRACE_FAST_ARRAY, stat, TLPM_getNextFastArrayMeasurement(instrHandle, &count, timestamps, values));
+		PM_TRACE_VALUE(PM_TRACE_FAST_ARRAY_COUNT, count);
 		if(stat != VI_SUCCESS)
 			return returnErr(instrHandle, stat, "Failed to query fast measure stream.\n");
 
@@ -94,7 +104,7 @@ int main(void)
 			count = FAST_MEAS_BUF_SIZE - totalCnt;
 
 		//Copy temporary results to final result buffers
-		memcpy(&time[totalCnt], timestamps, count * sizeof(ViUInt32));
+		memcpy(&tstamp[totalCnt], timestamps, count * sizeof(ViUInt32));
 		memcpy(&val[totalCnt],  values, 	count * sizeof(ViReal32));
 
 		totalCnt += count;
@@ -102,19 +112,23 @@ int main(void)
 
 	//Do whatever you want to to with fast measure data
 	for(uint32_t i = 0; i < FAST_MEAS_BUF_SIZE; i += 100)
-		printf("%010lu, %f mW\n", time[i], val[i] * 1000);
+		printf("%010lu, %f mW\n", tstamp[i], val[i] * 1000);
 
 	printf("--------------");
 
-	//Be careful relative time will wrap around
-	if(time[FAST_MEAS_BUF_SIZE - 1] > time[0])
-		printf("Total time: %ld us", time[FAST_MEAS_BUF_SIZE - 1] - time[0]);
+	//Relative time wraps around every 2^32 us. Unsigned differences stay correct across one wrap.
+	printf("Total time: %lu us", (unsigned long)(ViUInt32)(tstamp[FAST_MEAS_BUF_SIZE - 1] - tstamp[0]));
 
 	printf("--------------");
 
 	for(uint32_t i = 1; i < FAST_MEAS_BUF_SIZE; i ++)
-		if(time[i] - time[i - 0] > 10)
-			printf("Time delta %ld > 10 us @ %d\n", time[i] - time[i - 0], i);
+		if((ViUInt32)(tstamp[i] - tstamp[i - 1]) > 10)
+			printf("Time delta %lu > 10 us @ %d\n", (unsigned long)(ViUInt32)(tstamp[i] - tstamp[i - 1]), i);
+
+#ifdef PM_TRACE
+	printf("--------------\n");
+	PMTrace_dump(stdout);
+#endif
 
 	TLPM_close (instrHandle);
 	return 1;
@@ -0,0 +1,376 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_capture.h"
+#include "pm_zcapture.h"
+#include "pm_lod.h"
+#include "pm_model.h"
+#include "pm_sim.h"
+#include "pm_stats.h"
+#include "pm_timeline.h"
+#include "pm_trace.h"
+
+#define FAST_MEAS_BUF_SIZE		10000
+#define DEFAULT_RUN_TIME_SEC	5
+#define MAX_PRINTED_GAPS		10
+#define WINDOW_BLOCKS			500		// ~1 s of 200 sample blocks
+#define OVERVIEW_PIXELS			20
+
+typedef struct
+{
+	PMStats       total;
+	PMStatsWindow window;
+	PMTimeline    timeline;
+} ProcessingCtx;
+
+typedef struct
+{
+	uint32_t totalCnt;
+	ViUInt32 time[FAST_MEAS_BUF_SIZE];
+	ViReal32 val[FAST_MEAS_BUF_SIZE];
+} StorageCtx;
+
+static ProcessingCtx processing;
+static StorageCtx    storage;
+static PMCapture     capture;
+static PMZCapture    zcapture;
+static PMLod         lod;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+static void printGap(void *ctx, const PMGap *gap)
+{
+	PMTimeline *tl = (PMTimeline*)ctx;
+
+	if(tl->gaps < MAX_PRINTED_GAPS)
+		printf("Gap @ sample %llu: %llu us without data after t = %llu us, ~%llu samples lost\n",
+				(unsigned long long)gap->sampleIndex, (unsigned long long)gap->lengthUs,
+				(unsigned long long)gap->startUs, (unsigned long long)gap->missingSamples);
+}
+
+//Runs on its own thread. May take its time, the reader keeps polling meanwhile.
+static void processBlock(void *ctx, const PMFastBlock *block)
+{
+	ProcessingCtx *p = (ProcessingCtx*)ctx;
+
+	//Unwraps the 32 bit timestamps and reports samples lost by the device
+	PMTimeline_process(&p->timeline, block->timestamps, block->count, NULL);
+
+	//Vectorized block statistics, merged into the whole run and the rolling window
+	PMStats part;
+	PMStats_block(&part, block->values, block->count);
+	PMStats_merge(&p->total, &part);
+	PMStatsWindow_push(&p->window, &part);
+}
+
+//Runs on its own thread. Keeps the first FAST_MEAS_BUF_SIZE samples like the original sample.
+static void storeBlock(void *ctx, const PMFastBlock *block)
+{
+	StorageCtx *s = (StorageCtx*)ctx;
+	uint32_t   count = block->count;
+
+	if(s->totalCnt + count > FAST_MEAS_BUF_SIZE)
+		count = FAST_MEAS_BUF_SIZE - s->totalCnt;
+
+	memcpy(&s->time[s->totalCnt], block->timestamps, count * sizeof(ViUInt32));
+	memcpy(&s->val[s->totalCnt],  block->values,     count * sizeof(ViReal32));
+	s->totalCnt += count;
+}
+
+static ViStatus openDevice(ViSession *instrHandle)
+{
+	ViStatus stat;
+	ViUInt32 resourceCount = 0;
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+
+	*instrHandle = VI_NULL;
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	stat = TLPM_init (rsrcDescr, VI_TRUE, VI_FALSE, instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	//Do not limit bandwidth and keep the range fixed (see PM103_fast_measurement.c)
+	stat = TLPM_setInputFilterState(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set filter to full bandwidth.\n");
+
+	stat = TLPM_setPowerAutoRange(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to disable autoranging.\n");
+
+	stat = TLPM_confPowerFastArrayMeasurement(*instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to configure fast measure stream.\n");
+
+	return VI_SUCCESS;
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream acquisition engine sample\n");
+	printf("=================================================================\n");
+	printf("Usage: %s [-sim] [-capture <file>] [-zcapture <file>] [-trace] [-rt] [-cpu <n>] [seconds]\n\n", argv[0]);
+
+	ViStatus    stat;
+	ViSession   instrHandle = VI_NULL;
+	ViBoolean   useSim = VI_FALSE;
+	ViBoolean   trace = VI_FALSE;
+	ViBoolean   realtime = VI_FALSE;
+	PMAcqRealtime rtCfg;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	const char  *capturePath = NULL;
+	const char  *zcapturePath = NULL;
+	PMSim       sim;
+	PMSimConfig simCfg;
+	const PMModel *model = PMModel_get(PM_MODEL_PM103);   //the simulation streams like a PM103
+	PMBlockSource source;
+
+	PMAcq_defaultRealtime(&rtCfg);
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-sim") == 0)
+			useSim = VI_TRUE;
+		else if(strcmp(argv[i], "-capture") == 0 && i + 1 < argc)
+			capturePath = argv[++i];
+		else if(strcmp(argv[i], "-zcapture") == 0 && i + 1 < argc)
+			zcapturePath = argv[++i];
+		else if(strcmp(argv[i], "-trace") == 0)
+			trace = VI_TRUE;
+		else if(strcmp(argv[i], "-rt") == 0)
+			realtime = VI_TRUE;
+		else if(strcmp(argv[i], "-cpu") == 0 && i + 1 < argc)
+			rtCfg.cpu = atoi(argv[++i]);
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	//Latency histograms of the poll loop, driver calls and consumers (needs a PM_TRACE build)
+	PMTrace_enable(trace);
+
+	if(!useSim)
+	{
+		ViChar name[TLPM_BUFFER_SIZE];
+
+		if((stat = openDevice(&instrHandle)) != VI_SUCCESS)
+			return stat;
+
+		//Reader specialized on the model, resolved once here
+		if((stat = TLPM_identificationQuery(instrHandle, VI_NULL, name, VI_NULL, VI_NULL)) != VI_SUCCESS)
+			return returnErr(instrHandle, stat, "Failed to identify the instrument.\n");
+		model = PMModel_find(name);
+		if(!(model->modes & PM_MODEL_FAST))
+			return returnErr(instrHandle, VI_ERROR_NSUP_OPER, "%s has no fast measure stream.\n", name);
+		source = PMModel_source(model, instrHandle);
+	}
+
+	//Unbounded capture: the file is grown, mapped and flushed by its own thread.
+	//The compressed capture encodes on its consumer thread, ~3 bytes instead of 8 per sample.
+	if(capturePath != NULL || zcapturePath != NULL)
+	{
+		PMCaptureInfo info;
+		ViChar        name[TLPM_BUFFER_SIZE] = "Simulation";
+		ViChar        serial[TLPM_BUFFER_SIZE] = "";
+
+		if(!useSim)
+			TLPM_identificationQuery(instrHandle, VI_NULL, name, serial, VI_NULL);
+
+		info.device     = name;
+		info.serial     = serial;
+		info.unit       = "W";
+		info.channel    = 1;
+		info.sampleRate = 1000000 / model->periodUs;
+		if(capturePath != NULL &&
+		   (stat = PMCapture_create(&capture, capturePath, &info, (uint64_t)runTime * info.sampleRate)) != VI_SUCCESS)
+			return returnErr(instrHandle, stat, "Failed to create capture file '%s'.\n", capturePath);
+		if(zcapturePath != NULL &&
+		   (stat = PMZCapture_create(&zcapture, zcapturePath, &info, 0)) != VI_SUCCESS)
+		{
+			if(capturePath != NULL)
+				PMCapture_close(&capture);
+			return returnErr(instrHandle, stat, "Failed to create capture file '%s'.\n", zcapturePath);
+		}
+	}
+
+	//The simulated device starts streaming right away, so set it up last
+	if(useSim)
+	{
+		PMSim_defaultConfig(&simCfg);
+		PMSim_init(&sim, &simCfg);
+		source = PMSim_source(&sim);
+	}
+
+	PMTimeline_init(&processing.timeline, PM_TIMELINE_DEFAULT_PERIOD_US, printGap, &processing.timeline);
+	if((stat = PMStatsWindow_init(&processing.window, WINDOW_BLOCKS)) != VI_SUCCESS ||
+	   (stat = PMLod_init(&lod, PM_LOD_DEFAULT_BASE)) != VI_SUCCESS)
+	{
+		PMStatsWindow_free(&processing.window);
+		if(capturePath != NULL)
+			PMCapture_close(&capture);
+		if(zcapturePath != NULL)
+			PMZCapture_close(&zcapture);
+		return returnErr(instrHandle, stat, "Failed to allocate statistics.\n");
+	}
+	printf("Statistics kernel: %s\n", PMStats_kernelName(PMStats_kernel()));
+
+	//The reader thread only polls the stream. Processing, storage and the plot pyramid run on their own threads.
+	static PMAcq acq;
+	PMAcq_init(&acq, source, PM_ACQ_DEFAULT_RING_SIZE);
+	//Real-time mode (Linux): SCHED_FIFO reader on an isolated core (or -cpu), locked and pre-faulted memory
+	if((realtime && (stat = PMAcq_setRealtime(&acq, &rtCfg))) ||
+	   (stat = PMAcq_addConsumer(&acq, "processing", processBlock, &processing)) ||
+	   (stat = PMAcq_addConsumer(&acq, "storage", storeBlock, &storage)) ||
+	   (stat = PMAcq_addConsumer(&acq, "lod", PMLod_consumer, &lod)) ||
+	   (capturePath != NULL && (stat = PMAcq_addConsumer(&acq, "capture", PMCapture_consumer, &capture))) ||
+	   (zcapturePath != NULL && (stat = PMAcq_addConsumer(&acq, "zcapture", PMZCapture_consumer, &zcapture))) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		PMStatsWindow_free(&processing.window);
+		PMLod_free(&lod);
+		if(capturePath != NULL)
+			PMCapture_close(&capture);
+		if(zcapturePath != NULL)
+			PMZCapture_close(&zcapture);
+		return returnErr(instrHandle, stat, "Failed to start acquisition engine.\n");
+	}
+
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMAcqStats stats;
+
+		PMPlat_sleepUs(1000000);
+		PMAcq_getStats(&acq, &stats);
+		PMAcq_printStats(&stats);
+		if(trace)
+			PMTrace_dump(stdout);
+	}
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+
+	if(realtime)
+	{
+		printf("Poll loop wake-up latency:\n");
+		for(uint32_t b = 0; b < PM_ACQ_LATENCY_BUCKETS; b++)
+			if(stats.wakeHist[b] > 0)
+				printf("  < %8llu us: %llu\n", (unsigned long long)(1ull << b), (unsigned long long)stats.wakeHist[b]);
+	}
+
+	if(capturePath != NULL)
+	{
+		uint64_t stalls = capture.stalls;
+		uint64_t samples = capture.samples;
+		ViStatus capStat = PMCapture_close(&capture);
+
+		printf("Capture '%s': %llu samples, %llu writer stalls, status 0x%08X\n", capturePath,
+				(unsigned long long)samples, (unsigned long long)stalls, (unsigned int)capStat);
+	}
+
+	if(zcapturePath != NULL)
+	{
+		uint64_t samples = zcapture.samples;
+		double   encodeNs = samples ? (double)zcapture.encodeNs / (double)samples : 0.0;
+		ViStatus capStat = PMZCapture_close(&zcapture);
+
+		printf("Compressed capture '%s': %llu samples, %.2f bytes/sample, encoding %.1f ns/sample, status 0x%08X\n",
+				zcapturePath, (unsigned long long)samples, PMZCapture_bytesPerSample(&zcapture), encodeNs, (unsigned int)capStat);
+	}
+
+	if(processing.total.count > 0)
+	{
+		PMTimelineStats tls;
+		PMStats         last;
+		PMTimeline_getStats(&processing.timeline, &tls);
+		PMStatsWindow_get(&processing.window, &last);
+
+		printf("Samples: %llu, min %f mW, max %f mW, mean %f mW, rms %f mW, std dev %f mW\n",
+				(unsigned long long)processing.total.count, processing.total.min * 1000, processing.total.max * 1000,
+				processing.total.mean * 1000, PMStats_rms(&processing.total) * 1000, PMStats_stdDev(&processing.total) * 1000);
+		printf("Last %llu samples: min %f mW, max %f mW, mean %f mW, std dev %f mW\n",
+				(unsigned long long)last.count, last.min * 1000, last.max * 1000, last.mean * 1000, PMStats_stdDev(&last) * 1000);
+		printf("Total time: %llu us, gaps %llu (max %llu us), lost samples %llu, drop rate %.4f %%, wraps %llu\n",
+				(unsigned long long)tls.spanUs, (unsigned long long)tls.gaps, (unsigned long long)tls.maxGapUs,
+				(unsigned long long)tls.missing, tls.dropRate * 100.0, (unsigned long long)tls.wraps);
+	}
+	PMStatsWindow_free(&processing.window);
+	if(useSim)
+		printf("Simulated device lost %llu samples to buffer overrun\n", (unsigned long long)sim.lost);
+
+	printf("--------------\n");
+
+	for(uint32_t i = 0; i < storage.totalCnt; i += 1000)
+		printf("%010lu, %f mW\n", (unsigned long)storage.time[i], storage.val[i] * 1000);
+
+	//Whole run at plot resolution from the pyramid, spikes included
+	PMLodBucket overview[OVERVIEW_PIXELS];
+	uint32_t    pixels = 0;
+	uint64_t    available = PMLod_available(&lod);
+
+	if(available > 0 && PMLod_query(&lod, 0, available, OVERVIEW_PIXELS, overview, &pixels) == VI_SUCCESS)
+	{
+		printf("--------------\n");
+		for(uint32_t i = 0; i < pixels; i++)
+			printf("Samples %9llu+: min %f mW, mean %f mW, max %f mW\n", (unsigned long long)(available * i / OVERVIEW_PIXELS),
+					overview[i].min * 1000, overview[i].mean * 1000, overview[i].max * 1000);
+	}
+	PMLod_free(&lod);
+
+	if(stat != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Fast measure stream stopped with error.\n");
+
+	if(instrHandle != VI_NULL)
+		TLPM_close (instrHandle);
+	return 0;
+}
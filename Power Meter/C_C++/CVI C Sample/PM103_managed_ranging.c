@@ -0,0 +1,233 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_range.h"
+#include "pm_timeline.h"
+
+#define DEFAULT_RUN_TIME_SEC	10
+#define SWITCH_LOG_SIZE			64		// power of two
+
+//Switch log, written by the reader thread, printed by main
+static PMRangeSwitch     switchLog[SWITCH_LOG_SIZE];
+static volatile uint64_t switchCount;
+
+//Stream consumer: timeline with marked interruptions, power span per interval
+typedef struct
+{
+	PMTimeline        timeline;
+	volatile uint64_t lock;
+	double            minW, maxW;
+	uint64_t          samples;
+} RangeMonitor;
+
+static RangeMonitor monitor;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+//The range is not fixed here, PMRange_init takes over ranging
+static ViStatus openDevice(ViSession *instrHandle)
+{
+	ViStatus stat;
+	ViUInt32 resourceCount = 0;
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+
+	*instrHandle = VI_NULL;
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	stat = TLPM_init (rsrcDescr, VI_TRUE, VI_FALSE, instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	stat = TLPM_setInputFilterState(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set filter to full bandwidth.\n");
+
+	return VI_SUCCESS;
+}
+
+//Reader thread, before the first sample of the new range is queued: every consumer timeline gets the mark
+static void onSwitch(void *ctx, const PMRangeSwitch *sw)
+{
+	RangeMonitor *mon = (RangeMonitor*)ctx;
+
+	PMTimeline_mark(&mon->timeline, sw->lastRaw, sw->firstRaw, PM_GAP_RANGE_SWITCH);
+	switchLog[switchCount & (SWITCH_LOG_SIZE - 1)] = *sw;
+	PMPlat_store64(&switchCount, switchCount + 1);
+}
+
+static void monitorConsumer(void *ctx, const PMFastBlock *block)
+{
+	RangeMonitor *mon = (RangeMonitor*)ctx;
+	double       lo = block->values[0], hi = block->values[0];
+
+	PMTimeline_process(&mon->timeline, block->timestamps, block->count, NULL);
+	for(uint32_t i = 1; i < block->count; i++)
+	{
+		if(block->values[i] < lo) lo = block->values[i];
+		if(block->values[i] > hi) hi = block->values[i];
+	}
+
+	while(!PMPlat_cas64(&mon->lock, 0, 1))
+		PMPlat_yield();
+	if(mon->samples == 0 || lo < mon->minW) mon->minW = lo;
+	if(mon->samples == 0 || hi > mon->maxW) mon->maxW = hi;
+	mon->samples += block->count;
+	PMPlat_store64(&mon->lock, 0);
+}
+
+static void printSwitches(const PMRange *range, uint64_t *printed)
+{
+	uint64_t count = PMPlat_load64(&switchCount);
+
+	if(count - *printed > SWITCH_LOG_SIZE)
+		*printed = count - SWITCH_LOG_SIZE;
+	for(; *printed < count; (*printed)++)
+	{
+		const PMRangeSwitch *sw = &switchLog[*printed & (SWITCH_LOG_SIZE - 1)];
+
+		printf("  switch %llu %-15s %10.3g W -> %10.3g W, dead %6u us, driver %7.3f ms\n", (unsigned long long)sw->index,
+				PMRange_reasonName(sw->reason), range->cfg.range[sw->fromRange], range->cfg.range[sw->toRange],
+				(unsigned int)sw->deadUs, (double)sw->switchNs / 1e6);
+	}
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter managed ranging sample\n");
+	printf("==========================================\n");
+	printf("Usage: %s [-up <fraction>] [-down <fraction>] [-hold <us>] [seconds]\n\n", argv[0]);
+
+	ViStatus      stat;
+	ViSession     instrHandle = VI_NULL;
+	uint32_t      runTime = DEFAULT_RUN_TIME_SEC;
+	PMRangeConfig cfg;
+	static PMRange range;
+
+	PMRange_defaultConfig(&cfg);
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-up") == 0 && i + 1 < argc)
+			cfg.upFraction = atof(argv[++i]);
+		else if(strcmp(argv[i], "-down") == 0 && i + 1 < argc)
+			cfg.downFraction = atof(argv[++i]);
+		else if(strcmp(argv[i], "-hold") == 0 && i + 1 < argc)
+			cfg.holdUs = (uint32_t)atoi(argv[++i]);
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	if((stat = openDevice(&instrHandle)) != VI_SUCCESS)
+		return stat;
+
+	PMTimeline_init(&monitor.timeline, cfg.periodUs, NULL, NULL);
+	if((stat = PMRange_init(&range, instrHandle, &cfg, onSwitch, &monitor)) != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Failed to set up managed ranging.\n");
+	printf("%u ranges from %.3g W to %.3g W, up at %.0f %%, down below %.0f %% for %u ms\n",
+			(unsigned int)range.cfg.rangeCount, range.cfg.range[0], range.cfg.range[range.cfg.rangeCount - 1],
+			range.cfg.upFraction * 100, range.cfg.downFraction * 100, (unsigned int)(range.cfg.holdUs / 1000));
+
+	static PMAcq acq;
+	PMAcq_init(&acq, PMRange_source(&range), PM_ACQ_DEFAULT_RING_SIZE);
+	if((stat = PMAcq_addConsumer(&acq, "monitor", monitorConsumer, &monitor)) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		return returnErr(instrHandle, stat, "Failed to start acquisition engine.\n");
+	}
+
+	uint64_t printed = 0;
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMRangeStats    rs;
+		PMTimelineStats ts;
+		double          lo, hi;
+
+		PMPlat_sleepUs(1000000);
+		PMRange_getStats(&range, &rs);
+		PMTimeline_getStats(&monitor.timeline, &ts);
+		while(!PMPlat_cas64(&monitor.lock, 0, 1))
+			PMPlat_yield();
+		lo = monitor.minW;
+		hi = monitor.maxW;
+		monitor.samples = 0;
+		PMPlat_store64(&monitor.lock, 0);
+
+		printf("%3u s: range %9.3g W, power %10.4g .. %10.4g W, switches %llu up %llu down, "
+				"interruptions %llu (%llu us), gaps %llu (%llu samples)\n", (unsigned int)(sec + 1), rs.currentW, lo, hi,
+				(unsigned long long)rs.switchesUp, (unsigned long long)rs.switchesDown,
+				(unsigned long long)ts.interruptions, (unsigned long long)ts.interruptedUs,
+				(unsigned long long)ts.gaps, (unsigned long long)ts.missing);
+		printSwitches(&range, &printed);
+	}
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+
+	PMRangeStats    rs;
+	PMTimelineStats ts;
+	PMRange_getStats(&range, &rs);
+	PMTimeline_getStats(&monitor.timeline, &ts);
+	printf("Switches: %llu up, %llu down, dead time %llu us total, %llu us max, %llu saturated samples, %llu rebases\n",
+			(unsigned long long)rs.switchesUp, (unsigned long long)rs.switchesDown, (unsigned long long)rs.deadUs,
+			(unsigned long long)rs.maxDeadUs, (unsigned long long)rs.saturated, (unsigned long long)rs.rebases);
+	printf("Timeline: %llu interruptions (%llu samples), %llu unexplained gaps (%llu samples), drop rate %.6f %%\n",
+			(unsigned long long)ts.interruptions, (unsigned long long)ts.interruptedSamples,
+			(unsigned long long)ts.gaps, (unsigned long long)ts.missing, ts.dropRate * 100.0);
+
+	if(stat != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Fast measure stream stopped with error.\n");
+
+	TLPM_close (instrHandle);
+	return 0;
+}
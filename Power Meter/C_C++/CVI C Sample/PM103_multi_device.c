@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_multi.h"
+#include "pm_sim.h"
+#include "pm_stats.h"
+
+#define DEFAULT_RUN_TIME_SEC	5
+
+typedef struct
+{
+	PMStats  stats[PM_MULTI_MAX_DEVICES];
+} SharedCtx;
+
+static SharedCtx shared;
+static PMSim     sims[PM_MULTI_MAX_DEVICES];
+static PMMulti   multi;
+
+//Shared consumer. Runs on the dispatcher thread only, so no locking is needed.
+static void consumeBlock(void *ctx, uint32_t device, const PMFastBlock *block)
+{
+	SharedCtx *s = (SharedCtx*)ctx;
+
+	PMStats_add(&s->stats[device], block->values, block->count);
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter multi-device fast measure stream sample\n");
+	printf("===========================================================\n");
+	printf("Usage: %s [-sim <devices>] [-fast] [seconds] [resource ...]\n", argv[0]);
+	printf("       Without -sim and resources all connected power meters are opened.\n\n");
+
+	ViStatus    stat;
+	uint32_t    simCount = 0;
+	ViBoolean   fast = VI_FALSE;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	const char  *resources[PM_MULTI_MAX_DEVICES];
+	uint32_t    rsrcCount = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-sim") == 0 && i + 1 < argc)
+			simCount = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-fast") == 0)
+			fast = VI_TRUE;
+		else if(argv[i][0] >= '0' && argv[i][0] <= '9')
+			runTime = (uint32_t)atoi(argv[i]);
+		else if(rsrcCount < PM_MULTI_MAX_DEVICES)
+			resources[rsrcCount++] = argv[i];
+	}
+
+	PMMulti_init(&multi, consumeBlock, &shared, PM_ACQ_DEFAULT_RING_SIZE);
+
+	if(simCount > 0)
+	{
+		//Simulated heads, -fast streams as fast as the workers can poll to show scaling
+		for(uint32_t i = 0; i < simCount && i < PM_MULTI_MAX_DEVICES; i++)
+		{
+			PMSimConfig cfg;
+			char        name[32];
+
+			PMSim_defaultConfig(&cfg);
+			cfg.realTime   = fast ? VI_FALSE : VI_TRUE;
+			cfg.signalMean = 1.0e-3 * (i + 1);
+			cfg.seed       = 0x1313u + i;
+			PMSim_init(&sims[i], &cfg);
+
+			sprintf(name, "Simulation %u", (unsigned int)i);
+			if((stat = PMMulti_addSource(&multi, name, PMSim_source(&sims[i]), PM_MULTI_CPU_AUTO)) != VI_SUCCESS)
+				break;
+		}
+	}
+	else
+	{
+		stat = PMMulti_openDevices(&multi, rsrcCount > 0 ? resources : NULL, rsrcCount);
+	}
+
+	if(stat != VI_SUCCESS || (stat = PMMulti_start(&multi)) != VI_SUCCESS)
+	{
+		printf("Failed to start %u devices (0x%08X)\n", (unsigned int)multi.deviceCount, (unsigned int)stat);
+		PMMulti_free(&multi);
+		return stat;
+	}
+
+	for(uint32_t sec = 0; sec < runTime && PMMulti_isRunning(&multi); sec++)
+	{
+		PMMultiStats stats;
+
+		PMPlat_sleepUs(1000000);
+		PMMulti_getStats(&multi, &stats);
+		PMMulti_printStats(&stats);
+	}
+
+	stat = PMMulti_stop(&multi);
+
+	printf("--------------\n");
+	PMMultiStats stats;
+	PMMulti_getStats(&multi, &stats);
+	PMMulti_printStats(&stats);
+
+	printf("--------------\n");
+	for(uint32_t i = 0; i < multi.deviceCount; i++)
+	{
+		const PMStats *s = &shared.stats[i];
+
+		printf("%-24.24s %llu samples, min %f mW, max %f mW, mean %f mW, std dev %f mW\n",
+				multi.devices[i].name, (unsigned long long)s->count, s->min * 1000, s->max * 1000,
+				s->mean * 1000, PMStats_stdDev(s) * 1000);
+	}
+
+	PMMulti_free(&multi);
+	if(stat != VI_SUCCESS)
+		printf("Acquisition stopped with error 0x%08X\n", (unsigned int)stat);
+	return stat;
+}
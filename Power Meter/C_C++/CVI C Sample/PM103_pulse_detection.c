@@ -0,0 +1,324 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_model.h"
+#include "pm_pulse.h"
+#include "pm_sim.h"
+
+#define DEFAULT_RUN_TIME_SEC	5
+#define DEFAULT_HIGH_MW			2.0
+#define DEFAULT_LOW_MW			1.3
+#define MAX_PRINTED_PULSES		5
+#define BENCH_SAMPLES			2000000		// 20 s of stream
+#define BENCH_REPEAT			10
+
+typedef struct
+{
+	volatile uint64_t count;
+	double   energy;
+	double   peak;
+	double   width;
+	double   rise;
+	uint64_t flagged;			// truncated, gap or cut edge
+	FILE     *csv;
+	ViBoolean quiet;
+} PulseCtx;
+
+static PulseCtx        pulses;
+static PMPulseDetector detector;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+//Runs on the detector's consumer thread, once per pulse instead of once per sample
+static void onPulse(void *ctx, const PMPulse *pulse)
+{
+	PulseCtx *p = (PulseCtx*)ctx;
+
+	if(!p->quiet && p->count < MAX_PRINTED_PULSES)
+		printf("Pulse @ sample %llu: peak %f mW, width %.1f us, rise %.1f us, energy %f uJ, %u samples\n",
+				(unsigned long long)pulse->index, pulse->peak * 1000, pulse->widthUs, pulse->riseUs,
+				pulse->energy * 1e6, (unsigned int)pulse->samples);
+
+	p->energy += pulse->energy;
+	p->peak   += pulse->peak;
+	p->width  += pulse->widthUs;
+	p->rise   += pulse->riseUs;
+	if(pulse->flags)
+		p->flagged++;
+	if(p->csv != NULL)
+		fprintf(p->csv, "%llu,%lu,%u,%e,%e,%.2f,%.2f,%e,%u\n", (unsigned long long)pulse->index, (unsigned long)pulse->timestamp,
+				(unsigned int)pulse->samples, pulse->peak, pulse->baseline, pulse->widthUs, pulse->riseUs, pulse->energy,
+				(unsigned int)pulse->flags);
+	PMPlat_store64(&p->count, p->count + 1);
+}
+
+static void simPulses(PMSimConfig *cfg)
+{
+	cfg->pulseRate      = 1000;
+	cfg->pulseWidthUs   = 100;
+	cfg->pulseAmplitude = 5.0e-3;
+}
+
+//Detector throughput on a simulated pulse train, one core, every kernel the CPU supports
+static int benchmark(const PMPulseConfig *cfg)
+{
+	PMSim       sim;
+	PMSimConfig simCfg;
+	ViUInt32    *time = (ViUInt32*)PMPlat_alignedAlloc(BENCH_SAMPLES * sizeof(ViUInt32), PM_CACHE_LINE);
+	ViReal32    *values = (ViReal32*)PMPlat_alignedAlloc(BENCH_SAMPLES * sizeof(ViReal32), PM_CACHE_LINE);
+	int         kernels[] = { PM_PULSE_KERNEL_SCALAR, PM_PULSE_KERNEL_SSE2, PM_PULSE_KERNEL_AVX2 };
+	uint64_t    reference = 0;
+
+	if(time == NULL || values == NULL)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	PMSim_defaultConfig(&simCfg);
+	simPulses(&simCfg);
+	PMSim_init(&sim, &simCfg);
+	for(uint32_t i = 0; i < BENCH_SAMPLES; i++)
+	{
+		time[i]   = PMSim_timestamp(&sim, i);
+		values[i] = PMSim_sample(&sim, i);
+	}
+
+	printf("%-8s %14s %10s %14s\n", "Kernel", "MSamples/s", "pulses", "energy (uJ)");
+	for(int k = 0; k < 3; k++)
+	{
+		if(PMPulse_selectKernel(kernels[k]) != kernels[k])
+		{
+			printf("%-8s not supported on this CPU\n", PMPulse_kernelName(kernels[k]));
+			continue;
+		}
+
+		memset(&pulses, 0, sizeof(pulses));
+		pulses.quiet = VI_TRUE;
+		uint64_t t0 = PMPlat_timeNs();
+		for(int r = 0; r < BENCH_REPEAT; r++)
+		{
+			PMPulse_init(&detector, cfg, onPulse, &pulses);
+			for(uint32_t i = 0; i < BENCH_SAMPLES; i += PM_SIM_BLOCK_SAMPLES)
+				PMPulse_process(&detector, &time[i], &values[i], PM_SIM_BLOCK_SAMPLES);
+		}
+		uint64_t t1 = PMPlat_timeNs();
+
+		double rate = (double)BENCH_SAMPLES * BENCH_REPEAT / ((double)(t1 - t0) * 1e-9);
+		printf("%-8s %14.1f %10llu %14.6f\n", PMPulse_kernelName(kernels[k]), rate * 1e-6,
+				(unsigned long long)detector.pulses, pulses.count ? pulses.energy / (double)pulses.count * 1e6 : 0.0);
+
+		if(kernels[k] == PM_PULSE_KERNEL_SCALAR)
+			reference = pulses.count;
+		else if(pulses.count != reference)
+			printf("%-8s MISMATCH against scalar kernel\n", PMPulse_kernelName(kernels[k]));
+	}
+
+	printf("--------------\n");
+	printf("One 100 kHz stream needs 0.1 MSamples/s.\n");
+	PMPlat_alignedFree(time);
+	PMPlat_alignedFree(values);
+	return 0;
+}
+
+static ViStatus openDevice(ViSession *instrHandle, PMBlockSource *source)
+{
+	ViStatus stat;
+	ViUInt32 resourceCount = 0;
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+
+	*instrHandle = VI_NULL;
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	stat = TLPM_init (rsrcDescr, VI_TRUE, VI_FALSE, instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	//Do not limit bandwidth and keep the range fixed (see PM103_fast_measurement.c)
+	stat = TLPM_setInputFilterState(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set filter to full bandwidth.\n");
+
+	stat = TLPM_setPowerAutoRange(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to disable autoranging.\n");
+
+	stat = TLPM_confPowerFastArrayMeasurement(*instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to configure fast measure stream.\n");
+
+	//Reader specialized on the model, resolved once here
+	const PMModel *model;
+	stat = PMModel_deviceSource(*instrHandle, &model, source);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set up the fast measure stream reader of the %s.\n", model->name);
+
+	return VI_SUCCESS;
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream pulse detection sample\n");
+	printf("==============================================================\n");
+	printf("Usage: %s [-sim] [-bench] [-high <mW>] [-low <mW>] [-csv <file>] [seconds]\n\n", argv[0]);
+
+	ViStatus    stat;
+	ViSession   instrHandle = VI_NULL;
+	ViBoolean   useSim = VI_FALSE;
+	ViBoolean   bench = VI_FALSE;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	double      highMw = DEFAULT_HIGH_MW;
+	double      lowMw = DEFAULT_LOW_MW;
+	const char  *csvPath = NULL;
+	PMSim       sim;
+	PMSimConfig simCfg;
+	PMBlockSource source;
+	PMPulseConfig cfg;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-sim") == 0)
+			useSim = VI_TRUE;
+		else if(strcmp(argv[i], "-bench") == 0)
+			bench = VI_TRUE;
+		else if(strcmp(argv[i], "-high") == 0 && i + 1 < argc)
+			highMw = atof(argv[++i]);
+		else if(strcmp(argv[i], "-low") == 0 && i + 1 < argc)
+			lowMw = atof(argv[++i]);
+		else if(strcmp(argv[i], "-csv") == 0 && i + 1 < argc)
+			csvPath = argv[++i];
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	PMPulse_defaultConfig(&cfg, (ViReal32)(highMw * 1e-3), (ViReal32)(lowMw * 1e-3));
+	printf("Thresholds: high %f mW, low %f mW, kernel %s\n", cfg.highThreshold * 1000, cfg.lowThreshold * 1000,
+			PMPulse_kernelName(PMPulse_kernel()));
+	if(bench)
+		return benchmark(&cfg);
+
+	if(csvPath != NULL)
+	{
+		if((pulses.csv = fopen(csvPath, "w")) == NULL)
+		{
+			printf("Failed to create '%s'\n", csvPath);
+			return VI_ERROR_FILE_ACCESS;
+		}
+		fprintf(pulses.csv, "index,timestamp_us,samples,peak_W,baseline_W,width_us,rise_us,energy_J,flags\n");
+	}
+
+	if(!useSim)
+	{
+		if((stat = openDevice(&instrHandle, &source)) != VI_SUCCESS)
+			return stat;
+	}
+	else
+	{
+		//1 kHz train of 100 us pulses, 5 mW on the 1 mW default signal
+		PMSim_defaultConfig(&simCfg);
+		simPulses(&simCfg);
+		PMSim_init(&sim, &simCfg);
+		source = PMSim_source(&sim);
+	}
+
+	//The detector runs on its own consumer thread; only pulse records leave it
+	PMPulse_init(&detector, &cfg, onPulse, &pulses);
+
+	static PMAcq acq;
+	PMAcq_init(&acq, source, PM_ACQ_DEFAULT_RING_SIZE);
+	if((stat = PMAcq_addConsumer(&acq, "pulses", PMPulse_consumer, &detector)) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		if(pulses.csv != NULL)
+			fclose(pulses.csv);
+		return returnErr(instrHandle, stat, "Failed to start acquisition engine.\n");
+	}
+
+	uint64_t lastCount = 0;
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMPlat_sleepUs(1000000);
+		uint64_t count = PMPlat_load64(&pulses.count);
+		printf("%llu pulses/s\n", (unsigned long long)(count - lastCount));
+		lastCount = count;
+	}
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+	if(pulses.csv != NULL)
+		fclose(pulses.csv);
+
+	if(pulses.count > 0)
+	{
+		double n = (double)pulses.count;
+		printf("Pulses: %llu (%llu flagged), mean peak %f mW, width %.1f us, rise %.1f us, energy %f uJ\n",
+				(unsigned long long)pulses.count, (unsigned long long)pulses.flagged, pulses.peak / n * 1000,
+				pulses.width / n, pulses.rise / n, pulses.energy / n * 1e6);
+	}
+	//A raw sample is a 4 byte timestamp and a 4 byte value
+	printf("Samples: %llu (%llu in pulses), raw %llu bytes, pulse records %llu bytes\n",
+			(unsigned long long)detector.index, (unsigned long long)detector.pulseSamples,
+			(unsigned long long)detector.index * 8, (unsigned long long)(detector.pulses * sizeof(PMPulse)));
+	if(useSim)
+		printf("Simulated device lost %llu samples to buffer overrun\n", (unsigned long long)sim.lost);
+
+	if(stat != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Fast measure stream stopped with error.\n");
+
+	if(instrHandle != VI_NULL)
+		TLPM_close (instrHandle);
+	return 0;
+}
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_capture.h"
+#include "pm_supervisor.h"
+#include "pm_timeline.h"
+
+#define DEFAULT_RUN_TIME_SEC	10
+
+//Stream consumer: timeline with the reconnects marked as interruptions, optional capture file
+typedef struct
+{
+	PMTimeline        timeline;
+	PMCapture         *capture;
+} Recording;
+
+static Recording recording;
+static PMCapture capture;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+//Runs on every open of the session, the first one and each reconnect
+static ViStatus setupDevice(void *ctx, ViSession vi)
+{
+	ViStatus stat;
+
+	(void)ctx;
+	if((stat = TLPM_setInputFilterState(vi, VI_FALSE)) != VI_SUCCESS)
+		return stat;
+	return TLPM_setPowerAutoRange(vi, TLPM_AUTORANGE_POWER_OFF);
+}
+
+//Reader thread, before the first sample after the outage is queued
+static void onOutage(void *ctx, const PMSupOutage *outage)
+{
+	Recording *rec = (Recording*)ctx;
+
+	PMTimeline_mark(&rec->timeline, outage->lastRaw, outage->firstRaw, PM_GAP_RECONNECT);
+	if(rec->capture != NULL)
+		PMCapture_markGap(rec->capture, outage->lastRaw, outage->firstRaw, PM_GAP_RECONNECT, outage->cause);
+	printf("  outage %llu: 0x%08X, back after %u attempts, %llu us without samples\n",
+			(unsigned long long)outage->index, (unsigned int)outage->cause, (unsigned int)outage->attempts,
+			(unsigned long long)outage->downUs);
+}
+
+static void recordBlock(void *ctx, const PMFastBlock *block)
+{
+	Recording *rec = (Recording*)ctx;
+
+	PMTimeline_process(&rec->timeline, block->timestamps, block->count, NULL);
+}
+
+static void printStatus(const char *prefix, PMSupStats *ss, const PMTimelineStats *ts)
+{
+	printf("%s%-12s %9.0f S/s, outages %llu (%llu open attempts), retried %llu, down %llu us, availability %.4f %%, "
+			"interruptions %llu, gaps %llu (%llu samples)\n", prefix, PMSup_stateName(ss->state), ss->samplesPerSec,
+			(unsigned long long)ss->outages, (unsigned long long)ss->reconnects, (unsigned long long)ss->retried,
+			(unsigned long long)ss->downUs, ss->availability * 100.0, (unsigned long long)ts->interruptions,
+			(unsigned long long)ts->gaps, (unsigned long long)ts->missing);
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter resilient capture sample\n");
+	printf("============================================\n");
+	printf("Usage: %s [-capture <file>] [seconds]\n\n", argv[0]);
+
+	ViStatus     stat;
+	ViUInt32     resourceCount = 0;
+	ViChar       rsrcDescr[TLPM_BUFFER_SIZE];
+	uint32_t     runTime = DEFAULT_RUN_TIME_SEC;
+	const char   *capturePath = NULL;
+	PMSupConfig  cfg;
+	static PMSupervisor sup;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-capture") == 0 && i + 1 < argc)
+			capturePath = argv[++i];
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	//The supervisor owns the session from here on and opens it again after every outage
+	PMSup_defaultConfig(&cfg);
+	cfg.setup     = setupDevice;
+	cfg.onOutage  = onOutage;
+	cfg.outageCtx = &recording;
+	if((stat = PMSup_open(&sup, rsrcDescr, &cfg)) != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	PMTimeline_init(&recording.timeline, cfg.periodUs, NULL, NULL);
+	if(capturePath != NULL)
+	{
+		PMCaptureInfo info;
+		ViChar        name[TLPM_BUFFER_SIZE] = "";
+		ViChar        serial[TLPM_BUFFER_SIZE] = "";
+
+		TLPM_identificationQuery(sup.session, VI_NULL, name, serial, VI_NULL);
+		info.device     = name;
+		info.serial     = serial;
+		info.unit       = "W";
+		info.channel    = 1;
+		info.sampleRate = 1000000 / cfg.periodUs;
+		if((stat = PMCapture_create(&capture, capturePath, &info, (uint64_t)runTime * info.sampleRate)) != VI_SUCCESS)
+		{
+			PMSup_close(&sup);
+			return returnErr(VI_NULL, stat, "Failed to create capture file '%s'.\n", capturePath);
+		}
+		recording.capture = &capture;
+	}
+
+	static PMAcq acq;
+	PMAcq_init(&acq, PMSup_source(&sup), PM_ACQ_DEFAULT_RING_SIZE);
+	if((stat = PMAcq_addConsumer(&acq, "timeline", recordBlock, &recording)) ||
+	   (capturePath != NULL && (stat = PMAcq_addConsumer(&acq, "capture", PMCapture_consumer, &capture))) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		if(capturePath != NULL)
+			PMCapture_close(&capture);
+		PMSup_close(&sup);
+		return returnErr(VI_NULL, stat, "Failed to start acquisition engine.\n");
+	}
+
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMSupStats      ss;
+		PMTimelineStats ts;
+		char            prefix[16];
+
+		PMPlat_sleepUs(1000000);
+		PMSup_getStats(&sup, &ss);
+		PMTimeline_getStats(&recording.timeline, &ts);
+		snprintf(prefix, sizeof(prefix), "%3u s: ", (unsigned int)(sec + 1));
+		printStatus(prefix, &ss, &ts);
+	}
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+
+	PMSupStats      ss;
+	PMTimelineStats ts;
+	PMSup_getStats(&sup, &ss);
+	PMTimeline_getStats(&recording.timeline, &ts);
+	printStatus("Supervisor: ", &ss, &ts);
+	printf("Longest outage %llu us, last cause 0x%08X\n", (unsigned long long)ss.maxDownUs, (unsigned int)ss.lastCause);
+
+	if(capturePath != NULL)
+	{
+		uint32_t gaps = capture.header->gapCount;
+		uint64_t samples = capture.samples;
+		ViStatus capStat = PMCapture_close(&capture);
+
+		printf("Capture '%s': %llu samples, %u recorded gaps, status 0x%08X\n", capturePath,
+				(unsigned long long)samples, (unsigned int)gaps, (unsigned int)capStat);
+	}
+
+	PMSup_close(&sup);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Fast measure stream stopped with error.\n");
+	return 0;
+}
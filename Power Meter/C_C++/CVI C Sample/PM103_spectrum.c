@@ -0,0 +1,229 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_model.h"
+#include "pm_sim.h"
+#include "pm_spectrum.h"
+
+#define DEFAULT_RUN_TIME_SEC	5
+#define DEFAULT_MAINS_HZ		50
+#define MAX_PRINTED_PEAKS		5
+#define MAX_MAINS_HARMONIC		20
+
+static PMSpectrum spectrum;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+static ViStatus openDevice(ViSession *instrHandle, PMBlockSource *source)
+{
+	ViStatus stat;
+	ViUInt32 resourceCount = 0;
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+
+	*instrHandle = VI_NULL;
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	stat = TLPM_init (rsrcDescr, VI_TRUE, VI_FALSE, instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	//Do not limit bandwidth and keep the range fixed (see PM103_fast_measurement.c)
+	stat = TLPM_setInputFilterState(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set filter to full bandwidth.\n");
+
+	stat = TLPM_setPowerAutoRange(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to disable autoranging.\n");
+
+	stat = TLPM_confPowerFastArrayMeasurement(*instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to configure fast measure stream.\n");
+
+	//Reader specialized on the model, resolved once here
+	const PMModel *model;
+	stat = PMModel_deviceSource(*instrHandle, &model, source);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set up the fast measure stream reader of the %s.\n", model->name);
+
+	return VI_SUCCESS;
+}
+
+//Dominant frequencies and noise floor of the current estimate; tones near a mains harmonic are marked
+static void printSpectrum(double *psd, double mainsHz)
+{
+	PMSpectrumPeak peaks[MAX_PRINTED_PEAKS];
+	uint64_t       segments;
+	double         floor;
+	uint32_t       bins = PMSpectrum_get(&spectrum, psd, &segments);
+	uint32_t       n = PMSpectrum_analyze(psd, bins, spectrum.binHz, peaks, MAX_PRINTED_PEAKS, &floor);
+
+	printf("Segments %llu, gaps %llu, noise floor %.3f nW/sqrt(Hz)\n", (unsigned long long)segments,
+			(unsigned long long)spectrum.gaps, floor * 1e9);
+	for(uint32_t i = 0; i < n; i++)
+	{
+		int h = (int)(peaks[i].frequency / mainsHz + 0.5);
+
+		printf("  %10.1f Hz  %12.3f uW rms", peaks[i].frequency, peaks[i].amplitude * 1e6);
+		if(h >= 1 && h <= MAX_MAINS_HARMONIC && fabs(peaks[i].frequency - h * mainsHz) < spectrum.binHz)
+		{
+			if(h == 1)
+				printf("  mains");
+			else
+				printf("  mains harmonic %d", h);
+		}
+		printf("\n");
+	}
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream spectrum sample\n");
+	printf("=======================================================\n");
+	printf("Usage: %s [-sim] [-length <samples>] [-mains <Hz>] [seconds]\n\n", argv[0]);
+
+	ViStatus    stat;
+	ViSession   instrHandle = VI_NULL;
+	ViBoolean   useSim = VI_FALSE;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	double      mainsHz = DEFAULT_MAINS_HZ;
+	PMSim       sim;
+	PMSimConfig simCfg;
+	PMBlockSource source;
+	PMSpectrumConfig cfg;
+
+	PMSpectrum_defaultConfig(&cfg);
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-sim") == 0)
+			useSim = VI_TRUE;
+		else if(strcmp(argv[i], "-length") == 0 && i + 1 < argc)
+		{
+			cfg.length = (uint32_t)atoi(argv[++i]);
+			cfg.hop    = cfg.length / 2;
+		}
+		else if(strcmp(argv[i], "-mains") == 0 && i + 1 < argc)
+			mainsHz = atof(argv[++i]);
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	if((stat = PMSpectrum_init(&spectrum, &cfg, NULL)) != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Segment length must be a power of two.\n");
+	printf("Segment %u samples, %.1f Hz resolution, %u%% overlap, %u averages\n", (unsigned int)spectrum.cfg.length,
+			spectrum.binHz, (unsigned int)(100 - spectrum.cfg.hop * 100 / spectrum.cfg.length), (unsigned int)spectrum.cfg.averages);
+
+	double *psd = (double*)malloc(spectrum.bins * sizeof(double));
+	if(psd == NULL)
+	{
+		PMSpectrum_free(&spectrum);
+		return returnErr(VI_NULL, VI_ERROR_ALLOC, "Out of memory.\n");
+	}
+
+	if(!useSim)
+	{
+		if((stat = openDevice(&instrHandle, &source)) != VI_SUCCESS)
+		{
+			PMSpectrum_free(&spectrum);
+			free(psd);
+			return stat;
+		}
+	}
+	else
+	{
+		//Default simulated signal: 1 mW with 0.1 mW of 50 Hz modulation and noise
+		PMSim_defaultConfig(&simCfg);
+		PMSim_configFromEnv(&simCfg);
+		PMSim_init(&sim, &simCfg);
+		source = PMSim_source(&sim);
+	}
+
+	//The transforms run on the spectrum consumer thread, the reader only polls
+	static PMAcq acq;
+	PMAcq_init(&acq, source, PM_ACQ_DEFAULT_RING_SIZE);
+	if((stat = PMAcq_addConsumer(&acq, "spectrum", PMSpectrum_consumer, &spectrum)) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		PMSpectrum_free(&spectrum);
+		free(psd);
+		return returnErr(instrHandle, stat, "Failed to start acquisition engine.\n");
+	}
+
+	uint64_t startNs = PMPlat_timeNs();
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMPlat_sleepUs(1000000);
+		printSpectrum(psd, mainsHz);
+	}
+	uint64_t elapsedNs = PMPlat_timeNs() - startNs;
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+
+	printSpectrum(psd, mainsHz);
+	printf("Transforms: %llu, %.1f us each, %.3f %% of one core; %llu samples dropped at gaps\n",
+			(unsigned long long)spectrum.segments, spectrum.segments ? (double)spectrum.busyNs / (double)spectrum.segments / 1000 : 0.0,
+			(double)spectrum.busyNs * 100.0 / (double)elapsedNs, (unsigned long long)spectrum.dropped);
+	PMSpectrum_free(&spectrum);
+	free(psd);
+
+	if(stat != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Fast measure stream stopped with error.\n");
+
+	if(instrHandle != VI_NULL)
+		TLPM_close (instrHandle);
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_shmstream.h"
+
+#define DEFAULT_RUN_TIME_SEC	10
+#define QUERY_TIMEOUT_US		1000000
+#define IDLE_US					200
+
+static void printQuery(const char *what, ViStatus stat, const PMShmQuery *q)
+{
+	if(stat == VI_SUCCESS)
+		printf("%s: %g %s\n", what, q->value, q->text);
+	else
+		printf("%s: failed, status 0x%08X\n", what, (unsigned int)stat);
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream client sample\n");
+	printf("=====================================================\n");
+	printf("Usage: %s [-name <stream>] [-wavelength <nm>] [-delay <us per block>] [seconds]\n\n", argv[0]);
+
+	ViStatus    stat;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	uint32_t    delayUs = 0;
+	double      wavelength = 0.0;
+	const char  *name = PM_SHM_DEFAULT_NAME;
+	PMShmReader reader;
+	PMShmQuery  q;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-name") == 0 && i + 1 < argc)
+			name = argv[++i];
+		else if(strcmp(argv[i], "-wavelength") == 0 && i + 1 < argc)
+			wavelength = atof(argv[++i]);
+		else if(strcmp(argv[i], "-delay") == 0 && i + 1 < argc)
+			delayUs = (uint32_t)atoi(argv[++i]);
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	if((stat = PMShmReader_open(&reader, name)) != VI_SUCCESS)
+	{
+		printf("Failed to open stream '%s' (is the server running?), status 0x%08X\n", name, (unsigned int)stat);
+		return stat;
+	}
+	printf("Reading '%s' (%s %s, %.0f Hz), %u blocks in the ring\n", name, reader.hdr->info.device,
+			reader.hdr->info.serial, reader.hdr->info.sampleRate, (unsigned int)reader.hdr->capacity);
+	if(reader.entry == NULL)
+		printf("Client table full, the server will not list this client\n");
+
+	//Scalar queries go through the server, it owns the session
+	memset(&q, 0, sizeof(q));
+	q.op = PM_SHM_IDENTIFY;
+	stat = PMShmReader_query(&reader, &q, QUERY_TIMEOUT_US);
+	printQuery("Instrument", stat, &q);
+
+	if(wavelength > 0.0)
+	{
+		memset(&q, 0, sizeof(q));
+		q.op  = PM_SHM_SET_WAVELENGTH;
+		q.arg = wavelength;
+		stat = PMShmReader_query(&reader, &q, QUERY_TIMEOUT_US);
+		printQuery("Set wavelength", stat, &q);
+	}
+
+	memset(&q, 0, sizeof(q));
+	q.op        = PM_SHM_GET_WAVELENGTH;
+	q.attribute = TLPM_ATTR_SET_VAL;
+	stat = PMShmReader_query(&reader, &q, QUERY_TIMEOUT_US);
+	printQuery("Wavelength (nm)", stat, &q);
+
+	uint64_t startNs = PMPlat_timeNs();
+	uint64_t nextNs = startNs + 1000000000ull;
+	uint64_t samples = 0, totalSamples = 0;
+	double   sum = 0.0;
+
+	while(PMPlat_timeNs() - startNs < (uint64_t)runTime * 1000000000ull)
+	{
+		//The block is read in place; endRead tells if the server overwrote it meanwhile
+		const PMFastBlock *block = PMShmReader_beginRead(&reader);
+
+		if(block != NULL)
+		{
+			uint32_t count = block->count;
+			double   blockSum = 0.0;
+
+			for(uint32_t i = 0; i < count && i < PM_FAST_BLOCK_SIZE; i++)
+				blockSum += block->values[i];
+			if(delayUs > 0)
+				PMPlat_sleepUs(delayUs);
+
+			if(PMShmReader_endRead(&reader) == VI_SUCCESS)
+			{
+				samples += count;
+				sum     += blockSum;
+			}
+		}
+		else if(PMShmReader_state(&reader) == PM_SHM_STOPPED)
+		{
+			printf("Server stopped, status 0x%08X\n", (unsigned int)reader.hdr->status);
+			break;
+		}
+		else
+			PMPlat_sleepUs(IDLE_US);
+
+		if(PMPlat_timeNs() >= nextNs)
+		{
+			printf("%llu samples/s, mean %f mW, blocks read %llu, lost %llu, torn %llu\n",
+					(unsigned long long)samples, samples ? sum / (double)samples * 1000 : 0.0,
+					(unsigned long long)reader.blocks, (unsigned long long)reader.lost, (unsigned long long)reader.torn);
+			totalSamples += samples;
+			samples = 0;
+			sum     = 0.0;
+			nextNs += 1000000000ull;
+		}
+	}
+
+	printf("--------------\n");
+	printf("Samples: %llu, blocks read %llu, lost %llu, torn %llu\n", (unsigned long long)(totalSamples + samples),
+			(unsigned long long)reader.blocks, (unsigned long long)reader.lost, (unsigned long long)reader.torn);
+	PMShmReader_close(&reader);
+	return 0;
+}
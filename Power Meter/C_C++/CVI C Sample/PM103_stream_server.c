@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_model.h"
+#include "pm_shmstream.h"
+#include "pm_sim.h"
+
+#define DEFAULT_RUN_TIME_SEC	60
+
+static PMShmServer server;
+
+static int returnErr(ViSession instrHdl, ViStatus status, const char* format, ...)
+{
+	va_list args;
+	va_start (args, format);
+	vprintf (format, args);
+	va_end (args);
+
+	ViChar rsrcDescr[TLPM_BUFFER_SIZE];
+	if(TLPM_errorMessage (instrHdl, status, rsrcDescr) == VI_SUCCESS)
+		printf("Details: %s\n", rsrcDescr);
+	else
+		printf("Details: %ld\n", (long)status);
+
+	if(instrHdl != VI_NULL)
+		TLPM_close(instrHdl);
+	return status;
+}
+
+static ViStatus openDevice(ViSession *instrHandle, PMBlockSource *source)
+{
+	ViStatus stat;
+	ViUInt32 resourceCount = 0;
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+
+	*instrHandle = VI_NULL;
+	stat = TLPM_findRsrc (0, &resourceCount);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to init PM driver.\n");
+
+	stat = TLPM_getRsrcName(0, 0, rsrcDescr);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to get resource name.\n");
+
+	stat = TLPM_init (rsrcDescr, VI_TRUE, VI_FALSE, instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(VI_NULL, stat, "Failed to open PM.\n");
+
+	//Do not limit bandwidth and keep the range fixed (see PM103_fast_measurement.c)
+	stat = TLPM_setInputFilterState(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set filter to full bandwidth.\n");
+
+	stat = TLPM_setPowerAutoRange(*instrHandle, VI_FALSE);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to disable autoranging.\n");
+
+	stat = TLPM_confPowerFastArrayMeasurement(*instrHandle);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to configure fast measure stream.\n");
+
+	//Reader specialized on the model, resolved once here
+	const PMModel *model;
+	stat = PMModel_deviceSource(*instrHandle, &model, source);
+	if(stat != VI_SUCCESS)
+		return returnErr(*instrHandle, stat, "Failed to set up the fast measure stream reader of the %s.\n", model->name);
+
+	return VI_SUCCESS;
+}
+
+//Run time in seconds, decimal digits only
+static int parseSeconds(const char *arg, uint32_t *seconds)
+{
+	char          *end;
+	unsigned long value;
+
+	if(arg[0] < '0' || arg[0] > '9')
+		return 0;
+	value = strtoul(arg, &end, 10);
+	if(*end != '\0' || value > UINT32_MAX)
+		return 0;
+	*seconds = (uint32_t)value;
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter fast measure stream server sample\n");
+	printf("=====================================================\n");
+	printf("Usage: %s [-sim] [-name <stream>] [-blocks <ring blocks>] [seconds]\n\n", argv[0]);
+
+	ViStatus    stat;
+	ViSession   instrHandle = VI_NULL;
+	ViBoolean   useSim = VI_FALSE;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	uint32_t    capacity = PM_SHM_DEFAULT_CAPACITY;
+	const char  *name = PM_SHM_DEFAULT_NAME;
+	PMSim       sim;
+	PMSimConfig simCfg;
+	PMBlockSource device;
+	PMShmStreamInfo info;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-sim") == 0)
+			useSim = VI_TRUE;
+		else if(strcmp(argv[i], "-name") == 0 && i + 1 < argc)
+			name = argv[++i];
+		else if(strcmp(argv[i], "-blocks") == 0 && i + 1 < argc)
+			capacity = (uint32_t)atoi(argv[++i]);
+		else if(!parseSeconds(argv[i], &runTime))
+		{
+			printf("Unknown option '%s'\n", argv[i]);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+
+	memset(&info, 0, sizeof(info));
+	strcpy(info.device, "Simulation");
+	strcpy(info.unit, "W");
+	info.sampleRate = 100000;
+
+	//This process owns the session, the clients only map the stream
+	if(!useSim)
+	{
+		if((stat = openDevice(&instrHandle, &device)) != VI_SUCCESS)
+			return stat;
+		TLPM_identificationQuery(instrHandle, VI_NULL, info.device, info.serial, VI_NULL);
+	}
+
+	if((stat = PMShmServer_create(&server, name, capacity, &info)) != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Failed to create stream '%s' (is another server running?).\n", name);
+	printf("Publishing '%s' (%s %s), %u blocks of %u samples\n", name, info.device, info.serial,
+			(unsigned int)server.hdr->capacity, (unsigned int)PM_FAST_BLOCK_SIZE);
+
+	//The simulated device starts streaming right away, so set it up last
+	if(useSim)
+	{
+		PMSim_defaultConfig(&simCfg);
+		PMSim_init(&sim, &simCfg);
+		device = PMSim_source(&sim);
+	}
+
+	//Client queries run on the reader thread between two stream reads
+	static PMAcq acq;
+	PMAcq_init(&acq, PMShmServer_source(&server, device, instrHandle), PM_ACQ_DEFAULT_RING_SIZE);
+	if((stat = PMAcq_addConsumer(&acq, "shm", PMShmServer_consumer, &server)) ||
+	   (stat = PMAcq_start(&acq)))
+	{
+		PMAcq_free(&acq);
+		PMShmServer_close(&server, stat);
+		return returnErr(instrHandle, stat, "Failed to start acquisition engine.\n");
+	}
+
+	for(uint32_t sec = 0; sec < runTime && PMAcq_isRunning(&acq); sec++)
+	{
+		PMAcqStats       stats;
+		PMShmReaderStats readers[PM_SHM_MAX_READERS];
+		uint32_t         n;
+
+		PMPlat_sleepUs(1000000);
+		PMAcq_getStats(&acq, &stats);
+		PMAcq_printStats(&stats);
+
+		n = PMShmServer_readers(&server, readers, PM_SHM_MAX_READERS);
+		printf("Clients: %u, queries answered: %llu\n", (unsigned int)n, (unsigned long long)server.queriesServed);
+		for(uint32_t i = 0; i < n; i++)
+			printf("  client %2u: %s, %llu blocks behind, %llu lost\n", (unsigned int)readers[i].id,
+					readers[i].active ? "reading" : "idle   ", (unsigned long long)readers[i].lag, (unsigned long long)readers[i].lost);
+	}
+
+	stat = PMAcq_stop(&acq);
+
+	printf("--------------\n");
+	PMAcqStats stats;
+	PMAcq_getStats(&acq, &stats);
+	PMAcq_printStats(&stats);
+	PMAcq_free(&acq);
+
+	printf("Published %llu blocks, %llu samples\n", (unsigned long long)server.hdr->head, (unsigned long long)server.hdr->samples);
+	PMShmServer_close(&server, stat);
+
+	if(stat != VI_SUCCESS)
+		return returnErr(instrHandle, stat, "Fast measure stream stopped with error.\n");
+
+	if(instrHandle != VI_NULL)
+		TLPM_close (instrHandle);
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "visatype.h"
+
+#include "pm_track.h"
+
+#define DEFAULT_RUN_TIME_SEC	5
+#define STATUS_INTERVAL_US		200000
+
+typedef struct
+{
+	uint64_t lastNs;
+	uint64_t maxGapNs;			// longest time between two samples
+	uint64_t restarts;
+} TrackCtx;
+
+//Runs on the tracking thread for every sample. A beam steering loop would
+//compute its correction from predictedX/predictedY right here.
+static void onSample(void *ctx, const PMTrackSample *s)
+{
+	TrackCtx *tc = (TrackCtx*)ctx;
+
+	if(tc->lastNs != 0 && s->timeNs - tc->lastNs > tc->maxGapNs)
+		tc->maxGapNs = s->timeNs - tc->lastNs;
+	tc->lastNs = s->timeNs;
+	if(s->flags & PM_TRACK_FLAG_RESTART)
+		tc->restarts++;
+}
+
+//Beam position from the quadrant voltages at the rate of the device round
+//trip, filtered and extrapolated for closed-loop beam steering
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter 4Q position tracking sample\n");
+	printf("===============================================\n");
+	printf("Usage: %s [-calibrate] [-gain g] [-alpha a] [-beta b] [-predict us] [-interval us] [-cpu n] [seconds] [resource]\n", argv[0]);
+	printf("       -calibrate fits gain and offset to the driver positions (move the beam meanwhile).\n\n");
+
+	ViStatus      stat;
+	ViSession     instrHandle = VI_NULL;
+	ViChar        rsrcDescr[TLPM_BUFFER_SIZE] = "";
+	ViUInt32      found = 0;
+	ViBoolean     calibrate = VI_FALSE;
+	uint32_t      runTime = DEFAULT_RUN_TIME_SEC;
+	PMTrackConfig cfg;
+	static PMTrack track;
+	static TrackCtx tc;
+
+	PMTrack_defaultConfig(&cfg);
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-calibrate") == 0)
+			calibrate = VI_TRUE;
+		else if(strcmp(argv[i], "-gain") == 0 && i + 1 < argc)
+			cfg.gainX = cfg.gainY = atof(argv[++i]);
+		else if(strcmp(argv[i], "-alpha") == 0 && i + 1 < argc)
+			cfg.alpha = atof(argv[++i]);
+		else if(strcmp(argv[i], "-beta") == 0 && i + 1 < argc)
+			cfg.beta = atof(argv[++i]);
+		else if(strcmp(argv[i], "-predict") == 0 && i + 1 < argc)
+			cfg.predictUs = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-interval") == 0 && i + 1 < argc)
+			cfg.intervalUs = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-cpu") == 0 && i + 1 < argc)
+			cfg.cpu = atoi(argv[++i]);
+		else if(argv[i][0] >= '0' && argv[i][0] <= '9')
+			runTime = (uint32_t)atoi(argv[i]);
+		else
+			strncpy(rsrcDescr, argv[i], TLPM_BUFFER_SIZE - 1);
+	}
+
+	if(rsrcDescr[0] == '\0')
+	{
+		if((stat = TLPMX_findRsrc(0, &found)) != VI_SUCCESS || found == 0)
+		{
+			printf("No power meter found (0x%08X)\n", (unsigned int)stat);
+			return 1;
+		}
+		if((stat = TLPMX_getRsrcName(0, 0, rsrcDescr)) != VI_SUCCESS)
+		{
+			printf("Failed to get resource name (0x%08X)\n", (unsigned int)stat);
+			return stat;
+		}
+	}
+	if((stat = TLPMX_init(rsrcDescr, VI_TRUE, VI_FALSE, &instrHandle)) != VI_SUCCESS)
+	{
+		printf("Failed to open '%s' (0x%08X)\n", rsrcDescr, (unsigned int)stat);
+		return stat;
+	}
+
+	if(calibrate)
+	{
+		if((stat = PMTrack_calibrate(instrHandle, &cfg, 0)) != VI_SUCCESS)
+		{
+			printf("Calibration failed (0x%08X)\n", (unsigned int)stat);
+			TLPMX_close(instrHandle);
+			return stat;
+		}
+		printf("Calibrated: x = %.4f * nx %+.4f, y = %.4f * ny %+.4f\n", cfg.gainX, cfg.offsetX, cfg.gainY, cfg.offsetY);
+	}
+	printf("Filter alpha %.3f, beta %.3f, prediction %u us\n\n", cfg.alpha, cfg.beta, (unsigned int)cfg.predictUs);
+
+	PMTrack_init(&track, instrHandle, &cfg, onSample, &tc);
+	if((stat = PMTrack_start(&track)) != VI_SUCCESS)
+	{
+		printf("Failed to start tracking (0x%08X)\n", (unsigned int)stat);
+		TLPMX_close(instrHandle);
+		return stat;
+	}
+
+	//The main thread only looks at the latest sample now and then
+	uint64_t endNs = PMPlat_timeNs() + (uint64_t)runTime * 1000000000;
+	while(PMPlat_timeNs() < endNs)
+	{
+		PMTrackSample s;
+		PMTrackStats  stats;
+
+		PMPlat_sleepUs(STATUS_INTERVAL_US);
+		PMTrack_getStats(&track, &stats);
+		if(!PMTrack_latest(&track, &s))
+			continue;
+		printf("%8.0f S/s  x %9.4f  y %9.4f  filtered %9.4f %9.4f  predicted %9.4f %9.4f  sum %.4f V%s\r",
+				stats.rate, s.x, s.y, s.filteredX, s.filteredY, s.predictedX, s.predictedY, s.sum,
+				(s.flags & PM_TRACK_FLAG_NO_BEAM) ? " no beam" : (s.flags & PM_TRACK_FLAG_ERROR) ? " error  " : "        ");
+		fflush(stdout);
+	}
+
+	PMTrack_stop(&track);
+
+	PMTrackStats stats;
+	PMTrack_getStats(&track, &stats);
+	printf("\n--------------\n");
+	printf("%llu samples, %.0f S/s, round trip %.1f us mean, %.1f us max, longest gap %.1f us\n",
+			(unsigned long long)stats.samples, stats.rate, stats.meanLatencyUs, stats.maxLatencyUs, (double)tc.maxGapNs / 1000.0);
+	printf("%llu without beam, %llu errors (last 0x%08X), %llu filter restarts\n", (unsigned long long)stats.noBeam,
+			(unsigned long long)stats.errors, (unsigned int)stats.lastError, (unsigned long long)tc.restarts);
+	if(cfg.cpu != PM_TRACK_CPU_NONE && stats.pinStatus != VI_SUCCESS)
+		printf("Tracking thread not pinned to CPU %d (0x%08X)\n", cfg.cpu, (unsigned int)stats.pinStatus);
+
+	TLPMX_close(instrHandle);
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "visatype.h"
+
+#include "pm_async.h"
+
+#define MAX_DEVICES				8
+#define DEFAULT_READINGS		100			// per device and measurement
+#define REQUEST_TIMEOUT_US		2000000
+#define STATUS_INTERVAL_US		100000
+
+static const int measurements[] = { PM_ASYNC_POWER, PM_ASYNC_ENERGY, PM_ASYNC_FREQUENCY, PM_ASYNC_POWER_DENSITY, PM_ASYNC_4Q_POSITIONS };
+#define MEASUREMENT_COUNT		(sizeof(measurements) / sizeof(measurements[0]))
+
+typedef struct
+{
+	PMAsync           async;
+	ViSession         session;
+	char              name[TLPM_BUFFER_SIZE];
+	uint32_t          target;
+	volatile uint32_t done[MEASUREMENT_COUNT];		// completed readings per measurement
+	volatile uint32_t failed[MEASUREMENT_COUNT];
+	uint64_t          latencyNs[MEASUREMENT_COUNT];
+	ViReal64          last[MEASUREMENT_COUNT];
+} Device;
+
+static Device devices[MAX_DEVICES];
+
+static uint32_t measurementIndex(int op)
+{
+	for(uint32_t i = 0; i < MEASUREMENT_COUNT; i++)
+		if(measurements[i] == op)
+			return i;
+	return 0;
+}
+
+//Completion callback, runs on the I/O thread of the device. Keeps one request
+//per measurement outstanding until the target count is reached.
+static void onResult(void *ctx, const PMAsyncResult *res)
+{
+	Device   *dev = (Device*)ctx;
+	uint32_t m = measurementIndex(res->op);
+
+	if(res->status == VI_SUCCESS)
+		dev->last[m] = res->value;
+	else
+		PMPlat_fetchAdd32(&dev->failed[m], 1);
+	dev->latencyNs[m] += res->latencyNs;
+
+	if(PMPlat_fetchAdd32(&dev->done[m], 1) + 1 < dev->target && res->status != VI_ERROR_ABORT)
+		PMAsync_submit(&dev->async, res->op, TLPM_DEFAULT_CHANNEL, REQUEST_TIMEOUT_US, onResult, dev, NULL);
+}
+
+static ViBoolean allDone(uint32_t count)
+{
+	for(uint32_t d = 0; d < count; d++)
+		for(uint32_t m = 0; m < MEASUREMENT_COUNT; m++)
+			if(PMPlat_load32(&devices[d].done[m]) < devices[d].target)
+				return VI_FALSE;
+	return VI_TRUE;
+}
+
+//Power, energy, frequency, power density and 4Q position readings from all
+//connected meters at once. The main thread only submits and reports, every
+//driver call runs on the I/O thread owning the session.
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter asynchronous measurement sample\n");
+	printf("===================================================\n");
+	printf("Usage: %s [-readings n] [resource ...]\n", argv[0]);
+	printf("       Without resources all connected power meters are opened.\n\n");
+
+	ViStatus    stat = VI_SUCCESS;
+	uint32_t    readings = DEFAULT_READINGS;
+	uint32_t    count = 0;
+	ViUInt32    found = 0;
+
+	for(int i = 1; i < argc && count < MAX_DEVICES; i++)
+	{
+		if(strcmp(argv[i], "-readings") == 0 && i + 1 < argc)
+			readings = (uint32_t)atoi(argv[++i]);
+		else
+			strncpy(devices[count++].name, argv[i], TLPM_BUFFER_SIZE - 1);
+	}
+
+	if(count == 0)
+	{
+		if((stat = TLPMX_findRsrc(0, &found)) != VI_SUCCESS || found == 0)
+		{
+			printf("No power meter found (0x%08X)\n", (unsigned int)stat);
+			return 1;
+		}
+		for(count = 0; count < found && count < MAX_DEVICES; count++)
+			if((stat = TLPMX_getRsrcName(0, count, devices[count].name)) != VI_SUCCESS)
+				break;
+	}
+
+	uint32_t opened = 0;
+	for(; opened < count; opened++)
+	{
+		Device *dev = &devices[opened];
+
+		if((stat = TLPMX_init(dev->name, VI_TRUE, VI_FALSE, &dev->session)) != VI_SUCCESS)
+		{
+			printf("Failed to open '%s' (0x%08X)\n", dev->name, (unsigned int)stat);
+			break;
+		}
+		dev->target = readings;
+		PMAsync_init(&dev->async, dev->session);
+		if((stat = PMAsync_start(&dev->async)) != VI_SUCCESS)
+		{
+			TLPMX_close(dev->session);
+			break;
+		}
+	}
+
+	//One outstanding request per device and measurement; callbacks keep them going
+	uint64_t start = PMPlat_timeNs();
+	for(uint32_t d = 0; d < opened && stat == VI_SUCCESS; d++)
+		for(uint32_t m = 0; m < MEASUREMENT_COUNT; m++)
+			if((stat = PMAsync_submit(&devices[d].async, measurements[m], TLPM_DEFAULT_CHANNEL, REQUEST_TIMEOUT_US,
+					onResult, &devices[d], NULL)) != VI_SUCCESS)
+				break;
+
+	//The main thread stays free: here it just reports progress
+	while(stat == VI_SUCCESS && !allDone(opened))
+	{
+		PMPlat_sleepUs(STATUS_INTERVAL_US);
+		printf("%8.3f s:", (double)(PMPlat_timeNs() - start) * 1e-9);
+		for(uint32_t d = 0; d < opened; d++)
+		{
+			PMAsyncStats s;
+
+			PMAsync_getStats(&devices[d].async, &s);
+			printf(" [%u: %llu done, %llu pending, %llu retries]", (unsigned int)d, (unsigned long long)s.completed,
+					(unsigned long long)s.pending, (unsigned long long)s.retries);
+		}
+		printf("\r");
+		fflush(stdout);
+	}
+	double elapsed = (double)(PMPlat_timeNs() - start) * 1e-9;
+	printf("\n--------------\n");
+
+	for(uint32_t d = 0; d < opened; d++)
+	{
+		Device *dev = &devices[d];
+
+		PMAsync_stop(&dev->async);
+		printf("%s\n", dev->name);
+		for(uint32_t m = 0; m < MEASUREMENT_COUNT; m++)
+		{
+			uint32_t n = dev->done[m];
+
+			printf("  %-14s %5u readings, %3u failed, mean latency %9.3f ms, last %g\n",
+					PMAsync_opName(measurements[m]), (unsigned int)n, (unsigned int)dev->failed[m],
+					n ? (double)dev->latencyNs[m] / n * 1e-6 : 0.0, dev->last[m]);
+		}
+		TLPMX_close(dev->session);
+	}
+	printf("%u devices in %.3f s\n", (unsigned int)opened, elapsed);
+
+	if(stat != VI_SUCCESS)
+		printf("Stopped with error 0x%08X\n", (unsigned int)stat);
+	return stat;
+}
@@ -0,0 +1,282 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "visatype.h"
+
+#include "pm_acquisition.h"
+#include "pm_model.h"
+#include "pm_multi.h"
+#include "pm_stats.h"
+#include "pm_timeline.h"
+#include "SimDriver/pm_simdriver.h"
+
+#define DEFAULT_RUN_TIME_SEC	3
+#define DEFAULT_DEVICES			4
+#define DEFAULT_GAP_SAMPLES		20
+#define WRAP_AFTER_US			1000000		// -wrap: 32 bit timestamps wrap 1 s into every run
+
+typedef struct
+{
+	const char  *name;
+	uint64_t    samples;			// samples that reached the consumer
+	uint64_t    missing;			// samples the consumer never saw (timestamp gaps)
+	double      seconds;
+	uint64_t    cpuNs;				// process CPU time during the run
+	uint64_t    wraps;
+	ViStatus    status;
+} BenchResult;
+
+typedef struct
+{
+	PMTimeline  timeline;
+	PMStats     stats;
+} BenchSink;
+
+static BenchSink sinks[PM_MULTI_MAX_DEVICES];
+static PMAcq     acq;
+static PMMulti   multi;
+
+static void resetSinks(void)
+{
+	for(uint32_t i = 0; i < PM_MULTI_MAX_DEVICES; i++)
+	{
+		PMTimeline_init(&sinks[i].timeline, PM_TIMELINE_DEFAULT_PERIOD_US, NULL, NULL);
+		PMStats_reset(&sinks[i].stats);
+	}
+}
+
+//Consumers: timeline reconstruction and statistics, the work every real consumer does at least
+static void sinkBlock(BenchSink *sink, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count)
+{
+	PMTimeline_process(&sink->timeline, timestamps, count, NULL);
+	PMStats_add(&sink->stats, values, count);
+}
+
+static void consumeEngine(void *ctx, const PMFastBlock *block)
+{
+	sinkBlock((BenchSink*)ctx, block->timestamps, block->values, block->count);
+}
+
+static void consumeMulti(void *ctx, uint32_t device, const PMFastBlock *block)
+{
+	sinkBlock(&((BenchSink*)ctx)[device], block->timestamps, block->values, block->count);
+}
+
+static void collectSinks(BenchResult *res, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		res->samples += sinks[i].timeline.samples;
+		res->missing += sinks[i].timeline.missing;
+		res->wraps   += sinks[i].timeline.wraps;
+	}
+}
+
+static ViStatus openFastStream(ViUInt32 index, ViSession *instr)
+{
+	ViChar   rsrcDescr[TLPM_BUFFER_SIZE];
+	ViStatus err;
+
+	if((err = TLPM_getRsrcName(0, index, rsrcDescr)) || (err = TLPM_init(rsrcDescr, VI_TRUE, VI_FALSE, instr)))
+		return err;
+	if((err = TLPM_setInputFilterState(*instr, VI_FALSE)) ||
+	   (err = TLPM_setPowerAutoRange(*instr, VI_FALSE)) ||
+	   (err = TLPM_confPowerFastArrayMeasurement(*instr)))
+		TLPM_close(*instr);
+	return err;
+}
+
+//Plain poll loop on the calling thread, like PM103_fast_measurement
+static void benchDirect(BenchResult *res, uint32_t seconds)
+{
+	ViSession instr;
+	ViUInt16  count;
+	ViUInt32  timestamps[PM_FAST_BLOCK_SIZE];
+	ViReal32  values[PM_FAST_BLOCK_SIZE];
+
+	if((res->status = openFastStream(0, &instr)) != VI_SUCCESS)
+		return;
+
+	uint64_t endNs = PMPlat_timeNs() + (uint64_t)seconds * 1000000000ull;
+	while(PMPlat_timeNs() < endNs)
+	{
+		if((res->status = TLPM_getNextFastArrayMeasurement(instr, &count, timestamps, values)) != VI_SUCCESS)
+			break;
+		if(count > 0)
+			sinkBlock(&sinks[0], timestamps, values, count);
+	}
+
+	collectSinks(res, 1);
+	TLPM_close(instr);
+}
+
+//Reader thread plus consumer thread through the SPSC ring (PMAcq)
+static void benchEngine(BenchResult *res, uint32_t seconds)
+{
+	ViSession     instr;
+	const PMModel *model;
+	PMBlockSource source;
+
+	if((res->status = openFastStream(0, &instr)) != VI_SUCCESS)
+		return;
+	if((res->status = PMModel_deviceSource(instr, &model, &source)) != VI_SUCCESS)
+	{
+		TLPM_close(instr);
+		return;
+	}
+
+	PMAcq_init(&acq, source, PM_ACQ_DEFAULT_RING_SIZE);
+	if((res->status = PMAcq_addConsumer(&acq, "sink", consumeEngine, &sinks[0])) == VI_SUCCESS &&
+	   (res->status = PMAcq_start(&acq)) == VI_SUCCESS)
+	{
+		PMPlat_sleepUs(seconds * 1000000);
+		res->status = PMAcq_stop(&acq);
+	}
+
+	collectSinks(res, 1);
+	PMAcq_free(&acq);
+	TLPM_close(instr);
+}
+
+//All simulated devices with one pinned worker each and a shared consumer (PMMulti)
+static void benchMulti(BenchResult *res, uint32_t seconds)
+{
+	PMMulti_init(&multi, consumeMulti, sinks, PM_ACQ_DEFAULT_RING_SIZE);
+	if((res->status = PMMulti_openDevices(&multi, NULL, 0)) == VI_SUCCESS &&
+	   (res->status = PMMulti_start(&multi)) == VI_SUCCESS)
+	{
+		PMPlat_sleepUs(seconds * 1000000);
+		res->status = PMMulti_stop(&multi);
+	}
+
+	collectSinks(res, multi.deviceCount);
+	PMMulti_free(&multi);
+}
+
+//Scalar readings; a "sample" is one TLPM_measPower round trip
+static void benchScalar(BenchResult *res, uint32_t seconds)
+{
+	ViSession instr;
+	ViChar    rsrcDescr[TLPM_BUFFER_SIZE];
+	ViReal64  power;
+
+	if((res->status = TLPM_getRsrcName(0, 0, rsrcDescr)) || (res->status = TLPM_init(rsrcDescr, VI_TRUE, VI_FALSE, &instr)))
+		return;
+
+	uint64_t endNs = PMPlat_timeNs() + (uint64_t)seconds * 1000000000ull;
+	while(PMPlat_timeNs() < endNs)
+	{
+		if((res->status = TLPM_measPower(instr, &power)) != VI_SUCCESS)
+			break;
+		PMStats_add(&sinks[0].stats, &(ViReal32){ (ViReal32)power }, 1);
+		res->samples++;
+	}
+
+	TLPM_close(instr);
+}
+
+typedef struct
+{
+	const char  *name;
+	void        (*run)(BenchResult *res, uint32_t seconds);
+} BenchScenario;
+
+static const BenchScenario scenarios[] =
+{
+	{ "direct", benchDirect },
+	{ "engine", benchEngine },
+	{ "multi",  benchMulti  },
+	{ "scalar", benchScalar },
+};
+
+#define SCENARIO_COUNT	(sizeof(scenarios) / sizeof(scenarios[0]))
+
+//End-to-end throughput of the acquisition paths against the simulated driver.
+//Drop rate is what the consumers lost according to the device timestamps,
+//CPU per sample is the process CPU time (all threads) divided by the samples delivered.
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter acquisition benchmark suite (simulated driver)\n");
+	printf("==================================================================\n");
+	printf("Usage: %s [-devices n] [-latency us] [-jitter us] [-gaps probability] [-gapsamples n]\n", argv[0]);
+	printf("       [-wrap] [-unpaced] [seconds] [direct|engine|multi|scalar ...]\n\n");
+
+	PMSimConfig cfg;
+	uint32_t    devices = DEFAULT_DEVICES;
+	uint32_t    runTime = DEFAULT_RUN_TIME_SEC;
+	ViBoolean   selected[SCENARIO_COUNT] = { VI_FALSE };
+	ViBoolean   any = VI_FALSE;
+
+	PMSimDriver_getConfig(&cfg);
+	cfg.gapSamples = DEFAULT_GAP_SAMPLES;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-devices") == 0 && i + 1 < argc)
+			devices = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-latency") == 0 && i + 1 < argc)
+			cfg.callLatencyUs = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-jitter") == 0 && i + 1 < argc)
+			cfg.callJitterUs = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-gaps") == 0 && i + 1 < argc)
+			cfg.gapProbability = atof(argv[++i]);
+		else if(strcmp(argv[i], "-gapsamples") == 0 && i + 1 < argc)
+			cfg.gapSamples = (uint32_t)atoi(argv[++i]);
+		else if(strcmp(argv[i], "-wrap") == 0)
+			cfg.timestampStart = (ViUInt32)(0u - WRAP_AFTER_US);
+		else if(strcmp(argv[i], "-unpaced") == 0)
+			cfg.realTime = VI_FALSE;
+		else if(argv[i][0] >= '0' && argv[i][0] <= '9')
+			runTime = (uint32_t)atoi(argv[i]);
+		else
+		{
+			for(uint32_t s = 0; s < SCENARIO_COUNT; s++)
+				if(strcmp(argv[i], scenarios[s].name) == 0)
+					selected[s] = any = VI_TRUE;
+		}
+	}
+
+	PMSimDriver_setConfig(&cfg);
+	PMSimDriver_setDeviceCount(devices);
+
+	printf("%u simulated devices, %s, call latency %u us + jitter %u us, gaps %g x %u samples%s\n",
+			(unsigned int)PMSimDriver_deviceCount(), cfg.realTime ? "paced at 100 kHz" : "unpaced",
+			(unsigned int)cfg.callLatencyUs, (unsigned int)cfg.callJitterUs, cfg.gapProbability,
+			(unsigned int)cfg.gapSamples, cfg.timestampStart ? ", timestamps wrap" : "");
+	printf("Statistics kernel %s, %u s per scenario, %u CPUs\n\n", PMStats_kernelName(PMStats_kernel()),
+			(unsigned int)runTime, (unsigned int)PMPlat_cpuCount());
+	printf("%-8s %12s %14s %10s %12s %7s %6s %s\n", "Scenario", "Samples", "Samples/s", "Drop rate",
+			"CPU ns/S", "CPU %", "Wraps", "Status");
+
+	int failed = 0;
+	for(uint32_t s = 0; s < SCENARIO_COUNT; s++)
+	{
+		if(any && !selected[s])
+			continue;
+
+		BenchResult res;
+		memset(&res, 0, sizeof(res));
+		res.name = scenarios[s].name;
+		resetSinks();
+
+		uint64_t t0   = PMPlat_timeNs();
+		uint64_t cpu0 = PMPlat_cpuTimeNs();
+		scenarios[s].run(&res, runTime);
+		res.cpuNs   = PMPlat_cpuTimeNs() - cpu0;
+		res.seconds = (double)(PMPlat_timeNs() - t0) * 1e-9;
+
+		uint64_t expected = res.samples + res.missing;
+		printf("%-8s %12llu %14.0f %9.4f%% %12.1f %6.1f%% %6llu 0x%08X\n", res.name,
+				(unsigned long long)res.samples, (double)res.samples / res.seconds,
+				expected ? 100.0 * (double)res.missing / (double)expected : 0.0,
+				res.samples ? (double)res.cpuNs / (double)res.samples : 0.0,
+				100.0 * (double)res.cpuNs * 1e-9 / res.seconds,
+				(unsigned long long)res.wraps, (unsigned int)res.status);
+		if(res.status != VI_SUCCESS)
+			failed = 1;
+	}
+
+	return failed;
+}
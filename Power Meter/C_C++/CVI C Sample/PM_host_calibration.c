@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "TLPMX.h"
+#include "visatype.h"
+
+#include "pm_block.h"
+#include "pm_calib.h"
+#include "pm_model.h"
+
+#define DEFAULT_RUN_TIME_SEC	5
+#define BENCH_SAMPLES			(1u << 20)
+#define BENCH_REPEAT			20
+#define EMPTY_POLL_US			100
+
+static PMCalCurve curve;
+static PMCalTable table;
+static PMCal      cal;
+
+//Parse a comma separated wavelength list
+static uint32_t parseWavelengths(const char *list, double nm[])
+{
+	uint32_t n = 0;
+	char     *end;
+
+	while(*list != '\0' && n < PM_CAL_MAX_LINES)
+	{
+		nm[n++] = strtod(list, &end);
+		if(end == list)
+			return 0;
+		list = (*end == ',') ? end + 1 : end;
+	}
+	return n;
+}
+
+//Conversion throughput of every kernel on a synthetic current stream
+static int benchmark(uint32_t lines)
+{
+	ViReal32 *current = (ViReal32*)PMPlat_alignedAlloc(BENCH_SAMPLES * sizeof(ViReal32), PM_CACHE_LINE);
+	ViReal32 *power[PM_CAL_MAX_LINES];
+	ViReal32 *reference = (ViReal32*)PMPlat_alignedAlloc(BENCH_SAMPLES * sizeof(ViReal32), PM_CACHE_LINE);
+	int      kernels[] = { PM_CAL_KERNEL_SCALAR, PM_CAL_KERNEL_SSE2, PM_CAL_KERNEL_AVX2 };
+	int      ok = (current != NULL && reference != NULL);
+
+	for(uint32_t l = 0; l < lines; l++)
+		ok = ok && (power[l] = (ViReal32*)PMPlat_alignedAlloc(BENCH_SAMPLES * sizeof(ViReal32), PM_CACHE_LINE)) != NULL;
+	if(!ok)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	for(uint32_t i = 0; i < BENCH_SAMPLES; i++)
+		current[i] = (ViReal32)(5.0e-4 * (1.0 + 0.1 * sin(i * 0.001)));
+
+	printf("%-8s %14s %16s %14s\n", "Kernel", "MSamples/s", "conversions/s", "max deviation");
+	for(int k = 0; k < 3; k++)
+	{
+		if(PMCal_selectKernel(kernels[k]) != kernels[k])
+		{
+			printf("%-8s not supported on this CPU\n", PMCal_kernelName(kernels[k]));
+			continue;
+		}
+
+		uint64_t t0 = PMPlat_timeNs();
+		for(int r = 0; r < BENCH_REPEAT; r++)
+			PMCal_convert(&cal, current, BENCH_SAMPLES, power);
+		double seconds = (double)(PMPlat_timeNs() - t0) * 1e-9;
+
+		//All kernels have to agree with the scalar one (last line compared)
+		double deviation = 0.0;
+		if(kernels[k] == PM_CAL_KERNEL_SCALAR)
+			memcpy(reference, power[lines - 1], BENCH_SAMPLES * sizeof(ViReal32));
+		for(uint32_t i = 0; i < BENCH_SAMPLES; i++)
+			if(fabs((double)power[lines - 1][i] - reference[i]) > deviation)
+				deviation = fabs((double)power[lines - 1][i] - reference[i]);
+
+		printf("%-8s %14.1f %16.1f %14.3g\n", PMCal_kernelName(kernels[k]), BENCH_SAMPLES * (double)BENCH_REPEAT / seconds * 1e-6,
+				BENCH_SAMPLES * (double)BENCH_REPEAT * lines / seconds * 1e-6, deviation);
+	}
+	return 0;
+}
+
+//Raw photodiode current from the fast measure stream, converted to power on
+//the host for several wavelengths at once. The device is never reconfigured
+//for a wavelength or calibration change.
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter host calibration sample\n");
+	printf("===========================================\n");
+	printf("Usage: %s [-file <curve>] [-user <index>] [-wl <nm>[,<nm>...]] [-bench] [seconds] [resource]\n", argv[0]);
+	printf("       Without -file the responsivity curve is swept from the sensor.\n");
+	printf("       A curve file holds one 'wavelength_nm responsivity_A/W' pair per line.\n\n");
+
+	ViStatus  stat;
+	ViSession instrHandle = VI_NULL;
+	ViChar    rsrcDescr[TLPM_BUFFER_SIZE] = "";
+	ViUInt32  found = 0;
+	ViBoolean bench = VI_FALSE;
+	uint32_t  runTime = DEFAULT_RUN_TIME_SEC;
+	const char *curvePath = NULL;
+	int       userIndex = 0;
+	double    nm[PM_CAL_MAX_LINES];
+	uint32_t  lines = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-file") == 0 && i + 1 < argc)
+			curvePath = argv[++i];
+		else if(strcmp(argv[i], "-user") == 0 && i + 1 < argc)
+			userIndex = atoi(argv[++i]);
+		else if(strcmp(argv[i], "-wl") == 0 && i + 1 < argc)
+			lines = parseWavelengths(argv[++i], nm);
+		else if(strcmp(argv[i], "-bench") == 0)
+			bench = VI_TRUE;
+		else if(argv[i][0] >= '0' && argv[i][0] <= '9')
+			runTime = (uint32_t)atoi(argv[i]);
+		else
+			strncpy(rsrcDescr, argv[i], TLPM_BUFFER_SIZE - 1);
+	}
+
+	if(rsrcDescr[0] == '\0')
+	{
+		if((stat = TLPMX_findRsrc(0, &found)) != VI_SUCCESS || found == 0)
+		{
+			printf("No power meter found (0x%08X)\n", (unsigned int)stat);
+			return 1;
+		}
+		if((stat = TLPMX_getRsrcName(0, 0, rsrcDescr)) != VI_SUCCESS)
+		{
+			printf("Failed to get resource name (0x%08X)\n", (unsigned int)stat);
+			return stat;
+		}
+	}
+	if((stat = TLPMX_init(rsrcDescr, VI_TRUE, VI_FALSE, &instrHandle)) != VI_SUCCESS)
+	{
+		printf("Failed to open '%s' (0x%08X)\n", rsrcDescr, (unsigned int)stat);
+		return stat;
+	}
+
+	//Stream reader specialized on the model, resolved once here
+	const PMModel *model;
+	if((stat = PMModel_identify(instrHandle, &model)) == VI_SUCCESS && !(model->modes & PM_MODEL_FAST))
+		stat = VI_ERROR_NSUP_OPER;
+	if(stat != VI_SUCCESS)
+	{
+		printf("No fast measure stream on '%s' (0x%08X)\n", rsrcDescr, (unsigned int)stat);
+		TLPMX_close(instrHandle);
+		return stat;
+	}
+
+	//Load the responsivity curve once, everything after runs on the host
+	uint64_t t0 = PMPlat_timeNs();
+	if(curvePath != NULL)
+		stat = PMCal_loadFile(&curve, curvePath);
+	else
+		stat = PMCal_loadSensor(&curve, instrHandle, TLPM_DEFAULT_CHANNEL, 0.0, 0.0, 1.0);
+	if(stat == VI_SUCCESS && userIndex > 0)
+		stat = PMCal_loadCorrection(&curve, instrHandle, TLPM_DEFAULT_CHANNEL, (ViUInt16)userIndex);
+	if(stat == VI_SUCCESS)
+		stat = PMCal_buildTable(&table, &curve, PM_CAL_DEFAULT_STEP_NM);
+	if(stat != VI_SUCCESS)
+	{
+		printf("Failed to load the responsivity curve (0x%08X)\n", (unsigned int)stat);
+		TLPMX_close(instrHandle);
+		return stat;
+	}
+	printf("Curve: %u points, %.1f to %.1f nm, loaded in %.1f ms; table %u entries of %.1f nm\n", (unsigned int)curve.count,
+			curve.wavelength[0], curve.wavelength[curve.count - 1], (double)(PMPlat_timeNs() - t0) * 1e-6,
+			(unsigned int)table.count, table.stepNm);
+
+	//Default: the wavelength the device is set to
+	if(lines == 0)
+	{
+		TLPMX_getWavelength(instrHandle, TLPM_ATTR_SET_VAL, &nm[0], TLPM_DEFAULT_CHANNEL);
+		lines = 1;
+	}
+
+	PMCal_init(&cal, &table);
+	t0 = PMPlat_timeNs();
+	stat = PMCal_setWavelengths(&cal, nm, lines);
+	uint64_t changeNs = PMPlat_timeNs() - t0;
+	if(stat != VI_SUCCESS)
+	{
+		printf("Wavelength outside the curve (0x%08X)\n", (unsigned int)stat);
+		PMCal_freeTable(&table);
+		TLPMX_close(instrHandle);
+		return stat;
+	}
+	PMCalParams params;
+	PMCal_getParams(&cal, &params);
+	for(uint32_t l = 0; l < lines; l++)
+		printf("  %8.1f nm: %.4f A/W\n", params.wavelength[l], 1.0 / params.scale[l]);
+	printf("Wavelength change applied in %.1f us (%s kernel)\n\n", (double)changeNs * 1e-3, PMCal_kernelName(PMCal_kernel()));
+
+	if(bench)
+	{
+		int res = benchmark(lines);
+		PMCal_freeTable(&table);
+		TLPMX_close(instrHandle);
+		return res;
+	}
+
+	//Raw current stream
+	PMSampleBlock block;
+	static ViReal32 powerColumns[PM_CAL_MAX_LINES][PM_BLOCK_FAST_SPACE];
+	ViReal32 *power[PM_CAL_MAX_LINES];
+	for(uint32_t l = 0; l < PM_CAL_MAX_LINES; l++)
+		power[l] = powerColumns[l];
+
+	if((stat = PMBlock_init(&block, PM_BLOCK_FAST_SPACE, 1)) == VI_SUCCESS &&
+	   (stat = TLPMX_setInputFilterState(instrHandle, VI_FALSE, TLPM_DEFAULT_CHANNEL)) == VI_SUCCESS)
+		stat = TLPMX_confCurrentFastArrayMeasurement(instrHandle, TLPM_DEFAULT_CHANNEL);
+	if(stat != VI_SUCCESS)
+	{
+		printf("Failed to configure the current stream (0x%08X)\n", (unsigned int)stat);
+		PMCal_freeTable(&table);
+		TLPMX_close(instrHandle);
+		return stat;
+	}
+
+	uint64_t convertNs = 0, samples = 0;
+	for(uint32_t sec = 0; sec < runTime && stat == VI_SUCCESS; sec++)
+	{
+		double   currentSum = 0.0, powerSum[PM_CAL_MAX_LINES] = { 0 };
+		uint64_t count = 0;
+		uint64_t endNs = PMPlat_timeNs() + 1000000000;
+
+		while(PMPlat_timeNs() < endNs)
+		{
+			ViUInt16 n = 0;
+
+			PMBlock_clear(&block, 0);
+			if((stat = model->readFast(&block, instrHandle, TLPM_DEFAULT_CHANNEL, &n)) != VI_SUCCESS)
+				break;
+			if(n == 0)
+			{
+				PMPlat_sleepUs(EMPTY_POLL_US);
+				continue;
+			}
+
+			uint64_t c0 = PMPlat_timeNs();
+			PMCal_convert(&cal, block.channel[0], n, power);
+			convertNs += PMPlat_timeNs() - c0;
+
+			for(uint32_t i = 0; i < n; i++)
+			{
+				currentSum += block.channel[0][i];
+				for(uint32_t l = 0; l < lines; l++)
+					powerSum[l] += power[l][i];
+			}
+			count += n;
+		}
+		samples += count;
+		if(count == 0)
+			continue;
+
+		printf("%6.3f mA:", currentSum / (double)count * 1e3);
+		for(uint32_t l = 0; l < lines; l++)
+			printf("  %.1f nm %.4f mW", nm[l], powerSum[l] / (double)count * 1e3);
+		printf("\n");
+	}
+
+	printf("--------------\n");
+	printf("%llu samples, conversion %.2f ns per sample for %u wavelengths\n", (unsigned long long)samples,
+			samples ? (double)convertNs / (double)samples : 0.0, (unsigned int)lines);
+	if(stat != VI_SUCCESS)
+		printf("Stream stopped with error 0x%08X\n", (unsigned int)stat);
+
+	PMBlock_free(&block);
+	PMCal_freeTable(&table);
+	TLPMX_close(instrHandle);
+	return stat;
+}
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "visatype.h"
+
+#include "pm_platform.h"
+#include "pm_stats.h"
+
+#define BENCH_BLOCK_SAMPLES		200			// one fast measure stream block
+#define BENCH_TOTAL_SAMPLES		200000000ULL
+#define BENCH_BUF_BLOCKS		512			// 400 KB of values, cycled
+
+//Single thread micro-benchmark of the block statistics kernels.
+//Reports samples per second per core for every kernel the CPU supports and
+//checks that all kernels agree with the scalar reference.
+int main(int argc, char **argv)
+{
+	printf("Thorlabs Powermeter block statistics benchmark\n");
+	printf("==============================================\n");
+	printf("Usage: %s [block samples]\n\n", argv[0]);
+
+	uint32_t blockSamples = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_BLOCK_SAMPLES;
+	if(blockSamples == 0)
+		blockSamples = BENCH_BLOCK_SAMPLES;
+
+	size_t   bufSamples = (size_t)blockSamples * BENCH_BUF_BLOCKS;
+	ViReal32 *values = (ViReal32*)PMPlat_alignedAlloc(bufSamples * sizeof(ViReal32), PM_CACHE_LINE);
+	if(values == NULL)
+	{
+		printf("Out of memory\n");
+		return 1;
+	}
+
+	//Small signal on a large offset, the case where sum of squares fails
+	srand(1);
+	for(size_t i = 0; i < bufSamples; i++)
+		values[i] = 1.0e-3f + 1.0e-6f * (ViReal32)sin((double)i * 0.01) + 1.0e-8f * (ViReal32)(rand() % 100);
+
+	PMStats reference;
+	int     kernels[] = { PM_STATS_KERNEL_SCALAR, PM_STATS_KERNEL_SSE2, PM_STATS_KERNEL_AVX2 };
+
+	printf("Block size %u samples, %llu samples per run\n", (unsigned int)blockSamples, BENCH_TOTAL_SAMPLES);
+	printf("%-8s %14s %14s %14s\n", "Kernel", "MSamples/s", "mean", "std dev");
+
+	for(int k = 0; k < 3; k++)
+	{
+		if(PMStats_selectKernel(kernels[k]) != kernels[k])
+		{
+			printf("%-8s not supported on this CPU\n", PMStats_kernelName(kernels[k]));
+			continue;
+		}
+
+		uint64_t blocks = BENCH_TOTAL_SAMPLES / blockSamples;
+		PMStats  total, part;
+		PMStats_reset(&total);
+
+		uint64_t t0 = PMPlat_timeNs();
+		for(uint64_t b = 0; b < blocks; b++)
+		{
+			PMStats_block(&part, &values[(b % BENCH_BUF_BLOCKS) * blockSamples], blockSamples);
+			PMStats_merge(&total, &part);
+		}
+		uint64_t t1 = PMPlat_timeNs();
+
+		double rate = (double)total.count / ((double)(t1 - t0) * 1e-9);
+		printf("%-8s %14.1f %14.9f %14.9f\n", PMStats_kernelName(kernels[k]), rate * 1e-6,
+				total.mean, PMStats_stdDev(&total));
+
+		if(kernels[k] == PM_STATS_KERNEL_SCALAR)
+			reference = total;
+		else if(fabs(total.mean - reference.mean) > 1e-12 || fabs(PMStats_stdDev(&total) - PMStats_stdDev(&reference)) > 1e-12 ||
+				total.min != reference.min || total.max != reference.max)
+			printf("%-8s MISMATCH against scalar kernel\n", PMStats_kernelName(kernels[k]));
+	}
+
+	printf("--------------\n");
+	printf("One 100 kHz stream needs 0.1 MSamples/s.\n");
+
+	PMPlat_alignedFree(values);
+	return 0;
+}
@@ -0,0 +1,698 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Record/replay driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define DEFAULT_FILE        "pm_replay.bin"
+#define WRITE_BUFFER        (1u << 20)
+#define LOOKAHEAD           64          // recorded calls of a session skipped at most to find a match
+#define SLEEP_MARGIN_NS     2000000     // sleep while further away from the due time, then yield
+#define REPEAT_BYTES        256         // inputs and outputs of a call that can be merged with repeats
+
+#if defined(_WIN64)
+	#define DEFAULT_TLPM_LIB   "TLPM_64.dll"
+	#define DEFAULT_TLPMX_LIB  "TLPMX_64.dll"
+#elif defined(_WIN32)
+	#define DEFAULT_TLPM_LIB   "TLPM_32.dll"
+	#define DEFAULT_TLPMX_LIB  "TLPMX_32.dll"
+#else
+	#define DEFAULT_TLPM_LIB   "libTLPM.so"
+	#define DEFAULT_TLPMX_LIB  "libTLPMX.so"
+#endif
+
+#define STATE_NONE          0
+#define STATE_INIT          1
+#define STATE_READY         2
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViBoolean used;
+	ViSession vi;
+	size_t    offset;             // next record to look at
+	uint32_t  consumed;           // repeats of the record at offset already replayed
+} ReplaySession;
+
+// Record: last call of a session, held back while identical calls follow
+typedef struct
+{
+	ViBoolean      used;
+	ViSession      vi;
+	ViBoolean      pending;
+	PMReplayRecord rec;
+	uint8_t        payload[REPEAT_BYTES];   // inputs, then the serialized outputs
+} ReplayRepeat;
+
+/*===========================================================================
+ Global variables
+===========================================================================*/
+static volatile uint64_t replayState;
+static volatile uint64_t replayLock;
+static int               replayMode;
+static ViBoolean         replayFast;
+static uint64_t          replayStartNs;
+static ViStatus          replayError;   // returned for calls that cannot be replayed
+static PMReplayStats     replayStats;
+static char              replayPath[260];
+
+// record
+static FILE              *replayOut;
+static ReplayRepeat      replayRepeats[PM_REPLAY_MAX_SESSIONS];
+
+// replay
+static PMPlatFile        replayFile;
+static PMPlatMap         replayMap;
+static ViBoolean         replayMapped;
+static ReplaySession     replaySessions[PM_REPLAY_MAX_SESSIONS];
+
+// driver libraries for off and record mode
+static const char        *replayLibEnv[2]     = { "PM_REPLAY_TLPM_LIB", "PM_REPLAY_TLPMX_LIB" };
+static const char        *replayLibDefault[2] = { DEFAULT_TLPM_LIB, DEFAULT_TLPMX_LIB };
+static void              *replayLib[2];
+static ViBoolean         replayLibTried[2];
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+static void replay_atExit(void);
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static void replay_lock(void)
+{
+	while(!PMPlat_cas64(&replayLock, 0, 1))
+		PMPlat_yield();
+}
+
+
+static void replay_unlock(void)
+{
+	PMPlat_store64(&replayLock, 0);
+}
+
+
+static uint32_t replay_hash(const char *name)
+{
+	uint32_t h = 2166136261u;
+
+	while(*name)
+		h = (h ^ (uint8_t)*name++) * 16777619u;
+	return h;
+}
+
+
+/*---------------------------------------------------------------------------
+  Setup from the environment on the first driver call
+---------------------------------------------------------------------------*/
+static void replay_openRecord(void)
+{
+	PMReplayFileHeader hdr;
+
+	if((replayOut = fopen(replayPath, "wb")) == NULL)
+	{
+		fprintf(stderr, "pm_replay: cannot create %s, calls are not recorded\n", replayPath);
+		return;
+	}
+	setvbuf(replayOut, NULL, _IOFBF, WRITE_BUFFER);
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, PM_REPLAY_MAGIC, sizeof(PM_REPLAY_MAGIC));
+	hdr.version     = PM_REPLAY_VERSION;
+	hdr.headerSize  = sizeof(hdr);
+	hdr.startUnixUs = PMPlat_unixTimeUs();
+	fwrite(&hdr, sizeof(hdr), 1, replayOut);
+	replayStats.bytes = sizeof(hdr);
+}
+
+
+static void replay_openReplay(void)
+{
+	const PMReplayFileHeader *hdr;
+	uint64_t                 size;
+
+	replayError = VI_ERROR_FILE_ACCESS;
+	if(PMPlat_fileOpen(&replayFile, replayPath, VI_FALSE, VI_FALSE) != VI_SUCCESS)
+	{
+		fprintf(stderr, "pm_replay: cannot open %s\n", replayPath);
+		return;
+	}
+	if(PMPlat_fileSize(&replayFile, &size) != VI_SUCCESS || size < sizeof(PMReplayFileHeader) || size > (size_t)-1 ||
+	   PMPlat_fileMap(&replayFile, 0, (size_t)size, &replayMap) != VI_SUCCESS)
+	{
+		fprintf(stderr, "pm_replay: cannot map %s\n", replayPath);
+		PMPlat_fileClose(&replayFile);
+		return;
+	}
+
+	hdr = (const PMReplayFileHeader*)replayMap.base;
+	if(memcmp(hdr->magic, PM_REPLAY_MAGIC, sizeof(PM_REPLAY_MAGIC)) != 0 || hdr->version < 1 || hdr->version > PM_REPLAY_VERSION ||
+	   hdr->headerSize < sizeof(PMReplayFileHeader) || hdr->headerSize > size)
+	{
+		fprintf(stderr, "pm_replay: %s is no recording\n", replayPath);
+		PMPlat_fileUnmap(&replayMap);
+		PMPlat_fileClose(&replayFile);
+		replayError = VI_ERROR_INV_FMT;
+		return;
+	}
+
+	replayMapped = VI_TRUE;
+	replayError  = VI_ERROR_IO;
+}
+
+
+static void replay_init(void)
+{
+	const char *v;
+
+	if(PMPlat_load64(&replayState) == STATE_READY)
+		return;
+	if(!PMPlat_cas64(&replayState, STATE_NONE, STATE_INIT))
+	{
+		while(PMPlat_load64(&replayState) != STATE_READY)
+			PMPlat_yield();
+		return;
+	}
+
+	replayMode = PM_REPLAY_OFF;
+	if((v = getenv("PM_REPLAY_MODE")) != NULL)
+	{
+		if(strcmp(v, "record") == 0)
+			replayMode = PM_REPLAY_RECORD;
+		else if(strcmp(v, "replay") == 0)
+			replayMode = PM_REPLAY_REPLAY;
+	}
+	replayFast = ((v = getenv("PM_REPLAY_TIMING")) != NULL && strcmp(v, "fast") == 0);
+	v = getenv("PM_REPLAY_FILE");
+	strncpy(replayPath, (v != NULL && *v) ? v : DEFAULT_FILE, sizeof(replayPath) - 1);
+
+	replayStats.mode = replayMode;
+	replayStartNs    = PMPlat_timeNs();
+	if(replayMode == PM_REPLAY_RECORD)
+		replay_openRecord();
+	else if(replayMode == PM_REPLAY_REPLAY)
+		replay_openReplay();
+	if(replayMode != PM_REPLAY_OFF)
+		atexit(replay_atExit);
+
+	PMPlat_store64(&replayState, STATE_READY);
+}
+
+
+int PMReplay_mode(void)
+{
+	replay_init();
+	return replayMode;
+}
+
+
+/*---------------------------------------------------------------------------
+  Driver library symbol, looked up once and cached by the call site
+---------------------------------------------------------------------------*/
+void *PMReplay_symbol(int library, const char *name, volatile uint64_t *cache)
+{
+	uint64_t   fn = PMPlat_load64(cache);
+	const char *path;
+
+	if(fn != 0)
+		return (void*)(uintptr_t)fn;
+
+	replay_lock();
+	if(!replayLibTried[library])
+	{
+		replayLibTried[library] = VI_TRUE;
+		path = getenv(replayLibEnv[library]);
+		if(path == NULL || *path == '\0')
+			path = replayLibDefault[library];
+		if((replayLib[library] = PMPlat_libraryOpen(path)) == NULL)
+			fprintf(stderr, "pm_replay: cannot load driver library %s\n", path);
+	}
+	replay_unlock();
+
+	fn = (uint64_t)(uintptr_t)PMPlat_librarySymbol(replayLib[library], name);
+	PMPlat_store64(cache, fn);
+	return (void*)(uintptr_t)fn;
+}
+
+
+/*---------------------------------------------------------------------------
+  Wrapper side
+---------------------------------------------------------------------------*/
+void PMReplay_begin(PMReplayCall *call, const char *name, ViSession vi)
+{
+	replay_init();
+	call->mode       = replayMode;
+	call->name       = name;
+	call->rec.vi     = vi;
+	call->rec.status = VI_SUCCESS;
+	call->failed     = VI_FALSE;
+	call->inBytes    = 0;
+	call->outCount   = 0;
+	if(call->mode == PM_REPLAY_OFF)
+		return;
+
+	call->rec.func = replay_hash(name);
+	call->startNs  = PMPlat_timeNs();
+}
+
+
+void PMReplay_in(PMReplayCall *call, const void *data, size_t size)
+{
+	if(call->mode == PM_REPLAY_OFF || data == NULL)
+		return;
+	if(size > PM_REPLAY_MAX_INPUT - call->inBytes)
+		size = PM_REPLAY_MAX_INPUT - call->inBytes;
+	memcpy(call->in + call->inBytes, data, size);
+	call->inBytes += (uint32_t)size;
+}
+
+
+void PMReplay_inString(PMReplayCall *call, const char *str)
+{
+	size_t len = 0;
+
+	if(call->mode == PM_REPLAY_OFF)
+		return;
+	if(str == NULL)
+		str = "";
+	while(len < PM_REPLAY_MAX_STRING - 1 && str[len] != '\0')
+		len++;
+	PMReplay_in(call, str, len);
+	PMReplay_in(call, "", 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Finds the recorded counterpart of a call on replay
+---------------------------------------------------------------------------*/
+static ReplaySession *replay_session(ViSession vi)
+{
+	int i, unused = -1;
+
+	for(i = 0; i < PM_REPLAY_MAX_SESSIONS; i++)
+	{
+		if(replaySessions[i].used && replaySessions[i].vi == vi)
+			return &replaySessions[i];
+		if(!replaySessions[i].used && unused < 0)
+			unused = i;
+	}
+	if(unused < 0)
+		return NULL;
+
+	replaySessions[unused].used   = VI_TRUE;
+	replaySessions[unused].vi     = vi;
+	replaySessions[unused].offset = ((const PMReplayFileHeader*)replayMap.base)->headerSize;
+	return &replaySessions[unused];
+}
+
+
+static void replay_find(PMReplayCall *call)
+{
+	const uint8_t  *base = (const uint8_t*)replayMap.base;
+	ReplaySession  *session;
+	PMReplayRecord rec;
+	size_t         offset, size;
+	uint32_t       skipped = 0, repeat, index;
+
+	replay_lock();
+	call->failed     = VI_TRUE;
+	call->rec.status = replayError;
+	if(!replayMapped || (session = replay_session(call->rec.vi)) == NULL)
+	{
+		replayStats.missing++;
+		replay_unlock();
+		return;
+	}
+
+	for(offset = session->offset; offset + sizeof(rec) <= replayMap.size; offset += size)
+	{
+		memcpy(&rec, base + offset, sizeof(rec));
+		size = sizeof(rec) + (size_t)rec.inBytes + rec.outBytes;
+		if(offset + size > replayMap.size)
+			break;                       // truncated recording
+		if(rec.vi != call->rec.vi)
+			continue;
+		if(rec.func != call->rec.func)
+		{
+			if(++skipped > LOOKAHEAD)
+				break;
+			continue;
+		}
+
+		if(rec.inBytes != call->inBytes || memcmp(base + offset + sizeof(rec), call->in, rec.inBytes) != 0)
+			replayStats.inputMismatches++;
+		replayStats.mismatches += skipped;
+		replayStats.calls++;
+
+		// one call of a run of repeats, spread evenly over the span of the run
+		repeat = (rec.repeat > 1) ? rec.repeat : 1;
+		if(offset != session->offset)
+			session->consumed = 0;
+		index = session->consumed++;
+		if(index == 0)
+			replayStats.bytes += size;
+		if(session->consumed >= repeat)
+		{
+			session->offset   = offset + size;
+			session->consumed = 0;
+		}
+		else
+			session->offset = offset;
+		if(repeat > 1)
+		{
+			rec.durationNs /= repeat;
+			rec.startNs    += index * rec.durationNs;
+		}
+
+		call->rec    = rec;
+		call->cursor = base + offset + sizeof(rec) + rec.inBytes;
+		call->end    = call->cursor + rec.outBytes;
+		call->failed = VI_FALSE;
+		replay_unlock();
+		return;
+	}
+
+	replayStats.missing++;
+	replay_unlock();
+}
+
+
+// Returns VI_TRUE if the driver library has to be called
+ViBoolean PMReplay_live(PMReplayCall *call)
+{
+	if(call->mode != PM_REPLAY_REPLAY)
+		return VI_TRUE;
+	replay_find(call);
+	return VI_FALSE;
+}
+
+
+void PMReplay_done(PMReplayCall *call)
+{
+	if(call->mode == PM_REPLAY_RECORD)
+		call->rec.durationNs = PMPlat_timeNs() - call->startNs;
+}
+
+
+void PMReplay_out(PMReplayCall *call, void *data, size_t size)
+{
+	uint32_t recorded;
+
+	if(call->mode == PM_REPLAY_OFF || call->failed || call->rec.status < 0)
+		return;
+
+	if(call->mode == PM_REPLAY_RECORD)
+	{
+		if(call->outCount < PM_REPLAY_MAX_OUTPUTS)
+		{
+			call->out[call->outCount]     = data;
+			call->outSize[call->outCount] = (data != NULL) ? (uint32_t)size : PM_REPLAY_NULL;
+			call->outCount++;
+		}
+		return;
+	}
+
+	if(call->end - call->cursor < (ptrdiff_t)sizeof(recorded))
+		return;
+	memcpy(&recorded, call->cursor, sizeof(recorded));
+	call->cursor += sizeof(recorded);
+	if(recorded == PM_REPLAY_NULL || recorded > (size_t)(call->end - call->cursor))
+		return;
+	if(data != NULL)
+		memcpy(data, call->cursor, (recorded < size) ? recorded : size);
+	call->cursor += recorded;
+}
+
+
+void PMReplay_outString(PMReplayCall *call, char *str, size_t capacity)
+{
+	size_t len = 0;
+
+	if(capacity > PM_REPLAY_MAX_STRING)
+		capacity = PM_REPLAY_MAX_STRING;
+	if(call->mode == PM_REPLAY_RECORD && str != NULL && call->rec.status >= 0)
+	{
+		while(len < capacity - 1 && str[len] != '\0')
+			len++;
+		PMReplay_out(call, str, len + 1);
+		return;
+	}
+
+	PMReplay_out(call, str, capacity);
+	if(call->mode == PM_REPLAY_REPLAY && str != NULL && !call->failed && call->rec.status >= 0)
+		str[capacity - 1] = '\0';
+}
+
+
+/*---------------------------------------------------------------------------
+  Recording: writes a held back call (with its repeats). Lock held.
+---------------------------------------------------------------------------*/
+static void replay_flushRepeat(ReplayRepeat *held)
+{
+	size_t payload = (size_t)held->rec.inBytes + held->rec.outBytes;
+
+	if(!held->pending)
+		return;
+	held->pending = VI_FALSE;
+	fwrite(&held->rec, sizeof(held->rec), 1, replayOut);
+	fwrite(held->payload, 1, payload, replayOut);
+	replayStats.bytes += sizeof(held->rec) + payload;
+}
+
+
+static void replay_flushRepeats(void)
+{
+	int i;
+
+	for(i = 0; i < PM_REPLAY_MAX_SESSIONS; i++)
+		if(replayRepeats[i].used)
+			replay_flushRepeat(&replayRepeats[i]);
+}
+
+
+static ReplayRepeat *replay_repeat(ViSession vi)
+{
+	int i, unused = -1;
+
+	for(i = 0; i < PM_REPLAY_MAX_SESSIONS; i++)
+	{
+		if(replayRepeats[i].used && replayRepeats[i].vi == vi)
+			return &replayRepeats[i];
+		if(!replayRepeats[i].used && unused < 0)
+			unused = i;
+	}
+	if(unused < 0)
+		return NULL;
+
+	replayRepeats[unused].used    = VI_TRUE;
+	replayRepeats[unused].vi      = vi;
+	replayRepeats[unused].pending = VI_FALSE;
+	return &replayRepeats[unused];
+}
+
+
+/*---------------------------------------------------------------------------
+  Inputs and outputs of a call as written to the file, if they fit
+---------------------------------------------------------------------------*/
+static ViBoolean replay_serialize(const PMReplayCall *call, uint8_t *buffer)
+{
+	size_t   used = call->inBytes;
+	uint32_t i;
+
+	if((size_t)call->inBytes + call->rec.outBytes > REPEAT_BYTES)
+		return VI_FALSE;
+	memcpy(buffer, call->in, call->inBytes);
+	for(i = 0; i < call->outCount; i++)
+	{
+		memcpy(buffer + used, &call->outSize[i], sizeof(uint32_t));
+		used += sizeof(uint32_t);
+		if(call->outSize[i] != PM_REPLAY_NULL)
+		{
+			memcpy(buffer + used, call->out[i], call->outSize[i]);
+			used += call->outSize[i];
+		}
+	}
+	return VI_TRUE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Appends the call to the recording. A successful call with small inputs
+  and outputs is held back per session and merged with the identical
+  calls that follow it.
+---------------------------------------------------------------------------*/
+static void replay_write(PMReplayCall *call)
+{
+	uint8_t      payload[REPEAT_BYTES];
+	ViBoolean    small;
+	ReplayRepeat *held;
+	uint32_t     i;
+
+	call->rec.outBytes = 0;
+	if(call->rec.status >= 0)
+	{
+		for(i = 0; i < call->outCount; i++)
+			call->rec.outBytes += sizeof(uint32_t) + ((call->outSize[i] != PM_REPLAY_NULL) ? call->outSize[i] : 0);
+	}
+	else
+		call->outCount = 0;
+	call->rec.inBytes  = call->inBytes;
+	call->rec.repeat   = 1;
+	call->rec.startNs  = call->startNs - replayStartNs;
+	small = (call->rec.status >= 0) && replay_serialize(call, payload);
+
+	replay_lock();
+	if(replayOut != NULL && small && (held = replay_repeat(call->rec.vi)) != NULL)
+	{
+		size_t bytes = (size_t)call->rec.inBytes + call->rec.outBytes;
+
+		if(held->pending && held->rec.func == call->rec.func && held->rec.status == call->rec.status &&
+		   held->rec.inBytes == call->rec.inBytes && held->rec.outBytes == call->rec.outBytes &&
+		   memcmp(held->payload, payload, bytes) == 0)
+		{
+			held->rec.repeat++;
+			held->rec.durationNs = call->rec.startNs + call->rec.durationNs - held->rec.startNs;
+		}
+		else
+		{
+			replay_flushRepeat(held);
+			held->rec     = call->rec;
+			held->pending = VI_TRUE;
+			memcpy(held->payload, payload, bytes);
+		}
+		replayStats.calls++;
+	}
+	else if(replayOut != NULL)
+	{
+		// keeps the calls of a session in order; failures are flushed with everything before them
+		if(call->rec.status < 0)
+			replay_flushRepeats();
+		else if((held = replay_repeat(call->rec.vi)) != NULL)
+			replay_flushRepeat(held);
+
+		fwrite(&call->rec, sizeof(call->rec), 1, replayOut);
+		fwrite(call->in, 1, call->inBytes, replayOut);
+		for(i = 0; i < call->outCount; i++)
+		{
+			fwrite(&call->outSize[i], sizeof(uint32_t), 1, replayOut);
+			if(call->outSize[i] != PM_REPLAY_NULL)
+				fwrite(call->out[i], 1, call->outSize[i], replayOut);
+		}
+		if(call->rec.status < 0)
+			fflush(replayOut);           // keep failures even if the program crashes afterwards
+		replayStats.calls++;
+		replayStats.bytes += sizeof(call->rec) + call->rec.inBytes + call->rec.outBytes;
+	}
+	replay_unlock();
+}
+
+
+static void replay_waitUntil(uint64_t due)
+{
+	uint64_t now;
+
+	while((now = PMPlat_timeNs()) < due)
+	{
+		if(due - now > SLEEP_MARGIN_NS)
+			PMPlat_sleepUs((uint32_t)((due - now - SLEEP_MARGIN_NS / 2) / 1000));
+		else
+			PMPlat_yield();
+	}
+}
+
+
+ViStatus PMReplay_end(PMReplayCall *call)
+{
+	switch(call->mode)
+	{
+		case PM_REPLAY_RECORD:
+			replay_write(call);
+			break;
+
+		case PM_REPLAY_REPLAY:
+			if(!call->failed && !replayFast)
+				replay_waitUntil(replayStartNs + call->rec.startNs + call->rec.durationNs);
+			break;
+	}
+	return call->rec.status;
+}
+
+
+/*---------------------------------------------------------------------------
+  Statistics and shutdown
+---------------------------------------------------------------------------*/
+void PMReplay_getStats(PMReplayStats *stats)
+{
+	replay_init();
+	replay_lock();
+	*stats = replayStats;
+	replay_unlock();
+}
+
+
+// Flushes the recording or releases the replayed file; later calls are
+// passed to the driver unrecorded (record) or fail (replay). The driver
+// libraries stay loaded.
+void PMReplay_close(void)
+{
+	replay_init();
+	replay_lock();
+	if(replayOut != NULL)
+	{
+		replay_flushRepeats();
+		fclose(replayOut);
+		replayOut = NULL;
+		fprintf(stderr, "pm_replay: recorded %llu calls (%llu bytes) to %s\n",
+			(unsigned long long)replayStats.calls, (unsigned long long)replayStats.bytes, replayPath);
+	}
+	if(replayMapped)
+	{
+		replayMapped = VI_FALSE;
+		replayError  = VI_ERROR_IO;
+		PMPlat_fileUnmap(&replayMap);
+		PMPlat_fileClose(&replayFile);
+		fprintf(stderr, "pm_replay: replayed %llu calls from %s, %llu skipped, %llu with other inputs, %llu missing\n",
+			(unsigned long long)replayStats.calls, replayPath, (unsigned long long)replayStats.mismatches,
+			(unsigned long long)replayStats.inputMismatches, (unsigned long long)replayStats.missing);
+	}
+	replay_unlock();
+}
+
+
+static void replay_atExit(void)
+{
+	PMReplay_close();
+}
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,195 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Record/replay driver
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Drop-in shim for the TLPM / TLPMX instrument drivers that records every
+   driver call of a program to a file and feeds the recorded answers back
+   later, so a misbehaving production run can be reproduced and profiled
+   without the instrument. Link tlpm_replay.c, tlpmx_replay.c and
+   pm_replay.c together with the toolkit (pm_*.c) instead of the Thorlabs
+   driver library, e.g.
+
+     gcc -O2 -o sample sample.c pm_*.c
+         ReplayDriver/pm_replay.c ReplayDriver/tlpm_replay.c
+         ReplayDriver/tlpmx_replay.c -lpthread -lm -ldl
+
+   The shim is configured with environment variables, read on the first
+   driver call:
+
+     PM_REPLAY_MODE       off (default), record or replay
+     PM_REPLAY_FILE       recording, default "pm_replay.bin"
+     PM_REPLAY_TIMING     original (default) or fast, for replay
+     PM_REPLAY_TLPM_LIB   driver library loaded in off and record mode,
+     PM_REPLAY_TLPMX_LIB  default TLPM_64.dll / TLPMX_64.dll (Windows)
+                          or libTLPM.so / libTLPMX.so (Linux)
+
+   In off mode every call goes straight to the driver library. In record
+   mode the call, its input arguments, the returned buffers, the status
+   and the host time spent in the driver are appended to the file. In
+   replay mode no library is loaded: each call takes the next recorded
+   call of the same session and function, copies the recorded buffers to
+   the caller and returns the recorded status. With original timing the
+   call returns at the same offset from the start of the run as during
+   recording, with fast timing it returns immediately.
+
+   The session handles returned by init are replayed as well, so programs
+   with several sessions and threads replay as recorded as long as each
+   session issues the same sequence of calls. Calls with other inputs than
+   recorded are still answered and counted as input mismatches; a call
+   with no recorded counterpart returns VI_ERROR_IO.
+
+   File layout (little endian, host byte order):
+
+     PMReplayFileHeader
+     PMReplayRecord, inputs, outputs      one per driver call
+
+   Inputs are the scalar arguments and input buffers of the call in
+   declaration order. Every output buffer is stored as a 32 bit size
+   followed by the data; PM_REPLAY_NULL marks a NULL pointer. Outputs are
+   only recorded for calls that succeeded (status >= 0).
+
+   Consecutive identical calls of a session (same function, status,
+   inputs and outputs - typically the empty polls of the fast measure
+   stream) are stored once with a repeat count; durationNs then spans
+   from the start of the first to the end of the last call, and replay
+   spreads the calls evenly over it. Version 1 files have no repeats.
+
+****************************************************************************/
+#ifndef _PM_REPLAY_HEADER_
+#define _PM_REPLAY_HEADER_
+
+#include "../pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_REPLAY_MAGIC           "TLPMRPL"
+#define PM_REPLAY_VERSION         2
+#define PM_REPLAY_MAX_INPUT       1024      // bytes of inputs per call
+#define PM_REPLAY_MAX_OUTPUTS     8         // output buffers per call
+#define PM_REPLAY_MAX_STRING      512       // longest recorded string (TLPM_ERR_DESCR_BUFFER_SIZE)
+#define PM_REPLAY_MAX_SESSIONS    64
+#define PM_REPLAY_NULL            0xFFFFFFFFu
+#define PM_REPLAY_SEQUENCE_POINTS 100       // measurement sequence entries per base time unit
+
+#define PM_REPLAY_OFF             0
+#define PM_REPLAY_RECORD          1
+#define PM_REPLAY_REPLAY          2
+
+#define PM_REPLAY_TLPM            0         // driver libraries
+#define PM_REPLAY_TLPMX           1
+
+/*---------------------------------------------------------------------------
+  Calls the driver function name of library lib with the argument list
+  args of the parameter types types, unless the call is replayed. The
+  symbol is looked up once per call site.
+---------------------------------------------------------------------------*/
+#define PM_REPLAY_CALL(call, lib, name, types, args)                          \
+	do {                                                                      \
+		static volatile uint64_t symbol_;                                     \
+		if(PMReplay_live(call))                                               \
+		{                                                                     \
+			void *fn_ = PMReplay_symbol(lib, #name, &symbol_);                \
+			(call)->rec.status = (fn_ != NULL) ?                              \
+				((ViStatus (_VI_FUNC *) types)fn_) args : VI_ERROR_NSUP_OPER; \
+			PMReplay_done(call);                                              \
+		}                                                                     \
+	} while(0)
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	char      magic[8];           // PM_REPLAY_MAGIC
+	uint32_t  version;
+	uint32_t  headerSize;         // sizeof(PMReplayFileHeader)
+	uint64_t  startUnixUs;        // wall clock time of the first call
+	uint8_t   reserved[40];
+} PMReplayFileHeader;
+
+typedef struct
+{
+	uint32_t  func;               // FNV-1a hash of the function name
+	ViStatus  status;
+	ViSession vi;                 // 0 for calls without session
+	uint32_t  inBytes;
+	uint32_t  outBytes;
+	uint32_t  repeat;             // identical consecutive calls, 0 in version 1 files
+	uint64_t  startNs;            // call start relative to the first call
+	uint64_t  durationNs;         // time spent in the driver, all repeats included
+} PMReplayRecord;
+
+typedef struct
+{
+	PMReplayRecord rec;
+	const char     *name;
+	int            mode;          // PM_REPLAY_*
+	uint64_t       startNs;
+	ViBoolean      failed;        // replay: no recorded call
+
+	// inputs, compared against the recorded inputs on replay
+	uint8_t        in[PM_REPLAY_MAX_INPUT];
+	uint32_t       inBytes;
+
+	// outputs, written after the live call (record) or read in order (replay)
+	const void     *out[PM_REPLAY_MAX_OUTPUTS];
+	uint32_t       outSize[PM_REPLAY_MAX_OUTPUTS];
+	uint32_t       outCount;
+	const uint8_t  *cursor;       // replay: next recorded output
+	const uint8_t  *end;
+} PMReplayCall;
+
+typedef struct
+{
+	int       mode;               // PM_REPLAY_*
+	uint64_t  calls;              // recorded or replayed calls
+	uint64_t  bytes;              // file bytes written or consumed
+	uint64_t  mismatches;         // recorded calls skipped on replay
+	uint64_t  inputMismatches;    // replayed calls with other inputs
+	uint64_t  missing;            // calls without recorded counterpart
+} PMReplayStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+// Wrapper side, in this order for every driver call
+void     PMReplay_begin(PMReplayCall *call, const char *name, ViSession vi);
+void     PMReplay_in(PMReplayCall *call, const void *data, size_t size);
+void     PMReplay_inString(PMReplayCall *call, const char *str);
+ViBoolean PMReplay_live(PMReplayCall *call);
+void    *PMReplay_symbol(int library, const char *name, volatile uint64_t *cache);
+void     PMReplay_done(PMReplayCall *call);
+void     PMReplay_out(PMReplayCall *call, void *data, size_t size);
+void     PMReplay_outString(PMReplayCall *call, char *str, size_t capacity);
+ViStatus PMReplay_end(PMReplayCall *call);
+
+// Control
+int      PMReplay_mode(void);
+void     PMReplay_getStats(PMReplayStats *stats);
+void     PMReplay_close(void);
+
+#endif /* _PM_REPLAY_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
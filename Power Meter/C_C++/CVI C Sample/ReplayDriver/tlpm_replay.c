@@ -0,0 +1,256 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Record/replay TLPM driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_replay.h"
+
+#include "TLPM.h"
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+ViStatus _VI_FUNC TLPM_init(ViRsrc resourceName, ViBoolean IDQuery, ViBoolean resetDevice, ViSession *vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_init", VI_NULL);
+	PMReplay_inString(&call, resourceName);
+	PMReplay_in(&call, &IDQuery, sizeof(IDQuery));
+	PMReplay_in(&call, &resetDevice, sizeof(resetDevice));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_init, (ViRsrc, ViBoolean, ViBoolean, ViSession*), (resourceName, IDQuery, resetDevice, vi));
+	PMReplay_out(&call, vi, sizeof(*vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_close(ViSession vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_close", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_close, (ViSession), (vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_findRsrc(ViSession vi, ViUInt32 *resourceCount)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_findRsrc", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_findRsrc, (ViSession, ViUInt32*), (vi, resourceCount));
+	PMReplay_out(&call, resourceCount, sizeof(*resourceCount));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getRsrcName(ViSession vi, ViUInt32 index, ViChar resourceName[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_getRsrcName", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getRsrcName, (ViSession, ViUInt32, ViChar*), (vi, index, resourceName));
+	PMReplay_outString(&call, resourceName, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getRsrcInfo(ViSession vi, ViUInt32 index, ViChar modelName[], ViChar serialNumber[], ViChar manufacturer[], ViBoolean *deviceAvailable)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_getRsrcInfo", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getRsrcInfo, (ViSession, ViUInt32, ViChar*, ViChar*, ViChar*, ViBoolean*), (vi, index, modelName, serialNumber, manufacturer, deviceAvailable));
+	PMReplay_outString(&call, modelName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, manufacturer, TLPM_BUFFER_SIZE);
+	PMReplay_out(&call, deviceAvailable, sizeof(*deviceAvailable));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_errorMessage(ViSession vi, ViStatus statusCode, ViChar description[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_errorMessage", vi);
+	PMReplay_in(&call, &statusCode, sizeof(statusCode));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_errorMessage, (ViSession, ViStatus, ViChar*), (vi, statusCode, description));
+	PMReplay_outString(&call, description, TLPM_ERR_DESCR_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_identificationQuery(ViSession vi, ViChar manufacturerName[], ViChar deviceName[], ViChar serialNumber[], ViChar firmwareRevision[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_identificationQuery", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_identificationQuery, (ViSession, ViChar*, ViChar*, ViChar*, ViChar*), (vi, manufacturerName, deviceName, serialNumber, firmwareRevision));
+	PMReplay_outString(&call, manufacturerName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, deviceName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, firmwareRevision, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_setInputFilterState(ViSession vi, ViBoolean inputFilterState)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_setInputFilterState", vi);
+	PMReplay_in(&call, &inputFilterState, sizeof(inputFilterState));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_setInputFilterState, (ViSession, ViBoolean), (vi, inputFilterState));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_setPowerAutoRange(ViSession vi, ViInt16 powerAutorangeMode)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_setPowerAutoRange", vi);
+	PMReplay_in(&call, &powerAutorangeMode, sizeof(powerAutorangeMode));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_setPowerAutoRange, (ViSession, ViInt16), (vi, powerAutorangeMode));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_setPowerRange(ViSession vi, ViReal64 power_to_Measure)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_setPowerRange", vi);
+	PMReplay_in(&call, &power_to_Measure, sizeof(power_to_Measure));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_setPowerRange, (ViSession, ViReal64), (vi, power_to_Measure));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getPowerRange(ViSession vi, ViInt16 attribute, ViReal64 *powerValue)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_getPowerRange", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getPowerRange, (ViSession, ViInt16, ViReal64*), (vi, attribute, powerValue));
+	PMReplay_out(&call, powerValue, sizeof(*powerValue));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getPowerUnit(ViSession vi, ViInt16 *powerUnit)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_getPowerUnit", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getPowerUnit, (ViSession, ViInt16*), (vi, powerUnit));
+	PMReplay_out(&call, powerUnit, sizeof(*powerUnit));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getWavelength(ViSession vi, ViInt16 attribute, ViReal64 *wavelength)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_getWavelength", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getWavelength, (ViSession, ViInt16, ViReal64*), (vi, attribute, wavelength));
+	PMReplay_out(&call, wavelength, sizeof(*wavelength));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_setWavelength(ViSession vi, ViReal64 wavelength)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_setWavelength", vi);
+	PMReplay_in(&call, &wavelength, sizeof(wavelength));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_setWavelength, (ViSession, ViReal64), (vi, wavelength));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_measPower(ViSession vi, ViReal64 *power)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_measPower", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_measPower, (ViSession, ViReal64*), (vi, power));
+	PMReplay_out(&call, power, sizeof(*power));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_measCurrent(ViSession vi, ViReal64 *current)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_measCurrent", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_measCurrent, (ViSession, ViReal64*), (vi, current));
+	PMReplay_out(&call, current, sizeof(*current));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_confPowerFastArrayMeasurement(ViSession vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_confPowerFastArrayMeasurement", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_confPowerFastArrayMeasurement, (ViSession), (vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_confCurrentFastArrayMeasurement(ViSession vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPM_confCurrentFastArrayMeasurement", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_confCurrentFastArrayMeasurement, (ViSession), (vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPM_getNextFastArrayMeasurement(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMReplayCall call;
+	ViUInt32     n;
+
+	PMReplay_begin(&call, "TLPM_getNextFastArrayMeasurement", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPM, TLPM_getNextFastArrayMeasurement, (ViSession, ViUInt16*, ViUInt32*, ViReal32*), (vi, count, timestamps, values));
+	PMReplay_out(&call, count, sizeof(*count));
+	n = (call.rec.status >= 0) ? *count : 0;
+	PMReplay_out(&call, timestamps, n * sizeof(ViUInt32));
+	PMReplay_out(&call, values, n * sizeof(ViReal32));
+	return PMReplay_end(&call);
+}
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
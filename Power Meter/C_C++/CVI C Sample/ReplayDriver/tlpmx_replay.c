@@ -0,0 +1,830 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Record/replay TLPMX driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_replay.h"
+
+#include "TLPMX.h"
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+ViStatus _VI_FUNC TLPMX_init(ViRsrc resourceName, ViBoolean IDQuery, ViBoolean resetDevice, ViSession *vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_init", VI_NULL);
+	PMReplay_inString(&call, resourceName);
+	PMReplay_in(&call, &IDQuery, sizeof(IDQuery));
+	PMReplay_in(&call, &resetDevice, sizeof(resetDevice));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_init, (ViRsrc, ViBoolean, ViBoolean, ViSession*), (resourceName, IDQuery, resetDevice, vi));
+	PMReplay_out(&call, vi, sizeof(*vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_close(ViSession vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_close", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_close, (ViSession), (vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_findRsrc(ViSession vi, ViUInt32 *resourceCount)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_findRsrc", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_findRsrc, (ViSession, ViUInt32*), (vi, resourceCount));
+	PMReplay_out(&call, resourceCount, sizeof(*resourceCount));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getRsrcName(ViSession vi, ViUInt32 index, ViChar resourceName[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getRsrcName", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getRsrcName, (ViSession, ViUInt32, ViChar*), (vi, index, resourceName));
+	PMReplay_outString(&call, resourceName, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getRsrcInfo(ViSession vi, ViUInt32 index, ViChar modelName[], ViChar serialNumber[], ViChar manufacturer[], ViBoolean *deviceAvailable)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getRsrcInfo", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getRsrcInfo, (ViSession, ViUInt32, ViChar*, ViChar*, ViChar*, ViBoolean*), (vi, index, modelName, serialNumber, manufacturer, deviceAvailable));
+	PMReplay_outString(&call, modelName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, manufacturer, TLPM_BUFFER_SIZE);
+	PMReplay_out(&call, deviceAvailable, sizeof(*deviceAvailable));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setEnableBthSearch(ViSession vi, ViBoolean enable)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setEnableBthSearch", vi);
+	PMReplay_in(&call, &enable, sizeof(enable));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setEnableBthSearch, (ViSession, ViBoolean), (vi, enable));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_errorMessage(ViSession vi, ViStatus statusCode, ViChar description[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_errorMessage", vi);
+	PMReplay_in(&call, &statusCode, sizeof(statusCode));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_errorMessage, (ViSession, ViStatus, ViChar*), (vi, statusCode, description));
+	PMReplay_outString(&call, description, TLPM_ERR_DESCR_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Identification and system
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_identificationQuery(ViSession vi, ViChar manufacturerName[], ViChar deviceName[], ViChar serialNumber[], ViChar firmwareRevision[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_identificationQuery", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_identificationQuery, (ViSession, ViChar*, ViChar*, ViChar*, ViChar*), (vi, manufacturerName, deviceName, serialNumber, firmwareRevision));
+	PMReplay_outString(&call, manufacturerName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, deviceName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, firmwareRevision, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_revisionQuery(ViSession vi, ViChar instrumentDriverRevision[], ViChar firmwareRevision[])
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_revisionQuery", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_revisionQuery, (ViSession, ViChar*, ViChar*), (vi, instrumentDriverRevision, firmwareRevision));
+	PMReplay_outString(&call, instrumentDriverRevision, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, firmwareRevision, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getCalibrationMsg(ViSession vi, ViChar message[], ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getCalibrationMsg", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getCalibrationMsg, (ViSession, ViChar*, ViUInt16), (vi, message, channel));
+	PMReplay_outString(&call, message, TLPM_BUFFER_SIZE);
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getTime(ViSession vi, ViInt16 *year, ViInt16 *month, ViInt16 *day, ViInt16 *hour, ViInt16 *minute, ViInt16 *second)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getTime", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getTime, (ViSession, ViInt16*, ViInt16*, ViInt16*, ViInt16*, ViInt16*, ViInt16*), (vi, year, month, day, hour, minute, second));
+	PMReplay_out(&call, year, sizeof(*year));
+	PMReplay_out(&call, month, sizeof(*month));
+	PMReplay_out(&call, day, sizeof(*day));
+	PMReplay_out(&call, hour, sizeof(*hour));
+	PMReplay_out(&call, minute, sizeof(*minute));
+	PMReplay_out(&call, second, sizeof(*second));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setTime(ViSession vi, ViInt16 year, ViInt16 month, ViInt16 day, ViInt16 hour, ViInt16 minute, ViInt16 second)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setTime", vi);
+	PMReplay_in(&call, &year, sizeof(year));
+	PMReplay_in(&call, &month, sizeof(month));
+	PMReplay_in(&call, &day, sizeof(day));
+	PMReplay_in(&call, &hour, sizeof(hour));
+	PMReplay_in(&call, &minute, sizeof(minute));
+	PMReplay_in(&call, &second, sizeof(second));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setTime, (ViSession, ViInt16, ViInt16, ViInt16, ViInt16, ViInt16, ViInt16), (vi, year, month, day, hour, minute, second));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getLineFrequency(ViSession vi, ViInt16 *lineFrequency)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getLineFrequency", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getLineFrequency, (ViSession, ViInt16*), (vi, lineFrequency));
+	PMReplay_out(&call, lineFrequency, sizeof(*lineFrequency));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setLineFrequency(ViSession vi, ViInt16 lineFrequency)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setLineFrequency", vi);
+	PMReplay_in(&call, &lineFrequency, sizeof(lineFrequency));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setLineFrequency, (ViSession, ViInt16), (vi, lineFrequency));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_writeRaw(ViSession vi, ViString command)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_writeRaw", vi);
+	PMReplay_inString(&call, command);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_writeRaw, (ViSession, ViString), (vi, command));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_readRaw(ViSession vi, ViChar buffer[], ViUInt32 size, ViUInt32 *returnCount)
+{
+	PMReplayCall call;
+	ViUInt32     n = 0;
+
+	PMReplay_begin(&call, "TLPMX_readRaw", vi);
+	PMReplay_in(&call, &size, sizeof(size));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_readRaw, (ViSession, ViChar*, ViUInt32, ViUInt32*), (vi, buffer, size, &n));
+	PMReplay_out(&call, &n, sizeof(n));
+	if(call.rec.status < 0 || n > size)
+		n = 0;
+	PMReplay_out(&call, buffer, n);
+	if(returnCount != NULL)
+		*returnCount = n;
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Sensor
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_getSensorInfo(ViSession vi, ViChar sensorName[], ViChar serialNumber[], ViChar calibrationMessage[], ViInt16 *sensorType, ViInt16 *sensorSubtype, ViInt16 *sensorFlags, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getSensorInfo", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getSensorInfo, (ViSession, ViChar*, ViChar*, ViChar*, ViInt16*, ViInt16*, ViInt16*, ViUInt16), (vi, sensorName, serialNumber, calibrationMessage, sensorType, sensorSubtype, sensorFlags, channel));
+	PMReplay_outString(&call, sensorName, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, calibrationMessage, TLPM_BUFFER_SIZE);
+	PMReplay_out(&call, sensorType, sizeof(*sensorType));
+	PMReplay_out(&call, sensorSubtype, sizeof(*sensorSubtype));
+	PMReplay_out(&call, sensorFlags, sizeof(*sensorFlags));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_reinitSensor(ViSession vi, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_reinitSensor", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_reinitSensor, (ViSession, ViUInt16), (vi, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getSensorPositionAvailable(ViSession vi, ViBoolean *avail, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getSensorPositionAvailable", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getSensorPositionAvailable, (ViSession, ViBoolean*, ViUInt16), (vi, avail, channel));
+	PMReplay_out(&call, avail, sizeof(*avail));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBeamDia(ViSession vi, ViInt16 attribute, ViReal64 *beamDiameter, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getBeamDia", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getBeamDia, (ViSession, ViInt16, ViReal64*, ViUInt16), (vi, attribute, beamDiameter, channel));
+	PMReplay_out(&call, beamDiameter, sizeof(*beamDiameter));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setBeamDia(ViSession vi, ViReal64 beamDiameter, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setBeamDia", vi);
+	PMReplay_in(&call, &beamDiameter, sizeof(beamDiameter));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setBeamDia, (ViSession, ViReal64, ViUInt16), (vi, beamDiameter, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getWavelength(ViSession vi, ViInt16 attribute, ViReal64 *wavelength, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getWavelength", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getWavelength, (ViSession, ViInt16, ViReal64*, ViUInt16), (vi, attribute, wavelength, channel));
+	PMReplay_out(&call, wavelength, sizeof(*wavelength));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setWavelength(ViSession vi, ViReal64 wavelength, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setWavelength", vi);
+	PMReplay_in(&call, &wavelength, sizeof(wavelength));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setWavelength, (ViSession, ViReal64, ViUInt16), (vi, wavelength, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPhotodiodeResponsivity(ViSession vi, ViInt16 attribute, ViReal64 *responsivity, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getPhotodiodeResponsivity", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPhotodiodeResponsivity, (ViSession, ViInt16, ViReal64*, ViUInt16), (vi, attribute, responsivity, channel));
+	PMReplay_out(&call, responsivity, sizeof(*responsivity));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setFreqMode(ViSession vi, ViUInt16 frequencyMode, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setFreqMode", vi);
+	PMReplay_in(&call, &frequencyMode, sizeof(frequencyMode));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setFreqMode, (ViSession, ViUInt16, ViUInt16), (vi, frequencyMode, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setInputFilterState(ViSession vi, ViBoolean inputFilterState, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setInputFilterState", vi);
+	PMReplay_in(&call, &inputFilterState, sizeof(inputFilterState));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setInputFilterState, (ViSession, ViBoolean, ViUInt16), (vi, inputFilterState, channel));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Power calibration points
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPointsInformation(ViSession vi, ViUInt16 index, ViChar serialNumber[], ViChar calibrationDate[], ViUInt16 *calibrationPointsCount, ViChar author[], ViUInt16 *sensorPosition, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getPowerCalibrationPointsInformation", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPowerCalibrationPointsInformation, (ViSession, ViUInt16, ViChar*, ViChar*, ViUInt16*, ViChar*, ViUInt16*, ViUInt16), (vi, index, serialNumber, calibrationDate, calibrationPointsCount, author, sensorPosition, channel));
+	PMReplay_outString(&call, serialNumber, TLPM_BUFFER_SIZE);
+	PMReplay_outString(&call, calibrationDate, TLPM_BUFFER_SIZE);
+	PMReplay_out(&call, calibrationPointsCount, sizeof(*calibrationPointsCount));
+	PMReplay_outString(&call, author, TLPM_BUFFER_SIZE);
+	PMReplay_out(&call, sensorPosition, sizeof(*sensorPosition));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPointsState(ViSession vi, ViUInt16 index, ViBoolean *state, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getPowerCalibrationPointsState", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPowerCalibrationPointsState, (ViSession, ViUInt16, ViBoolean*, ViUInt16), (vi, index, state, channel));
+	PMReplay_out(&call, state, sizeof(*state));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerCalibrationPointsState(ViSession vi, ViUInt16 index, ViBoolean state, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setPowerCalibrationPointsState", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PMReplay_in(&call, &state, sizeof(state));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setPowerCalibrationPointsState, (ViSession, ViUInt16, ViBoolean, ViUInt16), (vi, index, state, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPoints(ViSession vi, ViUInt16 index, ViUInt16 pointCounts, ViReal64 wavelengths[], ViReal64 powerCorrectionFactors[], ViUInt16 channel)
+{
+	PMReplayCall call;
+	ViUInt32     n;
+
+	PMReplay_begin(&call, "TLPMX_getPowerCalibrationPoints", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PMReplay_in(&call, &pointCounts, sizeof(pointCounts));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPowerCalibrationPoints, (ViSession, ViUInt16, ViUInt16, ViReal64*, ViReal64*, ViUInt16), (vi, index, pointCounts, wavelengths, powerCorrectionFactors, channel));
+	n = (call.rec.status >= 0) ? pointCounts : 0;
+	PMReplay_out(&call, wavelengths, n * sizeof(ViReal64));
+	PMReplay_out(&call, powerCorrectionFactors, n * sizeof(ViReal64));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerCalibrationPoints(ViSession vi, ViUInt16 index, ViUInt16 pointCounts, ViReal64 wavelengths[], ViReal64 powerCorrectionFactors[], ViChar author[], ViUInt16 sensorPosition, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setPowerCalibrationPoints", vi);
+	PMReplay_in(&call, &index, sizeof(index));
+	PMReplay_in(&call, &pointCounts, sizeof(pointCounts));
+	PMReplay_in(&call, wavelengths, pointCounts * sizeof(ViReal64));
+	PMReplay_in(&call, powerCorrectionFactors, pointCounts * sizeof(ViReal64));
+	PMReplay_inString(&call, author);
+	PMReplay_in(&call, &sensorPosition, sizeof(sensorPosition));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setPowerCalibrationPoints, (ViSession, ViUInt16, ViUInt16, ViReal64*, ViReal64*, ViChar*, ViUInt16, ViUInt16), (vi, index, pointCounts, wavelengths, powerCorrectionFactors, author, sensorPosition, channel));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Ranges
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_setPowerAutoRange(ViSession vi, ViInt16 powerAutorangeMode, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setPowerAutoRange", vi);
+	PMReplay_in(&call, &powerAutorangeMode, sizeof(powerAutorangeMode));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setPowerAutoRange, (ViSession, ViInt16, ViUInt16), (vi, powerAutorangeMode, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerRange(ViSession vi, ViReal64 power_to_Measure, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setPowerRange", vi);
+	PMReplay_in(&call, &power_to_Measure, sizeof(power_to_Measure));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setPowerRange, (ViSession, ViReal64, ViUInt16), (vi, power_to_Measure, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerRange(ViSession vi, ViInt16 attribute, ViReal64 *powerValue, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getPowerRange", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPowerRange, (ViSession, ViInt16, ViReal64*, ViUInt16), (vi, attribute, powerValue, channel));
+	PMReplay_out(&call, powerValue, sizeof(*powerValue));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setCurrentAutoRange(ViSession vi, ViInt16 currentAutorangeMode, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setCurrentAutoRange", vi);
+	PMReplay_in(&call, &currentAutorangeMode, sizeof(currentAutorangeMode));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setCurrentAutoRange, (ViSession, ViInt16, ViUInt16), (vi, currentAutorangeMode, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setCurrentRange(ViSession vi, ViReal64 current_to_Measure, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_setCurrentRange", vi);
+	PMReplay_in(&call, &current_to_Measure, sizeof(current_to_Measure));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_setCurrentRange, (ViSession, ViReal64, ViUInt16), (vi, current_to_Measure, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getCurrentRange(ViSession vi, ViInt16 attribute, ViReal64 *currentValue, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getCurrentRange", vi);
+	PMReplay_in(&call, &attribute, sizeof(attribute));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getCurrentRange, (ViSession, ViInt16, ViReal64*, ViUInt16), (vi, attribute, currentValue, channel));
+	PMReplay_out(&call, currentValue, sizeof(*currentValue));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Scalar measurements
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_getPowerUnit(ViSession vi, ViInt16 *powerUnit, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getPowerUnit", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getPowerUnit, (ViSession, ViInt16*, ViUInt16), (vi, powerUnit, channel));
+	PMReplay_out(&call, powerUnit, sizeof(*powerUnit));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measPower(ViSession vi, ViReal64 *power, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measPower", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measPower, (ViSession, ViReal64*, ViUInt16), (vi, power, channel));
+	PMReplay_out(&call, power, sizeof(*power));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measCurrent(ViSession vi, ViReal64 *current, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measCurrent", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measCurrent, (ViSession, ViReal64*, ViUInt16), (vi, current, channel));
+	PMReplay_out(&call, current, sizeof(*current));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measEnergy(ViSession vi, ViReal64 *energy, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measEnergy", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measEnergy, (ViSession, ViReal64*, ViUInt16), (vi, energy, channel));
+	PMReplay_out(&call, energy, sizeof(*energy));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measFreq(ViSession vi, ViReal64 *frequency, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measFreq", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measFreq, (ViSession, ViReal64*, ViUInt16), (vi, frequency, channel));
+	PMReplay_out(&call, frequency, sizeof(*frequency));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measPowerDens(ViSession vi, ViReal64 *powerDensity, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measPowerDens", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measPowerDens, (ViSession, ViReal64*, ViUInt16), (vi, powerDensity, channel));
+	PMReplay_out(&call, powerDensity, sizeof(*powerDensity));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_measEnergyDens(ViSession vi, ViReal64 *energyDensity, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_measEnergyDens", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_measEnergyDens, (ViSession, ViReal64*, ViUInt16), (vi, energyDensity, channel));
+	PMReplay_out(&call, energyDensity, sizeof(*energyDensity));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_meas4QPositions(ViSession vi, ViReal64 *xPosition, ViReal64 *yPosition, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_meas4QPositions", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_meas4QPositions, (ViSession, ViReal64*, ViReal64*, ViUInt16), (vi, xPosition, yPosition, channel));
+	PMReplay_out(&call, xPosition, sizeof(*xPosition));
+	PMReplay_out(&call, yPosition, sizeof(*yPosition));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_meas4QVoltages(ViSession vi, ViReal64 *voltage1, ViReal64 *voltage2, ViReal64 *voltage3, ViReal64 *voltage4, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_meas4QVoltages", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_meas4QVoltages, (ViSession, ViReal64*, ViReal64*, ViReal64*, ViReal64*, ViUInt16), (vi, voltage1, voltage2, voltage3, voltage4, channel));
+	PMReplay_out(&call, voltage1, sizeof(*voltage1));
+	PMReplay_out(&call, voltage2, sizeof(*voltage2));
+	PMReplay_out(&call, voltage3, sizeof(*voltage3));
+	PMReplay_out(&call, voltage4, sizeof(*voltage4));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Peak detector and measurement sequence
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_startPeakDetector(ViSession vi, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_startPeakDetector", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_startPeakDetector, (ViSession, ViUInt16), (vi, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_isPeakDetectorRunning(ViSession vi, ViBoolean *isRunning, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_isPeakDetectorRunning", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_isPeakDetectorRunning, (ViSession, ViBoolean*, ViUInt16), (vi, isRunning, channel));
+	PMReplay_out(&call, isRunning, sizeof(*isRunning));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_confPowerMeasurementSequence(ViSession vi, ViUInt32 baseTime, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_confPowerMeasurementSequence", vi);
+	PMReplay_in(&call, &baseTime, sizeof(baseTime));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_confPowerMeasurementSequence, (ViSession, ViUInt32, ViUInt16), (vi, baseTime, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_startMeasurementSequence(ViSession vi, ViUInt32 autoTriggerDelay, ViBoolean *triggerForced, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_startMeasurementSequence", vi);
+	PMReplay_in(&call, &autoTriggerDelay, sizeof(autoTriggerDelay));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_startMeasurementSequence, (ViSession, ViUInt32, ViBoolean*, ViUInt16), (vi, autoTriggerDelay, triggerForced, channel));
+	PMReplay_out(&call, triggerForced, sizeof(*triggerForced));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getMeasurementSequence(ViSession vi, ViUInt32 baseTime, ViReal32 timeStamps[], ViReal32 values[], ViReal32 values2[], ViUInt16 channel)
+{
+	PMReplayCall call;
+	ViUInt32     n;
+
+	PMReplay_begin(&call, "TLPMX_getMeasurementSequence", vi);
+	PMReplay_in(&call, &baseTime, sizeof(baseTime));
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getMeasurementSequence, (ViSession, ViUInt32, ViReal32*, ViReal32*, ViReal32*, ViUInt16), (vi, baseTime, timeStamps, values, values2, channel));
+	n = (call.rec.status >= 0) ? baseTime * PM_REPLAY_SEQUENCE_POINTS : 0;
+	PMReplay_out(&call, timeStamps, n * sizeof(ViReal32));
+	PMReplay_out(&call, values, n * sizeof(ViReal32));
+	PMReplay_out(&call, values2, n * sizeof(ViReal32));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Burst array measurement
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_confBurstArrayMeasPowerChannel(ViSession vi, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_confBurstArrayMeasPowerChannel", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_confBurstArrayMeasPowerChannel, (ViSession, ViUInt16), (vi, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_confBurstArrayMeasTrigger(ViSession vi, ViUInt32 trgSource, ViUInt32 initDelay, ViUInt32 burstCount, ViUInt32 averaging)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_confBurstArrayMeasTrigger", vi);
+	PMReplay_in(&call, &trgSource, sizeof(trgSource));
+	PMReplay_in(&call, &initDelay, sizeof(initDelay));
+	PMReplay_in(&call, &burstCount, sizeof(burstCount));
+	PMReplay_in(&call, &averaging, sizeof(averaging));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_confBurstArrayMeasTrigger, (ViSession, ViUInt32, ViUInt32, ViUInt32, ViUInt32), (vi, trgSource, initDelay, burstCount, averaging));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_startBurstArrayMeasurement(ViSession vi)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_startBurstArrayMeasurement", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_startBurstArrayMeasurement, (ViSession), (vi));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBurstArraySamplesCount(ViSession vi, ViUInt32 *samplesCount)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getBurstArraySamplesCount", vi);
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getBurstArraySamplesCount, (ViSession, ViUInt32*), (vi, samplesCount));
+	PMReplay_out(&call, samplesCount, sizeof(*samplesCount));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBurstArraySamples(ViSession vi, ViUInt32 startIndex, ViUInt32 sampleCount, ViUInt32 timeStamps[], ViReal32 values[], ViReal32 values2[])
+{
+	PMReplayCall call;
+	ViUInt32     n;
+
+	PMReplay_begin(&call, "TLPMX_getBurstArraySamples", vi);
+	PMReplay_in(&call, &startIndex, sizeof(startIndex));
+	PMReplay_in(&call, &sampleCount, sizeof(sampleCount));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getBurstArraySamples, (ViSession, ViUInt32, ViUInt32, ViUInt32*, ViReal32*, ViReal32*), (vi, startIndex, sampleCount, timeStamps, values, values2));
+	n = (call.rec.status >= 0) ? sampleCount : 0;
+	PMReplay_out(&call, timeStamps, n * sizeof(ViUInt32));
+	PMReplay_out(&call, values, n * sizeof(ViReal32));
+	PMReplay_out(&call, values2, n * sizeof(ViReal32));
+	return PMReplay_end(&call);
+}
+
+
+/*---------------------------------------------------------------------------
+  Fast measure stream
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_confPowerFastArrayMeasurement(ViSession vi, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_confPowerFastArrayMeasurement", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_confPowerFastArrayMeasurement, (ViSession, ViUInt16), (vi, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_confCurrentFastArrayMeasurement(ViSession vi, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_confCurrentFastArrayMeasurement", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_confCurrentFastArrayMeasurement, (ViSession, ViUInt16), (vi, channel));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getNextFastArrayMeasurement(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[], ViUInt16 channel)
+{
+	PMReplayCall call;
+	ViUInt32     n;
+
+	PMReplay_begin(&call, "TLPMX_getNextFastArrayMeasurement", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getNextFastArrayMeasurement, (ViSession, ViUInt16*, ViUInt32*, ViReal32*, ViUInt16), (vi, count, timestamps, values, channel));
+	PMReplay_out(&call, count, sizeof(*count));
+	n = (call.rec.status >= 0) ? *count : 0;
+	PMReplay_out(&call, timestamps, n * sizeof(ViUInt32));
+	PMReplay_out(&call, values, n * sizeof(ViReal32));
+	return PMReplay_end(&call);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getFastMaxSamplerate(ViSession vi, ViUInt32 *pVal, ViUInt16 channel)
+{
+	PMReplayCall call;
+
+	PMReplay_begin(&call, "TLPMX_getFastMaxSamplerate", vi);
+	PMReplay_in(&call, &channel, sizeof(channel));
+	PM_REPLAY_CALL(&call, PM_REPLAY_TLPMX, TLPMX_getFastMaxSamplerate, (ViSession, ViUInt32*, ViUInt16), (vi, pVal, channel));
+	PMReplay_out(&call, pVal, sizeof(*pVal));
+	return PMReplay_end(&call);
+}
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
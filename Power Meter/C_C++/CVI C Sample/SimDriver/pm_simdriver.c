@@ -0,0 +1,628 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_simdriver.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "TLPM.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define SESSION_BASE          0x5100u   // session handles are SESSION_BASE + slot
+
+#define DEFAULT_WAVELENGTH    635.0
+#define DEFAULT_BEAM_DIAMETER 9.5
+#define CHANNEL2_OFFSET       0x10000u  // second channel reads another part of the signal
+
+/*===========================================================================
+ Global variables
+===========================================================================*/
+static PMSimConfig simConfig;
+static ViBoolean   simConfigured;
+static uint32_t    simDevices;
+static PMSimInstr  simSessions[PM_SIMDRV_MAX_SESSIONS];
+
+// Injected faults
+static PMSimFaults       simFaults;
+static uint32_t          disconnectRng = 0x9E3779B9u;
+static volatile uint64_t nextDisconnectNs[PM_SIMDRV_MAX_DEVICES];   // 0: not scheduled yet
+static volatile uint64_t downUntilNs[PM_SIMDRV_MAX_DEVICES];
+static volatile uint64_t injectedTimeouts;
+static volatile uint64_t injectedDisconnects;
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static void configure(void)
+{
+	const char *v;
+
+	if(simConfigured)
+		return;
+
+	simConfigured = VI_TRUE;
+	PMSim_defaultConfig(&simConfig);
+	PMSim_configFromEnv(&simConfig);
+	simDevices = 1;
+	if((v = getenv("PM_SIM_DEVICES")) != NULL)
+		PMSimDriver_setDeviceCount((uint32_t)atoi(v));
+
+	memset(&simFaults, 0, sizeof(PMSimFaults));
+	simFaults.timeoutUs = PM_SIMDRV_FAULT_TIMEOUT_US;
+	simFaults.downMs    = PM_SIMDRV_FAULT_DOWN_MS;
+	if((v = getenv("PM_SIM_FAULT_TIMEOUT")) != NULL)
+		simFaults.timeoutProbability = atof(v);
+	if((v = getenv("PM_SIM_FAULT_TIMEOUT_US")) != NULL)
+		simFaults.timeoutUs = (uint32_t)strtoul(v, NULL, 0);
+	if((v = getenv("PM_SIM_FAULT_DISCONNECT_S")) != NULL)
+		simFaults.disconnectMeanSec = atof(v);
+	if((v = getenv("PM_SIM_FAULT_DOWN_MS")) != NULL)
+		simFaults.downMs = (uint32_t)strtoul(v, NULL, 0);
+}
+
+
+static uint32_t nextRandom(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+
+/*---------------------------------------------------------------------------
+  Disconnect the instrument when its time has come. The caller that wins
+  the exchange of the schedule cuts all open sessions of the instrument
+  and schedules the next disconnect (exponentially distributed).
+---------------------------------------------------------------------------*/
+static void checkDisconnect(uint32_t device)
+{
+	uint64_t now, next, down, interval;
+	uint32_t i;
+
+	if(simFaults.disconnectMeanSec <= 0.0)
+		return;
+
+	now  = PMPlat_timeNs();
+	next = PMPlat_load64(&nextDisconnectNs[device]);
+	interval = (uint64_t)(-log(((double)nextRandom(&disconnectRng) + 1.0) / 4294967297.0) * simFaults.disconnectMeanSec * 1e9);
+	if(next == 0)
+	{
+		PMPlat_cas64(&nextDisconnectNs[device], 0, now + interval);
+		return;
+	}
+
+	down = now + (uint64_t)simFaults.downMs * 1000000;
+	if(now < next || !PMPlat_cas64(&nextDisconnectNs[device], next, down + interval))
+		return;
+
+	PMPlat_store64(&downUntilNs[device], down);
+	for(i = 0; i < PM_SIMDRV_MAX_SESSIONS; i++)
+		if(simSessions[i].used && simSessions[i].device == device)
+			simSessions[i].connectionLost = VI_TRUE;
+	PMPlat_fetchAdd64(&injectedDisconnects, 1);
+}
+
+
+static ViBoolean deviceAway(uint32_t device)
+{
+	checkDisconnect(device);
+	return (PMPlat_timeNs() < PMPlat_load64(&downUntilNs[device])) ? VI_TRUE : VI_FALSE;
+}
+
+
+void PMSimDriver_setConfig(const PMSimConfig *cfg)
+{
+	configure();
+	simConfig = *cfg;
+}
+
+
+void PMSimDriver_getConfig(PMSimConfig *cfg)
+{
+	configure();
+	*cfg = simConfig;
+}
+
+
+void PMSimDriver_setDeviceCount(uint32_t count)
+{
+	configure();
+	simDevices = (count > PM_SIMDRV_MAX_DEVICES) ? PM_SIMDRV_MAX_DEVICES : count;
+}
+
+
+uint32_t PMSimDriver_deviceCount(void)
+{
+	configure();
+	return simDevices;
+}
+
+
+void PMSimDriver_setFaults(const PMSimFaults *faults)
+{
+	configure();
+	simFaults = *faults;
+}
+
+
+void PMSimDriver_getFaults(PMSimFaults *faults)
+{
+	configure();
+	*faults = simFaults;
+}
+
+
+void PMSimDriver_getFaultStats(PMSimFaultStats *stats)
+{
+	stats->timeouts    = PMPlat_load64(&injectedTimeouts);
+	stats->disconnects = PMPlat_load64(&injectedDisconnects);
+}
+
+
+ViStatus PMSimDriver_rsrcName(ViUInt32 index, ViChar name[])
+{
+	if(index >= PMSimDriver_deviceCount())
+		return VI_ERROR_RSRC_NFOUND;
+	sprintf(name, PM_SIMDRV_RSRC_FORMAT, (unsigned int)index);
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMSimDriver_rsrcInfo(ViUInt32 index, ViChar model[], ViChar serial[], ViChar manufacturer[], ViBoolean *available)
+{
+	if(index >= PMSimDriver_deviceCount())
+		return VI_ERROR_RSRC_NFOUND;
+	if(model != NULL)
+		strcpy(model, PM_SIMDRV_MODEL);
+	if(serial != NULL)
+		sprintf(serial, "SIM%05u", (unsigned int)index);
+	if(manufacturer != NULL)
+		strcpy(manufacturer, "Thorlabs");
+	if(available != NULL)
+		*available = deviceAway(index) ? VI_FALSE : VI_TRUE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Open a session on a simulated resource. Every session has its own
+  stream; the device index only selects seed and signal level.
+---------------------------------------------------------------------------*/
+ViStatus PMSimDriver_open(ViRsrc resource, ViSession *vi)
+{
+	PMSimConfig cfg;
+	PMSimInstr  *instr = NULL;
+	unsigned int device;
+	uint32_t    i;
+
+	configure();
+	*vi = VI_NULL;
+	if(resource == NULL || sscanf(resource, PM_SIMDRV_RSRC_FORMAT, &device) != 1 || device >= simDevices ||
+	   deviceAway(device))
+		return VI_ERROR_RSRC_NFOUND;
+
+	for(i = 0; i < PM_SIMDRV_MAX_SESSIONS && instr == NULL; i++)
+		if(!simSessions[i].used)
+			instr = &simSessions[i];
+	if(instr == NULL)
+		return VI_ERROR_ALLOC;
+
+	memset(instr, 0, sizeof(PMSimInstr));
+	cfg = simConfig;
+	cfg.seed       += device * 7919u;
+	cfg.signalMean *= 1.0 + 0.1 * device;
+
+	instr->used             = VI_TRUE;
+	instr->device           = device;
+	instr->powerUnit        = TLPM_POWER_UNIT_WATT;
+	instr->wavelength       = DEFAULT_WAVELENGTH;
+	instr->beamDiameter     = DEFAULT_BEAM_DIAMETER;
+	instr->powerRange       = PM_SIMDRV_POWER_MAX;
+	instr->currentRange     = PM_SIMDRV_CURRENT_MAX;
+	instr->powerAutoRange   = TLPM_AUTORANGE_POWER_ON;
+	instr->currentAutoRange = TLPM_AUTORANGE_POWER_ON;
+	instr->inputFilter      = VI_TRUE;
+	instr->freqMode         = TLPM_FREQ_MODE_CW;
+	instr->lineFrequency    = 50;
+	instr->seqAveraging     = 1;
+	instr->burstAveraging   = 1;
+	instr->faultRng         = (cfg.seed * 2654435761u) | 1;
+	PMSim_init(&instr->sim, &cfg);
+
+	*vi = (ViSession)(SESSION_BASE + (uint32_t)(instr - simSessions));
+	return VI_SUCCESS;
+}
+
+
+static PMSimInstr *lookup(ViSession vi)
+{
+	uint32_t slot = (uint32_t)vi - SESSION_BASE;
+
+	if(slot >= PM_SIMDRV_MAX_SESSIONS || !simSessions[slot].used)
+		return NULL;
+	return &simSessions[slot];
+}
+
+
+ViStatus PMSimDriver_close(ViSession vi)
+{
+	PMSimInstr *instr = lookup(vi);
+
+	if(instr == NULL)
+		return VI_ERROR_INV_OBJECT;
+	instr->used = VI_FALSE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Resolve a session for a driver call and spend the simulated call time
+---------------------------------------------------------------------------*/
+ViStatus PMSimDriver_call(ViSession vi, PMSimInstr **instr)
+{
+	if((*instr = lookup(vi)) == NULL)
+		return VI_ERROR_INV_OBJECT;
+	checkDisconnect((*instr)->device);
+	if((*instr)->connectionLost)
+		return VI_ERROR_CONN_LOST;
+	(*instr)->calls++;
+	PMSim_callDelay(&(*instr)->sim);
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMSimDriver_getStats(ViSession vi, PMSimDriverStats *stats)
+{
+	PMSimInstr *instr = lookup(vi);
+
+	memset(stats, 0, sizeof(PMSimDriverStats));
+	if(instr == NULL)
+		return VI_ERROR_INV_OBJECT;
+	stats->calls    = instr->calls;
+	stats->produced = instr->sim.produced;
+	stats->lost     = instr->sim.lost;
+	stats->gapped   = instr->sim.gapped;
+	return VI_SUCCESS;
+}
+
+
+void PMSimDriver_errorMessage(ViStatus status, ViChar description[])
+{
+	const char *msg;
+
+	switch(status)
+	{
+		case VI_SUCCESS:           msg = "Operation completed successfully"; break;
+		case VI_ERROR_INV_OBJECT:  msg = "Invalid session handle (simulated driver)"; break;
+		case VI_ERROR_RSRC_NFOUND: msg = "Resource not found (simulated driver)"; break;
+		case VI_ERROR_ALLOC:       msg = "Too many open sessions (simulated driver)"; break;
+		case VI_ERROR_INV_SETUP:   msg = "Measurement not configured (simulated driver)"; break;
+		case VI_ERROR_INV_OFFSET:  msg = "Sample index out of range (simulated driver)"; break;
+		case VI_ERROR_NSUP_OPER:   msg = "Operation not supported by the simulated driver"; break;
+		case VI_ERROR_TMO:         msg = "Timeout expired before operation completed (simulated fault)"; break;
+		case VI_ERROR_CONN_LOST:   msg = "Connection to the instrument lost (simulated fault)"; break;
+		default:                   msg = "Unknown status code (simulated driver)"; break;
+	}
+	sprintf(description, "%s", msg);
+}
+
+
+/*---------------------------------------------------------------------------
+  Fast measure stream
+---------------------------------------------------------------------------*/
+ViStatus PMSimInstr_confFastArray(PMSimInstr *instr, int mode)
+{
+	PMSimConfig cfg = instr->sim.cfg;
+	uint64_t    startNs = instr->sim.startNs;
+
+	// the device restarts the stream, its clock keeps running
+	instr->fastMode = mode;
+	PMSim_init(&instr->sim, &cfg);
+	instr->sim.startNs  = startNs;
+	instr->sim.produced = PMSim_now(&instr->sim);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Select the smallest range holding power. Like the real instrument the
+  measurement stops meanwhile: the call takes PM_SIMDRV_RANGE_SWITCH_US
+  and the samples of that time are never taken.
+---------------------------------------------------------------------------*/
+void PMSimInstr_setPowerRange(PMSimInstr *instr, ViReal64 power)
+{
+	ViReal64 range = PM_SIMDRV_POWER_MIN;
+
+	while(range < power * (1.0 - 1.0e-9) && range < PM_SIMDRV_POWER_MAX)
+		range *= 10.0;
+	if(range == instr->powerRange)
+		return;
+
+	instr->powerRange = range;
+	PMPlat_sleepUs(PM_SIMDRV_RANGE_SWITCH_US);
+	if(instr->sim.cfg.realTime)
+		instr->sim.produced = PMSim_now(&instr->sim);
+}
+
+
+ViStatus PMSimInstr_readFastArray(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMSimInstr *instr = lookup(vi);
+	ViStatus   err;
+	ViUInt16   i;
+
+	*count = 0;
+	if(instr == NULL)
+		return VI_ERROR_INV_OBJECT;
+	checkDisconnect(instr->device);
+	if(instr->connectionLost)
+		return VI_ERROR_CONN_LOST;
+	if(instr->fastMode == PM_SIMDRV_FAST_OFF)
+		return VI_ERROR_INV_SETUP;
+
+	instr->calls++;
+	if(simFaults.timeoutProbability > 0.0 &&
+	   (double)nextRandom(&instr->faultRng) < simFaults.timeoutProbability * 4294967296.0)
+	{
+		PMPlat_sleepUs(simFaults.timeoutUs);
+		PMPlat_fetchAdd64(&injectedTimeouts, 1);
+		return VI_ERROR_TMO;
+	}
+	if((err = PMSim_readBlock(&instr->sim, count, timestamps, values)) != VI_SUCCESS)
+		return err;
+	if(instr->fastMode == PM_SIMDRV_FAST_CURRENT)
+		for(i = 0; i < *count; i++)
+			values[i] *= (ViReal32)PM_SIMDRV_RESPONSIVITY;
+	else if(instr->powerAutoRange == TLPM_AUTORANGE_POWER_OFF)
+		for(i = 0; i < *count; i++)
+			if(values[i] > (ViReal32)instr->powerRange)
+				values[i] = (ViReal32)instr->powerRange;     // saturated
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Scalar readings: the sample the stream is taking right now
+---------------------------------------------------------------------------*/
+ViReal64 PMSimInstr_power(PMSimInstr *instr)
+{
+	return (ViReal64)PMSim_sample(&instr->sim, PMSim_now(&instr->sim));
+}
+
+
+ViReal64 PMSimInstr_powerInUnit(PMSimInstr *instr)
+{
+	ViReal64 power = PMSimInstr_power(instr);
+
+	if(instr->powerUnit == TLPM_POWER_UNIT_DBM)
+		return 10.0 * log10(power / 1.0e-3);
+	return power;
+}
+
+
+void PMSimInstr_identification(PMSimInstr *instr, ViChar manufacturer[], ViChar device[], ViChar serial[], ViChar firmware[])
+{
+	PMSimDriver_rsrcInfo(instr->device, device, serial, manufacturer, NULL);
+	if(firmware != NULL)
+		strcpy(firmware, PM_SIMDRV_FIRMWARE);
+}
+
+
+ViReal64 PMSimInstr_rangeAttribute(ViInt16 attribute, ViReal64 value, ViReal64 min, ViReal64 max)
+{
+	switch(attribute)
+	{
+		case TLPM_ATTR_MIN_VAL:  return min;
+		case TLPM_ATTR_MAX_VAL:  return max;
+		case TLPM_ATTR_DFLT_VAL: return max;
+		default:                 return value;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Measurement sequence: the simulated signal always triggers at once, a
+  point averages seqAveraging stream samples. Timestamps in ms, like the
+  driver.
+---------------------------------------------------------------------------*/
+ViStatus PMSimInstr_startSequence(PMSimInstr *instr, ViUInt32 autoTriggerDelay, ViBoolean *triggerForced)
+{
+	(void)autoTriggerDelay;
+	instr->seqStarted = VI_TRUE;
+	instr->seqStartNs = PMPlat_timeNs();
+	instr->seqFirst   = PMSim_now(&instr->sim);
+	if(triggerForced != NULL)
+		*triggerForced = VI_FALSE;
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMSimInstr_getSequence(PMSimInstr *instr, ViUInt32 baseTime, ViReal32 timeStamps[], ViReal32 values[], ViReal32 values2[])
+{
+	uint32_t avg    = instr->seqAveraging ? instr->seqAveraging : 1;
+	uint32_t points = baseTime * PM_SIMDRV_SEQUENCE_POINTS;
+	uint64_t periodNs = 1000000000ull / instr->sim.cfg.sampleRate;
+	uint64_t endNs  = instr->seqStartNs + (uint64_t)points * avg * periodNs;
+	uint32_t i, k;
+
+	if(!instr->seqStarted)
+		return VI_ERROR_INV_SETUP;
+
+	// the device returns the sequence once it is complete
+	if(instr->sim.cfg.realTime)
+		while(PMPlat_timeNs() < endNs)
+			PMPlat_sleepUs(100);
+
+	for(i = 0; i < points; i++)
+	{
+		uint64_t idx = instr->seqFirst + (uint64_t)i * avg;
+		double   sum = 0.0, sum2 = 0.0;
+
+		for(k = 0; k < avg; k++)
+		{
+			sum += PMSim_sample(&instr->sim, idx + k);
+			if(values2 != NULL)
+				sum2 += PMSim_sample(&instr->sim, idx + k + CHANNEL2_OFFSET);
+		}
+		if(timeStamps != NULL)
+			timeStamps[i] = (ViReal32)((double)i * avg * periodNs / 1e6);
+		if(values != NULL)
+			values[i] = (ViReal32)(sum / avg);
+		if(values2 != NULL)
+			values2[i] = (ViReal32)(sum2 / avg);
+	}
+
+	instr->seqStarted = VI_FALSE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Burst array: after the init delay the trigger fires every
+  PM_SIMDRV_BURST_PERIOD_US, each burst stores PM_SIMDRV_BURST_SAMPLES
+  stream samples averaged by burstAveraging. "ABOR" stops recording.
+---------------------------------------------------------------------------*/
+ViStatus PMSimInstr_startBurst(PMSimInstr *instr)
+{
+	if(instr->burstChannels == 0 || instr->burstCount == 0)
+		return VI_ERROR_INV_SETUP;
+	instr->burstRunning = VI_TRUE;
+	instr->burstStartNs = PMPlat_timeNs() + (uint64_t)instr->burstInitDelayUs * 1000;
+	instr->burstStopNs  = 0;
+	instr->burstFirst   = PMSim_now(&instr->sim);
+	return VI_SUCCESS;
+}
+
+
+ViUInt32 PMSimInstr_burstSamples(PMSimInstr *instr)
+{
+	uint32_t perBurst = PM_SIMDRV_BURST_SAMPLES / (instr->burstAveraging ? instr->burstAveraging : 1);
+	uint64_t nowNs = instr->burstStopNs ? instr->burstStopNs : PMPlat_timeNs();
+	uint64_t periodNs = 1000000000ull / instr->sim.cfg.sampleRate;
+	uint64_t bursts, inBurst, elapsedNs;
+
+	if(instr->burstStartNs == 0 || nowNs <= instr->burstStartNs)
+		return 0;
+
+	if(!instr->sim.cfg.realTime)
+		return instr->burstCount * perBurst;
+
+	elapsedNs = nowNs - instr->burstStartNs;
+	bursts    = elapsedNs / ((uint64_t)PM_SIMDRV_BURST_PERIOD_US * 1000);
+	if(bursts >= instr->burstCount)
+		return instr->burstCount * perBurst;
+
+	// the running burst has recorded part of its samples
+	inBurst = (elapsedNs - bursts * PM_SIMDRV_BURST_PERIOD_US * 1000ull) / periodNs
+			/ (instr->burstAveraging ? instr->burstAveraging : 1);
+	if(inBurst > perBurst)
+		inBurst = perBurst;
+	return (ViUInt32)(bursts * perBurst + inBurst);
+}
+
+
+ViStatus PMSimInstr_getBurst(PMSimInstr *instr, ViUInt32 start, ViUInt32 count, ViUInt32 timeStamps[], ViReal32 values[], ViReal32 values2[])
+{
+	uint32_t avg      = instr->burstAveraging ? instr->burstAveraging : 1;
+	uint32_t perBurst = PM_SIMDRV_BURST_SAMPLES / avg;
+	uint32_t samplesPerPeriod = PM_SIMDRV_BURST_PERIOD_US * (instr->sim.cfg.sampleRate / 1000) / 1000;
+	uint32_t i, k;
+
+	if(perBurst == 0)
+		return VI_ERROR_INV_SETUP;
+	if((uint64_t)start + count > PMSimInstr_burstSamples(instr))
+		return VI_ERROR_INV_OFFSET;
+
+	for(i = 0; i < count; i++)
+	{
+		uint32_t n     = start + i;
+		uint32_t burst = n / perBurst;
+		uint32_t pos   = (n % perBurst) * avg;
+		uint64_t idx   = instr->burstFirst + (uint64_t)burst * samplesPerPeriod + pos;
+		double   sum = 0.0, sum2 = 0.0;
+
+		for(k = 0; k < avg; k++)
+		{
+			sum  += PMSim_sample(&instr->sim, idx + k);
+			sum2 += PMSim_sample(&instr->sim, idx + k + CHANNEL2_OFFSET);
+		}
+		if(timeStamps != NULL)
+			timeStamps[i] = instr->burstInitDelayUs + burst * PM_SIMDRV_BURST_PERIOD_US
+					+ (ViUInt32)((uint64_t)pos * 1000000 / instr->sim.cfg.sampleRate);
+		if(values != NULL)
+			values[i] = (instr->burstChannels & 1) ? (ViReal32)(sum / avg) : 0.0f;
+		if(values2 != NULL)
+			values2[i] = (instr->burstChannels & 2) ? (ViReal32)(sum2 / avg) : 0.0f;
+	}
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  SCPI pass through: only the commands the samples use are understood
+---------------------------------------------------------------------------*/
+ViStatus PMSimInstr_writeRaw(PMSimInstr *instr, ViString command)
+{
+	ViChar manufacturer[32], device[32], serial[32], firmware[32];
+
+	instr->response[0] = '\0';
+	if(strncmp(command, "ABOR", 4) == 0)
+	{
+		if(instr->burstRunning)
+		{
+			instr->burstStopNs  = PMPlat_timeNs();
+			instr->burstRunning = VI_FALSE;
+		}
+		instr->seqStarted = VI_FALSE;
+		instr->fastMode   = PM_SIMDRV_FAST_OFF;
+	}
+	else if(strncmp(command, "*IDN?", 5) == 0)
+	{
+		PMSimInstr_identification(instr, manufacturer, device, serial, firmware);
+		snprintf(instr->response, PM_SIMDRV_RESPONSE_SIZE, "%s,%s,%s,%s\n", manufacturer, device, serial, firmware);
+	}
+	else if(strncmp(command, "MEAS:POW?", 9) == 0 || strncmp(command, "READ?", 5) == 0)
+	{
+		sprintf(instr->response, "%.9E\n", PMSimInstr_power(instr));
+	}
+	else if(strchr(command, '?') != NULL)
+	{
+		return VI_ERROR_NSUP_OPER;
+	}
+	return VI_SUCCESS;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,219 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated driver
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Drop-in replacement for the TLPM / TLPMX instrument drivers, for
+   benchmarking and regression testing without a power meter. Link
+   tlpm_sim.c, tlpmx_sim.c and pm_simdriver.c together with the toolkit
+   (pm_*.c) instead of the Thorlabs driver library, e.g.
+
+     gcc -O2 -o engine PM103_fast_stream_engine.c pm_*.c
+         SimDriver/pm_simdriver.c SimDriver/tlpm_sim.c SimDriver/tlpmx_sim.c
+         -lpthread -lm
+
+   The TLPM.h / TLPMX.h headers of the driver installation are still
+   needed to compile.
+
+   Every session gets its own PMSim stream (100 kHz fast measure stream
+   with a 10 ms device buffer, see pm_sim.h) plus scalar readings,
+   measurement sequences and burst arrays derived from the same signal.
+   Latency, jitter, gaps and the timestamp start (wrap around) come from
+   the PMSimConfig set with PMSimDriver_setConfig or from the PM_SIM_*
+   environment variables (see PMSim_configFromEnv). PM_SIM_DEVICES sets
+   the number of simulated instruments found by findRsrc.
+
+   Power ranges are decades from PM_SIMDRV_POWER_MIN. With auto-ranging
+   off the fast measure stream saturates at the range; a range change
+   interrupts the measurement for PM_SIMDRV_RANGE_SWITCH_US.
+
+   Faults for resilience tests (PMSimDriver_setFaults or the environment):
+   PM_SIM_FAULT_TIMEOUT is the probability of a fast array read failing
+   with VI_ERROR_TMO after PM_SIM_FAULT_TIMEOUT_US; the session stays
+   usable. PM_SIM_FAULT_DISCONNECT_S is the mean time between
+   disconnects of an instrument: its open sessions fail with
+   VI_ERROR_CONN_LOST from then on and init finds no resource for
+   PM_SIM_FAULT_DOWN_MS. A new session starts a new stream whose clock
+   restarts, like an instrument that was power cycled.
+
+   All channels of a simulated instrument see the same sensor. init and
+   close must not run concurrently with other calls; calls on different
+   sessions may run on different threads.
+
+****************************************************************************/
+#ifndef _PM_SIMDRIVER_HEADER_
+#define _PM_SIMDRIVER_HEADER_
+
+#include "../pm_sim.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_SIMDRV_MAX_DEVICES     16
+#define PM_SIMDRV_MAX_SESSIONS    32
+#define PM_SIMDRV_RSRC_FORMAT     "USB0::0x1313::0x8081::SIM%05u::INSTR"
+#define PM_SIMDRV_MODEL           "PM103"
+#define PM_SIMDRV_FIRMWARE        "1.0.0 (simulated)"
+#define PM_SIMDRV_RESPONSE_SIZE   256
+
+#define PM_SIMDRV_RESPONSIVITY    0.5       // A/W of the simulated photodiode
+#define PM_SIMDRV_POWER_MIN       5.0e-9    // W, power range limits
+#define PM_SIMDRV_POWER_MAX       0.5
+#define PM_SIMDRV_RANGE_SWITCH_US 3000      // measurement interruption of a range change
+#define PM_SIMDRV_CURRENT_MIN     5.0e-9    // A, current range limits
+#define PM_SIMDRV_CURRENT_MAX     5.0e-3
+#define PM_SIMDRV_WAVELENGTH_MIN  400.0     // nm
+#define PM_SIMDRV_WAVELENGTH_MAX  1100.0
+#define PM_SIMDRV_PEAK_US         10000     // peak detector search time
+#define PM_SIMDRV_SEQUENCE_POINTS 100       // sequence points per base time unit
+#define PM_SIMDRV_BURST_SAMPLES   100       // raw samples per burst
+#define PM_SIMDRV_BURST_PERIOD_US 1000      // simulated trigger period
+#define PM_SIMDRV_CAL_SETS        5
+#define PM_SIMDRV_CAL_POINTS      8
+
+#define PM_SIMDRV_FAULT_TIMEOUT_US 5000     // a failing read takes this long
+#define PM_SIMDRV_FAULT_DOWN_MS   500       // instrument away after a disconnect
+
+#define PM_SIMDRV_FAST_OFF        0
+#define PM_SIMDRV_FAST_POWER      1
+#define PM_SIMDRV_FAST_CURRENT    2
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViBoolean used;
+	uint32_t  device;             // index in the simulated resource list
+	PMSim     sim;
+	int       fastMode;           // PM_SIMDRV_FAST_*
+	uint64_t  calls;
+	ViBoolean connectionLost;     // instrument disconnected since the session was opened
+	uint32_t  faultRng;           // xorshift state of the injected read timeouts
+
+	// settings
+	ViInt16   powerUnit;
+	ViReal64  wavelength;         // nm
+	ViReal64  beamDiameter;       // mm
+	ViReal64  powerRange;         // W
+	ViReal64  currentRange;       // A
+	ViInt16   powerAutoRange;
+	ViInt16   currentAutoRange;
+	ViBoolean inputFilter;
+	ViUInt16  freqMode;
+	ViInt16   lineFrequency;
+	int64_t   clockOffsetS;       // setTime relative to the host clock
+
+	// pulses for energy readings, one per signal period
+	uint64_t  lastPulse;
+
+	// peak detector and measurement sequence
+	uint64_t  peakEndNs;
+	ViUInt32  seqAveraging;
+	ViBoolean seqStarted;
+	uint64_t  seqStartNs;
+	uint64_t  seqFirst;           // stream index of the first sequence sample
+
+	// burst array
+	ViUInt16  burstChannels;      // bit mask of configured channels
+	ViUInt32  burstInitDelayUs;
+	ViUInt32  burstCount;
+	ViUInt32  burstAveraging;
+	ViBoolean burstRunning;
+	uint64_t  burstStartNs;
+	uint64_t  burstStopNs;
+	uint64_t  burstFirst;
+
+	// power calibration points
+	ViUInt16  calPoints[PM_SIMDRV_CAL_SETS];
+	ViBoolean calState[PM_SIMDRV_CAL_SETS];
+	ViReal64  calWavelengths[PM_SIMDRV_CAL_SETS][PM_SIMDRV_CAL_POINTS];
+	ViReal64  calFactors[PM_SIMDRV_CAL_SETS][PM_SIMDRV_CAL_POINTS];
+	ViChar    calAuthor[PM_SIMDRV_CAL_SETS][PM_SIMDRV_RESPONSE_SIZE];
+
+	// answer to the last query sent by writeRaw
+	ViChar    response[PM_SIMDRV_RESPONSE_SIZE];
+} PMSimInstr;
+
+typedef struct
+{
+	double    timeoutProbability; // per fast array read
+	uint32_t  timeoutUs;          // duration of a failing read
+	double    disconnectMeanSec;  // mean time between disconnects, 0: none
+	uint32_t  downMs;             // time the instrument stays away
+} PMSimFaults;
+
+typedef struct
+{
+	uint64_t  timeouts;           // injected read timeouts, all sessions
+	uint64_t  disconnects;        // injected disconnects, all instruments
+} PMSimFaultStats;
+
+typedef struct
+{
+	uint64_t  calls;              // driver calls on the session
+	uint64_t  produced;           // fast stream samples handed out or lost
+	uint64_t  lost;               // lost to device buffer overruns
+	uint64_t  gapped;             // lost to injected gaps
+} PMSimDriverStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+// Configuration, applies to sessions opened afterwards
+void        PMSimDriver_setConfig(const PMSimConfig *cfg);
+void        PMSimDriver_getConfig(PMSimConfig *cfg);
+void        PMSimDriver_setDeviceCount(uint32_t count);
+uint32_t    PMSimDriver_deviceCount(void);
+void        PMSimDriver_setFaults(const PMSimFaults *faults);
+void        PMSimDriver_getFaults(PMSimFaults *faults);
+void        PMSimDriver_getFaultStats(PMSimFaultStats *stats);
+
+// Resources and sessions
+ViStatus    PMSimDriver_rsrcName(ViUInt32 index, ViChar name[]);
+ViStatus    PMSimDriver_rsrcInfo(ViUInt32 index, ViChar model[], ViChar serial[], ViChar manufacturer[], ViBoolean *available);
+ViStatus    PMSimDriver_open(ViRsrc resource, ViSession *vi);
+ViStatus    PMSimDriver_close(ViSession vi);
+ViStatus    PMSimDriver_call(ViSession vi, PMSimInstr **instr);
+ViStatus    PMSimDriver_getStats(ViSession vi, PMSimDriverStats *stats);
+void        PMSimDriver_errorMessage(ViStatus status, ViChar description[]);
+
+// Instrument behaviour shared by the TLPM and TLPMX entry points
+ViStatus    PMSimInstr_confFastArray(PMSimInstr *instr, int mode);
+ViStatus    PMSimInstr_readFastArray(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[]);
+void        PMSimInstr_setPowerRange(PMSimInstr *instr, ViReal64 power);
+ViReal64    PMSimInstr_power(PMSimInstr *instr);
+ViReal64    PMSimInstr_powerInUnit(PMSimInstr *instr);
+void        PMSimInstr_identification(PMSimInstr *instr, ViChar manufacturer[], ViChar device[], ViChar serial[], ViChar firmware[]);
+ViReal64    PMSimInstr_rangeAttribute(ViInt16 attribute, ViReal64 value, ViReal64 min, ViReal64 max);
+
+ViStatus    PMSimInstr_startSequence(PMSimInstr *instr, ViUInt32 autoTriggerDelay, ViBoolean *triggerForced);
+ViStatus    PMSimInstr_getSequence(PMSimInstr *instr, ViUInt32 baseTime, ViReal32 timeStamps[], ViReal32 values[], ViReal32 values2[]);
+ViStatus    PMSimInstr_startBurst(PMSimInstr *instr);
+ViUInt32    PMSimInstr_burstSamples(PMSimInstr *instr);
+ViStatus    PMSimInstr_getBurst(PMSimInstr *instr, ViUInt32 start, ViUInt32 count, ViUInt32 timeStamps[], ViReal32 values[], ViReal32 values2[]);
+ViStatus    PMSimInstr_writeRaw(PMSimInstr *instr, ViString command);
+
+#endif /* _PM_SIMDRIVER_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
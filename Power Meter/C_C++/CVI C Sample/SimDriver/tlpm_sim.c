@@ -0,0 +1,215 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated TLPM driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_simdriver.h"
+
+#include "TLPM.h"
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+ViStatus _VI_FUNC TLPM_init(ViRsrc resourceName, ViBoolean IDQuery, ViBoolean resetDevice, ViSession *vi)
+{
+	(void)IDQuery;
+	(void)resetDevice;
+	return PMSimDriver_open(resourceName, vi);
+}
+
+
+ViStatus _VI_FUNC TLPM_close(ViSession vi)
+{
+	return PMSimDriver_close(vi);
+}
+
+
+ViStatus _VI_FUNC TLPM_findRsrc(ViSession vi, ViUInt32 *resourceCount)
+{
+	(void)vi;
+	*resourceCount = PMSimDriver_deviceCount();
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPM_getRsrcName(ViSession vi, ViUInt32 index, ViChar resourceName[])
+{
+	(void)vi;
+	return PMSimDriver_rsrcName(index, resourceName);
+}
+
+
+ViStatus _VI_FUNC TLPM_getRsrcInfo(ViSession vi, ViUInt32 index, ViChar modelName[], ViChar serialNumber[], ViChar manufacturer[], ViBoolean *deviceAvailable)
+{
+	(void)vi;
+	return PMSimDriver_rsrcInfo(index, modelName, serialNumber, manufacturer, deviceAvailable);
+}
+
+
+ViStatus _VI_FUNC TLPM_errorMessage(ViSession vi, ViStatus statusCode, ViChar description[])
+{
+	(void)vi;
+	PMSimDriver_errorMessage(statusCode, description);
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPM_identificationQuery(ViSession vi, ViChar manufacturerName[], ViChar deviceName[], ViChar serialNumber[], ViChar firmwareRevision[])
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		PMSimInstr_identification(instr, manufacturerName, deviceName, serialNumber, firmwareRevision);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_setInputFilterState(ViSession vi, ViBoolean inputFilterState)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		instr->inputFilter = inputFilterState;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_setPowerAutoRange(ViSession vi, ViInt16 powerAutorangeMode)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		instr->powerAutoRange = powerAutorangeMode;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_setPowerRange(ViSession vi, ViReal64 power_to_Measure)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		PMSimInstr_setPowerRange(instr, power_to_Measure);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_getPowerRange(ViSession vi, ViInt16 attribute, ViReal64 *powerValue)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		*powerValue = PMSimInstr_rangeAttribute(attribute, instr->powerRange, PM_SIMDRV_POWER_MIN, PM_SIMDRV_POWER_MAX);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_getPowerUnit(ViSession vi, ViInt16 *powerUnit)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		*powerUnit = instr->powerUnit;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_getWavelength(ViSession vi, ViInt16 attribute, ViReal64 *wavelength)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		*wavelength = PMSimInstr_rangeAttribute(attribute, instr->wavelength, PM_SIMDRV_WAVELENGTH_MIN, PM_SIMDRV_WAVELENGTH_MAX);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_setWavelength(ViSession vi, ViReal64 wavelength)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		instr->wavelength = wavelength;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_measPower(ViSession vi, ViReal64 *power)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		*power = PMSimInstr_powerInUnit(instr);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_measCurrent(ViSession vi, ViReal64 *current)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		*current = PMSimInstr_power(instr) * PM_SIMDRV_RESPONSIVITY;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_confPowerFastArrayMeasurement(ViSession vi)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		err = PMSimInstr_confFastArray(instr, PM_SIMDRV_FAST_POWER);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_confCurrentFastArrayMeasurement(ViSession vi)
+{
+	PMSimInstr *instr;
+	ViStatus   err;
+
+	if((err = PMSimDriver_call(vi, &instr)) == VI_SUCCESS)
+		err = PMSimInstr_confFastArray(instr, PM_SIMDRV_FAST_CURRENT);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPM_getNextFastArrayMeasurement(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	return PMSimInstr_readFastArray(vi, count, timestamps, values);
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,850 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated TLPMX driver
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_simdriver.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "TLPMX.h"
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+ViStatus _VI_FUNC TLPMX_init(ViRsrc resourceName, ViBoolean IDQuery, ViBoolean resetDevice, ViSession *vi)
+{
+	(void)IDQuery;
+	(void)resetDevice;
+	return PMSimDriver_open(resourceName, vi);
+}
+
+
+ViStatus _VI_FUNC TLPMX_close(ViSession vi)
+{
+	return PMSimDriver_close(vi);
+}
+
+
+ViStatus _VI_FUNC TLPMX_findRsrc(ViSession vi, ViUInt32 *resourceCount)
+{
+	(void)vi;
+	*resourceCount = PMSimDriver_deviceCount();
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getRsrcName(ViSession vi, ViUInt32 index, ViChar resourceName[])
+{
+	(void)vi;
+	return PMSimDriver_rsrcName(index, resourceName);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getRsrcInfo(ViSession vi, ViUInt32 index, ViChar modelName[], ViChar serialNumber[], ViChar manufacturer[], ViBoolean *deviceAvailable)
+{
+	(void)vi;
+	return PMSimDriver_rsrcInfo(index, modelName, serialNumber, manufacturer, deviceAvailable);
+}
+
+
+ViStatus _VI_FUNC TLPMX_setEnableBthSearch(ViSession vi, ViBoolean enable)
+{
+	(void)vi;
+	(void)enable;
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_errorMessage(ViSession vi, ViStatus statusCode, ViChar description[])
+{
+	(void)vi;
+	PMSimDriver_errorMessage(statusCode, description);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Identification and system
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_identificationQuery(ViSession vi, ViChar manufacturerName[], ViChar deviceName[], ViChar serialNumber[], ViChar firmwareRevision[])
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		PMSimInstr_identification(instr, manufacturerName, deviceName, serialNumber, firmwareRevision);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_revisionQuery(ViSession vi, ViChar instrumentDriverRevision[], ViChar firmwareRevision[])
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS && instrumentDriverRevision != NULL)
+		strcpy(instrumentDriverRevision, PM_SIMDRV_FIRMWARE);
+	if(err == VI_SUCCESS && firmwareRevision != NULL)
+		strcpy(firmwareRevision, PM_SIMDRV_FIRMWARE);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getCalibrationMsg(ViSession vi, ViChar message[], ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		strcpy(message, "Simulated sensor, not calibrated");
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getTime(ViSession vi, ViInt16 *year, ViInt16 *month, ViInt16 *day, ViInt16 *hour, ViInt16 *minute, ViInt16 *second)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	time_t     now;
+	struct tm  *t;
+
+	if(err != VI_SUCCESS)
+		return err;
+
+	now = (time_t)(PMPlat_unixTimeUs() / 1000000 + instr->clockOffsetS);
+	t   = gmtime(&now);
+	*year   = (ViInt16)(t->tm_year + 1900);
+	*month  = (ViInt16)(t->tm_mon + 1);
+	*day    = (ViInt16)t->tm_mday;
+	*hour   = (ViInt16)t->tm_hour;
+	*minute = (ViInt16)t->tm_min;
+	*second = (ViInt16)t->tm_sec;
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setTime(ViSession vi, ViInt16 year, ViInt16 month, ViInt16 day, ViInt16 hour, ViInt16 minute, ViInt16 second)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	int64_t    days, y, m;
+
+	if(err != VI_SUCCESS)
+		return err;
+
+	// days since 1970-01-01 of the proleptic Gregorian calendar (UTC)
+	y = (month <= 2) ? year - 1 : year;
+	m = (month <= 2) ? month + 9 : month - 3;
+	days = 365 * y + y / 4 - y / 100 + y / 400 + (153 * m + 2) / 5 + day - 1 - 719468;
+
+	instr->clockOffsetS = days * 86400 + hour * 3600 + minute * 60 + second
+			- (int64_t)(PMPlat_unixTimeUs() / 1000000);
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getLineFrequency(ViSession vi, ViInt16 *lineFrequency)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		*lineFrequency = instr->lineFrequency;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setLineFrequency(ViSession vi, ViInt16 lineFrequency)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		instr->lineFrequency = lineFrequency;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_writeRaw(ViSession vi, ViString command)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_writeRaw(instr, command);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_readRaw(ViSession vi, ViChar buffer[], ViUInt32 size, ViUInt32 *returnCount)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	size_t     len;
+
+	if(err != VI_SUCCESS)
+		return err;
+	if(instr->response[0] == '\0')
+		return VI_ERROR_TMO;             // nothing was queried
+
+	len = strlen(instr->response);
+	if(len > size)
+		len = size;
+	memcpy(buffer, instr->response, len);
+	if(returnCount != NULL)
+		*returnCount = (ViUInt32)len;
+	instr->response[0] = '\0';
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Sensor
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_getSensorInfo(ViSession vi, ViChar sensorName[], ViChar serialNumber[], ViChar calibrationMessage[], ViInt16 *sensorType, ViInt16 *sensorSubtype, ViInt16 *sensorFlags, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+	strcpy(sensorName, "S120C");
+	sprintf(serialNumber, "SIMS%05u", (unsigned int)instr->device);
+	strcpy(calibrationMessage, "Simulated sensor, not calibrated");
+	*sensorType    = SENSOR_TYPE_PD_SINGLE;
+	*sensorSubtype = 0;
+	*sensorFlags   = 0;
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_reinitSensor(ViSession vi, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+
+	(void)channel;
+	return PMSimDriver_call(vi, &instr);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getSensorPositionAvailable(ViSession vi, ViBoolean *avail, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*avail = VI_FALSE;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBeamDia(ViSession vi, ViInt16 attribute, ViReal64 *beamDiameter, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*beamDiameter = PMSimInstr_rangeAttribute(attribute, instr->beamDiameter, 0.001, 9.5);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setBeamDia(ViSession vi, ViReal64 beamDiameter, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->beamDiameter = beamDiameter;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getWavelength(ViSession vi, ViInt16 attribute, ViReal64 *wavelength, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*wavelength = PMSimInstr_rangeAttribute(attribute, instr->wavelength, PM_SIMDRV_WAVELENGTH_MIN, PM_SIMDRV_WAVELENGTH_MAX);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setWavelength(ViSession vi, ViReal64 wavelength, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->wavelength = wavelength;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPhotodiodeResponsivity(ViSession vi, ViInt16 attribute, ViReal64 *responsivity, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	(void)attribute;
+	if(err == VI_SUCCESS)
+		*responsivity = PM_SIMDRV_RESPONSIVITY;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setFreqMode(ViSession vi, ViUInt16 frequencyMode, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->freqMode = frequencyMode;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setInputFilterState(ViSession vi, ViBoolean inputFilterState, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->inputFilter = inputFilterState;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Power calibration points (user correction tables, PM_SIMDRV_CAL_SETS)
+---------------------------------------------------------------------------*/
+static ViStatus calSet(ViSession vi, ViUInt16 index, PMSimInstr **instr)
+{
+	ViStatus err = PMSimDriver_call(vi, instr);
+
+	if(err == VI_SUCCESS && (index < 1 || index > PM_SIMDRV_CAL_SETS))
+		err = VI_ERROR_INV_OFFSET;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPointsInformation(ViSession vi, ViUInt16 index, ViChar serialNumber[], ViChar calibrationDate[], ViUInt16 *calibrationPointsCount, ViChar author[], ViUInt16 *sensorPosition, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = calSet(vi, index, &instr);
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+	sprintf(serialNumber, "SIMS%05u", (unsigned int)instr->device);
+	strcpy(calibrationDate, "17-Oct-2026");
+	*calibrationPointsCount = instr->calPoints[index - 1];
+	strcpy(author, instr->calAuthor[index - 1]);
+	*sensorPosition = SENSOR_SWITCH_POS_1;
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPointsState(ViSession vi, ViUInt16 index, ViBoolean *state, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = calSet(vi, index, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*state = instr->calState[index - 1];
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerCalibrationPointsState(ViSession vi, ViUInt16 index, ViBoolean state, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = calSet(vi, index, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->calState[index - 1] = state;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerCalibrationPoints(ViSession vi, ViUInt16 index, ViUInt16 pointCounts, ViReal64 wavelengths[], ViReal64 powerCorrectionFactors[], ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = calSet(vi, index, &instr);
+	ViUInt16   i;
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+	if(pointCounts > instr->calPoints[index - 1])
+		return VI_ERROR_INV_OFFSET;
+	for(i = 0; i < pointCounts; i++)
+	{
+		wavelengths[i]            = instr->calWavelengths[index - 1][i];
+		powerCorrectionFactors[i] = instr->calFactors[index - 1][i];
+	}
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerCalibrationPoints(ViSession vi, ViUInt16 index, ViUInt16 pointCounts, ViReal64 wavelengths[], ViReal64 powerCorrectionFactors[], ViChar author[], ViUInt16 sensorPosition, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = calSet(vi, index, &instr);
+	ViUInt16   i;
+
+	(void)channel;
+	(void)sensorPosition;
+	if(err != VI_SUCCESS)
+		return err;
+	if(pointCounts > PM_SIMDRV_CAL_POINTS)
+		return VI_ERROR_USER_BUF;
+	for(i = 0; i < pointCounts; i++)
+	{
+		instr->calWavelengths[index - 1][i] = wavelengths[i];
+		instr->calFactors[index - 1][i]     = powerCorrectionFactors[i];
+	}
+	instr->calPoints[index - 1] = pointCounts;
+	snprintf(instr->calAuthor[index - 1], PM_SIMDRV_RESPONSE_SIZE, "%s", author);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Ranges
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_setPowerAutoRange(ViSession vi, ViInt16 powerAutorangeMode, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->powerAutoRange = powerAutorangeMode;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setPowerRange(ViSession vi, ViReal64 power_to_Measure, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		PMSimInstr_setPowerRange(instr, power_to_Measure);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getPowerRange(ViSession vi, ViInt16 attribute, ViReal64 *powerValue, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*powerValue = PMSimInstr_rangeAttribute(attribute, instr->powerRange, PM_SIMDRV_POWER_MIN, PM_SIMDRV_POWER_MAX);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setCurrentAutoRange(ViSession vi, ViInt16 currentAutorangeMode, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->currentAutoRange = currentAutorangeMode;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_setCurrentRange(ViSession vi, ViReal64 current_to_Measure, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->currentRange = current_to_Measure;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getCurrentRange(ViSession vi, ViInt16 attribute, ViReal64 *currentValue, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*currentValue = PMSimInstr_rangeAttribute(attribute, instr->currentRange, PM_SIMDRV_CURRENT_MIN, PM_SIMDRV_CURRENT_MAX);
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Scalar measurements
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_getPowerUnit(ViSession vi, ViInt16 *powerUnit, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*powerUnit = instr->powerUnit;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measPower(ViSession vi, ViReal64 *power, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*power = PMSimInstr_powerInUnit(instr);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measCurrent(ViSession vi, ViReal64 *current, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*current = PMSimInstr_power(instr) * PM_SIMDRV_RESPONSIVITY;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measEnergy(ViSession vi, ViReal64 *energy, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	uint64_t   pulse;
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+
+	// like a pyroelectric sensor: each pulse can be read once
+	pulse = PMSim_now(&instr->sim) * (uint64_t)instr->sim.cfg.signalFreq / instr->sim.cfg.sampleRate + 1;
+	if(pulse == instr->lastPulse)
+		return VI_ERROR_TMO;
+	instr->lastPulse = pulse;
+	*energy = PMSimInstr_power(instr) * 1.0e-3;      // 1 ms pulses
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measFreq(ViSession vi, ViReal64 *frequency, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*frequency = instr->sim.cfg.signalFreq;
+	return err;
+}
+
+
+// Beam area in cm^2 from the diameter in mm
+static ViReal64 beamArea(PMSimInstr *instr)
+{
+	ViReal64 r = instr->beamDiameter / 20.0;
+
+	return 3.14159265358979323846 * r * r;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measPowerDens(ViSession vi, ViReal64 *powerDensity, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*powerDensity = PMSimInstr_power(instr) / beamArea(instr);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_measEnergyDens(ViSession vi, ViReal64 *energyDensity, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*energyDensity = PMSimInstr_power(instr) * 1.0e-3 / beamArea(instr);
+	return err;
+}
+
+
+// The simulated 4Q sensor sees the spot circling slowly around the center
+ViStatus _VI_FUNC TLPMX_meas4QPositions(ViSession vi, ViReal64 *xPosition, ViReal64 *yPosition, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	double     t;
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+	t = (double)PMPlat_timeNs() * 1.0e-9;
+	*xPosition = 0.5 * cos(t);
+	*yPosition = 0.5 * sin(t);
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_meas4QVoltages(ViSession vi, ViReal64 *voltage1, ViReal64 *voltage2, ViReal64 *voltage3, ViReal64 *voltage4, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+	double     t, x, y, sum;
+
+	(void)channel;
+	if(err != VI_SUCCESS)
+		return err;
+	t   = (double)PMPlat_timeNs() * 1.0e-9;
+	x   = 0.1 * cos(t);
+	y   = 0.1 * sin(t);
+	sum = PMSimInstr_power(instr) * PM_SIMDRV_RESPONSIVITY * 1.0e3;   // V at 1 kOhm
+	*voltage1 = sum * (1.0 + x + y) / 4.0;
+	*voltage2 = sum * (1.0 - x + y) / 4.0;
+	*voltage3 = sum * (1.0 - x - y) / 4.0;
+	*voltage4 = sum * (1.0 + x - y) / 4.0;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Peak detector and measurement sequence
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_startPeakDetector(ViSession vi, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		instr->peakEndNs = PMPlat_timeNs() + (uint64_t)PM_SIMDRV_PEAK_US * 1000;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_isPeakDetectorRunning(ViSession vi, ViBoolean *isRunning, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*isRunning = (PMPlat_timeNs() < instr->peakEndNs) ? VI_TRUE : VI_FALSE;
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_confPowerMeasurementSequence(ViSession vi, ViUInt32 baseTime, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+	{
+		instr->seqAveraging = baseTime ? baseTime : 1;
+		instr->seqStarted   = VI_FALSE;
+	}
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_startMeasurementSequence(ViSession vi, ViUInt32 autoTriggerDelay, ViBoolean *triggerForced, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_startSequence(instr, autoTriggerDelay, triggerForced);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getMeasurementSequence(ViSession vi, ViUInt32 baseTime, ViReal32 timeStamps[], ViReal32 values[], ViReal32 values2[], ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_getSequence(instr, baseTime, timeStamps, values, values2);
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Burst array measurement
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_confBurstArrayMeasPowerChannel(ViSession vi, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err != VI_SUCCESS)
+		return err;
+	if(channel < 1 || channel > 2)
+		return VI_ERROR_INV_SETUP;
+
+	// configuring a channel aborts a running burst
+	instr->burstRunning   = VI_FALSE;
+	instr->burstStartNs   = 0;
+	instr->burstChannels |= (ViUInt16)(1u << (channel - 1));
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_confBurstArrayMeasTrigger(ViSession vi, ViUInt32 trgSource, ViUInt32 initDelay, ViUInt32 burstCount, ViUInt32 averaging)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)trgSource;
+	if(err != VI_SUCCESS)
+		return err;
+	if(averaging == 0 || averaging > PM_SIMDRV_BURST_SAMPLES)
+		return VI_ERROR_INV_SETUP;
+	instr->burstInitDelayUs = initDelay;
+	instr->burstCount       = burstCount;
+	instr->burstAveraging   = averaging;
+	return VI_SUCCESS;
+}
+
+
+ViStatus _VI_FUNC TLPMX_startBurstArrayMeasurement(ViSession vi)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_startBurst(instr);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBurstArraySamplesCount(ViSession vi, ViUInt32 *samplesCount)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		*samplesCount = PMSimInstr_burstSamples(instr);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getBurstArraySamples(ViSession vi, ViUInt32 startIndex, ViUInt32 sampleCount, ViUInt32 timeStamps[], ViReal32 values[], ViReal32 values2[])
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_getBurst(instr, startIndex, sampleCount, timeStamps, values, values2);
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Fast measure stream
+---------------------------------------------------------------------------*/
+ViStatus _VI_FUNC TLPMX_confPowerFastArrayMeasurement(ViSession vi, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_confFastArray(instr, PM_SIMDRV_FAST_POWER);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_confCurrentFastArrayMeasurement(ViSession vi, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		err = PMSimInstr_confFastArray(instr, PM_SIMDRV_FAST_CURRENT);
+	return err;
+}
+
+
+ViStatus _VI_FUNC TLPMX_getNextFastArrayMeasurement(ViSession vi, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[], ViUInt16 channel)
+{
+	(void)channel;
+	return PMSimInstr_readFastArray(vi, count, timestamps, values);
+}
+
+
+ViStatus _VI_FUNC TLPMX_getFastMaxSamplerate(ViSession vi, ViUInt32 *pVal, ViUInt16 channel)
+{
+	PMSimInstr *instr;
+	ViStatus   err = PMSimDriver_call(vi, &instr);
+
+	(void)channel;
+	if(err == VI_SUCCESS)
+		*pVal = instr->sim.cfg.sampleRate;
+	return err;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
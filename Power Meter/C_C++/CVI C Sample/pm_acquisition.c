@@ -0,0 +1,480 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Acquisition engine
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_acquisition.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define CONSUMER_IDLE_US      200
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+
+/*---------------------------------------------------------------------------
+  Wake-up histogram bucket: 0 below 1 us, b covers 2^(b-1) to 2^b us
+---------------------------------------------------------------------------*/
+PM_INLINE uint32_t latencyBucket(uint64_t ns)
+{
+	uint64_t us = ns / 1000;
+	uint32_t bucket = 0;
+
+	while(us > 0 && bucket < PM_ACQ_LATENCY_BUCKETS - 1)
+	{
+		us >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+
+/*---------------------------------------------------------------------------
+  Timing of one poll: wakeNs since it was due, intervalNs since the
+  previous driver call was issued
+---------------------------------------------------------------------------*/
+PM_INLINE void recordLoop(PMAcq *acq, uint64_t wakeNs, uint64_t intervalNs)
+{
+	uint32_t bucket = latencyBucket(wakeNs);
+
+	PMPlat_store64(&acq->wakeHist[bucket], acq->wakeHist[bucket] + 1);
+	PMPlat_store64(&acq->loops, acq->loops + 1);
+	if(wakeNs > acq->maxWakeNs)
+		PMPlat_store64(&acq->maxWakeNs, wakeNs);
+	if(intervalNs > acq->maxIntervalNs)
+		PMPlat_store64(&acq->maxIntervalNs, intervalNs);
+	if(intervalNs > acq->deadlineNs)
+		PMPlat_store64(&acq->deadlineMisses, acq->deadlineMisses + 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Real-time settings of the reader thread itself. The stack below this
+  frame is what the poll loop and the driver run on.
+---------------------------------------------------------------------------*/
+static void enterRealtime(PMAcq *acq)
+{
+	char stack[PM_ACQ_RT_STACK_BYTES];
+
+	if(acq->cpu >= 0)
+		PMPlat_store32((volatile uint32_t*)&acq->pinStatus, (uint32_t)PMPlat_pinThread((uint32_t)acq->cpu));
+	if(acq->rt.priority > 0)
+		PMPlat_store32((volatile uint32_t*)&acq->priorityStatus, (uint32_t)PMPlat_setRealtime(acq->rt.priority));
+	if(acq->rt.lockMemory)
+		PMPlat_prefault(stack, sizeof(stack));
+}
+
+
+/*---------------------------------------------------------------------------
+  Reader thread: the poll loop. Nothing in here may block.
+---------------------------------------------------------------------------*/
+static void readerThread(void *arg)
+{
+	PMAcq       *acq = (PMAcq*)arg;
+	ViStatus    err = VI_SUCCESS;
+	uint64_t    sequence = 0;
+	uint64_t    loopNs = 0;
+	uint64_t    lastStartNs = 0, dueNs = 0;
+
+	if(acq->realtime)
+		enterRealtime(acq);
+
+	while(PMPlat_load32(&acq->running))
+	{
+		PMFastBlock *slot = NULL;
+		PMFastBlock *block;
+		ViUInt16    count = 0;
+		uint64_t    startNs, endNs;
+		uint32_t    i;
+
+		PM_TRACE_INTERVAL(PM_TRACE_POLL_LOOP, loopNs);
+
+		// With a single consumer the driver writes straight into the ring slot
+		if(acq->consumerCount == 1)
+			slot = PMRing_beginWrite(&acq->consumers[0].ring);
+		block = (slot != NULL) ? slot : &acq->staging;
+
+		startNs = PMPlat_timeNs();
+		err = acq->source.readBlock(acq->source.source, &count, block->timestamps, block->values);
+		endNs = PMPlat_timeNs();
+		if(dueNs != 0)
+			recordLoop(acq, (startNs > dueNs) ? startNs - dueNs : 0, startNs - lastStartNs);
+		lastStartNs = startNs;
+		dueNs       = endNs;      // the next poll is due right away
+		if(err != VI_SUCCESS)
+			break;
+
+		if(count == 0)
+		{
+			PMPlat_store64(&acq->emptyPolls, acq->emptyPolls + 1);
+			if(acq->pollNs != 0)
+			{
+				dueNs = startNs + acq->pollNs;
+				PMPlat_sleepUntilNs(dueNs);
+			}
+			continue;
+		}
+		if(count > PM_FAST_BLOCK_SIZE)
+			count = PM_FAST_BLOCK_SIZE;
+
+		block->count      = count;
+		block->sequence   = sequence++;
+		block->hostTimeNs = endNs;
+
+		if(slot != NULL)
+		{
+			PMRing_endWrite(&acq->consumers[0].ring);
+		}
+		else if(acq->consumerCount == 1)
+		{
+			PMRing_drop(&acq->consumers[0].ring);
+		}
+		else if(acq->consumerCount > 1)
+		{
+			for(i = 0; i < acq->consumerCount; i++)
+			{
+				PMRing      *ring = &acq->consumers[i].ring;
+				PMFastBlock *dst  = PMRing_beginWrite(ring);
+
+				if(dst == NULL)
+				{
+					PMRing_drop(ring);
+					continue;
+				}
+				dst->sequence   = block->sequence;
+				dst->hostTimeNs = block->hostTimeNs;
+				dst->count      = count;
+				memcpy(dst->timestamps, block->timestamps, count * sizeof(ViUInt32));
+				memcpy(dst->values,     block->values,     count * sizeof(ViReal32));
+				PMRing_endWrite(ring);
+			}
+		}
+
+		PMPlat_store64(&acq->blocksRead,  acq->blocksRead + 1);
+		PMPlat_store64(&acq->samplesRead, acq->samplesRead + count);
+	}
+
+	acq->readerStatus = err;
+	PMPlat_store64(&acq->stopNs, PMPlat_timeNs());
+	PMPlat_store32(&acq->running, 0);
+	PMPlat_store32(&acq->readerDone, 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Consumer thread: drain the ring until the reader finished and it is empty
+---------------------------------------------------------------------------*/
+static void consumerThread(void *arg)
+{
+	PMAcqConsumer *consumer = (PMAcqConsumer*)arg;
+
+	for(;;)
+	{
+		PMFastBlock *block = PMRing_beginRead(&consumer->ring);
+
+		if(block == NULL)
+		{
+			if(!PMPlat_load32(&consumer->engine->readerDone))
+			{
+				PMPlat_sleepUs(CONSUMER_IDLE_US);
+				continue;
+			}
+			// reader finished; take whatever was published before it stopped
+			block = PMRing_beginRead(&consumer->ring);
+			if(block == NULL)
+				break;
+		}
+
+		PM_TRACE_TIMED(PM_TRACE_PROCESS, consumer->func(consumer->ctx, block));
+		PMRing_endRead(&consumer->ring);
+		PMPlat_store64(&consumer->consumed, consumer->consumed + 1);
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Prepare an engine for the given block source
+---------------------------------------------------------------------------*/
+void PMAcq_init(PMAcq *acq, PMBlockSource source, uint32_t ringCapacity)
+{
+	memset(acq, 0, sizeof(PMAcq));
+	acq->source       = source;
+	acq->ringCapacity = (ringCapacity > 0) ? ringCapacity : PM_ACQ_DEFAULT_RING_SIZE;
+	acq->deadlineNs   = (uint64_t)PM_ACQ_DEADLINE_US * 1000;
+	acq->cpu          = PM_ACQ_CPU_NONE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Register a consumer. Must be called before PMAcq_start.
+---------------------------------------------------------------------------*/
+ViStatus PMAcq_addConsumer(PMAcq *acq, const char *name, PMConsumerFunc func, void *ctx)
+{
+	PMAcqConsumer *consumer;
+	ViStatus      err;
+
+	if(acq->started || acq->consumerCount >= PM_ACQ_MAX_CONSUMERS || func == NULL)
+		return VI_ERROR_INV_SETUP;
+
+	consumer = &acq->consumers[acq->consumerCount];
+	if((err = PMRing_init(&consumer->ring, acq->ringCapacity)))
+		return err;
+
+	consumer->name   = name;
+	consumer->func   = func;
+	consumer->ctx    = ctx;
+	consumer->engine = acq;
+	acq->consumerCount++;
+	return VI_SUCCESS;
+}
+
+
+void PMAcq_defaultRealtime(PMAcqRealtime *rt)
+{
+	memset(rt, 0, sizeof(PMAcqRealtime));
+	rt->priority   = PM_ACQ_RT_PRIORITY;
+	rt->cpu        = PM_ACQ_CPU_ISOLATED;
+	rt->lockMemory = VI_TRUE;
+	rt->deadlineUs = PM_ACQ_DEADLINE_US;
+}
+
+
+/*---------------------------------------------------------------------------
+  Run the reader in real-time mode. Must be called before PMAcq_start.
+---------------------------------------------------------------------------*/
+ViStatus PMAcq_setRealtime(PMAcq *acq, const PMAcqRealtime *rt)
+{
+	if(acq->started)
+		return VI_ERROR_INV_SETUP;
+
+	acq->rt         = *rt;
+	acq->realtime   = VI_TRUE;
+	acq->deadlineNs = (uint64_t)((rt->deadlineUs > 0) ? rt->deadlineUs : PM_ACQ_DEADLINE_US) * 1000;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Process wide part of the real-time mode: lock the memory and touch every
+  page the reader writes before it starts
+---------------------------------------------------------------------------*/
+static void prepareRealtime(PMAcq *acq)
+{
+	uint32_t i;
+
+	acq->cpu = (acq->rt.cpu == PM_ACQ_CPU_ISOLATED) ? PMPlat_isolatedCpu() : acq->rt.cpu;
+	if(acq->rt.pollUs != 0)
+		acq->pollNs = (uint64_t)acq->rt.pollUs * 1000;
+	else if(acq->cpu < 0)
+		acq->pollNs = (uint64_t)PM_ACQ_RT_POLL_US * 1000;
+	if(!acq->rt.lockMemory)
+		return;
+
+	acq->lockStatus = PMPlat_lockMemory();
+	for(i = 0; i < acq->consumerCount; i++)
+		PMPlat_prefault(acq->consumers[i].ring.slots, acq->consumers[i].ring.capacity * sizeof(PMFastBlock));
+	PMPlat_prefault(&acq->staging, sizeof(PMFastBlock));
+}
+
+
+/*---------------------------------------------------------------------------
+  Start consumer threads first, then the reader thread
+---------------------------------------------------------------------------*/
+ViStatus PMAcq_start(PMAcq *acq)
+{
+	ViStatus err;
+	uint32_t i;
+
+	if(acq->started)
+		return VI_ERROR_INV_SETUP;
+
+	acq->running      = 1;
+	acq->readerDone   = 0;
+	acq->readerStatus = VI_SUCCESS;
+	acq->startNs      = PMPlat_timeNs();
+	if(acq->realtime)
+		prepareRealtime(acq);
+
+	for(i = 0; i < acq->consumerCount; i++)
+	{
+		if((err = PMPlat_threadCreate(&acq->consumers[i].thread, consumerThread, &acq->consumers[i])))
+		{
+			// let the consumers started so far run dry and exit
+			acq->running = 0;
+			PMPlat_store32(&acq->readerDone, 1);
+			while(i-- > 0)
+				PMPlat_threadJoin(acq->consumers[i].thread);
+			return err;
+		}
+	}
+
+	if((err = PMPlat_threadCreate(&acq->reader, readerThread, acq)))
+	{
+		acq->running = 0;
+		PMPlat_store32(&acq->readerDone, 1);
+		for(i = 0; i < acq->consumerCount; i++)
+			PMPlat_threadJoin(acq->consumers[i].thread);
+		return err;
+	}
+
+	acq->started = 1;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Stop the reader, let every consumer drain its ring and join all threads.
+  Returns the status that ended the reader (VI_SUCCESS on a regular stop).
+---------------------------------------------------------------------------*/
+ViStatus PMAcq_stop(PMAcq *acq)
+{
+	uint32_t i;
+
+	if(!acq->started)
+		return acq->readerStatus;
+
+	PMPlat_store32(&acq->running, 0);
+	PMPlat_threadJoin(acq->reader);
+	for(i = 0; i < acq->consumerCount; i++)
+		PMPlat_threadJoin(acq->consumers[i].thread);
+
+	acq->started = 0;
+	return acq->readerStatus;
+}
+
+
+/*---------------------------------------------------------------------------
+  VI_FALSE once the reader stopped, either by PMAcq_stop or by an error
+---------------------------------------------------------------------------*/
+ViBoolean PMAcq_isRunning(PMAcq *acq)
+{
+	return PMPlat_load32(&acq->running) ? VI_TRUE : VI_FALSE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Snapshot of the counters. Safe to call while the engine is running.
+---------------------------------------------------------------------------*/
+void PMAcq_getStats(PMAcq *acq, PMAcqStats *stats)
+{
+	uint64_t endNs, below = 0;
+	uint32_t i;
+
+	memset(stats, 0, sizeof(PMAcqStats));
+	stats->blocksRead    = PMPlat_load64(&acq->blocksRead);
+	stats->samplesRead   = PMPlat_load64(&acq->samplesRead);
+	stats->emptyPolls    = PMPlat_load64(&acq->emptyPolls);
+	stats->readerStatus  = acq->readerStatus;
+	stats->consumerCount = acq->consumerCount;
+
+	endNs = PMPlat_load32(&acq->readerDone) ? PMPlat_load64(&acq->stopNs) : PMPlat_timeNs();
+	stats->elapsedSec = (acq->startNs != 0) ? (double)(endNs - acq->startNs) * 1.0e-9 : 0.0;
+
+	for(i = 0; i < acq->consumerCount; i++)
+	{
+		PMAcqConsumer      *consumer = &acq->consumers[i];
+		PMAcqConsumerStats *cs = &stats->consumer[i];
+
+		cs->name      = consumer->name;
+		cs->consumed  = PMPlat_load64(&consumer->consumed);
+		cs->overflows = PMPlat_load64(&consumer->ring.overflows);
+		cs->fill      = PMRing_fill(&consumer->ring);
+		cs->highWater = PMPlat_load32(&consumer->ring.highWater);
+		cs->capacity  = consumer->ring.capacity;
+	}
+
+	stats->loops          = PMPlat_load64(&acq->loops);
+	stats->deadlineMisses = PMPlat_load64(&acq->deadlineMisses);
+	stats->deadlineUs     = (uint32_t)(acq->deadlineNs / 1000);
+	stats->maxWakeUs      = (double)PMPlat_load64(&acq->maxWakeNs) / 1000.0;
+	stats->maxIntervalUs  = (double)PMPlat_load64(&acq->maxIntervalNs) / 1000.0;
+	for(i = 0; i < PM_ACQ_LATENCY_BUCKETS; i++)
+	{
+		stats->wakeHist[i] = PMPlat_load64(&acq->wakeHist[i]);
+		below += stats->wakeHist[i];
+		if(stats->wakeP99Us == 0.0 && stats->loops > 0 && (double)below >= 0.99 * (double)stats->loops)
+			stats->wakeP99Us = (double)(1ull << i);
+	}
+
+	stats->realtime       = acq->realtime;
+	stats->priority       = acq->rt.priority;
+	stats->cpu            = acq->cpu;
+	stats->pollUs         = (uint32_t)(acq->pollNs / 1000);
+	stats->lockStatus     = acq->lockStatus;
+	stats->pinStatus      = (ViStatus)PMPlat_load32((volatile uint32_t*)&acq->pinStatus);
+	stats->priorityStatus = (ViStatus)PMPlat_load32((volatile uint32_t*)&acq->priorityStatus);
+}
+
+
+void PMAcq_printStats(const PMAcqStats *stats)
+{
+	uint32_t i;
+
+	printf("Reader: %llu blocks, %llu samples in %.3f s (%.0f S/s), %llu empty polls, status 0x%08X\n",
+			(unsigned long long)stats->blocksRead, (unsigned long long)stats->samplesRead, stats->elapsedSec,
+			(stats->elapsedSec > 0.0) ? (double)stats->samplesRead / stats->elapsedSec : 0.0,
+			(unsigned long long)stats->emptyPolls, (unsigned int)stats->readerStatus);
+
+	for(i = 0; i < stats->consumerCount; i++)
+	{
+		const PMAcqConsumerStats *cs = &stats->consumer[i];
+
+		printf("  %-12s consumed %llu, overflow %llu, fill %u/%u, high water %u\n",
+				cs->name ? cs->name : "?", (unsigned long long)cs->consumed, (unsigned long long)cs->overflows,
+				(unsigned int)cs->fill, (unsigned int)cs->capacity, (unsigned int)cs->highWater);
+	}
+
+	if(stats->loops > 0)
+		printf("  poll loop    wake-up max %.1f us, p99 < %.0f us, interval max %.3f ms, %llu deadline misses (> %u us)\n",
+				stats->maxWakeUs, stats->wakeP99Us, stats->maxIntervalUs / 1000.0,
+				(unsigned long long)stats->deadlineMisses, (unsigned int)stats->deadlineUs);
+	if(stats->realtime)
+		printf("  real-time    priority %d (0x%08X), CPU %d (0x%08X), memory lock 0x%08X, poll period %u us\n", stats->priority,
+				(unsigned int)stats->priorityStatus, stats->cpu, (unsigned int)stats->pinStatus,
+				(unsigned int)stats->lockStatus, (unsigned int)stats->pollUs);
+}
+
+
+/*---------------------------------------------------------------------------
+  Release the rings. The engine must be stopped.
+---------------------------------------------------------------------------*/
+void PMAcq_free(PMAcq *acq)
+{
+	uint32_t i;
+
+	if(acq->started)
+		PMAcq_stop(acq);
+	for(i = 0; i < acq->consumerCount; i++)
+		PMRing_free(&acq->consumers[i].ring);
+	acq->consumerCount = 0;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,200 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Acquisition engine
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   The device buffers only 10 ms of the 100 kHz fast measure stream. The
+   engine therefore runs the poll loop on a dedicated reader thread that
+   does nothing but fetch blocks and push them into one PMRing per
+   consumer. Every consumer (processing, storage, ...) runs on its own
+   thread and can never stall the reader; a slow consumer only loses
+   blocks in its own ring, which is reported as overflow.
+
+   The reader measures its own timing: the wake-up latency (time between
+   the end of one driver call and the start of the next, spent elsewhere
+   or preempted) as a histogram, and the poll interval against the
+   deadline - the 10 ms the device can buffer. A longer interval is a
+   deadline miss and likely lost samples.
+
+   PMAcq_setRealtime is the opt-in real-time mode for Linux hosts: the
+   reader is pinned to an isolated core, runs with SCHED_FIFO priority,
+   the process memory is mlock'ed and the rings, the staging block and
+   the reader stack are pre-faulted before the first poll. On its own
+   core the loop busy polls: it allocates nothing and makes no system
+   call besides the driver I/O (the clock is read through the vDSO).
+   Without a core of its own a SCHED_FIFO busy loop would starve the
+   consumers, so the reader then polls every pollUs instead and sleeps
+   to the absolute wake-up time in between; the wake-up latency is then
+   measured against that time. Settings that fail, usually for lack of
+   CAP_SYS_NICE / rtprio and memlock limits, are reported in the
+   statistics and the reader runs without them.
+
+****************************************************************************/
+#ifndef _PM_ACQUISITION_HEADER_
+#define _PM_ACQUISITION_HEADER_
+
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_ACQ_MAX_CONSUMERS      8
+#define PM_ACQ_DEFAULT_RING_SIZE  256    // blocks, ~0.5 s of stream at 100 kHz
+#define PM_ACQ_DEADLINE_US        10000  // device buffer length
+#define PM_ACQ_LATENCY_BUCKETS    20     // wake-up histogram: < 1 us, then powers of two up to 0.5 s
+
+// Real-time mode
+#define PM_ACQ_RT_PRIORITY        80
+#define PM_ACQ_CPU_NONE           (-1)   // reader not pinned
+#define PM_ACQ_CPU_ISOLATED       (-2)   // first isolated CPU, not pinned if there is none
+#define PM_ACQ_RT_STACK_BYTES     65536  // reader stack pre-faulted
+#define PM_ACQ_RT_POLL_US         1000   // poll period of a reader without a core of its own
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Fetch the next block of the fast measure stream. Same contract as
+// TLPM_getNextFastArrayMeasurement: count = 0 means no new data yet.
+typedef ViStatus (*PMReadBlockFunc)(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[]);
+
+typedef struct
+{
+	PMReadBlockFunc   readBlock;
+	void              *source;
+} PMBlockSource;
+
+typedef struct
+{
+	int               priority;       // SCHED_FIFO priority of the reader, 0: normal scheduling
+	int               cpu;            // reader CPU, PM_ACQ_CPU_ISOLATED or PM_ACQ_CPU_NONE
+	ViBoolean         lockMemory;     // mlockall and pre-fault the rings
+	uint32_t          deadlineUs;     // longest poll interval without data loss
+	uint32_t          pollUs;         // sleep to the next poll after an empty one, 0: busy poll if pinned
+} PMAcqRealtime;
+
+// Called on the consumer thread for every block in stream order
+typedef void (*PMConsumerFunc)(void *ctx, const PMFastBlock *block);
+
+typedef struct
+{
+	const char        *name;
+	PMConsumerFunc    func;
+	void              *ctx;
+	PMRing            ring;
+	PMThread          thread;
+	volatile uint64_t consumed;
+	struct PMAcq      *engine;
+} PMAcqConsumer;
+
+typedef struct PMAcq
+{
+	PMBlockSource     source;
+	PMAcqConsumer     consumers[PM_ACQ_MAX_CONSUMERS];
+	uint32_t          consumerCount;
+	uint32_t          ringCapacity;
+
+	PMThread          reader;
+	uint32_t          started;
+	volatile uint32_t running;
+	volatile uint32_t readerDone;
+	volatile ViStatus readerStatus;
+
+	volatile uint64_t blocksRead;
+	volatile uint64_t samplesRead;
+	volatile uint64_t emptyPolls;
+	uint64_t          startNs;
+	volatile uint64_t stopNs;
+
+	// Poll loop timing, written by the reader
+	uint64_t          deadlineNs;
+	volatile uint64_t loops;
+	volatile uint64_t deadlineMisses;
+	volatile uint64_t maxWakeNs;
+	volatile uint64_t maxIntervalNs;
+	volatile uint64_t wakeHist[PM_ACQ_LATENCY_BUCKETS];
+
+	// Real-time mode
+	ViBoolean         realtime;
+	PMAcqRealtime     rt;
+	int               cpu;            // resolved reader CPU
+	uint64_t          pollNs;         // resolved poll period, 0: busy poll
+	ViStatus          lockStatus;
+	volatile ViStatus pinStatus;
+	volatile ViStatus priorityStatus;
+
+	PMFastBlock       staging;
+} PMAcq;
+
+typedef struct
+{
+	const char        *name;
+	uint64_t          consumed;
+	uint64_t          overflows;      // blocks this consumer lost because its ring was full
+	uint32_t          fill;
+	uint32_t          highWater;
+	uint32_t          capacity;
+} PMAcqConsumerStats;
+
+typedef struct
+{
+	uint64_t          blocksRead;
+	uint64_t          samplesRead;
+	uint64_t          emptyPolls;
+	double            elapsedSec;
+	ViStatus          readerStatus;
+	uint32_t          consumerCount;
+	PMAcqConsumerStats consumer[PM_ACQ_MAX_CONSUMERS];
+
+	uint64_t          loops;
+	uint64_t          deadlineMisses;  // poll intervals longer than deadlineUs
+	uint32_t          deadlineUs;
+	double            maxWakeUs;
+	double            wakeP99Us;       // upper bound of the histogram bucket
+	double            maxIntervalUs;
+	uint64_t          wakeHist[PM_ACQ_LATENCY_BUCKETS];
+
+	ViBoolean         realtime;
+	int               priority;
+	int               cpu;
+	uint32_t          pollUs;
+	ViStatus          lockStatus;
+	ViStatus          pinStatus;
+	ViStatus          priorityStatus;
+} PMAcqStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void          PMAcq_init(PMAcq *acq, PMBlockSource source, uint32_t ringCapacity);
+ViStatus      PMAcq_addConsumer(PMAcq *acq, const char *name, PMConsumerFunc func, void *ctx);
+void          PMAcq_defaultRealtime(PMAcqRealtime *rt);
+ViStatus      PMAcq_setRealtime(PMAcq *acq, const PMAcqRealtime *rt);
+ViStatus      PMAcq_start(PMAcq *acq);
+ViStatus      PMAcq_stop(PMAcq *acq);
+ViBoolean     PMAcq_isRunning(PMAcq *acq);
+void          PMAcq_getStats(PMAcq *acq, PMAcqStats *stats);
+void          PMAcq_printStats(const PMAcqStats *stats);
+void          PMAcq_free(PMAcq *acq);
+
+#endif /* _PM_ACQUISITION_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,339 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Asynchronous measurements
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_async.h"
+
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define QUEUE_MASK            (PM_ASYNC_QUEUE_SIZE - 1)
+#define IO_IDLE_US            200
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMAsync_init(PMAsync *async, ViSession session)
+{
+	uint32_t i;
+
+	memset(async, 0, sizeof(PMAsync));
+	async->session         = session;
+	async->retryIntervalUs = PM_ASYNC_RETRY_INTERVAL_US;
+	async->nextId          = 1;
+	for(i = 0; i < PM_ASYNC_QUEUE_SIZE; i++)
+		async->queue[i].seq = i;
+}
+
+
+const char *PMAsync_opName(int op)
+{
+	switch(op)
+	{
+		case PM_ASYNC_POWER:         return "power";
+		case PM_ASYNC_ENERGY:        return "energy";
+		case PM_ASYNC_FREQUENCY:     return "frequency";
+		case PM_ASYNC_POWER_DENSITY: return "power density";
+		case PM_ASYNC_4Q_POSITIONS:  return "4Q positions";
+		default:                     return "unknown";
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Queue a request; safe from any thread including completion callbacks.
+  timeoutUs = 0 selects PM_ASYNC_DEFAULT_TIMEOUT_US.
+---------------------------------------------------------------------------*/
+ViStatus PMAsync_submit(PMAsync *async, int op, ViUInt16 channel, uint32_t timeoutUs,
+                        PMAsyncFunc func, void *ctx, uint64_t *id)
+{
+	PMAsyncRequest *slot;
+	uint64_t       pos, now;
+
+	if(op < PM_ASYNC_POWER || op > PM_ASYNC_4Q_POSITIONS)
+		return VI_ERROR_NSUP_OPER;
+
+	// announced before running is checked, so PMAsync_stop waits for this request to be published
+	PMPlat_fetchAdd32(&async->submitting, 1);
+	PMPlat_fence();
+	if(async->started && !PMPlat_load32(&async->running))
+	{
+		PMPlat_fetchAdd32(&async->submitting, (uint32_t)-1);
+		return VI_ERROR_ABORT;
+	}
+
+	// claim a slot (bounded MPMC queue after D. Vyukov, single consumer)
+	pos = PMPlat_load64(&async->tail);
+	for(;;)
+	{
+		int64_t diff;
+
+		slot = &async->queue[pos & QUEUE_MASK];
+		diff = (int64_t)(PMPlat_load64(&slot->seq) - pos);
+		if(diff == 0)
+		{
+			if(PMPlat_cas64(&async->tail, pos, pos + 1))
+				break;
+			pos = PMPlat_load64(&async->tail);
+		}
+		else if(diff < 0)
+		{
+			PMPlat_fetchAdd32(&async->submitting, (uint32_t)-1);
+			return VI_ERROR_QUEUE_OVERFLOW;
+		}
+		else
+			pos = PMPlat_load64(&async->tail);
+	}
+
+	now = PMPlat_timeNs();
+	slot->op         = op;
+	slot->channel    = channel;
+	slot->id         = PMPlat_fetchAdd64(&async->nextId, 1);
+	slot->submitNs   = now;
+	slot->deadlineNs = now + (uint64_t)(timeoutUs ? timeoutUs : PM_ASYNC_DEFAULT_TIMEOUT_US) * 1000;
+	slot->nextTryNs  = now;
+	slot->attempts   = 0;
+	slot->func       = func;
+	slot->ctx        = ctx;
+	if(id != NULL)
+		*id = slot->id;
+
+	PMPlat_fetchAdd64(&async->submitted, 1);
+	PMPlat_store64(&slot->seq, pos + 1);    // publish
+	PMPlat_fetchAdd32(&async->submitting, (uint32_t)-1);
+	return VI_SUCCESS;
+}
+
+
+static ViBoolean dequeue(PMAsync *async, PMAsyncRequest *req)
+{
+	PMAsyncRequest *slot = &async->queue[async->head & QUEUE_MASK];
+
+	if(PMPlat_load64(&slot->seq) != async->head + 1)
+		return VI_FALSE;
+	*req = *slot;
+	PMPlat_store64(&slot->seq, async->head + PM_ASYNC_QUEUE_SIZE);
+	async->head++;
+	return VI_TRUE;
+}
+
+
+static void complete(PMAsync *async, const PMAsyncRequest *req, PMAsyncResult *res, ViStatus status)
+{
+	res->op        = req->op;
+	res->id        = req->id;
+	res->status    = status;
+	res->attempts  = req->attempts;
+	res->latencyNs = PMPlat_timeNs() - req->submitNs;
+	if(status == VI_ERROR_TMO)
+		PMPlat_fetchAdd64(&async->timeouts, 1);
+	PMPlat_fetchAdd64(&async->completed, 1);
+	if(req->func != NULL)
+		req->func(req->ctx, res);
+}
+
+
+static ViStatus measure(PMAsync *async, PMAsyncRequest *req, PMAsyncResult *res)
+{
+	ViSession vi = async->session;
+	ViStatus  err = VI_ERROR_NSUP_OPER;
+
+	memset(res, 0, sizeof(PMAsyncResult));
+	req->attempts++;
+	switch(req->op)
+	{
+		case PM_ASYNC_POWER:
+			PM_TRACE_CALL(PM_TRACE_MEAS_POWER, err, TLPMX_measPower(vi, &res->value, req->channel));
+			break;
+		case PM_ASYNC_ENERGY:
+			PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measEnergy(vi, &res->value, req->channel));
+			break;
+		case PM_ASYNC_FREQUENCY:
+			PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measFreq(vi, &res->value, req->channel));
+			break;
+		case PM_ASYNC_POWER_DENSITY:
+			PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measPowerDens(vi, &res->value, req->channel));
+			break;
+		case PM_ASYNC_4Q_POSITIONS:
+			PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_meas4QPositions(vi, &res->value, &res->value2, req->channel));
+			break;
+	}
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Run one attempt. Returns VI_TRUE if the request is finished, VI_FALSE if
+  it has to be retried later.
+---------------------------------------------------------------------------*/
+static ViBoolean attempt(PMAsync *async, PMAsyncRequest *req)
+{
+	PMAsyncResult res;
+	ViStatus      err;
+	uint64_t      intervalNs = (uint64_t)async->retryIntervalUs * 1000;
+
+	if(PMPlat_timeNs() >= req->deadlineNs)
+	{
+		memset(&res, 0, sizeof(PMAsyncResult));
+		complete(async, req, &res, VI_ERROR_TMO);
+		return VI_TRUE;
+	}
+
+	err = measure(async, req, &res);
+
+	// only energy readings wait for an event (the next pulse); real errors
+	// such as a lost connection or a missing sensor complete right away
+	if(err == PM_ASYNC_NO_PULSE && req->op == PM_ASYNC_ENERGY && PMPlat_load32(&async->running))
+	{
+		req->nextTryNs = PMPlat_timeNs() + intervalNs;
+		if(req->nextTryNs < req->deadlineNs)
+			return VI_FALSE;
+		err = VI_ERROR_TMO;
+	}
+
+	complete(async, req, &res, err);
+	return VI_TRUE;
+}
+
+
+/*---------------------------------------------------------------------------
+  I/O thread: serve new requests in order, interleaved with due retries
+---------------------------------------------------------------------------*/
+static void ioThread(void *arg)
+{
+	PMAsync        *async = (PMAsync*)arg;
+	PMAsyncRequest req;
+	PMAsyncResult  res;
+	uint32_t       i;
+
+	while(PMPlat_load32(&async->running))
+	{
+		ViBoolean busy = VI_FALSE;
+		uint64_t  now;
+
+		// new requests; one whose retry list is full waits in the queue
+		while(async->retryCount < PM_ASYNC_MAX_RETRIES && dequeue(async, &req))
+		{
+			busy = VI_TRUE;
+			if(!attempt(async, &req))
+			{
+				async->retry[async->retryCount++] = req;
+				PMPlat_fetchAdd64(&async->retries, 1);
+			}
+		}
+
+		now = PMPlat_timeNs();
+		for(i = 0; i < async->retryCount; )
+		{
+			if(async->retry[i].nextTryNs > now && async->retry[i].deadlineNs > now)
+			{
+				i++;
+				continue;
+			}
+			busy = VI_TRUE;
+			if(attempt(async, &async->retry[i]))
+				async->retry[i] = async->retry[--async->retryCount];
+			else
+			{
+				PMPlat_fetchAdd64(&async->retries, 1);
+				i++;
+			}
+		}
+
+		if(!busy)
+			PMPlat_sleepUs(IO_IDLE_US);
+	}
+
+	// stopped: everything still open completes with VI_ERROR_ABORT
+	memset(&res, 0, sizeof(PMAsyncResult));
+	for(i = 0; i < async->retryCount; i++)
+		complete(async, &async->retry[i], &res, VI_ERROR_ABORT);
+	async->retryCount = 0;
+	while(dequeue(async, &req))
+		complete(async, &req, &res, VI_ERROR_ABORT);
+}
+
+
+ViStatus PMAsync_start(PMAsync *async)
+{
+	ViStatus err;
+
+	if(async->started)
+		return VI_ERROR_INV_SETUP;
+
+	PMPlat_store32(&async->running, 1);
+	if((err = PMPlat_threadCreate(&async->thread, ioThread, async)) != VI_SUCCESS)
+	{
+		PMPlat_store32(&async->running, 0);
+		return err;
+	}
+	async->started = 1;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Stop the I/O thread. Requests not finished yet complete with
+  VI_ERROR_ABORT before this returns; those submitted while the I/O
+  thread was draining complete on the calling thread.
+---------------------------------------------------------------------------*/
+ViStatus PMAsync_stop(PMAsync *async)
+{
+	PMAsyncRequest req;
+	PMAsyncResult  res;
+
+	if(!async->started)
+		return VI_SUCCESS;
+
+	PMPlat_store32(&async->running, 0);
+	PMPlat_fence();
+	PMPlat_threadJoin(async->thread);
+
+	// submits that saw running before it was cleared publish their request before they return
+	while(PMPlat_load32(&async->submitting) != 0)
+		PMPlat_yield();
+	memset(&res, 0, sizeof(PMAsyncResult));
+	while(dequeue(async, &req))
+		complete(async, &req, &res, VI_ERROR_ABORT);
+	return VI_SUCCESS;
+}
+
+
+void PMAsync_getStats(PMAsync *async, PMAsyncStats *stats)
+{
+	memset(stats, 0, sizeof(PMAsyncStats));
+	stats->submitted = PMPlat_load64(&async->submitted);
+	stats->completed = PMPlat_load64(&async->completed);
+	stats->timeouts  = PMPlat_load64(&async->timeouts);
+	stats->retries   = PMPlat_load64(&async->retries);
+	stats->pending   = stats->submitted - stats->completed;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
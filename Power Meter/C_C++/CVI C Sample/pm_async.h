@@ -0,0 +1,142 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Asynchronous measurements
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Non-blocking access to the TLPMX scalar measurements. A PMAsync
+   executor owns one session and runs its driver calls on an I/O thread;
+   callers submit requests from any thread and get a completion callback
+   with the result, the status and the latency. Energy requests that
+   fail because no pulse arrived since the last reading (the driver call
+   times out, PM_ASYNC_NO_PULSE) are retried every retryIntervalUs
+   without holding up the other requests of the session, until their
+   timeout expires. Every other status completes the request at once.
+
+   The driver call itself cannot be interrupted: the timeout is checked
+   before every attempt, a reading that arrives after it is still
+   delivered with its own status.
+
+****************************************************************************/
+#ifndef _PM_ASYNC_HEADER_
+#define _PM_ASYNC_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_ASYNC_QUEUE_SIZE           64        // power of two
+#define PM_ASYNC_MAX_RETRIES          16        // requests waiting for a retry at a time
+#define PM_ASYNC_DEFAULT_TIMEOUT_US   10000000
+#define PM_ASYNC_RETRY_INTERVAL_US    20000
+#define PM_ASYNC_NO_PULSE             VI_ERROR_TMO  // measEnergy status while no new pulse arrived
+
+// Operations
+#define PM_ASYNC_POWER                0
+#define PM_ASYNC_ENERGY               1
+#define PM_ASYNC_FREQUENCY            2
+#define PM_ASYNC_POWER_DENSITY        3
+#define PM_ASYNC_4Q_POSITIONS         4
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	int       op;
+	uint64_t  id;                 // returned by PMAsync_submit
+	ViStatus  status;
+	ViReal64  value;              // x position for PM_ASYNC_4Q_POSITIONS
+	ViReal64  value2;             // y position for PM_ASYNC_4Q_POSITIONS
+	uint32_t  attempts;
+	uint64_t  latencyNs;          // submit to completion
+} PMAsyncResult;
+
+// Called on the I/O thread of the executor; may submit new requests
+typedef void (*PMAsyncFunc)(void *ctx, const PMAsyncResult *result);
+
+typedef struct
+{
+	volatile uint64_t seq;        // slot ownership for the multi-producer queue
+	int               op;
+	ViUInt16          channel;
+	uint64_t          id;
+	uint64_t          submitNs;
+	uint64_t          deadlineNs;
+	uint64_t          nextTryNs;
+	uint32_t          attempts;
+	PMAsyncFunc       func;
+	void              *ctx;
+} PMAsyncRequest;
+
+typedef struct
+{
+	ViSession         session;
+	uint32_t          retryIntervalUs;
+
+	// bounded multi-producer, single-consumer queue
+	PMAsyncRequest    queue[PM_ASYNC_QUEUE_SIZE];
+	char              padQueue[PM_CACHE_LINE];
+	volatile uint64_t tail;       // producers
+	char              padTail[PM_CACHE_LINE];
+	uint64_t          head;       // I/O thread
+
+	// I/O thread only
+	PMAsyncRequest    retry[PM_ASYNC_MAX_RETRIES];
+	uint32_t          retryCount;
+
+	PMThread          thread;
+	uint32_t          started;
+	volatile uint32_t running;
+	volatile uint32_t submitting; // PMAsync_submit calls in progress
+	volatile uint64_t nextId;
+
+	volatile uint64_t submitted;
+	volatile uint64_t completed;
+	volatile uint64_t timeouts;
+	volatile uint64_t retries;
+} PMAsync;
+
+typedef struct
+{
+	uint64_t          submitted;
+	uint64_t          completed;
+	uint64_t          pending;
+	uint64_t          timeouts;
+	uint64_t          retries;
+} PMAsyncStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void        PMAsync_init(PMAsync *async, ViSession session);
+ViStatus    PMAsync_start(PMAsync *async);
+ViStatus    PMAsync_stop(PMAsync *async);
+ViStatus    PMAsync_submit(PMAsync *async, int op, ViUInt16 channel, uint32_t timeoutUs,
+                           PMAsyncFunc func, void *ctx, uint64_t *id);
+void        PMAsync_getStats(PMAsync *async, PMAsyncStats *stats);
+const char *PMAsync_opName(int op);
+
+#endif /* _PM_ASYNC_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
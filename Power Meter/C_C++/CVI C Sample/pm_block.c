@@ -0,0 +1,109 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Columnar sample blocks
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_block.h"
+
+#include <string.h>
+
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static uint32_t roundVector(uint32_t n)
+{
+	return (n + PM_BLOCK_VECTOR - 1) & ~(uint32_t)(PM_BLOCK_VECTOR - 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Allocate a block with 'capacity' entries (rounded up to whole vectors)
+  in each of the timestamp and 1..PM_BLOCK_MAX_CHANNELS value columns
+---------------------------------------------------------------------------*/
+ViStatus PMBlock_init(PMSampleBlock *block, uint32_t capacity, uint32_t channels)
+{
+	size_t   column;
+	uint8_t  *mem;
+	uint32_t c;
+
+	memset(block, 0, sizeof(PMSampleBlock));
+	if(capacity == 0 || channels == 0 || channels > PM_BLOCK_MAX_CHANNELS)
+		return VI_ERROR_INV_SETUP;
+
+	block->capacity = roundVector(capacity);
+	block->channels = channels;
+	column = (size_t)block->capacity * sizeof(ViReal32);   // a multiple of the cache line
+
+	mem = (uint8_t*)PMPlat_alignedAlloc(column * (1 + channels), PM_CACHE_LINE);
+	if(mem == NULL)
+		return VI_ERROR_ALLOC;
+	memset(mem, 0, column * (1 + channels));
+
+	block->memory     = mem;
+	block->timestamps = (ViUInt32*)mem;
+	for(c = 0; c < channels; c++)
+		block->channel[c] = (ViReal32*)(mem + column * (1 + c));
+	return VI_SUCCESS;
+}
+
+
+void PMBlock_free(PMSampleBlock *block)
+{
+	PMPlat_alignedFree(block->memory);
+	memset(block, 0, sizeof(PMSampleBlock));
+}
+
+
+/*---------------------------------------------------------------------------
+  Empty the block; the next sample written gets index 'first'
+---------------------------------------------------------------------------*/
+void PMBlock_clear(PMSampleBlock *block, uint64_t first)
+{
+	PMBlock_setCount(block, 0);
+	block->first = first;
+}
+
+
+/*---------------------------------------------------------------------------
+  Set the number of valid entries and zero the rest of the last vector
+---------------------------------------------------------------------------*/
+void PMBlock_setCount(PMSampleBlock *block, uint32_t count)
+{
+	uint32_t end, c;
+
+	if(count > block->capacity)
+		count = block->capacity;
+	end = roundVector(count);
+
+	if(end > count)
+	{
+		memset(block->timestamps + count, 0, (end - count) * sizeof(ViUInt32));
+		for(c = 0; c < block->channels; c++)
+			memset(block->channel[c] + count, 0, (end - count) * sizeof(ViReal32));
+	}
+	block->count = count;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
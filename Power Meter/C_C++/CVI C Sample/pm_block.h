@@ -0,0 +1,75 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Columnar sample blocks
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   One sample container for every acquisition mode: a shared timestamp
+   column (device time in us) and one value column per channel, each
+   starting on a cache line and padded to whole SIMD vectors. The padding
+   is kept at zero, so vector kernels may always process full vectors.
+
+   The driver writes straight into the columns (fast measure stream,
+   measurement sequence, burst array) through the readers of the model
+   (pm_model.h); sequence timestamps, which the driver delivers as
+   ViReal32 in ms, are converted to us in place.
+
+****************************************************************************/
+#ifndef _PM_BLOCK_HEADER_
+#define _PM_BLOCK_HEADER_
+
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_BLOCK_MAX_CHANNELS     2
+#define PM_BLOCK_VECTOR           16       // column length granularity (one cache line of ViReal32)
+#define PM_BLOCK_FAST_SPACE       PM_FAST_BLOCK_SIZE    // free entries a fast measure stream read needs
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint64_t  first;                                   // sample index of entry 0 in the acquisition
+	uint32_t  count;
+	uint32_t  capacity;                                // entries per column, multiple of PM_BLOCK_VECTOR
+	uint32_t  channels;
+	ViUInt32  *timestamps;
+	ViReal32  *channel[PM_BLOCK_MAX_CHANNELS];
+	void      *memory;                                 // one allocation for all columns
+} PMSampleBlock;
+
+// Burst reader of the model (pm_model.h)
+typedef ViStatus (*PMBlockBurstFunc)(PMSampleBlock *block, ViSession vi, ViUInt32 start, ViUInt32 count);
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus PMBlock_init(PMSampleBlock *block, uint32_t capacity, uint32_t channels);
+void     PMBlock_free(PMSampleBlock *block);
+void     PMBlock_clear(PMSampleBlock *block, uint64_t first);
+void     PMBlock_setCount(PMSampleBlock *block, uint32_t count);
+
+#endif /* _PM_BLOCK_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,314 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Burst array reader
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_burst.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define IDLE_SPINS            64       // yields before sleeping
+#define IDLE_US               100      // wait for the other thread
+#define RECORD_POLL_US        1000     // streamed read: wait for the burst to record more
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+
+/*---------------------------------------------------------------------------
+  Chunk size tuning: compare the driver time per sample of a full chunk
+  with the previous chunk size and stop once doubling no longer pays off
+---------------------------------------------------------------------------*/
+static void tune(PMBurstReader *reader, uint64_t ns, uint32_t count, double *prevNsPerSample)
+{
+	double nsPerSample;
+
+	if(!reader->tuning || count != reader->chunkSamples)
+		return;
+
+	nsPerSample = (double)ns / (double)count;
+	if(*prevNsPerSample > 0.0 && nsPerSample > *prevNsPerSample * PM_BURST_TUNE_GAIN)
+	{
+		reader->tuning = VI_FALSE;
+		if(nsPerSample > *prevNsPerSample)
+			reader->chunkSamples /= 2;
+		return;
+	}
+
+	*prevNsPerSample = nsPerSample;
+	if(reader->chunkSamples * 2 <= PM_BURST_MAX_CHUNK)
+		reader->chunkSamples *= 2;
+	else
+		reader->tuning = VI_FALSE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Fetch thread: the only user of the session while a read is running
+---------------------------------------------------------------------------*/
+static void fetchThread(void *arg)
+{
+	PMBurstReader *reader = (PMBurstReader*)arg;
+	ViStatus      err = VI_SUCCESS;
+	ViUInt32      total = reader->totalSamples;
+	ViUInt32      available = 0;
+	uint64_t      next = 0;
+	uint64_t      progressNs = PMPlat_timeNs();
+	double        prevNsPerSample = 0.0;
+	uint32_t      i = 0;
+
+	if(total == 0)
+	{
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getBurstArraySamplesCount(reader->vi, &total));
+		available = total;
+	}
+
+	while(err == VI_SUCCESS && next < total && !PMPlat_load32(&reader->abort))
+	{
+		PMSampleBlock *chunk = &reader->slot[i];
+		uint64_t     t0, t1;
+		uint32_t     n, idle = 0;
+
+		t0 = PMPlat_timeNs();
+		while(PMPlat_load32(&reader->full[i]) && !PMPlat_load32(&reader->abort))
+		{
+			if(idle++ < IDLE_SPINS)
+				PMPlat_yield();
+			else
+				PMPlat_sleepUs(IDLE_US);
+		}
+		reader->stallNs += PMPlat_timeNs() - t0;
+
+		// streamed read: only ask for the count once the known samples are fetched
+		if(next >= available)
+		{
+			PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getBurstArraySamplesCount(reader->vi, &available));
+			if(err != VI_SUCCESS)
+				break;
+			if(next >= available)
+			{
+				if(PMPlat_timeNs() - progressNs > (uint64_t)reader->timeoutUs * 1000)
+					err = VI_ERROR_TMO;
+				else
+					PMPlat_sleepUs(RECORD_POLL_US);
+				continue;
+			}
+		}
+
+		n = reader->chunkSamples;
+		if(next + n > available)
+			n = (uint32_t)(available - next);
+		if(next + n > total)
+			n = (uint32_t)(total - next);
+
+		t0 = PMPlat_timeNs();
+		err = reader->readBurst(chunk, reader->vi, (ViUInt32)next, n);
+		t1 = PMPlat_timeNs();
+		if(err != VI_SUCCESS)
+			break;
+
+		reader->fetchNs += t1 - t0;
+		tune(reader, t1 - t0, n, &prevNsPerSample);
+
+		PMPlat_store32(&reader->full[i], 1);
+		next      += n;
+		progressNs = t1;
+		i ^= 1;
+	}
+
+	// the buffer is on the host now, the next burst can record meanwhile
+	if(err == VI_SUCCESS && next >= total && reader->rearm && !PMPlat_load32(&reader->abort))
+	{
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_startBurstArrayMeasurement(reader->vi));
+		if(err == VI_SUCCESS)
+			reader->rearms++;
+	}
+
+	if(err == VI_SUCCESS && next < total)
+		err = VI_ERROR_ABORT;
+	reader->fetchStatus = err;
+	PMPlat_store32(&reader->fetchDone, 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Allocate both chunk buffers. chunkSamples 0 tunes the chunk size. The
+  chunks are read with the burst reader of the model resolved at open.
+---------------------------------------------------------------------------*/
+ViStatus PMBurst_init(PMBurstReader *reader, const PMModel *model, ViSession vi, uint32_t chunkSamples,
+		PMBurstFunc func, void *ctx)
+{
+	ViStatus err;
+	uint32_t i;
+
+	memset(reader, 0, sizeof(PMBurstReader));
+	if(func == NULL || model == NULL)
+		return VI_ERROR_INV_SETUP;
+	if(!(model->modes & PM_MODEL_BURST))
+		return VI_ERROR_NSUP_OPER;
+
+	reader->vi        = vi;
+	reader->readBurst = model->readBurst;
+	reader->func      = func;
+	reader->ctx       = ctx;
+	reader->tuning    = (chunkSamples == 0) ? VI_TRUE : VI_FALSE;
+	reader->chunkSamples = (chunkSamples == 0) ? PM_BURST_MIN_CHUNK :
+			(chunkSamples > PM_BURST_MAX_CHUNK) ? PM_BURST_MAX_CHUNK : chunkSamples;
+
+	for(i = 0; i < 2; i++)
+	{
+		if((err = PMBlock_init(&reader->slot[i], PM_BURST_MAX_CHUNK, 2)))
+		{
+			PMBurst_free(reader);
+			return err;
+		}
+	}
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Read totalSamples burst samples (0: the samples recorded so far, the
+  burst should be stopped) and pass them to the consumer chunk by chunk.
+  A streamed read fails with VI_ERROR_TMO when no new samples arrive
+  within timeoutUs. rearm restarts the burst after the last fetch.
+---------------------------------------------------------------------------*/
+ViStatus PMBurst_read(PMBurstReader *reader, uint32_t totalSamples, ViBoolean rearm, uint32_t timeoutUs)
+{
+	PMThread thread;
+	ViStatus err;
+	uint64_t startNs, t0;
+	uint32_t i = 0;
+	uint32_t idle = 0;
+
+	reader->totalSamples = totalSamples;
+	reader->rearm        = rearm;
+	reader->timeoutUs    = (timeoutUs > 0) ? timeoutUs : PM_BURST_DEFAULT_TIMEOUT_US;
+	reader->fetchStatus  = VI_SUCCESS;
+	reader->fetchDone    = 0;
+	reader->abort        = 0;
+	reader->full[0]      = 0;
+	reader->full[1]      = 0;
+	reader->samples      = 0;
+	reader->chunks       = 0;
+	reader->fetchNs      = 0;
+	reader->consumeNs    = 0;
+	reader->stallNs      = 0;
+	reader->rearms       = 0;
+
+	startNs = PMPlat_timeNs();
+	if((err = PMPlat_threadCreate(&thread, fetchThread, reader)))
+		return err;
+
+	for(;;)
+	{
+		if(PMPlat_load32(&reader->full[i]))
+		{
+			t0 = PMPlat_timeNs();
+			PM_TRACE_TIMED(PM_TRACE_PROCESS, reader->func(reader->ctx, &reader->slot[i]));
+			reader->consumeNs += PMPlat_timeNs() - t0;
+			reader->samples   += reader->slot[i].count;
+			reader->chunks++;
+			PMPlat_store32(&reader->full[i], 0);
+			i ^= 1;
+			idle = 0;
+		}
+		else if(PMPlat_load32(&reader->fetchDone))
+		{
+			// chunks are published before fetchDone, so an empty slot now means the end
+			if(!PMPlat_load32(&reader->full[i]))
+				break;
+		}
+		else if(idle++ < IDLE_SPINS)
+		{
+			PMPlat_yield();
+		}
+		else
+		{
+			PMPlat_sleepUs(IDLE_US);
+		}
+	}
+
+	PMPlat_threadJoin(thread);
+	reader->elapsedNs = PMPlat_timeNs() - startNs;
+	return reader->fetchStatus;
+}
+
+
+/*---------------------------------------------------------------------------
+  End a running read early, e.g. from the consumer. PMBurst_read returns
+  VI_ERROR_ABORT.
+---------------------------------------------------------------------------*/
+void PMBurst_abort(PMBurstReader *reader)
+{
+	PMPlat_store32(&reader->abort, 1);
+}
+
+
+void PMBurst_getStats(const PMBurstReader *reader, PMBurstStats *stats)
+{
+	memset(stats, 0, sizeof(PMBurstStats));
+	stats->samples      = reader->samples;
+	stats->chunks       = reader->chunks;
+	stats->chunkSamples = reader->chunkSamples;
+	stats->rearms       = reader->rearms;
+	stats->elapsedSec   = (double)reader->elapsedNs * 1.0e-9;
+	stats->fetchSec     = (double)reader->fetchNs * 1.0e-9;
+	stats->consumeSec   = (double)reader->consumeNs * 1.0e-9;
+	stats->stallSec     = (double)reader->stallNs * 1.0e-9;
+	if(stats->elapsedSec > 0.0)
+	{
+		stats->samplesPerSec = (double)stats->samples / stats->elapsedSec;
+		stats->bytesPerSec   = stats->samplesPerSec * (sizeof(ViUInt32) + 2 * sizeof(ViReal32));
+	}
+}
+
+
+void PMBurst_printStats(const PMBurstStats *stats)
+{
+	printf("Burst readout: %llu samples in %llu chunks of up to %u in %.3f s (%.0f S/s, %.2f MB/s)\n",
+			(unsigned long long)stats->samples, (unsigned long long)stats->chunks, (unsigned int)stats->chunkSamples,
+			stats->elapsedSec, stats->samplesPerSec, stats->bytesPerSec * 1.0e-6);
+	printf("  driver %.3f s, consumer %.3f s, fetch waited for consumer %.3f s, re-armed %u\n",
+			stats->fetchSec, stats->consumeSec, stats->stallSec, (unsigned int)stats->rearms);
+}
+
+
+/*---------------------------------------------------------------------------
+  Release the chunk buffers. No read may be running.
+---------------------------------------------------------------------------*/
+void PMBurst_free(PMBurstReader *reader)
+{
+	PMBlock_free(&reader->slot[0]);
+	PMBlock_free(&reader->slot[1]);
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
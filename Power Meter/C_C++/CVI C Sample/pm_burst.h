@@ -0,0 +1,117 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Burst array reader
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Reads the burst array buffer of a TLPMX session in chunks of bounded
+   size, so bursts of any length are handled with constant memory. The
+   chunks are PMSampleBlocks filled by the driver directly.
+
+   A fetch thread owns the session during PMBurst_read and fills two chunk
+   buffers alternately, while the calling thread hands the other buffer
+   to the consumer. With a sample total the readout streams while the
+   burst is still recording. After the last chunk has been fetched the
+   trigger can be re-armed for the next burst, which then records while
+   the consumer drains the final chunks.
+
+   With chunk size 0 the reader tunes it: the chunk doubles as long as
+   that lowers the driver time per sample noticeably. The result is kept
+   for later reads.
+
+****************************************************************************/
+#ifndef _PM_BURST_HEADER_
+#define _PM_BURST_HEADER_
+
+#include "pm_model.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_BURST_MIN_CHUNK        256
+#define PM_BURST_MAX_CHUNK        8192     // samples per driver call and buffer
+#define PM_BURST_TUNE_GAIN        0.9      // keep doubling while ns/sample drops below this ratio
+#define PM_BURST_DEFAULT_TIMEOUT_US 5000000  // no new samples for this long ends a streamed read
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Called on the thread running PMBurst_read for every chunk in order.
+// chunk->first is the burst buffer index of the first sample.
+typedef void (*PMBurstFunc)(void *ctx, const PMSampleBlock *chunk);
+
+typedef struct
+{
+	ViSession         vi;
+	PMBlockBurstFunc  readBurst;      // reader of the model given to PMBurst_init
+	PMBurstFunc       func;
+	void              *ctx;
+	uint32_t          chunkSamples;   // current chunk size
+	ViBoolean         tuning;
+
+	PMSampleBlock     slot[2];        // both channels
+	volatile uint32_t full[2];
+
+	// set by PMBurst_read for the fetch thread
+	uint32_t          totalSamples;   // 0: what the buffer holds when reading starts
+	ViBoolean         rearm;
+	uint32_t          timeoutUs;
+	volatile uint32_t fetchDone;
+	volatile uint32_t abort;
+	ViStatus          fetchStatus;
+
+	// statistics of the last read
+	uint64_t          samples;
+	uint64_t          chunks;
+	uint64_t          fetchNs;        // time spent in the driver
+	uint64_t          consumeNs;      // time spent in the consumer
+	uint64_t          stallNs;        // fetch thread waiting for a free buffer
+	uint64_t          elapsedNs;
+	uint32_t          rearms;
+} PMBurstReader;
+
+typedef struct
+{
+	uint64_t          samples;
+	uint64_t          chunks;
+	uint32_t          chunkSamples;
+	uint32_t          rearms;
+	double            elapsedSec;
+	double            samplesPerSec;
+	double            bytesPerSec;    // timestamps and both channels
+	double            fetchSec;
+	double            consumeSec;
+	double            stallSec;
+} PMBurstStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus PMBurst_init(PMBurstReader *reader, const PMModel *model, ViSession vi, uint32_t chunkSamples, PMBurstFunc func, void *ctx);
+ViStatus PMBurst_read(PMBurstReader *reader, uint32_t totalSamples, ViBoolean rearm, uint32_t timeoutUs);
+void     PMBurst_abort(PMBurstReader *reader);
+void     PMBurst_getStats(const PMBurstReader *reader, PMBurstStats *stats);
+void     PMBurst_printStats(const PMBurstStats *stats);
+void     PMBurst_free(PMBurstReader *reader);
+
+#endif /* _PM_BURST_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,582 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Host calibration
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_calib.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+#if PM_HAVE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define CORRECTION_POINTS     32        // user power calibration points read from the device
+#define LINE_SIZE             256
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef void (*ConvertKernel)(const ViReal32 in[], uint32_t count, const PMCalParams *p, ViReal32 *out[]);
+
+/*===========================================================================
+ Kernels
+ Every input vector is loaded once and written to all lines. Multiply and
+ add stay separate (no FMA), so all kernels give identical results.
+===========================================================================*/
+static void convertScalar(const ViReal32 in[], uint32_t count, const PMCalParams *p, ViReal32 *out[])
+{
+	uint32_t l, i;
+
+	for(l = 0; l < p->lines; l++)
+	{
+		ViReal32 s = p->scale[l], o = p->offset[l];
+		ViReal32 *dst = out[l];
+
+		for(i = 0; i < count; i++)
+			dst[i] = in[i] * s + o;
+	}
+}
+
+
+static void convertTail(const ViReal32 in[], uint32_t start, uint32_t count, const PMCalParams *p, ViReal32 *out[])
+{
+	uint32_t l, i;
+
+	for(i = start; i < count; i++)
+		for(l = 0; l < p->lines; l++)
+			out[l][i] = in[i] * p->scale[l] + p->offset[l];
+}
+
+
+#if PM_HAVE_X86_SIMD
+
+PM_TARGET_SSE2 static void convertSse2(const ViReal32 in[], uint32_t count, const PMCalParams *p, ViReal32 *out[])
+{
+	__m128   vs[PM_CAL_MAX_LINES], vo[PM_CAL_MAX_LINES];
+	uint32_t l, i;
+
+	for(l = 0; l < p->lines; l++)
+	{
+		vs[l] = _mm_set1_ps(p->scale[l]);
+		vo[l] = _mm_set1_ps(p->offset[l]);
+	}
+	for(i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&in[i]);
+
+		for(l = 0; l < p->lines; l++)
+			_mm_storeu_ps(&out[l][i], _mm_add_ps(_mm_mul_ps(x, vs[l]), vo[l]));
+	}
+	convertTail(in, i, count, p, out);
+}
+
+
+PM_TARGET_AVX2 static void convertAvx2(const ViReal32 in[], uint32_t count, const PMCalParams *p, ViReal32 *out[])
+{
+	__m256   vs[PM_CAL_MAX_LINES], vo[PM_CAL_MAX_LINES];
+	uint32_t l, i;
+
+	for(l = 0; l < p->lines; l++)
+	{
+		vs[l] = _mm256_set1_ps(p->scale[l]);
+		vo[l] = _mm256_set1_ps(p->offset[l]);
+	}
+	for(i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&in[i]);
+
+		for(l = 0; l < p->lines; l++)
+			_mm256_storeu_ps(&out[l][i], _mm256_add_ps(_mm256_mul_ps(x, vs[l]), vo[l]));
+	}
+	convertTail(in, i, count, p, out);
+}
+
+#endif
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static ConvertKernel convert  = NULL;
+static int           kernelId = PM_CAL_KERNEL_AUTO;
+
+
+/*---------------------------------------------------------------------------
+  Choose the conversion kernel. PM_CAL_KERNEL_AUTO picks the fastest one
+  the CPU supports. Returns the kernel in use (unsupported requests fall
+  back).
+---------------------------------------------------------------------------*/
+int PMCal_selectKernel(int kernel)
+{
+	uint32_t cpu = PMPlat_cpuFeatures();
+
+	if(kernel == PM_CAL_KERNEL_AUTO)
+		kernel = PM_CAL_KERNEL_AVX2;
+
+#if PM_HAVE_X86_SIMD
+	if(kernel == PM_CAL_KERNEL_AVX2 && (cpu & PM_CPU_AVX2))
+	{
+		convert = convertAvx2;
+		return kernelId = PM_CAL_KERNEL_AVX2;
+	}
+	if(kernel >= PM_CAL_KERNEL_SSE2 && (cpu & PM_CPU_SSE2))
+	{
+		convert = convertSse2;
+		return kernelId = PM_CAL_KERNEL_SSE2;
+	}
+#else
+	(void)cpu;
+#endif
+
+	convert = convertScalar;
+	return kernelId = PM_CAL_KERNEL_SCALAR;
+}
+
+
+int PMCal_kernel(void)
+{
+	if(convert == NULL)
+		PMCal_selectKernel(PM_CAL_KERNEL_AUTO);
+	return kernelId;
+}
+
+
+const char *PMCal_kernelName(int kernel)
+{
+	switch(kernel)
+	{
+		case PM_CAL_KERNEL_SCALAR: return "scalar";
+		case PM_CAL_KERNEL_SSE2:   return "SSE2";
+		case PM_CAL_KERNEL_AVX2:   return "AVX2";
+		default:                   return "auto";
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Linear interpolation in ascending points, constant beyond both ends
+---------------------------------------------------------------------------*/
+static double interpolate(const double x[], const double y[], uint32_t count, double at)
+{
+	uint32_t lo = 0, hi = count - 1;
+
+	if(at <= x[0])
+		return y[0];
+	if(at >= x[hi])
+		return y[hi];
+	while(hi - lo > 1)
+	{
+		uint32_t mid = (lo + hi) / 2;
+
+		if(x[mid] <= at)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return y[lo] + (y[hi] - y[lo]) * (at - x[lo]) / (x[hi] - x[lo]);
+}
+
+
+/*---------------------------------------------------------------------------
+  Text file with one point per line: wavelength in nm and responsivity in
+  A/W, separated by blanks, tabs, commas or semicolons. Lines starting
+  with '#' are comments. Wavelengths must ascend.
+---------------------------------------------------------------------------*/
+ViStatus PMCal_loadFile(PMCalCurve *curve, const char *path)
+{
+	FILE     *f = fopen(path, "r");
+	char     line[LINE_SIZE];
+	ViStatus err = VI_SUCCESS;
+
+	if(f == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	memset(curve, 0, sizeof(PMCalCurve));
+	while(err == VI_SUCCESS && fgets(line, sizeof(line), f) != NULL)
+	{
+		double nm, aw;
+		char   *p = line;
+
+		while(*p == ' ' || *p == '\t')
+			p++;
+		if(*p == '#' || *p == '\r' || *p == '\n' || *p == '\0')
+			continue;
+		if(sscanf(p, "%lf%*[ \t,;]%lf", &nm, &aw) != 2)
+			err = VI_ERROR_INV_FMT;
+		else if(curve->count > 0 && nm <= curve->wavelength[curve->count - 1])
+			err = VI_ERROR_INV_FMT;
+		else if(curve->count == PM_CAL_MAX_POINTS)
+			err = VI_ERROR_USER_BUF;
+		else
+		{
+			curve->wavelength[curve->count]   = nm;
+			curve->responsivity[curve->count] = aw;
+			curve->count++;
+		}
+	}
+	fclose(f);
+
+	if(err == VI_SUCCESS && curve->count < 2)
+		err = VI_ERROR_INV_FMT;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Responsivity curve of the connected sensor, by stepping the wavelength
+  over fromNm..toNm (both 0: the range of the sensor) and reading the
+  responsivity at every step. Two round trips per point, done once; the
+  wavelength set before is restored.
+---------------------------------------------------------------------------*/
+ViStatus PMCal_loadSensor(PMCalCurve *curve, ViSession session, ViUInt16 channel, double fromNm, double toNm, double stepNm)
+{
+	ViReal64 original, nm, aw;
+	ViStatus err, restore;
+	uint32_t points, i;
+
+	memset(curve, 0, sizeof(PMCalCurve));
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getWavelength(session, TLPM_ATTR_SET_VAL, &original, channel));
+	if(err != VI_SUCCESS)
+		return err;
+	if(fromNm <= 0.0 && toNm <= 0.0)
+	{
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getWavelength(session, TLPM_ATTR_MIN_VAL, &fromNm, channel));
+		if(err == VI_SUCCESS)
+			PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getWavelength(session, TLPM_ATTR_MAX_VAL, &toNm, channel));
+		if(err != VI_SUCCESS)
+			return err;
+	}
+	if(toNm <= fromNm)
+		return VI_ERROR_INV_SETUP;
+
+	if(stepNm <= 0.0)
+		stepNm = 1.0;
+	if((toNm - fromNm) / stepNm + 1.0 > PM_CAL_MAX_POINTS)
+		stepNm = (toNm - fromNm) / (PM_CAL_MAX_POINTS - 1);
+	points = (uint32_t)((toNm - fromNm) / stepNm + 1.0e-9) + 1;
+
+	for(i = 0; i < points && err == VI_SUCCESS; i++)
+	{
+		nm = (i + 1 == points) ? toNm : fromNm + stepNm * i;
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_setWavelength(session, nm, channel));
+		if(err == VI_SUCCESS)
+			PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getPhotodiodeResponsivity(session, TLPM_ATTR_SET_VAL, &aw, channel));
+		if(err == VI_SUCCESS && (curve->count == 0 || nm > curve->wavelength[curve->count - 1]))
+		{
+			curve->wavelength[curve->count]   = nm;
+			curve->responsivity[curve->count] = aw;
+			curve->count++;
+		}
+	}
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, restore, TLPMX_setWavelength(session, original, channel));
+	if(err == VI_SUCCESS)
+		err = restore;
+	if(err == VI_SUCCESS && curve->count < 2)
+		err = VI_ERROR_INV_SETUP;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Apply the user power calibration points at memory position index to the
+  curve, the way the device applies them when they are active: the power
+  is multiplied by the correction factor interpolated at the wavelength.
+  No points stored: the curve is left as it is.
+---------------------------------------------------------------------------*/
+ViStatus PMCal_loadCorrection(PMCalCurve *curve, ViSession session, ViUInt16 channel, ViUInt16 index)
+{
+	ViChar   serial[TLPM_BUFFER_SIZE], date[TLPM_BUFFER_SIZE], author[TLPM_BUFFER_SIZE];
+	ViUInt16 points = 0, position;
+	ViReal64 nm[CORRECTION_POINTS], factor[CORRECTION_POINTS];
+	ViStatus err;
+	uint32_t i;
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerCalibrationPointsInformation(session, index, serial, date, &points, author, &position, channel));
+	if(err != VI_SUCCESS)
+		return err;
+	if(points == 0)
+		return VI_SUCCESS;
+	if(points > CORRECTION_POINTS)
+		return VI_ERROR_USER_BUF;
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerCalibrationPoints(session, index, points, nm, factor, channel));
+	if(err != VI_SUCCESS)
+		return err;
+	for(i = 1; i < points; i++)
+		if(nm[i] <= nm[i - 1])
+			return VI_ERROR_INV_FMT;
+
+	for(i = 0; i < curve->count; i++)
+	{
+		double f = interpolate(nm, factor, points, curve->wavelength[i]);
+
+		if(f > 0.0)
+			curve->responsivity[i] /= f;
+	}
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Resample the curve on a grid of stepNm (0: PM_CAL_DEFAULT_STEP_NM)
+  covering its wavelength range. Points without response convert to 0 W.
+---------------------------------------------------------------------------*/
+ViStatus PMCal_buildTable(PMCalTable *table, const PMCalCurve *curve, double stepNm)
+{
+	double   span;
+	uint32_t i;
+
+	memset(table, 0, sizeof(PMCalTable));
+	if(curve->count < 2)
+		return VI_ERROR_INV_SETUP;
+	if(stepNm <= 0.0)
+		stepNm = PM_CAL_DEFAULT_STEP_NM;
+
+	span = curve->wavelength[curve->count - 1] - curve->wavelength[0];
+	if(span / stepNm + 1.0 > PM_CAL_MAX_TABLE)
+		return VI_ERROR_INV_SETUP;
+
+	table->startNm = curve->wavelength[0];
+	table->stepNm  = stepNm;
+	table->count   = (uint32_t)(span / stepNm + 1.0e-9) + 1;
+	if(table->startNm + (table->count - 1) * stepNm < curve->wavelength[curve->count - 1] - 1.0e-9)
+		table->count++;             // last grid point on or beyond the end of the curve
+	table->wattsPerAmp = (double*)PMPlat_alignedAlloc(table->count * sizeof(double), PM_CACHE_LINE);
+	if(table->wattsPerAmp == NULL)
+	{
+		table->count = 0;
+		return VI_ERROR_ALLOC;
+	}
+
+	for(i = 0; i < table->count; i++)
+	{
+		double aw = interpolate(curve->wavelength, curve->responsivity, curve->count, table->startNm + i * stepNm);
+
+		table->wattsPerAmp[i] = (aw > 0.0) ? 1.0 / aw : 0.0;
+	}
+	return VI_SUCCESS;
+}
+
+
+void PMCal_freeTable(PMCalTable *table)
+{
+	PMPlat_alignedFree(table->wattsPerAmp);
+	memset(table, 0, sizeof(PMCalTable));
+}
+
+
+/*---------------------------------------------------------------------------
+  W/A at nm, 0 outside the table
+---------------------------------------------------------------------------*/
+double PMCal_lookup(const PMCalTable *table, double nm)
+{
+	double   x;
+	uint32_t i;
+
+	if(table == NULL || table->count == 0)
+		return 0.0;
+	x = (nm - table->startNm) / table->stepNm;
+	if(x < -1.0e-9 || x > (double)(table->count - 1) + 1.0e-9)
+		return 0.0;
+	if(x <= 0.0)
+		return table->wattsPerAmp[0];
+	i = (uint32_t)x;
+	if(i >= table->count - 1)
+		return table->wattsPerAmp[table->count - 1];
+	return table->wattsPerAmp[i] + (table->wattsPerAmp[i + 1] - table->wattsPerAmp[i]) * (x - (double)i);
+}
+
+
+static ViBoolean inTable(const PMCalTable *table, double nm)
+{
+	return (table != NULL && table->count > 0 && nm >= table->startNm - 1.0e-9 &&
+			nm <= table->startNm + (table->count - 1) * table->stepNm + 1.0e-9) ? VI_TRUE : VI_FALSE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Setters run under the lock: recompute the scales of cal->next from the
+  table and publish them
+---------------------------------------------------------------------------*/
+static void lock(PMCal *cal)
+{
+	while(!PMPlat_cas64(&cal->lock, 0, 1))
+		PMPlat_yield();
+}
+
+
+static void publish(PMCal *cal)
+{
+	uint64_t stamp = cal->stamp;
+	uint32_t l;
+
+	for(l = 0; l < cal->next.lines; l++)
+	{
+		double w = PMCal_lookup(cal->table, cal->next.wavelength[l]);
+
+		cal->next.scale[l]  = (ViReal32)w;
+		cal->next.offset[l] = (ViReal32)(-cal->darkCurrent * w);
+	}
+
+	PMPlat_store64(&cal->stamp, stamp + 1);
+	PMPlat_fence();
+	cal->params = cal->next;
+	PMPlat_store64(&cal->stamp, stamp + 2);
+	PMPlat_store64(&cal->lock, 0);
+}
+
+
+/*---------------------------------------------------------------------------
+  The table is not copied and must stay valid while the converter uses it
+---------------------------------------------------------------------------*/
+void PMCal_init(PMCal *cal, const PMCalTable *table)
+{
+	memset(cal, 0, sizeof(PMCal));
+	cal->table = table;
+	lock(cal);
+	publish(cal);
+}
+
+
+/*---------------------------------------------------------------------------
+  Switch to another table (new curve or correction). Fails without change
+  if a wavelength in use is outside the new table. The old table may be
+  freed when this returns.
+---------------------------------------------------------------------------*/
+ViStatus PMCal_setTable(PMCal *cal, const PMCalTable *table)
+{
+	uint32_t l;
+
+	lock(cal);
+	for(l = 0; l < cal->next.lines; l++)
+	{
+		if(!inTable(table, cal->next.wavelength[l]))
+		{
+			PMPlat_store64(&cal->lock, 0);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+	cal->table = table;
+	publish(cal);
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMCal_setWavelengths(PMCal *cal, const double nm[], uint32_t lines)
+{
+	uint32_t l;
+
+	if(lines > PM_CAL_MAX_LINES)
+		return VI_ERROR_USER_BUF;
+
+	lock(cal);
+	for(l = 0; l < lines; l++)
+	{
+		if(!inTable(cal->table, nm[l]))
+		{
+			PMPlat_store64(&cal->lock, 0);
+			return VI_ERROR_INV_SETUP;
+		}
+	}
+	memcpy(cal->next.wavelength, nm, lines * sizeof(double));
+	cal->next.lines = lines;
+	publish(cal);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Change one wavelength; line == lines adds one
+---------------------------------------------------------------------------*/
+ViStatus PMCal_setWavelength(PMCal *cal, uint32_t line, double nm)
+{
+	lock(cal);
+	if(line > cal->next.lines || line >= PM_CAL_MAX_LINES || !inTable(cal->table, nm))
+	{
+		PMPlat_store64(&cal->lock, 0);
+		return VI_ERROR_INV_SETUP;
+	}
+	cal->next.wavelength[line] = nm;
+	if(line == cal->next.lines)
+		cal->next.lines++;
+	publish(cal);
+	return VI_SUCCESS;
+}
+
+
+void PMCal_setDarkCurrent(PMCal *cal, double amps)
+{
+	lock(cal);
+	cal->darkCurrent = amps;
+	publish(cal);
+}
+
+
+/*---------------------------------------------------------------------------
+  Consistent copy of the published parameters, from any thread
+---------------------------------------------------------------------------*/
+void PMCal_getParams(PMCal *cal, PMCalParams *params)
+{
+	for(;;)
+	{
+		uint64_t stamp = PMPlat_load64(&cal->stamp);
+
+		if(stamp & 1)
+		{
+			PMPlat_yield();
+			continue;
+		}
+		*params = cal->params;
+		PMPlat_fence();
+		if(PMPlat_load64(&cal->stamp) == stamp)
+			return;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Convert count current samples (A) to power (W) at every wavelength:
+  power[l] receives line l. Returns the number of lines written.
+---------------------------------------------------------------------------*/
+uint32_t PMCal_convert(PMCal *cal, const ViReal32 current[], uint32_t count, ViReal32 *power[])
+{
+	PMCalParams p;
+
+	if(convert == NULL)
+		PMCal_selectKernel(PM_CAL_KERNEL_AUTO);
+	PMCal_getParams(cal, &p);
+	if(p.lines > 0 && count > 0)
+		convert(current, count, &p, power);
+	return p.lines;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,126 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Host calibration
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Current to power conversion on the host, for photodiode sensors
+   streaming raw current (TLPMX_confCurrentFastArrayMeasurement).
+
+   Changing the responsivity on the device means writing calibration
+   points, TLPMX_reinitSensor and a wait of seconds. Here the
+   responsivity curve (A/W over wavelength) is loaded once - swept from
+   the sensor, read from a text file, corrected with the user power
+   calibration points of the device - and resampled into a table on a
+   uniform wavelength grid. A PMCal converter holds up to
+   PM_CAL_MAX_LINES wavelengths; each one turns into a scale (W/A) and
+   an offset (dark current), so a conversion is one multiply-add per
+   sample and wavelength, vectorized (AVX2, SSE2 or scalar, chosen once
+   at runtime). The stream is read once for all wavelengths.
+
+   Wavelength, dark current and table changes compute the new scales
+   and publish them with a stamp; the conversion picks them up with its
+   next call, without a lock or device round trip.
+
+****************************************************************************/
+#ifndef _PM_CALIB_HEADER_
+#define _PM_CALIB_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_CAL_KERNEL_AUTO        0
+#define PM_CAL_KERNEL_SCALAR      1
+#define PM_CAL_KERNEL_SSE2        2
+#define PM_CAL_KERNEL_AVX2        3
+
+#define PM_CAL_MAX_POINTS         1024      // responsivity curve
+#define PM_CAL_MAX_LINES          8         // wavelengths converted at once
+#define PM_CAL_DEFAULT_STEP_NM    0.1       // table grid
+#define PM_CAL_MAX_TABLE          (1u << 20)
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint32_t  count;
+	double    wavelength[PM_CAL_MAX_POINTS];    // nm, ascending
+	double    responsivity[PM_CAL_MAX_POINTS];  // A/W
+} PMCalCurve;
+
+typedef struct
+{
+	double    startNm;
+	double    stepNm;
+	uint32_t  count;
+	double    *wattsPerAmp;                     // 1 / responsivity at startNm + i * stepNm
+} PMCalTable;
+
+typedef struct
+{
+	uint32_t  lines;
+	double    wavelength[PM_CAL_MAX_LINES];
+	ViReal32  scale[PM_CAL_MAX_LINES];          // W/A
+	ViReal32  offset[PM_CAL_MAX_LINES];         // W, -dark current * scale
+} PMCalParams;
+
+typedef struct
+{
+	volatile uint64_t lock;                     // setters
+	const PMCalTable  *table;
+	double            darkCurrent;              // A
+	PMCalParams       next;
+
+	// Published parameters; stamp is odd while they are written
+	volatile uint64_t stamp;
+	PMCalParams       params;
+} PMCal;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+int         PMCal_selectKernel(int kernel);
+int         PMCal_kernel(void);
+const char *PMCal_kernelName(int kernel);
+
+// Responsivity curves
+ViStatus PMCal_loadFile(PMCalCurve *curve, const char *path);
+ViStatus PMCal_loadSensor(PMCalCurve *curve, ViSession session, ViUInt16 channel, double fromNm, double toNm, double stepNm);
+ViStatus PMCal_loadCorrection(PMCalCurve *curve, ViSession session, ViUInt16 channel, ViUInt16 index);
+ViStatus PMCal_buildTable(PMCalTable *table, const PMCalCurve *curve, double stepNm);
+void     PMCal_freeTable(PMCalTable *table);
+double   PMCal_lookup(const PMCalTable *table, double nm);
+
+// Converter
+void     PMCal_init(PMCal *cal, const PMCalTable *table);
+ViStatus PMCal_setTable(PMCal *cal, const PMCalTable *table);
+ViStatus PMCal_setWavelengths(PMCal *cal, const double nm[], uint32_t lines);
+ViStatus PMCal_setWavelength(PMCal *cal, uint32_t line, double nm);
+void     PMCal_setDarkCurrent(PMCal *cal, double amps);
+void     PMCal_getParams(PMCal *cal, PMCalParams *params);
+uint32_t PMCal_convert(PMCal *cal, const ViReal32 current[], uint32_t count, ViReal32 *power[]);
+
+#endif /* _PM_CALIB_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,492 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Capture file
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_capture.h"
+
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define EXTENT_FREE           0
+#define EXTENT_READY          1     // mapped and pre-faulted, waiting for the writer
+#define EXTENT_ACTIVE         2     // owned by the writer
+#define EXTENT_RETIRED        3     // full, waiting to be flushed and unmapped
+
+#define FILE_THREAD_IDLE_US   1000
+#define FLUSH_INTERVAL_NS     250000000ull
+#define WRITER_WAIT_US        100
+#define GROW_EXTENTS          4
+#define PAGE_SIZE_MIN         4096
+
+#define CHUNK_BYTES(samples)  ((uint64_t)(samples) * (sizeof(ViUInt32) + sizeof(ViReal32)))
+
+// The header with its gap table must fit in front of the first chunk
+typedef char PMCaptureHeaderCheck[(sizeof(PMCaptureHeader) <= PM_CAPTURE_HEADER_SIZE) ? 1 : -1];
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static void copyString(char *dst, size_t size, const char *src)
+{
+	if(src == NULL)
+		src = "";
+	strncpy(dst, src, size - 1);
+	dst[size - 1] = '\0';
+}
+
+
+/*---------------------------------------------------------------------------
+  Map the next extent of the file and fault its pages in
+---------------------------------------------------------------------------*/
+static ViStatus prepareExtent(PMCapture *cap, PMCaptureExtent *ext)
+{
+	uint64_t offset = PM_CAPTURE_HEADER_SIZE + cap->nextChunk * CHUNK_BYTES(cap->chunkSamples);
+	uint64_t end    = offset + cap->extentBytes;
+	ViStatus err;
+	size_t   p;
+
+	if(end > cap->fileSize)
+	{
+		uint64_t size = cap->fileSize + cap->growBytes;
+
+		if(size < end)
+			size = end;
+#ifndef _WIN32
+		// On Windows CreateFileMapping extends the file itself and
+		// SetEndOfFile is not allowed while views are mapped.
+		if((err = PMPlat_fileResize(&cap->file, size)))
+			return err;
+#endif
+		cap->fileSize = size;
+	}
+
+	if((err = PMPlat_fileMap(&cap->file, offset, (size_t)cap->extentBytes, &ext->map)))
+		return err;
+
+	for(p = 0; p < cap->extentBytes; p += PAGE_SIZE_MIN)
+		((volatile char*)ext->map.base)[p] = 0;
+
+	ext->firstChunk = cap->nextChunk;
+	cap->nextChunk += PM_CAPTURE_EXTENT_CHUNKS;
+	PMPlat_store32(&ext->state, EXTENT_READY);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  File thread: keeps one extent ready ahead of the writer, retires full
+  extents and flushes the active one periodically.
+---------------------------------------------------------------------------*/
+static void fileThread(void *arg)
+{
+	PMCapture *cap = (PMCapture*)arg;
+	ViStatus  err;
+	int       i;
+
+	for(;;)
+	{
+		ViBoolean running = PMPlat_load32(&cap->running) ? VI_TRUE : VI_FALSE;
+		ViBoolean ready = VI_FALSE;
+		uint64_t  now = PMPlat_timeNs();
+		PMCaptureExtent *freeExt = NULL;
+
+		for(i = 0; i < 3; i++)
+		{
+			PMCaptureExtent *ext = &cap->extents[i];
+			uint32_t state = PMPlat_load32(&ext->state);
+
+			if(state == EXTENT_RETIRED)
+			{
+				PMPlat_fileFlush(&ext->map, 0, ext->map.size, running ? VI_FALSE : VI_TRUE);
+				PMPlat_fileUnmap(&ext->map);
+				PMPlat_store32(&ext->state, EXTENT_FREE);
+				state = EXTENT_FREE;
+			}
+			else if(state == EXTENT_ACTIVE && now - cap->lastFlushNs > FLUSH_INTERVAL_NS)
+			{
+				PMPlat_fileFlush(&ext->map, 0, ext->map.size, VI_FALSE);
+				PMPlat_fileFlush(&cap->headerMap, 0, sizeof(PMCaptureHeader), VI_FALSE);
+				cap->lastFlushNs = now;
+			}
+
+			if(state == EXTENT_READY)
+				ready = VI_TRUE;
+			else if(state == EXTENT_FREE && freeExt == NULL)
+				freeExt = ext;
+		}
+
+		if(!running)
+			break;
+
+		if(!ready && freeExt != NULL && cap->fileStatus == VI_SUCCESS)
+		{
+			if((err = prepareExtent(cap, freeExt)))
+				cap->fileStatus = err;
+			continue;
+		}
+
+		PMPlat_sleepUs(FILE_THREAD_IDLE_US);
+	}
+
+	// release extents prepared but never used
+	for(i = 0; i < 3; i++)
+	{
+		if(cap->extents[i].state != EXTENT_FREE)
+			PMPlat_fileUnmap(&cap->extents[i].map);
+		cap->extents[i].state = EXTENT_FREE;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Writer: retire the active extent and take over the prepared one
+---------------------------------------------------------------------------*/
+static ViStatus nextExtent(PMCapture *cap)
+{
+	uint64_t want = 0;
+	int      i;
+
+	if(cap->active != NULL)
+	{
+		want = cap->activeChunk + PM_CAPTURE_EXTENT_CHUNKS;
+		PMPlat_store32(&cap->active->state, EXTENT_RETIRED);
+		cap->active = NULL;
+	}
+
+	for(;;)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			PMCaptureExtent *ext = &cap->extents[i];
+
+			if(PMPlat_load32(&ext->state) == EXTENT_READY && ext->firstChunk == want)
+			{
+				PMPlat_store32(&ext->state, EXTENT_ACTIVE);
+				cap->active      = ext;
+				cap->activeChunk = want;
+				return VI_SUCCESS;
+			}
+		}
+
+		if(cap->fileStatus != VI_SUCCESS)
+			return cap->fileStatus;
+
+		PMPlat_store64(&cap->stalls, cap->stalls + 1);
+		PMPlat_sleepUs(WRITER_WAIT_US);
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Create a new capture file
+---------------------------------------------------------------------------*/
+ViStatus PMCapture_create(PMCapture *cap, const char *path, const PMCaptureInfo *info, uint64_t presizeSamples)
+{
+	uint64_t extentSamples;
+	uint64_t extents;
+	ViStatus err;
+
+	memset(cap, 0, sizeof(PMCapture));
+	cap->chunkSamples = PM_CAPTURE_CHUNK_SAMPLES;
+	cap->extentBytes  = PM_CAPTURE_EXTENT_CHUNKS * CHUNK_BYTES(cap->chunkSamples);
+	cap->growBytes    = GROW_EXTENTS * cap->extentBytes;
+
+	extentSamples = (uint64_t)PM_CAPTURE_EXTENT_CHUNKS * cap->chunkSamples;
+	extents = (presizeSamples + extentSamples - 1) / extentSamples;
+	if(extents == 0)
+		extents = 1;
+	cap->fileSize = PM_CAPTURE_HEADER_SIZE + extents * cap->extentBytes;
+
+	if((err = PMPlat_fileOpen(&cap->file, path, VI_TRUE, VI_TRUE)))
+		return err;
+
+	if((err = PMPlat_fileResize(&cap->file, cap->fileSize)) ||
+	   (err = PMPlat_fileMap(&cap->file, 0, PM_CAPTURE_HEADER_SIZE, &cap->headerMap)))
+	{
+		PMPlat_fileClose(&cap->file);
+		return err;
+	}
+
+	cap->header = (PMCaptureHeader*)cap->headerMap.base;
+	memcpy(cap->header->magic, PM_CAPTURE_MAGIC, sizeof(PM_CAPTURE_MAGIC));
+	cap->header->version      = PM_CAPTURE_VERSION;
+	cap->header->headerSize   = PM_CAPTURE_HEADER_SIZE;
+	cap->header->chunkSamples = cap->chunkSamples;
+	cap->header->sampleRate   = info ? info->sampleRate : 0;
+	cap->header->startTimeUs  = PMPlat_unixTimeUs();
+	cap->header->channel      = info ? info->channel : 0;
+	copyString(cap->header->device, sizeof(cap->header->device), info ? info->device : NULL);
+	copyString(cap->header->serial, sizeof(cap->header->serial), info ? info->serial : NULL);
+	copyString(cap->header->unit,   sizeof(cap->header->unit),   info ? info->unit   : NULL);
+
+	// first extent is prepared here so the first block never waits
+	cap->running = 1;
+	if((err = prepareExtent(cap, &cap->extents[0])) ||
+	   (err = PMPlat_threadCreate(&cap->fileThread, fileThread, cap)))
+	{
+		PMPlat_fileUnmap(&cap->extents[0].map);
+		PMPlat_fileUnmap(&cap->headerMap);
+		PMPlat_fileClose(&cap->file);
+		return err;
+	}
+
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Fill in the sample index of recorded gaps that end in this block. A gap
+  whose first sample is already behind (its block never arrived here)
+  ends at the start of the block.
+---------------------------------------------------------------------------*/
+static void resolveGaps(PMCapture *cap, const ViUInt32 timestamps[], uint32_t count)
+{
+	uint32_t recorded = PMPlat_load32(&cap->header->gapCount);
+
+	while(cap->gapsResolved < recorded)
+	{
+		PMCaptureGap *gap = &cap->header->gaps[cap->gapsResolved];
+		uint32_t     i;
+
+		for(i = 0; i < count && timestamps[i] != gap->firstTimestamp; i++)
+			;
+		if(i == count)
+		{
+			if((ViUInt32)(gap->firstTimestamp - timestamps[count - 1]) < 0x80000000u)
+				break;                  // still ahead
+			i = 0;
+		}
+		gap->sampleIndex = cap->samples + i;
+		cap->gapsResolved++;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Append samples. Only copies into mapped memory.
+---------------------------------------------------------------------------*/
+ViStatus PMCapture_append(PMCapture *cap, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count)
+{
+	uint64_t extentSamples = (uint64_t)PM_CAPTURE_EXTENT_CHUNKS * cap->chunkSamples;
+	uint64_t chunkBytes = CHUNK_BYTES(cap->chunkSamples);
+
+	if(cap->writeStatus != VI_SUCCESS)
+		return cap->writeStatus;
+	if(count > 0 && cap->gapsResolved != PMPlat_load32(&cap->header->gapCount))
+		resolveGaps(cap, timestamps, count);
+
+	while(count > 0)
+	{
+		uint64_t pos = cap->samples - cap->activeChunk * cap->chunkSamples;
+		uint32_t idx, n;
+		char     *chunk;
+
+		if(cap->active == NULL || pos >= extentSamples)
+		{
+			if((cap->writeStatus = nextExtent(cap)))
+				return cap->writeStatus;
+			pos = cap->samples - cap->activeChunk * cap->chunkSamples;
+		}
+
+		idx   = (uint32_t)(pos % cap->chunkSamples);
+		n     = cap->chunkSamples - idx;
+		if(n > count)
+			n = count;
+		chunk = (char*)cap->active->map.base + (pos / cap->chunkSamples) * chunkBytes;
+
+		memcpy(chunk + idx * sizeof(ViUInt32), timestamps, n * sizeof(ViUInt32));
+		memcpy(chunk + cap->chunkSamples * sizeof(ViUInt32) + idx * sizeof(ViReal32), values, n * sizeof(ViReal32));
+
+		timestamps   += n;
+		values       += n;
+		count        -= n;
+		cap->samples += n;
+	}
+
+	PMPlat_store64(&cap->header->sampleCount, cap->samples);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  PMConsumerFunc adapter for PMAcq_addConsumer (ctx = PMCapture*)
+---------------------------------------------------------------------------*/
+void PMCapture_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMCapture_append((PMCapture*)ctx, block->timestamps, block->values, block->count);
+}
+
+
+/*---------------------------------------------------------------------------
+  Record an interruption of the stream between two sample timestamps.
+  May be called from one thread other than the writer, before the first
+  sample after the gap is appended.
+---------------------------------------------------------------------------*/
+ViStatus PMCapture_markGap(PMCapture *cap, ViUInt32 lastTimestamp, ViUInt32 firstTimestamp, uint32_t cause, ViStatus status)
+{
+	uint32_t     index = cap->header->gapCount;
+	PMCaptureGap *gap;
+
+	if(index >= PM_CAPTURE_MAX_GAPS)
+	{
+		cap->header->gapOverflows++;
+		return VI_ERROR_QUEUE_OVERFLOW;
+	}
+
+	gap = &cap->header->gaps[index];
+	gap->sampleIndex    = PM_CAPTURE_GAP_PENDING;
+	gap->hostTimeUs     = PMPlat_unixTimeUs();
+	gap->lastTimestamp  = lastTimestamp;
+	gap->firstTimestamp = firstTimestamp;
+	gap->cause          = cause;
+	gap->status         = status;
+	PMPlat_store32(&cap->header->gapCount, index + 1);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Finish the file: flush everything and trim it to the last used chunk
+---------------------------------------------------------------------------*/
+ViStatus PMCapture_close(PMCapture *cap)
+{
+	uint64_t chunks = (cap->samples + cap->chunkSamples - 1) / cap->chunkSamples;
+	ViStatus err;
+
+	if(cap->active != NULL)
+	{
+		PMPlat_store32(&cap->active->state, EXTENT_RETIRED);
+		cap->active = NULL;
+	}
+
+	PMPlat_store32(&cap->running, 0);
+	PMPlat_threadJoin(cap->fileThread);
+
+	PMPlat_store64(&cap->header->sampleCount, cap->samples);
+	PMPlat_store32(&cap->header->closed, 1);
+	PMPlat_fileFlush(&cap->headerMap, 0, sizeof(PMCaptureHeader), VI_TRUE);
+	PMPlat_fileUnmap(&cap->headerMap);
+	cap->header = NULL;
+
+	err = PMPlat_fileResize(&cap->file, PM_CAPTURE_HEADER_SIZE + chunks * CHUNK_BYTES(cap->chunkSamples));
+	PMPlat_fileClose(&cap->file);
+
+	if(cap->writeStatus != VI_SUCCESS)
+		return cap->writeStatus;
+	if(cap->fileStatus != VI_SUCCESS)
+		return cap->fileStatus;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Open a capture file for reading. Works on files still being recorded.
+---------------------------------------------------------------------------*/
+ViStatus PMCaptureReader_open(PMCaptureReader *reader, const char *path)
+{
+	ViStatus err;
+
+	memset(reader, 0, sizeof(PMCaptureReader));
+	reader->mappedChunk = UINT64_MAX;
+
+	if((err = PMPlat_fileOpen(&reader->file, path, VI_FALSE, VI_FALSE)))
+		return err;
+	if((err = PMPlat_fileMap(&reader->file, 0, PM_CAPTURE_HEADER_SIZE, &reader->headerMap)))
+	{
+		PMPlat_fileClose(&reader->file);
+		return err;
+	}
+
+	reader->header = (const PMCaptureHeader*)reader->headerMap.base;
+	if(memcmp(reader->header->magic, PM_CAPTURE_MAGIC, sizeof(PM_CAPTURE_MAGIC)) != 0 ||
+	   reader->header->version < 1 || reader->header->version > PM_CAPTURE_VERSION ||
+	   reader->header->headerSize != PM_CAPTURE_HEADER_SIZE ||
+	   reader->header->chunkSamples == 0 ||
+	   CHUNK_BYTES(reader->header->chunkSamples) % PM_MAP_GRANULARITY != 0)
+	{
+		PMCaptureReader_close(reader);
+		return VI_ERROR_INV_FMT;
+	}
+
+	return VI_SUCCESS;
+}
+
+
+uint64_t PMCaptureReader_sampleCount(PMCaptureReader *reader)
+{
+	return PMPlat_load64((volatile uint64_t*)&reader->header->sampleCount);
+}
+
+
+uint64_t PMCaptureReader_chunkCount(PMCaptureReader *reader)
+{
+	uint64_t samples = PMCaptureReader_sampleCount(reader);
+
+	return (samples + reader->header->chunkSamples - 1) / reader->header->chunkSamples;
+}
+
+
+/*---------------------------------------------------------------------------
+  Zero copy access to one chunk. Only the requested chunk is mapped.
+---------------------------------------------------------------------------*/
+ViStatus PMCaptureReader_getChunk(PMCaptureReader *reader, uint64_t chunk,
+								  const ViUInt32 **timestamps, const ViReal32 **values, uint32_t *count)
+{
+	uint32_t chunkSamples = reader->header->chunkSamples;
+	uint64_t samples = PMCaptureReader_sampleCount(reader);
+	uint64_t first = chunk * chunkSamples;
+	ViStatus err;
+
+	if(first >= samples)
+		return VI_ERROR_INV_OFFSET;
+
+	if(reader->mappedChunk != chunk)
+	{
+		PMPlat_fileUnmap(&reader->chunkMap);
+		reader->mappedChunk = UINT64_MAX;
+		if((err = PMPlat_fileMap(&reader->file, PM_CAPTURE_HEADER_SIZE + chunk * CHUNK_BYTES(chunkSamples),
+								 (size_t)CHUNK_BYTES(chunkSamples), &reader->chunkMap)))
+			return err;
+		reader->mappedChunk = chunk;
+	}
+
+	*timestamps = (const ViUInt32*)reader->chunkMap.base;
+	*values     = (const ViReal32*)((const char*)reader->chunkMap.base + chunkSamples * sizeof(ViUInt32));
+	*count      = (samples - first < chunkSamples) ? (uint32_t)(samples - first) : chunkSamples;
+	return VI_SUCCESS;
+}
+
+
+void PMCaptureReader_close(PMCaptureReader *reader)
+{
+	PMPlat_fileUnmap(&reader->chunkMap);
+	PMPlat_fileUnmap(&reader->headerMap);
+	PMPlat_fileClose(&reader->file);
+	reader->header = NULL;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,169 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Capture file
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Unbounded, append-only capture of the fast measure stream into a
+   memory mapped file.
+
+   File layout (little endian):
+      [0, PM_CAPTURE_HEADER_SIZE)   PMCaptureHeader, rest zero
+      chunk 0, chunk 1, ...          each chunk holds chunkSamples entries:
+                                     ViUInt32 timestamps[chunkSamples]
+                                     ViReal32 values[chunkSamples]
+
+   The writer copies samples into the currently mapped extent only. A
+   file thread grows the file, maps and pre-faults the next extent ahead
+   of time and flushes/unmaps finished ones, so neither the poll loop nor
+   the writer ever waits for the disk. header.sampleCount is updated
+   after every append, so a file can be read while it is recorded.
+
+   Interruptions of the recording (a reconnect of the instrument) are
+   recorded explicitly in the gap table of the header with
+   PMCapture_markGap. The sample index of a gap is filled in when its
+   first sample is appended. Version 1 files have no gap table and read
+   as files without gaps.
+
+****************************************************************************/
+#ifndef _PM_CAPTURE_HEADER_
+#define _PM_CAPTURE_HEADER_
+
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_CAPTURE_MAGIC          "TLPMCAP"
+#define PM_CAPTURE_VERSION        2        // 2: gap table
+#define PM_CAPTURE_HEADER_SIZE    PM_MAP_GRANULARITY
+#define PM_CAPTURE_CHUNK_SAMPLES  65536    // 512 kB per chunk, ~0.65 s at 100 kHz
+#define PM_CAPTURE_EXTENT_CHUNKS  16       // file grows and is mapped in 8 MB steps
+#define PM_CAPTURE_MAX_GAPS       1024     // gap table entries in the header
+#define PM_CAPTURE_GAP_PENDING    UINT64_MAX
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint64_t          sampleIndex;       // first sample after the gap, PM_CAPTURE_GAP_PENDING until appended
+	uint64_t          hostTimeUs;        // host wall clock when the gap was recorded
+	ViUInt32          lastTimestamp;     // last sample before the gap
+	ViUInt32          firstTimestamp;    // first sample after it
+	uint32_t          cause;             // PM_GAP_* (pm_timeline.h)
+	ViStatus          status;            // error that caused it, VI_SUCCESS if none
+} PMCaptureGap;
+
+typedef struct
+{
+	char              magic[8];
+	uint32_t          version;
+	uint32_t          headerSize;
+	uint32_t          chunkSamples;
+	uint32_t          sampleRate;        // Hz, nominal
+	uint64_t          startTimeUs;       // host wall clock at creation, us since 1970 UTC
+	volatile uint64_t sampleCount;       // samples committed so far
+	volatile uint32_t closed;            // 1 once the writer finished the file
+	uint16_t          channel;
+	uint16_t          reserved;
+	char              device[64];        // model name
+	char              serial[32];
+	char              unit[16];          // e.g. "W" or "A"
+	volatile uint32_t gapCount;          // valid entries of gaps[], version 2
+	uint32_t          gapOverflows;      // gaps not recorded, table full
+	PMCaptureGap      gaps[PM_CAPTURE_MAX_GAPS];
+} PMCaptureHeader;
+
+typedef struct
+{
+	const char        *device;
+	const char        *serial;
+	const char        *unit;
+	ViUInt16          channel;
+	uint32_t          sampleRate;
+} PMCaptureInfo;
+
+typedef struct
+{
+	PMPlatMap         map;
+	uint64_t          firstChunk;
+	volatile uint32_t state;
+} PMCaptureExtent;
+
+typedef struct
+{
+	PMPlatFile        file;
+	PMPlatMap         headerMap;
+	PMCaptureHeader   *header;
+	uint32_t          chunkSamples;
+	uint64_t          extentBytes;
+
+	// writer
+	PMCaptureExtent   *active;
+	uint64_t          activeChunk;       // first chunk of the active extent
+	uint64_t          samples;
+	uint32_t          gapsResolved;      // gaps with their sample index filled in
+	ViStatus          writeStatus;
+	volatile uint64_t stalls;            // writer had to wait for the next extent
+
+	// file thread
+	PMThread          fileThread;
+	volatile uint32_t running;
+	volatile ViStatus fileStatus;
+	uint64_t          fileSize;
+	uint64_t          nextChunk;         // first chunk of the next extent to prepare
+	uint64_t          growBytes;
+	uint64_t          lastFlushNs;
+
+	PMCaptureExtent   extents[3];
+} PMCapture;
+
+typedef struct
+{
+	PMPlatFile        file;
+	PMPlatMap         headerMap;
+	const PMCaptureHeader *header;
+	PMPlatMap         chunkMap;
+	uint64_t          mappedChunk;
+} PMCaptureReader;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+// Writer. presizeSamples reserves file space up front (0 = one extent).
+ViStatus PMCapture_create(PMCapture *cap, const char *path, const PMCaptureInfo *info, uint64_t presizeSamples);
+ViStatus PMCapture_append(PMCapture *cap, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count);
+void     PMCapture_consumer(void *ctx, const PMFastBlock *block);
+ViStatus PMCapture_markGap(PMCapture *cap, ViUInt32 lastTimestamp, ViUInt32 firstTimestamp, uint32_t cause, ViStatus status);
+ViStatus PMCapture_close(PMCapture *cap);
+
+// Reader. Chunk pointers stay valid until the next PMCaptureReader_getChunk or close.
+ViStatus PMCaptureReader_open(PMCaptureReader *reader, const char *path);
+uint64_t PMCaptureReader_sampleCount(PMCaptureReader *reader);
+uint64_t PMCaptureReader_chunkCount(PMCaptureReader *reader);
+ViStatus PMCaptureReader_getChunk(PMCaptureReader *reader, uint64_t chunk,
+								  const ViUInt32 **timestamps, const ViReal32 **values, uint32_t *count);
+void     PMCaptureReader_close(PMCaptureReader *reader);
+
+#endif /* _PM_CAPTURE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,467 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Resource discovery
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_discovery.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define WAIT_STEP_US    1000
+#define EMPTY_FIELD     "-"           // cache file placeholder for empty strings
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static void lock(PMDiscovery *disc)
+{
+	while(!PMPlat_cas64(&disc->lock, 0, 1))
+		PMPlat_yield();
+}
+
+
+static void unlock(PMDiscovery *disc)
+{
+	PMPlat_store64(&disc->lock, 0);
+}
+
+
+static PMDiscDevice *findDevice(PMDiscovery *disc, const char *resource)
+{
+	uint32_t i;
+
+	for(i = 0; i < disc->count; i++)
+	{
+		if(strcmp(disc->devices[i].resource, resource) == 0)
+			return &disc->devices[i];
+	}
+	return NULL;
+}
+
+
+static int transportOf(const char *resource, int scan)
+{
+	if(strncmp(resource, "USB", 3) == 0)
+		return PM_DISC_USB;
+	if(strncmp(resource, "ASRL", 4) == 0)
+		return PM_DISC_SERIAL;
+	return (scan == PM_DISC_SCAN_BLUETOOTH) ? PM_DISC_BLUETOOTH : PM_DISC_USB;
+}
+
+
+// src holds at most PM_DISC_NAME_SIZE - 1 characters (fscanf width)
+static void copyField(ViChar dst[], const char *src)
+{
+	strcpy(dst, (strcmp(src, EMPTY_FIELD) == 0) ? "" : src);
+}
+
+
+void PMDiscovery_defaultConfig(PMDiscConfig *cfg)
+{
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->bluetooth                         = VI_TRUE;
+	cfg->timeoutUs[PM_DISC_SCAN_WIRED]     = PM_DISC_WIRED_TIMEOUT_US;
+	cfg->timeoutUs[PM_DISC_SCAN_BLUETOOTH] = PM_DISC_BTH_TIMEOUT_US;
+}
+
+
+void PMDiscovery_init(PMDiscovery *disc, const PMDiscConfig *cfg)
+{
+	memset(disc, 0, sizeof(*disc));
+	if(cfg != NULL)
+		disc->cfg = *cfg;
+	else
+		PMDiscovery_defaultConfig(&disc->cfg);
+}
+
+
+// Waits for a running refresh, driver calls cannot be cancelled
+void PMDiscovery_free(PMDiscovery *disc)
+{
+	if(disc->started && !disc->joined)
+		PMPlat_threadJoin(disc->thread);
+	disc->joined = VI_TRUE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Cache file, one instrument per line: resource, serial number, model,
+  transport, last used flag and the unix time (us) it was last found,
+  separated by tabs
+---------------------------------------------------------------------------*/
+ViStatus PMDiscovery_load(PMDiscovery *disc, const char *path)
+{
+	uint64_t           t0 = PMPlat_timeNs();
+	FILE               *f = fopen(path, "r");
+	char               resource[PM_DISC_NAME_SIZE], serial[PM_DISC_NAME_SIZE], model[PM_DISC_NAME_SIZE];
+	int                transport, lastUsed;
+	unsigned long long lastSeen;
+
+	if(f == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	lock(disc);
+	while(disc->count < PM_DISC_MAX_DEVICES &&
+	      fscanf(f, " %255[^\t]\t%255[^\t]\t%255[^\t]\t%d\t%d\t%llu", resource, serial, model, &transport, &lastUsed, &lastSeen) == 6)
+	{
+		PMDiscDevice *dev = findDevice(disc, resource);
+
+		if(dev == NULL)
+			dev = &disc->devices[disc->count++];
+		memset(dev, 0, sizeof(*dev));
+		copyField(dev->resource, resource);
+		copyField(dev->serial, serial);
+		copyField(dev->model, model);
+		dev->transport  = (transport >= 0 && transport < PM_DISC_TRANSPORTS) ? transport : PM_DISC_USB;
+		dev->available  = VI_TRUE;
+		dev->cached     = VI_TRUE;
+		dev->lastUsed   = (lastUsed != 0);
+		dev->lastSeenUs = lastSeen;
+	}
+	disc->loadNs = PMPlat_timeNs() - t0;
+	unlock(disc);
+
+	fclose(f);
+	return VI_SUCCESS;
+}
+
+
+// Keeps what the refresh found; cached entries only survive if the
+// refresh did not complete or they were used last
+ViStatus PMDiscovery_save(PMDiscovery *disc, const char *path)
+{
+	FILE      *f = fopen(path, "w");
+	ViBoolean complete;
+	uint32_t  i;
+	int       ok = 1;
+
+	if(f == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	lock(disc);
+	complete = disc->started;
+	for(i = 0; i < PM_DISC_SCANS; i++)
+		complete = complete && disc->scan[i].done && disc->scan[i].status == VI_SUCCESS;
+
+	for(i = 0; i < disc->count && ok; i++)
+	{
+		const PMDiscDevice *dev = &disc->devices[i];
+
+		if(!dev->seen && !dev->lastUsed && complete)
+			continue;
+		ok = fprintf(f, "%s\t%s\t%s\t%d\t%d\t%llu\n", dev->resource, dev->serial[0] ? dev->serial : EMPTY_FIELD,
+				dev->model[0] ? dev->model : EMPTY_FIELD, dev->transport, dev->lastUsed ? 1 : 0,
+				(unsigned long long)dev->lastSeenUs) > 0;
+	}
+	unlock(disc);
+
+	if(fclose(f) != 0)
+		ok = 0;
+	return ok ? VI_SUCCESS : VI_ERROR_FILE_IO;
+}
+
+
+/*---------------------------------------------------------------------------
+  Background refresh
+---------------------------------------------------------------------------*/
+static void merge(PMDiscovery *disc, const PMDiscDevice *found)
+{
+	PMDiscDevice *dev;
+
+	lock(disc);
+	if((dev = findDevice(disc, found->resource)) == NULL && disc->count < PM_DISC_MAX_DEVICES)
+	{
+		dev = &disc->devices[disc->count++];
+		memset(dev, 0, sizeof(*dev));
+		strcpy(dev->resource, found->resource);
+	}
+	if(dev != NULL)
+	{
+		strcpy(dev->serial, found->serial);
+		strcpy(dev->model, found->model);
+		dev->transport  = found->transport;
+		dev->available  = found->available;
+		dev->seen       = VI_TRUE;
+		dev->lastSeenUs = PMPlat_unixTimeUs();
+	}
+	unlock(disc);
+}
+
+
+static ViBoolean seenBefore(PMDiscovery *disc, const char *resource)
+{
+	PMDiscDevice *dev;
+	ViBoolean    seen;
+
+	lock(disc);
+	seen = ((dev = findDevice(disc, resource)) != NULL && dev->seen);
+	unlock(disc);
+	return seen;
+}
+
+
+static void runScan(PMDiscovery *disc, int scan)
+{
+	uint64_t     t0 = PMPlat_timeNs();
+	PMDiscDevice dev;
+	ViUInt32     count = 0, i;
+	ViStatus     err;
+
+	// the Bluetooth flag and the resource list stay ours until the scan is done
+	PMDiscovery_lockDriver(disc);
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_setEnableBthSearch(VI_NULL, (scan == PM_DISC_SCAN_BLUETOOTH) ? VI_TRUE : VI_FALSE));
+	if(err == VI_SUCCESS)
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_findRsrc(VI_NULL, &count));
+	if(err == VI_ERROR_RSRC_NFOUND)
+	{
+		err   = VI_SUCCESS;
+		count = 0;
+	}
+
+	for(i = 0; i < count && err == VI_SUCCESS; i++)
+	{
+		memset(&dev, 0, sizeof(dev));
+		if((err = TLPMX_getRsrcName(VI_NULL, i, dev.resource)) != VI_SUCCESS)
+			break;
+		if(scan != PM_DISC_SCAN_WIRED && seenBefore(disc, dev.resource))
+			continue;                    // already queried by the wired scan
+		if((err = TLPMX_getRsrcInfo(VI_NULL, i, dev.model, dev.serial, VI_NULL, &dev.available)) != VI_SUCCESS)
+			break;
+		dev.transport = transportOf(dev.resource, scan);
+		merge(disc, &dev);
+	}
+	PMDiscovery_unlockDriver(disc);
+
+	lock(disc);
+	disc->scan[scan].status     = err;
+	disc->scan[scan].found      = count;
+	disc->scan[scan].durationNs = PMPlat_timeNs() - t0;
+	disc->scan[scan].done       = VI_TRUE;
+	unlock(disc);
+}
+
+
+static void refreshThread(void *arg)
+{
+	PMDiscovery *disc = (PMDiscovery*)arg;
+	uint32_t    i;
+
+	runScan(disc, PM_DISC_SCAN_WIRED);
+	if(disc->cfg.bluetooth)
+		runScan(disc, PM_DISC_SCAN_BLUETOOTH);
+
+	// instruments of the cache that were not found anymore
+	lock(disc);
+	for(i = 0; i < disc->count; i++)
+	{
+		if(!disc->devices[i].seen)
+			disc->devices[i].available = VI_FALSE;
+	}
+	unlock(disc);
+}
+
+
+ViStatus PMDiscovery_start(PMDiscovery *disc)
+{
+	ViStatus err;
+
+	if(disc->started)
+		return VI_ERROR_INV_SETUP;
+
+	memset(disc->scan, 0, sizeof(disc->scan));
+	if(!disc->cfg.bluetooth)
+		disc->scan[PM_DISC_SCAN_BLUETOOTH].done = VI_TRUE;
+	disc->startNs = PMPlat_timeNs();
+	if((err = PMPlat_threadCreate(&disc->thread, refreshThread, disc)) != VI_SUCCESS)
+		return err;
+	disc->started = VI_TRUE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Driver lock. A scan holds it for seconds (Bluetooth), so waiters sleep
+  instead of spinning.
+---------------------------------------------------------------------------*/
+void PMDiscovery_lockDriver(PMDiscovery *disc)
+{
+	while(!PMPlat_cas64(&disc->driverLock, 0, 1))
+		PMPlat_sleepUs(WAIT_STEP_US);
+}
+
+
+void PMDiscovery_unlockDriver(PMDiscovery *disc)
+{
+	PMPlat_store64(&disc->driverLock, 0);
+}
+
+
+/*---------------------------------------------------------------------------
+  Wait until the scan has completed, at most until its timeout counted
+  from the refresh start. Returns the scan status or VI_ERROR_TMO.
+---------------------------------------------------------------------------*/
+ViStatus PMDiscovery_waitScan(PMDiscovery *disc, int scan)
+{
+	uint64_t  deadline;
+	ViBoolean done;
+	ViStatus  status;
+
+	if(!disc->started || scan < 0 || scan >= PM_DISC_SCANS)
+		return VI_ERROR_INV_SETUP;
+
+	deadline = disc->startNs + (uint64_t)disc->cfg.timeoutUs[scan] * 1000;
+	for(;;)
+	{
+		lock(disc);
+		done   = disc->scan[scan].done;
+		status = disc->scan[scan].status;
+		unlock(disc);
+		if(done)
+			return status;
+		if(PMPlat_timeNs() >= deadline)
+			return VI_ERROR_TMO;
+		PMPlat_sleepUs(WAIT_STEP_US);
+	}
+}
+
+
+// VI_SUCCESS as soon as a scan found the resource, VI_ERROR_RSRC_NFOUND
+// if all scans completed without it, VI_ERROR_TMO if one timed out
+ViStatus PMDiscovery_validate(PMDiscovery *disc, const char *resource)
+{
+	ViBoolean timedOut = VI_FALSE;
+	int       scan;
+
+	for(scan = 0; scan < PM_DISC_SCANS; scan++)
+	{
+		if(seenBefore(disc, resource))
+			return VI_SUCCESS;
+		if(PMDiscovery_waitScan(disc, scan) == VI_ERROR_TMO)
+			timedOut = VI_TRUE;
+	}
+
+	if(seenBefore(disc, resource))
+		return VI_SUCCESS;
+	return timedOut ? VI_ERROR_TMO : VI_ERROR_RSRC_NFOUND;
+}
+
+
+/*---------------------------------------------------------------------------
+  Resource list
+---------------------------------------------------------------------------*/
+ViBoolean PMDiscovery_lastUsed(PMDiscovery *disc, PMDiscDevice *device)
+{
+	ViBoolean found = VI_FALSE;
+	uint32_t  i;
+
+	lock(disc);
+	for(i = 0; i < disc->count && !found; i++)
+	{
+		if(disc->devices[i].lastUsed)
+		{
+			*device = disc->devices[i];
+			found   = VI_TRUE;
+		}
+	}
+	unlock(disc);
+	return found;
+}
+
+
+void PMDiscovery_setLastUsed(PMDiscovery *disc, const char *resource)
+{
+	PMDiscDevice *dev;
+	uint32_t     i;
+
+	lock(disc);
+	for(i = 0; i < disc->count; i++)
+		disc->devices[i].lastUsed = VI_FALSE;
+	if((dev = findDevice(disc, resource)) == NULL && disc->count < PM_DISC_MAX_DEVICES)
+	{
+		dev = &disc->devices[disc->count++];
+		memset(dev, 0, sizeof(*dev));
+		strncpy(dev->resource, resource, PM_DISC_NAME_SIZE - 1);
+		dev->transport = transportOf(resource, PM_DISC_SCAN_WIRED);
+		dev->available = VI_TRUE;
+	}
+	if(dev != NULL)
+		dev->lastUsed = VI_TRUE;
+	unlock(disc);
+}
+
+
+uint32_t PMDiscovery_list(PMDiscovery *disc, PMDiscDevice devices[], uint32_t max, ViBoolean seenOnly)
+{
+	uint32_t i, n = 0;
+
+	lock(disc);
+	for(i = 0; i < disc->count && n < max; i++)
+	{
+		if(!seenOnly || disc->devices[i].seen)
+			devices[n++] = disc->devices[i];
+	}
+	unlock(disc);
+	return n;
+}
+
+
+static void printScan(const char *name, const PMDiscScan *scan, ViBoolean enabled)
+{
+	if(!enabled)
+		printf("  %-16s off\n", name);
+	else if(!scan->done)
+		printf("  %-16s still running\n", name);
+	else if(scan->status != VI_SUCCESS)
+		printf("  %-16s failed with 0x%08X after %.1f ms\n", name, (unsigned int)scan->status, scan->durationNs / 1e6);
+	else
+		printf("  %-16s %u instruments in %.1f ms\n", name, (unsigned int)scan->found, scan->durationNs / 1e6);
+}
+
+
+void PMDiscovery_printReport(PMDiscovery *disc)
+{
+	PMDiscScan scan[PM_DISC_SCANS];
+	uint32_t   cached = 0, i;
+	uint64_t   loadNs;
+
+	lock(disc);
+	memcpy(scan, disc->scan, sizeof(scan));
+	for(i = 0; i < disc->count; i++)
+		cached += disc->devices[i].cached;
+	loadNs = disc->loadNs;
+	unlock(disc);
+
+	printf("Instrument discovery:\n");
+	printf("  %-16s %u instruments, read in %.2f ms\n", "cache", (unsigned int)cached, loadNs / 1e6);
+	printScan("wired scan", &scan[PM_DISC_SCAN_WIRED], disc->started);
+	printScan("Bluetooth scan", &scan[PM_DISC_SCAN_BLUETOOTH], disc->started && disc->cfg.bluetooth);
+}
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,144 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Resource discovery
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Instrument discovery that does not hold up program start. The resource
+   list of the last run (resource name, serial number, model, transport)
+   is kept in a small cache file, so the instrument used last time can be
+   opened right away while a background thread enumerates the connected
+   instruments and validates the cache.
+
+   The refresh runs one scan per transport group, each with its own
+   timeout: wired instruments (USB and serial, Bluetooth search off)
+   first, then Bluetooth. Waiting for the wired scan therefore never
+   includes the much slower Bluetooth search. The TLPMX driver keeps a
+   single resource list and a global Bluetooth search flag, so the scans
+   themselves run one after the other on the refresh thread. TLPMX does
+   not document these as safe next to calls on an open session, so each
+   scan holds the driver lock; the application takes the same lock
+   (PMDiscovery_lockDriver) around its own driver calls while a refresh
+   may be running. The cache and the scan results are read without it.
+   A scan that takes longer than its timeout is reported as timed out to
+   waiting callers, its result is still merged when it arrives.
+
+****************************************************************************/
+#ifndef _PM_DISCOVERY_HEADER_
+#define _PM_DISCOVERY_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_DISC_MAX_DEVICES       32
+#define PM_DISC_NAME_SIZE         256       // TLPM_BUFFER_SIZE
+#define PM_DISC_WIRED_TIMEOUT_US  2000000
+#define PM_DISC_BTH_TIMEOUT_US    10000000
+
+// Transports, from the resource name
+#define PM_DISC_USB               0
+#define PM_DISC_SERIAL            1
+#define PM_DISC_BLUETOOTH         2
+#define PM_DISC_TRANSPORTS        3
+
+// Scans of a refresh, in this order
+#define PM_DISC_SCAN_WIRED        0         // USB and serial
+#define PM_DISC_SCAN_BLUETOOTH    1
+#define PM_DISC_SCANS             2
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViChar    resource[PM_DISC_NAME_SIZE];
+	ViChar    serial[PM_DISC_NAME_SIZE];
+	ViChar    model[PM_DISC_NAME_SIZE];
+	int       transport;          // PM_DISC_USB, ...
+	ViBoolean available;          // not locked by another application
+	ViBoolean cached;             // known from the cache file
+	ViBoolean seen;               // found by the running refresh
+	ViBoolean lastUsed;           // opened by the last run
+	uint64_t  lastSeenUs;         // unix time the instrument was last found
+} PMDiscDevice;
+
+typedef struct
+{
+	ViBoolean bluetooth;          // run the Bluetooth scan
+	uint32_t  timeoutUs[PM_DISC_SCANS];
+} PMDiscConfig;
+
+typedef struct
+{
+	ViBoolean done;
+	ViStatus  status;
+	uint32_t  found;              // instruments reported by the scan
+	uint64_t  durationNs;
+} PMDiscScan;
+
+typedef struct
+{
+	PMDiscConfig      cfg;
+	volatile uint64_t lock;       // devices, count and scan results
+	volatile uint64_t driverLock; // TLPMX calls, see PMDiscovery_lockDriver
+	PMDiscDevice      devices[PM_DISC_MAX_DEVICES];
+	uint32_t          count;
+
+	PMThread          thread;
+	ViBoolean         started;
+	ViBoolean         joined;
+	uint64_t          startNs;    // refresh start
+	uint64_t          loadNs;     // time spent reading the cache
+	PMDiscScan        scan[PM_DISC_SCANS];
+} PMDiscovery;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void     PMDiscovery_defaultConfig(PMDiscConfig *cfg);
+void     PMDiscovery_init(PMDiscovery *disc, const PMDiscConfig *cfg);
+void     PMDiscovery_free(PMDiscovery *disc);
+
+// Cache file
+ViStatus PMDiscovery_load(PMDiscovery *disc, const char *path);
+ViStatus PMDiscovery_save(PMDiscovery *disc, const char *path);
+
+// Background refresh
+ViStatus PMDiscovery_start(PMDiscovery *disc);
+ViStatus PMDiscovery_waitScan(PMDiscovery *disc, int scan);
+ViStatus PMDiscovery_validate(PMDiscovery *disc, const char *resource);
+
+// Serializes driver calls with a running scan; never hold it while waiting for a scan
+void     PMDiscovery_lockDriver(PMDiscovery *disc);
+void     PMDiscovery_unlockDriver(PMDiscovery *disc);
+
+// Resource list
+ViBoolean PMDiscovery_lastUsed(PMDiscovery *disc, PMDiscDevice *device);
+void     PMDiscovery_setLastUsed(PMDiscovery *disc, const char *resource);
+uint32_t PMDiscovery_list(PMDiscovery *disc, PMDiscDevice devices[], uint32_t max, ViBoolean seenOnly);
+void     PMDiscovery_printReport(PMDiscovery *disc);
+
+#endif /* _PM_DISCOVERY_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,157 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - FFT
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_fft.h"
+
+#include <math.h>
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+ViStatus PMFft_init(PMFft *plan, uint32_t length)
+{
+	uint32_t half = length / 2;
+	uint32_t bits = 0, i;
+
+	memset(plan, 0, sizeof(PMFft));
+	if(length < PM_FFT_MIN_LENGTH || length > PM_FFT_MAX_LENGTH || (length & (length - 1)) != 0)
+		return VI_ERROR_INV_SETUP;
+
+	plan->bitReverse = (uint32_t*)PMPlat_alignedAlloc(half * sizeof(uint32_t), PM_CACHE_LINE);
+	plan->cosTable   = (double*)PMPlat_alignedAlloc(half * sizeof(double), PM_CACHE_LINE);
+	plan->sinTable   = (double*)PMPlat_alignedAlloc(half * sizeof(double), PM_CACHE_LINE);
+	if(plan->bitReverse == NULL || plan->cosTable == NULL || plan->sinTable == NULL)
+	{
+		PMFft_free(plan);
+		return VI_ERROR_ALLOC;
+	}
+	plan->length = length;
+
+	while((1u << bits) < half)
+		bits++;
+	for(i = 0; i < half; i++)
+	{
+		uint32_t r = 0, b;
+
+		for(b = 0; b < bits; b++)
+			if(i & (1u << b))
+				r |= 1u << (bits - 1 - b);
+		plan->bitReverse[i] = r;
+		plan->cosTable[i]   = cos(2.0 * M_PI * (double)i / (double)length);
+		plan->sinTable[i]   = sin(2.0 * M_PI * (double)i / (double)length);
+	}
+	return VI_SUCCESS;
+}
+
+
+void PMFft_free(PMFft *plan)
+{
+	PMPlat_alignedFree(plan->bitReverse);
+	PMPlat_alignedFree(plan->cosTable);
+	PMPlat_alignedFree(plan->sinTable);
+	memset(plan, 0, sizeof(PMFft));
+}
+
+
+/*---------------------------------------------------------------------------
+  Spectrum of length real samples. re[] and im[] receive bins 0 to
+  length / 2 (length / 2 + 1 entries each) and serve as work buffers.
+---------------------------------------------------------------------------*/
+void PMFft_real(const PMFft *plan, const double input[], double re[], double im[])
+{
+	uint32_t half = plan->length / 2;
+	uint32_t size, i, k;
+
+	// Even samples as real part, odd samples as imaginary part, bit reversed
+	for(i = 0; i < half; i++)
+	{
+		uint32_t r = plan->bitReverse[i];
+
+		re[r] = input[2 * i];
+		im[r] = input[2 * i + 1];
+	}
+
+	// Radix-2 butterflies; the twiddle of a length half transform is every second table entry
+	for(size = 2; size <= half; size <<= 1)
+	{
+		uint32_t step = plan->length / size;
+		uint32_t span = size / 2;
+
+		for(i = 0; i < half; i += size)
+		{
+			for(k = 0; k < span; k++)
+			{
+				double   wr = plan->cosTable[k * step];
+				double   wi = -plan->sinTable[k * step];
+				uint32_t a = i + k, b = a + span;
+				double   tr = re[b] * wr - im[b] * wi;
+				double   ti = re[b] * wi + im[b] * wr;
+
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+
+	// Split Z into the spectra of the even and odd samples: X[k] = E[k] + W^k O[k] with
+	// E[k] = (Z[k] + conj(Z[half - k])) / 2, O[k] = (Z[k] - conj(Z[half - k])) / 2i.
+	// X[half - k] follows from E and O of the same pair: conjugate both, W^(half - k) = -conj(W^k).
+	{
+		double z0r = re[0], z0i = im[0];
+
+		for(k = 1; k <= half / 2; k++)
+		{
+			uint32_t j = half - k;
+			double   er = 0.5 * (re[k] + re[j]), ei = 0.5 * (im[k] - im[j]);
+			double   dr = 0.5 * (im[k] + im[j]), di = -0.5 * (re[k] - re[j]);
+			double   wr = plan->cosTable[k], wi = -plan->sinTable[k];
+			double   tr = wr * dr - wi * di;
+			double   ti = wr * di + wi * dr;
+
+			re[k] = er + tr;
+			im[k] = ei + ti;
+			re[j] = er - tr;
+			im[j] = ti - ei;
+		}
+
+		re[0]    = z0r + z0i;
+		im[0]    = 0.0;
+		re[half] = z0r - z0i;
+		im[half] = 0.0;
+	}
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,66 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - FFT
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Self-contained FFT of real input, for the spectral analysis of the
+   fast measure stream without an external library.
+
+   A plan holds the twiddle factors and the bit reversal table of one
+   power of two length; it is computed once and only read afterwards, so
+   any number of streams and threads can share it. A real transform of
+   length n runs as a complex radix-2 transform of length n / 2 plus one
+   pass that splits the even and odd spectra.
+
+****************************************************************************/
+#ifndef _PM_FFT_HEADER_
+#define _PM_FFT_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_FFT_MIN_LENGTH         8
+#define PM_FFT_MAX_LENGTH         (1u << 24)
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint32_t  length;             // real input samples, power of two
+	uint32_t  *bitReverse;        // length / 2 entries
+	double    *cosTable;          // cos(2 pi k / length), k < length / 2
+	double    *sinTable;          // sin(2 pi k / length)
+} PMFft;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus PMFft_init(PMFft *plan, uint32_t length);
+void     PMFft_free(PMFft *plan);
+void     PMFft_real(const PMFft *plan, const double input[], double re[], double im[]);
+
+#endif /* _PM_FFT_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,276 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Level-of-detail pyramid
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_lod.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+PM_INLINE PMLodBucket *bucketAt(PMLodLevel *lv, uint32_t index)
+{
+	return &lv->segments[index / PM_LOD_SEGMENT_BUCKETS][index % PM_LOD_SEGMENT_BUCKETS];
+}
+
+
+/*---------------------------------------------------------------------------
+  Publish a bucket on level k; every second one completes a bucket above
+---------------------------------------------------------------------------*/
+static void pushBucket(PMLod *lod, uint32_t k, PMLodBucket b)
+{
+	for(;;)
+	{
+		PMLodLevel  *lv = &lod->level[k];
+		uint32_t    n = lv->count;
+		uint32_t    seg = n / PM_LOD_SEGMENT_BUCKETS;
+		PMLodBucket *prev;
+
+		if(seg >= lv->maxSegments)
+		{
+			lod->status = VI_ERROR_ALLOC;
+			return;
+		}
+		if(lv->segments[seg] == NULL)
+		{
+			lv->segments[seg] = (PMLodBucket*)malloc(PM_LOD_SEGMENT_BUCKETS * sizeof(PMLodBucket));
+			if(lv->segments[seg] == NULL)
+			{
+				lod->status = VI_ERROR_ALLOC;
+				return;
+			}
+		}
+
+		*bucketAt(lv, n) = b;
+		PMPlat_store32(&lv->count, n + 1);
+
+		if((n & 1) == 0 || k + 1 >= PM_LOD_MAX_LEVELS)
+			return;
+
+		prev = bucketAt(lv, n - 1);
+		if(prev->min < b.min) b.min = prev->min;
+		if(prev->max > b.max) b.max = prev->max;
+		b.mean = (ViReal32)(((double)prev->mean + (double)b.mean) * 0.5);
+		k++;
+	}
+}
+
+
+ViStatus PMLod_init(PMLod *lod, uint32_t baseSamples)
+{
+	uint32_t k;
+
+	memset(lod, 0, sizeof(PMLod));
+	if(baseSamples == 0)
+		baseSamples = PM_LOD_DEFAULT_BASE;
+	if(baseSamples & (baseSamples - 1))
+		return VI_ERROR_INV_SETUP;
+
+	lod->baseSamples = baseSamples;
+	while((1u << lod->baseShift) < baseSamples)
+		lod->baseShift++;
+
+	for(k = 0; k < PM_LOD_MAX_LEVELS; k++)
+	{
+		lod->level[k].maxSegments = (PM_LOD_MAX_SEGMENTS >> k) + 1;
+		lod->level[k].segments    = (PMLodBucket**)calloc(lod->level[k].maxSegments, sizeof(PMLodBucket*));
+		if(lod->level[k].segments == NULL)
+		{
+			PMLod_free(lod);
+			return VI_ERROR_ALLOC;
+		}
+	}
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMLod_append(PMLod *lod, const ViReal32 values[], uint32_t count)
+{
+	while(count > 0 && lod->status == VI_SUCCESS)
+	{
+		uint32_t take = lod->baseSamples - (uint32_t)lod->open.count;
+
+		if(take > count)
+			take = count;
+
+		PMStats_add(&lod->open, values, take);
+		if(lod->open.count == lod->baseSamples)
+		{
+			PMLodBucket b;
+
+			b.min  = lod->open.min;
+			b.max  = lod->open.max;
+			b.mean = (ViReal32)lod->open.mean;
+			pushBucket(lod, 0, b);
+			PMStats_reset(&lod->open);
+		}
+
+		lod->samples += take;
+		values += take;
+		count  -= take;
+	}
+	return lod->status;
+}
+
+
+/*---------------------------------------------------------------------------
+  PMConsumerFunc adapter, ctx is the PMLod
+---------------------------------------------------------------------------*/
+void PMLod_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMLod_append((PMLod*)ctx, block->values, block->count);
+}
+
+
+/*---------------------------------------------------------------------------
+  Append the samples of a capture file not yet in the pyramid. Can be
+  called repeatedly to follow a file that is still being recorded.
+---------------------------------------------------------------------------*/
+ViStatus PMLod_appendCapture(PMLod *lod, PMCaptureReader *reader)
+{
+	uint64_t total = PMCaptureReader_sampleCount(reader);
+	uint32_t chunkSamples = reader->header->chunkSamples;
+	ViStatus stat = lod->status;
+
+	while(stat == VI_SUCCESS && lod->samples < total)
+	{
+		const ViUInt32 *timestamps;
+		const ViReal32 *values;
+		uint32_t       count;
+		uint32_t       offset = (uint32_t)(lod->samples % chunkSamples);
+
+		stat = PMCaptureReader_getChunk(reader, lod->samples / chunkSamples, &timestamps, &values, &count);
+		if(stat != VI_SUCCESS || count <= offset)
+			break;
+		stat = PMLod_append(lod, values + offset, count - offset);
+	}
+	return stat;
+}
+
+
+/*---------------------------------------------------------------------------
+  Samples covered by complete buckets, i.e. visible to PMLod_query
+---------------------------------------------------------------------------*/
+uint64_t PMLod_available(PMLod *lod)
+{
+	return (uint64_t)PMPlat_load32(&lod->level[0].count) << lod->baseShift;
+}
+
+
+/*---------------------------------------------------------------------------
+  Reduce samples [first, last) to 'pixels' buckets. Each pixel is served
+  from the coarsest level whose buckets are not wider than a pixel, so a
+  pixel touches at most a few buckets. Pixels narrower than a level 0
+  bucket repeat that bucket. *filled receives the number of pixels with
+  data, less than pixels if the range extends past PMLod_available.
+---------------------------------------------------------------------------*/
+ViStatus PMLod_query(PMLod *lod, uint64_t first, uint64_t last, uint32_t pixels,
+					 PMLodBucket out[], uint32_t *filled)
+{
+	uint64_t span = last - first;
+	uint64_t samplesPerPixel;
+	uint32_t top = 0, p;
+
+	*filled = 0;
+	if(pixels == 0 || last <= first)
+		return VI_ERROR_INV_SETUP;
+	if(first >= PMLod_available(lod))
+		return VI_ERROR_INV_OFFSET;
+
+	samplesPerPixel = span / pixels;
+	while(top + 1 < PM_LOD_MAX_LEVELS && ((uint64_t)lod->baseSamples << (top + 1)) <= samplesPerPixel &&
+		  PMPlat_load32(&lod->level[top + 1].count) > 0)
+		top++;
+
+	for(p = 0; p < pixels; p++)
+	{
+		uint64_t s0 = first + span * p / pixels;
+		uint64_t s1 = first + span * (p + 1) / pixels;
+		uint64_t s = s0, weight = 0;
+		double   sum = 0.0;
+		int      k = (int)top;
+		PMLodBucket px;
+
+		if(s1 <= s0)
+			s1 = s0 + 1;
+
+		// the newest buckets may not be merged into the upper levels yet,
+		// continue on the finer levels where the coarse one ends
+		while(s < s1 && k >= 0)
+		{
+			PMLodLevel *lv = &lod->level[k];
+			uint32_t   shift = lod->baseShift + (uint32_t)k;
+			uint64_t   n = PMPlat_load32(&lv->count);
+			uint64_t   b = s >> shift, bEnd = (s1 - 1) >> shift;
+
+			if(b >= n)
+			{
+				k--;
+				continue;
+			}
+			if(bEnd >= n)
+				bEnd = n - 1;
+
+			for(; b <= bEnd; b++)
+			{
+				const PMLodBucket *bk = bucketAt(lv, (uint32_t)b);
+
+				if(weight == 0 || bk->min < px.min) px.min = bk->min;
+				if(weight == 0 || bk->max > px.max) px.max = bk->max;
+				sum    += (double)bk->mean * (double)(1u << k);
+				weight += 1u << k;
+			}
+			s = (bEnd + 1) << shift;
+		}
+
+		if(weight == 0)
+			break;
+		px.mean = (ViReal32)(sum / (double)weight);
+		out[p]  = px;
+	}
+
+	*filled = p;
+	return VI_SUCCESS;
+}
+
+
+void PMLod_free(PMLod *lod)
+{
+	uint32_t k, s;
+
+	for(k = 0; k < PM_LOD_MAX_LEVELS; k++)
+	{
+		if(lod->level[k].segments == NULL)
+			continue;
+		for(s = 0; s < lod->level[k].maxSegments; s++)
+			free(lod->level[k].segments[s]);
+		free(lod->level[k].segments);
+	}
+	memset(lod, 0, sizeof(PMLod));
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,93 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Level-of-detail pyramid
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Min/max/mean level-of-detail pyramid for plotting long captures.
+
+   Level 0 holds one bucket per baseSamples samples, every level above
+   halves the resolution. Buckets are appended as blocks arrive, so a
+   viewer can query any sample range at any pixel count in O(pixels)
+   while the stream is still running, without touching raw samples. The
+   pyramid costs about 2 * 12 / baseSamples bytes per sample.
+
+   Storage is segmented and never moves, so one thread may append while
+   others query. Only complete buckets are visible to queries.
+
+****************************************************************************/
+#ifndef _PM_LOD_HEADER_
+#define _PM_LOD_HEADER_
+
+#include "pm_capture.h"
+#include "pm_stats.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_LOD_DEFAULT_BASE       256      // samples per level 0 bucket, power of two
+#define PM_LOD_MAX_LEVELS         32
+#define PM_LOD_SEGMENT_BUCKETS    4096
+#define PM_LOD_MAX_SEGMENTS       16384    // level 0 capacity: 64 M buckets
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViReal32  min;
+	ViReal32  max;
+	ViReal32  mean;
+} PMLodBucket;
+
+typedef struct
+{
+	PMLodBucket       **segments;
+	uint32_t          maxSegments;
+	volatile uint32_t count;            // published buckets
+} PMLodLevel;
+
+typedef struct
+{
+	uint32_t    baseSamples;
+	uint32_t    baseShift;
+	uint64_t    samples;                // samples appended, including the open bucket
+	PMStats     open;                   // level 0 bucket being filled
+	ViStatus    status;
+	PMLodLevel  level[PM_LOD_MAX_LEVELS];
+} PMLod;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus PMLod_init(PMLod *lod, uint32_t baseSamples);
+ViStatus PMLod_append(PMLod *lod, const ViReal32 values[], uint32_t count);
+void     PMLod_consumer(void *ctx, const PMFastBlock *block);
+ViStatus PMLod_appendCapture(PMLod *lod, PMCaptureReader *reader);
+uint64_t PMLod_available(PMLod *lod);
+ViStatus PMLod_query(PMLod *lod, uint64_t first, uint64_t last, uint32_t pixels,
+					 PMLodBucket out[], uint32_t *filled);
+void     PMLod_free(PMLod *lod);
+
+#endif /* _PM_LOD_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,272 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Device models
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_model.h"
+
+#include <string.h>
+
+#include "TLPM.h"
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define NAME_SIZE       256         // TLPM_BUFFER_SIZE
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+/*---------------------------------------------------------------------------
+  Reader templates. Every model instantiates them below with its
+  constants, so the checks on the traits are resolved by the compiler.
+---------------------------------------------------------------------------*/
+PM_INLINE ViStatus readBlockT(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[],
+		uint32_t modes, uint32_t fastBlock)
+{
+	ViStatus err;
+
+	if(!(modes & PM_MODEL_FAST))
+		return VI_ERROR_NSUP_OPER;
+
+	PM_TRACE_CALL(PM_TRACE_FAST_ARRAY, err, TLPM_getNextFastArrayMeasurement((ViSession)(uintptr_t)source, count, timestamps, values));
+	PM_TRACE_VALUE(PM_TRACE_FAST_ARRAY_COUNT, *count);
+	if(*count > fastBlock)
+		*count = (ViUInt16)fastBlock;
+	return err;
+}
+
+
+PM_INLINE ViStatus readFastT(PMSampleBlock *block, ViSession vi, ViUInt16 channel, ViUInt16 *count,
+		uint32_t modes, uint32_t fastBlock)
+{
+	ViStatus err;
+
+	*count = 0;
+	if(!(modes & PM_MODEL_FAST))
+		return VI_ERROR_NSUP_OPER;
+	if(block->capacity - block->count < fastBlock)
+		return VI_ERROR_USER_BUF;
+
+	PM_TRACE_CALL(PM_TRACE_FAST_ARRAY, err, TLPMX_getNextFastArrayMeasurement(vi, count,
+			block->timestamps + block->count, block->channel[0] + block->count, channel));
+	PM_TRACE_VALUE(PM_TRACE_FAST_ARRAY_COUNT, *count);
+	if(err != VI_SUCCESS)
+		return err;
+	if(*count > fastBlock)
+		*count = (ViUInt16)fastBlock;
+	PMBlock_setCount(block, block->count + *count);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  count is a multiple of 100, the conversion of the driver's ViReal32
+  timestamps in ms to ViUInt32 us runs four entries per iteration
+---------------------------------------------------------------------------*/
+PM_INLINE ViStatus readSequenceT(PMSampleBlock *block, ViSession vi, ViUInt16 channel,
+		uint32_t modes, uint32_t channels, uint32_t baseTime)
+{
+	const uint32_t count = baseTime * 100;
+	ViUInt32       *ts = block->timestamps;
+	ViReal32       t[4];
+	uint32_t       i, k;
+	ViStatus       err;
+
+	if(!(modes & PM_MODEL_SEQUENCE))
+		return VI_ERROR_NSUP_OPER;
+	if(block->capacity < count || block->channels < channels)
+		return VI_ERROR_USER_BUF;
+
+	PM_TRACE_CALL(PM_TRACE_MEAS_SEQUENCE, err, TLPMX_getMeasurementSequence(vi, baseTime, (ViReal32*)ts,
+			block->channel[0], (channels > 1) ? block->channel[1] : VI_NULL, channel));
+	if(err != VI_SUCCESS)
+	{
+		PMBlock_setCount(block, 0);
+		return err;
+	}
+
+	for(i = 0; i < count; i += 4)
+	{
+		memcpy(t, &ts[i], sizeof(t));
+		for(k = 0; k < 4; k++)
+			ts[i + k] = (t[k] > 0.0f) ? (ViUInt32)(t[k] * 1000.0f + 0.5f) : 0;
+	}
+	PMBlock_setCount(block, count);
+	return VI_SUCCESS;
+}
+
+
+PM_INLINE ViStatus readBurstT(PMSampleBlock *block, ViSession vi, ViUInt32 start, ViUInt32 count,
+		uint32_t modes, uint32_t channels)
+{
+	ViStatus err;
+
+	if(!(modes & PM_MODEL_BURST))
+		return VI_ERROR_NSUP_OPER;
+	if(count > block->capacity || block->channels < channels)
+		return VI_ERROR_USER_BUF;
+
+	PM_TRACE_CALL(PM_TRACE_BURST_SAMPLES, err, TLPMX_getBurstArraySamples(vi, start, count, block->timestamps,
+			block->channel[0], (channels > 1) ? block->channel[1] : VI_NULL));
+	PM_TRACE_VALUE(PM_TRACE_BURST_COUNT, count);
+
+	PMBlock_setCount(block, (err == VI_SUCCESS) ? count : 0);
+	block->first = start;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Per model instances and the model table
+---------------------------------------------------------------------------*/
+#define PM_MODEL_INSTANCE(M)                                                                                           \
+	typedef char PMModelCheck_##M[(PM_MODEL_##M##_FAST_BLOCK <= PM_FAST_BLOCK_SIZE &&                                  \
+								   PM_MODEL_##M##_CHANNELS <= PM_BLOCK_MAX_CHANNELS &&                                 \
+								   (!(PM_MODEL_##M##_MODES & PM_MODEL_BURST) || PM_MODEL_##M##_CHANNELS == 2)) ? 1 : -1]; \
+	static ViStatus readBlock_##M(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])             \
+	{ return readBlockT(source, count, timestamps, values, PM_MODEL_##M##_MODES, PM_MODEL_##M##_FAST_BLOCK); }         \
+	static ViStatus readFast_##M(PMSampleBlock *block, ViSession vi, ViUInt16 channel, ViUInt16 *count)                \
+	{ return readFastT(block, vi, channel, count, PM_MODEL_##M##_MODES, PM_MODEL_##M##_FAST_BLOCK); }                  \
+	static ViStatus readSequence_##M(PMSampleBlock *block, ViSession vi, ViUInt16 channel)                             \
+	{ return readSequenceT(block, vi, channel, PM_MODEL_##M##_MODES, PM_MODEL_##M##_CHANNELS,                          \
+						   PM_MODEL_##M##_SEQUENCE_BASE); }                                                            \
+	static ViStatus readBurst_##M(PMSampleBlock *block, ViSession vi, ViUInt32 start, ViUInt32 count)                  \
+	{ return readBurstT(block, vi, start, count, PM_MODEL_##M##_MODES, PM_MODEL_##M##_CHANNELS); }
+
+#define PM_MODEL_ENTRY(M)                                                                                              \
+	{ PM_MODEL_##M, #M, PM_MODEL_##M##_NAMES, PM_MODEL_##M##_CHANNELS, PM_MODEL_##M##_FAST_BLOCK,                      \
+	  PM_MODEL_##M##_PERIOD_US, PM_MODEL_##M##_SEQUENCE_BASE, PM_MODEL_##M##_MODES,                                    \
+	  readBlock_##M, readFast_##M, readSequence_##M, readBurst_##M },
+
+PM_MODEL_LIST(PM_MODEL_INSTANCE)
+
+static const PMModel models[PM_MODEL_COUNT] = { PM_MODEL_LIST(PM_MODEL_ENTRY) };
+
+
+const PMModel *PMModel_get(uint32_t id)
+{
+	return &models[(id < PM_MODEL_COUNT) ? id : PM_MODEL_GENERIC];
+}
+
+
+/*---------------------------------------------------------------------------
+  Model of an identification device name ("PM103", "PM100D", ...);
+  PM_MODEL_GENERIC if the name is not known
+---------------------------------------------------------------------------*/
+const PMModel *PMModel_find(const char *deviceName)
+{
+	uint32_t m;
+
+	for(m = 0; m < PM_MODEL_COUNT && deviceName != NULL; m++)
+	{
+		const char *p = models[m].names;
+
+		while(*p != '\0')
+		{
+			size_t len = strcspn(p, ",");
+
+			if(strncmp(deviceName, p, len) == 0)
+				return &models[m];
+			p += len;
+			if(*p == ',')
+				p++;
+		}
+	}
+	return &models[PM_MODEL_GENERIC];
+}
+
+
+/*---------------------------------------------------------------------------
+  Model of an open TLPMX session, queried once when the session is opened
+---------------------------------------------------------------------------*/
+ViStatus PMModel_identify(ViSession vi, const PMModel **model)
+{
+	ViChar   name[NAME_SIZE];
+	ViStatus err;
+
+	*model = &models[PM_MODEL_GENERIC];
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_identificationQuery(vi, VI_NULL, name, VI_NULL, VI_NULL));
+	if(err == VI_SUCCESS)
+		*model = PMModel_find(name);
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Fast measure stream source for PMAcq on a TLPM session
+---------------------------------------------------------------------------*/
+PMBlockSource PMModel_source(const PMModel *model, ViSession instrHandle)
+{
+	PMBlockSource src;
+
+	src.readBlock = model->readBlock;
+	src.source    = (void*)(uintptr_t)instrHandle;
+	return src;
+}
+
+
+/*---------------------------------------------------------------------------
+  Model and fast measure stream source of a TLPM session, resolved once
+  when the session is opened. VI_ERROR_NSUP_OPER if the model has no
+  fast measure stream.
+---------------------------------------------------------------------------*/
+ViStatus PMModel_deviceSource(ViSession instrHandle, const PMModel **model, PMBlockSource *source)
+{
+	ViChar   name[NAME_SIZE];
+	ViStatus err;
+
+	*model = &models[PM_MODEL_GENERIC];
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_identificationQuery(instrHandle, VI_NULL, name, VI_NULL, VI_NULL));
+	if(err != VI_SUCCESS)
+		return err;
+	*model = PMModel_find(name);
+	if(!((*model)->modes & PM_MODEL_FAST))
+		return VI_ERROR_NSUP_OPER;
+	*source = PMModel_source(*model, instrHandle);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Block sized for one read of a mode: PM_MODEL_FAST or PM_MODEL_SEQUENCE.
+  Burst chunks are sized by PMBurst.
+---------------------------------------------------------------------------*/
+ViStatus PMModel_initBlock(const PMModel *model, PMSampleBlock *block, uint32_t mode)
+{
+	memset(block, 0, sizeof(PMSampleBlock));
+	if(!(model->modes & mode))
+		return VI_ERROR_NSUP_OPER;
+
+	switch(mode)
+	{
+		case PM_MODEL_FAST:     return PMBlock_init(block, model->fastBlock, 1);
+		case PM_MODEL_SEQUENCE: return PMBlock_init(block, model->sequenceBase * 100, model->channels);
+		default:                return VI_ERROR_INV_SETUP;
+	}
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
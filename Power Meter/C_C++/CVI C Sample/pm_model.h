@@ -0,0 +1,165 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Device models
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Compile-time traits of the supported instrument models, and block
+   readers specialized on them.
+
+   Every model has a set of constants (channels, fast measure stream
+   block, sample period, measurement sequence length, supported modes).
+   pm_model.c instantiates the readers once per model from these
+   constants: buffer sizes are fixed, capability checks and the channel
+   count fold away at compile time and loops have a constant trip count
+   the compiler unrolls. The model is resolved once, when the session is
+   opened (PMModel_identify, PMModel_deviceSource / PMModel_find);
+   afterwards the acquisition calls the model's readers through its
+   PMModel entry without any further checks. These are the only block
+   readers; code that does not know the model uses PM_MODEL_GENERIC.
+
+   The rates are nominal figures of the models; TLPMX_getFastMaxSamplerate
+   reports the exact value of a connected instrument. Unknown instruments
+   get PM_MODEL_GENERIC, which supports every mode and leaves the checks
+   to the driver.
+
+****************************************************************************/
+#ifndef _PM_MODEL_HEADER_
+#define _PM_MODEL_HEADER_
+
+#include "pm_acquisition.h"
+#include "pm_block.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+// Modes
+#define PM_MODEL_FAST             0x01      // fast measure stream (confPower/CurrentFastArrayMeasurement)
+#define PM_MODEL_SEQUENCE         0x02      // measurement sequence
+#define PM_MODEL_BURST            0x04      // triggered burst array, both channels
+
+// Model identifiers, index into the model table
+#define PM_MODEL_PM100            0
+#define PM_MODEL_PM101            1
+#define PM_MODEL_PM103            2
+#define PM_MODEL_PM400            3
+#define PM_MODEL_PM5020           4
+#define PM_MODEL_PM60             5
+#define PM_MODEL_GENERIC          6
+#define PM_MODEL_COUNT            7
+
+// PM100A/D/USB, PM102: scalar readings only
+#define PM_MODEL_PM100_NAMES          "PM100,PM102"
+#define PM_MODEL_PM100_CHANNELS       1
+#define PM_MODEL_PM100_FAST_BLOCK     0
+#define PM_MODEL_PM100_PERIOD_US      100
+#define PM_MODEL_PM100_SEQUENCE_BASE  0
+#define PM_MODEL_PM100_MODES          0
+
+// PM101 OEM power meter: measurement sequences
+#define PM_MODEL_PM101_NAMES          "PM101"
+#define PM_MODEL_PM101_CHANNELS       1
+#define PM_MODEL_PM101_FAST_BLOCK     0
+#define PM_MODEL_PM101_PERIOD_US      100
+#define PM_MODEL_PM101_SEQUENCE_BASE  10
+#define PM_MODEL_PM101_MODES          (PM_MODEL_SEQUENCE)
+
+// PM103: 100 kHz fast measure stream
+#define PM_MODEL_PM103_NAMES          "PM103"
+#define PM_MODEL_PM103_CHANNELS       1
+#define PM_MODEL_PM103_FAST_BLOCK     202
+#define PM_MODEL_PM103_PERIOD_US      10
+#define PM_MODEL_PM103_SEQUENCE_BASE  10
+#define PM_MODEL_PM103_MODES          (PM_MODEL_FAST | PM_MODEL_SEQUENCE)
+
+// PM400 touch screen console
+#define PM_MODEL_PM400_NAMES          "PM400"
+#define PM_MODEL_PM400_CHANNELS       1
+#define PM_MODEL_PM400_FAST_BLOCK     0
+#define PM_MODEL_PM400_PERIOD_US      100
+#define PM_MODEL_PM400_SEQUENCE_BASE  10
+#define PM_MODEL_PM400_MODES          (PM_MODEL_SEQUENCE)
+
+// PM5020: two channels, burst array
+#define PM_MODEL_PM5020_NAMES         "PM5020"
+#define PM_MODEL_PM5020_CHANNELS      2
+#define PM_MODEL_PM5020_FAST_BLOCK    202
+#define PM_MODEL_PM5020_PERIOD_US     10
+#define PM_MODEL_PM5020_SEQUENCE_BASE 10
+#define PM_MODEL_PM5020_MODES         (PM_MODEL_FAST | PM_MODEL_SEQUENCE | PM_MODEL_BURST)
+
+// PM6x compact USB / Bluetooth power meters: measurement sequences, 100 kHz scope
+#define PM_MODEL_PM60_NAMES           "PM6"
+#define PM_MODEL_PM60_CHANNELS        1
+#define PM_MODEL_PM60_FAST_BLOCK      0
+#define PM_MODEL_PM60_PERIOD_US       10
+#define PM_MODEL_PM60_SEQUENCE_BASE   10
+#define PM_MODEL_PM60_MODES           (PM_MODEL_SEQUENCE)
+
+// Anything else: largest sizes, the driver reports what is not supported
+#define PM_MODEL_GENERIC_NAMES        ""
+#define PM_MODEL_GENERIC_CHANNELS     PM_BLOCK_MAX_CHANNELS
+#define PM_MODEL_GENERIC_FAST_BLOCK   PM_FAST_BLOCK_SIZE
+#define PM_MODEL_GENERIC_PERIOD_US    10
+#define PM_MODEL_GENERIC_SEQUENCE_BASE 10
+#define PM_MODEL_GENERIC_MODES        (PM_MODEL_FAST | PM_MODEL_SEQUENCE | PM_MODEL_BURST)
+
+// X macro over all models, in table order
+#define PM_MODEL_LIST(X) X(PM100) X(PM101) X(PM103) X(PM400) X(PM5020) X(PM60) X(GENERIC)
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef ViStatus (*PMModelFastFunc)(PMSampleBlock *block, ViSession vi, ViUInt16 channel, ViUInt16 *count);
+typedef ViStatus (*PMModelSequenceFunc)(PMSampleBlock *block, ViSession vi, ViUInt16 channel);
+
+typedef struct
+{
+	uint32_t            id;                 // PM_MODEL_*
+	const char          *name;
+	const char          *names;             // identification prefixes, comma separated
+	uint32_t            channels;
+	uint32_t            fastBlock;          // samples per fast measure stream block, 0: no stream
+	uint32_t            periodUs;           // sample period of the fastest array mode
+	uint32_t            sequenceBase;       // measurement sequence of sequenceBase x 100 samples
+	uint32_t            modes;              // PM_MODEL_FAST | ...
+
+	// Specialized readers; those of unsupported modes return VI_ERROR_NSUP_OPER
+	PMReadBlockFunc     readBlock;          // TLPM session, fast measure stream source for PMAcq
+	PMModelFastFunc     readFast;           // TLPMX session, appends the next fast measure stream block
+	PMModelSequenceFunc readSequence;       // measurement sequence of sequenceBase x 100 samples
+	PMBlockBurstFunc    readBurst;          // burst array samples, replaces the block content
+} PMModel;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+const PMModel *PMModel_get(uint32_t id);
+const PMModel *PMModel_find(const char *deviceName);
+ViStatus       PMModel_identify(ViSession vi, const PMModel **model);
+
+PMBlockSource  PMModel_source(const PMModel *model, ViSession instrHandle);
+ViStatus       PMModel_deviceSource(ViSession instrHandle, const PMModel **model, PMBlockSource *source);
+ViStatus       PMModel_initBlock(const PMModel *model, PMSampleBlock *block, uint32_t mode);
+
+#endif /* _PM_MODEL_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
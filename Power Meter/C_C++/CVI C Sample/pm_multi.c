@@ -0,0 +1,388 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Multi-device acquisition
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_multi.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "pm_model.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define DISPATCH_IDLE_US      200
+#define DISPATCH_BATCH        8       // blocks per device and round, keeps devices fair
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+
+/*---------------------------------------------------------------------------
+  Device worker: the poll loop of one session. Nothing in here may block.
+---------------------------------------------------------------------------*/
+static void workerThread(void *arg)
+{
+	PMMultiDevice *dev = (PMMultiDevice*)arg;
+	PMMulti       *multi = dev->multi;
+	ViStatus      err = VI_SUCCESS;
+	uint64_t      sequence = 0;
+	uint64_t      loopNs = 0;
+
+	if(dev->cpu >= 0)
+		PMPlat_store32((volatile uint32_t*)&dev->pinStatus, (uint32_t)PMPlat_pinThread((uint32_t)dev->cpu));
+
+	while(PMPlat_load32(&multi->running))
+	{
+		PMFastBlock *slot = PMRing_beginWrite(&dev->ring);
+		PMFastBlock *block = (slot != NULL) ? slot : &dev->staging;
+		ViUInt16    count = 0;
+
+		PM_TRACE_INTERVAL(PM_TRACE_POLL_LOOP, loopNs);
+		err = dev->source.readBlock(dev->source.source, &count, block->timestamps, block->values);
+		if(err != VI_SUCCESS)
+			break;
+
+		if(count == 0)
+		{
+			// cheap on a dedicated CPU, lets the other workers in when devices outnumber CPUs
+			PMPlat_store64(&dev->emptyPolls, dev->emptyPolls + 1);
+			PMPlat_yield();
+			continue;
+		}
+		if(count > PM_FAST_BLOCK_SIZE)
+			count = PM_FAST_BLOCK_SIZE;
+
+		block->count      = count;
+		block->sequence   = sequence++;
+		block->hostTimeNs = PMPlat_timeNs();
+		PMTimeline_process(&dev->timeline, block->timestamps, count, NULL);
+
+		if(slot != NULL)
+			PMRing_endWrite(&dev->ring);
+		else
+		{
+			PMRing_drop(&dev->ring);
+			PMPlat_store64(&dev->dropped, dev->dropped + 1);
+		}
+
+		PMPlat_store64(&dev->blocks,  dev->blocks + 1);
+		PMPlat_store64(&dev->samples, dev->samples + count);
+		PMPlat_store64(&dev->missing, dev->timeline.missing);
+	}
+
+	PMPlat_store32((volatile uint32_t*)&dev->status, (uint32_t)err);
+	PMPlat_store32(&dev->done, 1);
+	PMPlat_fetchAdd32(&multi->workersDone, 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Dispatcher: feed all device rings to the shared consumer until every
+  worker exited and the rings are empty
+---------------------------------------------------------------------------*/
+static void dispatcherThread(void *arg)
+{
+	PMMulti *multi = (PMMulti*)arg;
+
+	for(;;)
+	{
+		// sampled before the sweep: an empty sweep afterwards means all is drained
+		uint32_t done = PMPlat_load32(&multi->workersDone);
+		uint32_t delivered = 0;
+		uint32_t i, n;
+
+		for(i = 0; i < multi->deviceCount; i++)
+		{
+			PMMultiDevice *dev = &multi->devices[i];
+
+			for(n = 0; n < DISPATCH_BATCH; n++)
+			{
+				PMFastBlock *block = PMRing_beginRead(&dev->ring);
+
+				if(block == NULL)
+					break;
+				PM_TRACE_TIMED(PM_TRACE_PROCESS, multi->func(multi->ctx, i, block));
+				PMRing_endRead(&dev->ring);
+				PMPlat_store64(&dev->dispatched, dev->dispatched + 1);
+				delivered++;
+			}
+		}
+
+		if(delivered == 0)
+		{
+			if(done >= multi->workersStarted)
+				break;
+			PMPlat_sleepUs(DISPATCH_IDLE_US);
+		}
+	}
+}
+
+
+void PMMulti_init(PMMulti *multi, PMMultiConsumerFunc func, void *ctx, uint32_t ringCapacity)
+{
+	memset(multi, 0, sizeof(PMMulti));
+	multi->func         = func;
+	multi->ctx          = ctx;
+	multi->ringCapacity = (ringCapacity > 0) ? ringCapacity : PM_ACQ_DEFAULT_RING_SIZE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Register a block source. cpu is a logical CPU number, PM_MULTI_CPU_AUTO
+  or PM_MULTI_CPU_NONE. Must be called before PMMulti_start.
+---------------------------------------------------------------------------*/
+ViStatus PMMulti_addSource(PMMulti *multi, const char *name, PMBlockSource source, int cpu)
+{
+	PMMultiDevice *dev;
+	ViStatus      err;
+
+	if(multi->started || multi->deviceCount >= PM_MULTI_MAX_DEVICES || multi->func == NULL)
+		return VI_ERROR_INV_SETUP;
+
+	dev = &multi->devices[multi->deviceCount];
+	memset(dev, 0, sizeof(PMMultiDevice));
+	if((err = PMRing_init(&dev->ring, multi->ringCapacity)))
+		return err;
+
+	if(cpu == PM_MULTI_CPU_AUTO)
+		cpu = (int)((multi->deviceCount + 1) % PMPlat_cpuCount());
+
+	strncpy(dev->name, name ? name : "", PM_MULTI_NAME_SIZE - 1);
+	dev->source  = source;
+	dev->session = VI_NULL;
+	dev->cpu     = cpu;
+	dev->multi   = multi;
+	PMTimeline_init(&dev->timeline, PM_TIMELINE_DEFAULT_PERIOD_US, NULL, NULL);
+	multi->deviceCount++;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Open the given resources, or every connected power meter if resources
+  is NULL, and add them configured for the fast measure stream
+---------------------------------------------------------------------------*/
+ViStatus PMMulti_openDevices(PMMulti *multi, const char *const resources[], uint32_t count)
+{
+	ViChar    rsrcDescr[TLPM_BUFFER_SIZE];
+	ViUInt32  found = 0;
+	ViStatus  err;
+	uint32_t  i;
+
+	if(resources == NULL)
+	{
+		if((err = TLPM_findRsrc(0, &found)))
+			return err;
+		count = found;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		ViSession     instr = VI_NULL;
+		const char    *rsrc = rsrcDescr;
+		const PMModel *model;
+		PMBlockSource source;
+
+		if(resources != NULL)
+			rsrc = resources[i];
+		else if((err = TLPM_getRsrcName(0, i, rsrcDescr)))
+			return err;
+
+		if((err = TLPM_init((ViRsrc)rsrc, VI_TRUE, VI_FALSE, &instr)))
+			return err;
+
+		// full bandwidth, fixed range, then switch to the fast measure stream
+		// read by the reader of the model, resolved once here
+		if((err = TLPM_setInputFilterState(instr, VI_FALSE)) ||
+		   (err = TLPM_setPowerAutoRange(instr, VI_FALSE)) ||
+		   (err = TLPM_confPowerFastArrayMeasurement(instr)) ||
+		   (err = PMModel_deviceSource(instr, &model, &source)) ||
+		   (err = PMMulti_addSource(multi, rsrc, source, PM_MULTI_CPU_AUTO)))
+		{
+			TLPM_close(instr);
+			return err;
+		}
+		multi->devices[multi->deviceCount - 1].session = instr;
+	}
+
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Start the dispatcher, then one worker per device
+---------------------------------------------------------------------------*/
+ViStatus PMMulti_start(PMMulti *multi)
+{
+	ViStatus err;
+	uint32_t i;
+
+	if(multi->started || multi->deviceCount == 0)
+		return VI_ERROR_INV_SETUP;
+
+	multi->running        = 1;
+	multi->workersDone    = 0;
+	multi->workersStarted = multi->deviceCount;
+	multi->startNs        = PMPlat_timeNs();
+	multi->stopNs         = 0;
+
+	if((err = PMPlat_threadCreate(&multi->dispatcher, dispatcherThread, multi)))
+	{
+		multi->running = 0;
+		return err;
+	}
+
+	for(i = 0; i < multi->deviceCount; i++)
+	{
+		if((err = PMPlat_threadCreate(&multi->devices[i].thread, workerThread, &multi->devices[i])))
+		{
+			// account for the workers that never ran, then let everything drain
+			PMPlat_store32(&multi->running, 0);
+			PMPlat_fetchAdd32(&multi->workersDone, multi->deviceCount - i);
+			while(i-- > 0)
+				PMPlat_threadJoin(multi->devices[i].thread);
+			PMPlat_threadJoin(multi->dispatcher);
+			return err;
+		}
+	}
+
+	multi->started = 1;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Stop all workers, let the dispatcher drain the rings and join everything.
+  Returns the first error that ended a worker (VI_SUCCESS on a regular stop).
+---------------------------------------------------------------------------*/
+ViStatus PMMulti_stop(PMMulti *multi)
+{
+	ViStatus err = VI_SUCCESS;
+	uint32_t i;
+
+	if(multi->started)
+	{
+		PMPlat_store32(&multi->running, 0);
+		for(i = 0; i < multi->deviceCount; i++)
+			PMPlat_threadJoin(multi->devices[i].thread);
+		PMPlat_threadJoin(multi->dispatcher);
+		PMPlat_store64(&multi->stopNs, PMPlat_timeNs());
+		multi->started = 0;
+	}
+
+	for(i = 0; i < multi->deviceCount && err == VI_SUCCESS; i++)
+		err = multi->devices[i].status;
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  VI_FALSE once stopped or once every device worker ended with an error
+---------------------------------------------------------------------------*/
+ViBoolean PMMulti_isRunning(PMMulti *multi)
+{
+	return (PMPlat_load32(&multi->running) &&
+			PMPlat_load32(&multi->workersDone) < multi->workersStarted) ? VI_TRUE : VI_FALSE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Snapshot of the per-device counters. Safe to call while running.
+---------------------------------------------------------------------------*/
+void PMMulti_getStats(PMMulti *multi, PMMultiStats *stats)
+{
+	uint64_t endNs = PMPlat_load64(&multi->stopNs);
+	uint32_t i;
+
+	memset(stats, 0, sizeof(PMMultiStats));
+	if(endNs == 0)
+		endNs = PMPlat_timeNs();
+	stats->deviceCount = multi->deviceCount;
+	stats->elapsedSec  = (multi->startNs != 0) ? (double)(endNs - multi->startNs) * 1.0e-9 : 0.0;
+
+	for(i = 0; i < multi->deviceCount; i++)
+	{
+		PMMultiDevice      *dev = &multi->devices[i];
+		PMMultiDeviceStats *ds = &stats->device[i];
+
+		ds->name       = dev->name;
+		ds->cpu        = (PMPlat_load32((volatile uint32_t*)&dev->pinStatus) == VI_SUCCESS) ? dev->cpu : PM_MULTI_CPU_NONE;
+		ds->status     = (ViStatus)PMPlat_load32((volatile uint32_t*)&dev->status);
+		ds->blocks     = PMPlat_load64(&dev->blocks);
+		ds->samples    = PMPlat_load64(&dev->samples);
+		ds->emptyPolls = PMPlat_load64(&dev->emptyPolls);
+		ds->missing    = PMPlat_load64(&dev->missing);
+		ds->dropped    = PMPlat_load64(&dev->dropped);
+		ds->dispatched = PMPlat_load64(&dev->dispatched);
+		ds->highWater  = PMPlat_load32(&dev->ring.highWater);
+		ds->samplesPerSec = (stats->elapsedSec > 0.0) ? (double)ds->samples / stats->elapsedSec : 0.0;
+
+		stats->samples += ds->samples;
+	}
+	stats->samplesPerSec = (stats->elapsedSec > 0.0) ? (double)stats->samples / stats->elapsedSec : 0.0;
+}
+
+
+void PMMulti_printStats(const PMMultiStats *stats)
+{
+	uint32_t i;
+
+	printf("%u devices: %llu samples in %.3f s (%.0f S/s)\n", (unsigned int)stats->deviceCount,
+			(unsigned long long)stats->samples, stats->elapsedSec, stats->samplesPerSec);
+
+	for(i = 0; i < stats->deviceCount; i++)
+	{
+		const PMMultiDeviceStats *ds = &stats->device[i];
+
+		printf("  %-24.24s cpu %2d: %.0f S/s, lost on device %llu, dropped blocks %llu, high water %u, status 0x%08X\n",
+				ds->name, ds->cpu, ds->samplesPerSec, (unsigned long long)ds->missing,
+				(unsigned long long)ds->dropped, (unsigned int)ds->highWater, (unsigned int)ds->status);
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Stop, release the rings and close the sessions opened by PMMulti_openDevices
+---------------------------------------------------------------------------*/
+void PMMulti_free(PMMulti *multi)
+{
+	uint32_t i;
+
+	if(multi->started)
+		PMMulti_stop(multi);
+	for(i = 0; i < multi->deviceCount; i++)
+	{
+		PMRing_free(&multi->devices[i].ring);
+		if(multi->devices[i].session != VI_NULL)
+			TLPM_close(multi->devices[i].session);
+	}
+	multi->deviceCount = 0;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
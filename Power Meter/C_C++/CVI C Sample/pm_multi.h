@@ -0,0 +1,136 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Multi-device acquisition
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Streams several instruments at the same time. Every device gets its
+   own worker thread, pinned to its own CPU, that runs the poll loop and
+   writes straight into a per-device PMRing. A single dispatcher thread
+   drains all rings round robin and hands the blocks to one shared
+   consumer, so the consumer never needs locking and one slow or failed
+   device cannot stall the others.
+
+****************************************************************************/
+#ifndef _PM_MULTI_HEADER_
+#define _PM_MULTI_HEADER_
+
+#include "pm_acquisition.h"
+#include "pm_timeline.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_MULTI_MAX_DEVICES      16
+#define PM_MULTI_NAME_SIZE        256
+
+#define PM_MULTI_CPU_AUTO         (-1)   // worker i runs on CPU (i + 1) % cpu count
+#define PM_MULTI_CPU_NONE         (-2)   // leave scheduling to the OS
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Called on the dispatcher thread for every block, in stream order per device
+typedef void (*PMMultiConsumerFunc)(void *ctx, uint32_t device, const PMFastBlock *block);
+
+typedef struct
+{
+	char              name[PM_MULTI_NAME_SIZE];
+	PMBlockSource     source;
+	ViSession         session;         // opened by PMMulti_openDevices, closed by PMMulti_free
+	int               cpu;
+	volatile ViStatus pinStatus;
+
+	PMRing            ring;
+	PMTimeline        timeline;        // worker side, counts samples the device dropped
+	PMThread          thread;
+	volatile uint32_t done;
+	volatile ViStatus status;
+
+	volatile uint64_t blocks;
+	volatile uint64_t samples;
+	volatile uint64_t emptyPolls;
+	volatile uint64_t missing;
+	volatile uint64_t dropped;         // blocks read while the ring was full
+	volatile uint64_t dispatched;
+	struct PMMulti    *multi;
+
+	PMFastBlock       staging;
+} PMMultiDevice;
+
+typedef struct PMMulti
+{
+	PMMultiDevice     devices[PM_MULTI_MAX_DEVICES];
+	uint32_t          deviceCount;
+	uint32_t          ringCapacity;
+	PMMultiConsumerFunc func;
+	void              *ctx;
+
+	PMThread          dispatcher;
+	uint32_t          started;
+	uint32_t          workersStarted;
+	volatile uint32_t running;
+	volatile uint32_t workersDone;     // number of workers that have exited
+	uint64_t          startNs;
+	volatile uint64_t stopNs;
+} PMMulti;
+
+typedef struct
+{
+	const char        *name;
+	int               cpu;
+	ViStatus          status;
+	uint64_t          blocks;
+	uint64_t          samples;
+	uint64_t          emptyPolls;
+	uint64_t          missing;         // samples lost on the device (timestamp gaps)
+	uint64_t          dropped;         // blocks lost because the dispatcher fell behind
+	uint64_t          dispatched;
+	uint32_t          highWater;
+	double            samplesPerSec;
+} PMMultiDeviceStats;
+
+typedef struct
+{
+	uint32_t          deviceCount;
+	double            elapsedSec;
+	uint64_t          samples;
+	double            samplesPerSec;
+	PMMultiDeviceStats device[PM_MULTI_MAX_DEVICES];
+} PMMultiStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void      PMMulti_init(PMMulti *multi, PMMultiConsumerFunc func, void *ctx, uint32_t ringCapacity);
+ViStatus  PMMulti_addSource(PMMulti *multi, const char *name, PMBlockSource source, int cpu);
+ViStatus  PMMulti_openDevices(PMMulti *multi, const char *const resources[], uint32_t count);
+ViStatus  PMMulti_start(PMMulti *multi);
+ViStatus  PMMulti_stop(PMMulti *multi);
+ViBoolean PMMulti_isRunning(PMMulti *multi);
+void      PMMulti_getStats(PMMulti *multi, PMMultiStats *stats);
+void      PMMulti_printStats(const PMMultiStats *stats);
+void      PMMulti_free(PMMulti *multi);
+
+#endif /* _PM_MULTI_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
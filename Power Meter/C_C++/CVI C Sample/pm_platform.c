@@ -0,0 +1,734 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Platform abstraction
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#ifndef _WIN32
+	#define _GNU_SOURCE
+#endif
+
+#include "pm_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if PM_HAVE_X86_SIMD && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+	#include <time.h>
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <dlfcn.h>
+	#include <sys/mman.h>
+	#include <sys/file.h>
+	#include <sys/stat.h>
+	#include <sys/time.h>
+#endif
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	PMThreadFunc   func;
+	void           *arg;
+} PMThreadStart;
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+#ifdef _WIN32
+static DWORD WINAPI threadTrampoline(LPVOID param)
+#else
+static void *threadTrampoline(void *param)
+#endif
+{
+	PMThreadStart start = *(PMThreadStart*)param;
+
+	free(param);
+	start.func(start.arg);
+	return 0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Start a thread running func(arg)
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_threadCreate(PMThread *thread, PMThreadFunc func, void *arg)
+{
+	PMThreadStart *start = (PMThreadStart*)malloc(sizeof(PMThreadStart));
+	if(start == NULL)
+		return VI_ERROR_ALLOC;
+
+	start->func = func;
+	start->arg  = arg;
+
+#ifdef _WIN32
+	*thread = CreateThread(NULL, 0, threadTrampoline, start, 0, NULL);
+	if(*thread == NULL)
+#else
+	if(pthread_create(thread, NULL, threadTrampoline, start) != 0)
+#endif
+	{
+		free(start);
+		return VI_ERROR_SYSTEM_ERROR;
+	}
+
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Wait for a thread to finish and release it
+---------------------------------------------------------------------------*/
+void PMPlat_threadJoin(PMThread thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Give up the rest of the time slice
+---------------------------------------------------------------------------*/
+void PMPlat_yield(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Number of logical CPUs available to the process
+---------------------------------------------------------------------------*/
+uint32_t PMPlat_cpuCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	return (uint32_t)info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n > 0) ? (uint32_t)n : 1;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Bind the calling thread to one logical CPU
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_pinThread(uint32_t cpu)
+{
+#if defined(_WIN32)
+	if(cpu >= 64 || SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) == 0)
+		return VI_ERROR_SYSTEM_ERROR;
+	return VI_SUCCESS;
+#elif defined(__linux__)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+		return VI_ERROR_SYSTEM_ERROR;
+	return VI_SUCCESS;
+#else
+	(void)cpu;
+	return VI_ERROR_NSUP_OPER;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  First CPU taken out of the scheduler for general use (isolcpus= on the
+  kernel command line), -1 if there is none
+---------------------------------------------------------------------------*/
+int PMPlat_isolatedCpu(void)
+{
+#if defined(__linux__)
+	FILE *file = fopen("/sys/devices/system/cpu/isolated", "r");
+	int  cpu = -1;
+
+	if(file == NULL)
+		return -1;
+	if(fscanf(file, "%d", &cpu) != 1)
+		cpu = -1;
+	fclose(file);
+	return cpu;
+#else
+	return -1;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Run the calling thread ahead of all normal threads: SCHED_FIFO with the
+  given priority (1..99) on Linux, time critical priority on Windows.
+  Linux needs CAP_SYS_NICE or an rtprio limit for it.
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_setRealtime(int priority)
+{
+#if defined(_WIN32)
+	(void)priority;
+	if(!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+		return VI_ERROR_SYSTEM_ERROR;
+	return VI_SUCCESS;
+#elif defined(__linux__)
+	struct sched_param param;
+	int                maxPriority = sched_get_priority_max(SCHED_FIFO);
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = (priority < 1) ? 1 : (priority > maxPriority) ? maxPriority : priority;
+	if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+		return VI_ERROR_SYSTEM_ERROR;
+	return VI_SUCCESS;
+#else
+	(void)priority;
+	return VI_ERROR_NSUP_OPER;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Keep all current and future pages of the process in RAM, so the poll
+  loop never waits for a page fault
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_lockMemory(void)
+{
+#if defined(_WIN32)
+	return VI_ERROR_NSUP_OPER;
+#else
+	if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+		return VI_ERROR_SYSTEM_ERROR;
+	return VI_SUCCESS;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Touch every page of a buffer, so its first use takes no page fault.
+  The content is kept.
+---------------------------------------------------------------------------*/
+void PMPlat_prefault(void *ptr, size_t size)
+{
+	volatile char *p = (volatile char*)ptr;
+	size_t        i;
+
+	for(i = 0; i < size; i += 4096)
+		p[i] = p[i];
+	if(size > 0)
+		p[size - 1] = p[size - 1];
+}
+
+
+/*---------------------------------------------------------------------------
+  Monotonic clock in nanoseconds
+---------------------------------------------------------------------------*/
+uint64_t PMPlat_timeNs(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+
+	if(freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (uint64_t)((double)now.QuadPart * 1.0e9 / (double)freq.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Wall clock in microseconds since 1970-01-01 UTC
+---------------------------------------------------------------------------*/
+uint64_t PMPlat_unixTimeUs(void)
+{
+#ifdef _WIN32
+	FILETIME       ft;
+	ULARGE_INTEGER t;
+
+	GetSystemTimeAsFileTime(&ft);
+	t.LowPart  = ft.dwLowDateTime;
+	t.HighPart = ft.dwHighDateTime;
+	return (t.QuadPart - 116444736000000000ull) / 10;   // 100 ns ticks since 1601
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000000ull + (uint64_t)tv.tv_usec;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  CPU time consumed by all threads of the process in nanoseconds
+---------------------------------------------------------------------------*/
+uint64_t PMPlat_cpuTimeNs(void)
+{
+#ifdef _WIN32
+	FILETIME       created, exited, kernel, user;
+	ULARGE_INTEGER k, u;
+
+	if(!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+		return 0;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return (k.QuadPart + u.QuadPart) * 100;
+#else
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+		return 0;
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Sleep at least the given amount of microseconds
+  Note: Windows rounds up to the scheduler tick (typically 1 ms).
+---------------------------------------------------------------------------*/
+void PMPlat_sleepUs(uint32_t us)
+{
+#ifdef _WIN32
+	Sleep((us + 999) / 1000);
+#else
+	struct timespec ts;
+
+	ts.tv_sec  = us / 1000000;
+	ts.tv_nsec = (long)(us % 1000000) * 1000;
+	while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Sleep until PMPlat_timeNs() reaches ns. Absolute, so the wake-up time
+  does not drift with the time it took to get here.
+---------------------------------------------------------------------------*/
+void PMPlat_sleepUntilNs(uint64_t ns)
+{
+#ifdef _WIN32
+	uint64_t now = PMPlat_timeNs();
+
+	if(ns > now)
+		PMPlat_sleepUs((uint32_t)((ns - now) / 1000));
+#else
+	struct timespec ts;
+
+	ts.tv_sec  = (time_t)(ns / 1000000000ull);
+	ts.tv_nsec = (long)(ns % 1000000000ull);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  SIMD instruction sets usable on this CPU (PM_CPU_xxx bit mask)
+---------------------------------------------------------------------------*/
+uint32_t PMPlat_cpuFeatures(void)
+{
+	uint32_t features = 0;
+
+#if PM_HAVE_X86_SIMD && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 1);
+	if(info[3] & (1 << 26))
+		features |= PM_CPU_SSE2;
+
+	// FMA, OSXSAVE and AVX, then YMM state enabled by the OS, then AVX2
+	if((info[2] & ((1 << 12) | (1 << 27) | (1 << 28))) == ((1 << 12) | (1 << 27) | (1 << 28)) &&
+	   (_xgetbv(0) & 0x6) == 0x6)
+	{
+		__cpuidex(info, 7, 0);
+		if(info[1] & (1 << 5))
+			features |= PM_CPU_AVX2;
+	}
+#elif PM_HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("sse2"))
+		features |= PM_CPU_SSE2;
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		features |= PM_CPU_AVX2;
+#endif
+
+	return features;
+}
+
+
+/*---------------------------------------------------------------------------
+  Aligned heap memory. alignment must be a power of two.
+---------------------------------------------------------------------------*/
+void *PMPlat_alignedAlloc(size_t size, size_t alignment)
+{
+#ifdef _WIN32
+	return _aligned_malloc(size, alignment);
+#else
+	void *ptr = NULL;
+
+	if(alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	if(posix_memalign(&ptr, alignment, size) != 0)
+		return NULL;
+	return ptr;
+#endif
+}
+
+
+void PMPlat_alignedFree(void *ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Open a file for memory mapping
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_fileOpen(PMPlatFile *file, const char *path, ViBoolean writable, ViBoolean create)
+{
+	file->writable = writable;
+#ifdef _WIN32
+	file->handle = CreateFileA(path, writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+							   FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							   create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file->handle == INVALID_HANDLE_VALUE)
+		return VI_ERROR_FILE_ACCESS;
+#else
+	file->fd = open(path, (writable ? O_RDWR : O_RDONLY) | (create ? (O_CREAT | O_TRUNC) : 0), 0644);
+	if(file->fd < 0)
+		return VI_ERROR_FILE_ACCESS;
+#endif
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMPlat_fileSize(PMPlatFile *file, uint64_t *size)
+{
+#ifdef _WIN32
+	LARGE_INTEGER li;
+
+	if(!GetFileSizeEx(file->handle, &li))
+		return VI_ERROR_FILE_IO;
+	*size = (uint64_t)li.QuadPart;
+#else
+	struct stat st;
+
+	if(fstat(file->fd, &st) != 0)
+		return VI_ERROR_FILE_IO;
+	*size = (uint64_t)st.st_size;
+#endif
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Grow or shrink the file. New space reads as zero.
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_fileResize(PMPlatFile *file, uint64_t size)
+{
+#ifdef _WIN32
+	LARGE_INTEGER li;
+
+	li.QuadPart = (LONGLONG)size;
+	if(!SetFilePointerEx(file->handle, li, NULL, FILE_BEGIN) || !SetEndOfFile(file->handle))
+		return VI_ERROR_FILE_IO;
+#else
+	if(ftruncate(file->fd, (off_t)size) != 0)
+		return VI_ERROR_FILE_IO;
+#endif
+	return VI_SUCCESS;
+}
+
+
+void PMPlat_fileClose(PMPlatFile *file)
+{
+#ifdef _WIN32
+	if(file->handle != INVALID_HANDLE_VALUE && file->handle != NULL)
+		CloseHandle(file->handle);
+	file->handle = INVALID_HANDLE_VALUE;
+#else
+	if(file->fd >= 0)
+		close(file->fd);
+	file->fd = -1;
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Map [offset, offset + size) of the file. The range must exist.
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_fileMap(PMPlatFile *file, uint64_t offset, size_t size, PMPlatMap *map)
+{
+#ifdef _WIN32
+	uint64_t end = offset + size;
+
+	map->mapping = CreateFileMappingA(file->handle, NULL, file->writable ? PAGE_READWRITE : PAGE_READONLY,
+									  (DWORD)(end >> 32), (DWORD)end, NULL);
+	if(map->mapping == NULL)
+		return VI_ERROR_FILE_IO;
+
+	map->base = MapViewOfFile(map->mapping, file->writable ? FILE_MAP_WRITE : FILE_MAP_READ,
+							  (DWORD)(offset >> 32), (DWORD)offset, size);
+	if(map->base == NULL)
+	{
+		CloseHandle(map->mapping);
+		return VI_ERROR_ALLOC;
+	}
+#else
+	map->base = mmap(NULL, size, file->writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file->fd, (off_t)offset);
+	if(map->base == MAP_FAILED)
+	{
+		map->base = NULL;
+		return VI_ERROR_ALLOC;
+	}
+#endif
+	map->size = size;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Write back dirty pages of a mapped range. wait = VI_FALSE only schedules it.
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_fileFlush(PMPlatMap *map, size_t offset, size_t size, ViBoolean wait)
+{
+#ifdef _WIN32
+	(void)wait;
+	if(!FlushViewOfFile((char*)map->base + offset, size))
+		return VI_ERROR_FILE_IO;
+#else
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t start = offset & ~(page - 1);
+
+	if(msync((char*)map->base + start, size + (offset - start), wait ? MS_SYNC : MS_ASYNC) != 0)
+		return VI_ERROR_FILE_IO;
+#endif
+	return VI_SUCCESS;
+}
+
+
+void PMPlat_fileUnmap(PMPlatMap *map)
+{
+	if(map->base == NULL)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(map->base);
+	CloseHandle(map->mapping);
+#else
+	munmap(map->base, map->size);
+#endif
+	map->base = NULL;
+	map->size = 0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Named shared memory: a pagefile backed section in the session namespace
+  on Windows, a POSIX shared memory object on Linux (-lrt on old glibc)
+---------------------------------------------------------------------------*/
+ViStatus PMPlat_shmCreate(PMPlatShm *shm, const char *name, size_t size)
+{
+	memset(shm, 0, sizeof(*shm));
+#ifdef _WIN32
+	{
+		char path[96];
+
+		_snprintf(path, sizeof(path) - 1, "Local\\%s", name);
+		path[sizeof(path) - 1] = '\0';
+		shm->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+										  (DWORD)((uint64_t)size >> 32), (DWORD)size, path);
+		if(shm->mapping == NULL)
+			return VI_ERROR_ALLOC;
+		if(GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			CloseHandle(shm->mapping);
+			return VI_ERROR_INV_SETUP;      // another server uses the name
+		}
+		if((shm->base = MapViewOfFile(shm->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size)) == NULL)
+		{
+			CloseHandle(shm->mapping);
+			return VI_ERROR_ALLOC;
+		}
+	}
+#else
+	{
+		int fd;
+
+		snprintf(shm->name, sizeof(shm->name), "/%s", name);
+
+		// The owner holds a lock on the object; without it the object was left by a crashed server
+		if((fd = shm_open(shm->name, O_RDWR, 0)) >= 0)
+		{
+			ViBoolean inUse = (flock(fd, LOCK_EX | LOCK_NB) != 0);
+
+			close(fd);
+			if(inUse)
+				return VI_ERROR_INV_SETUP;  // another server uses the name
+			shm_unlink(shm->name);
+		}
+		if((fd = shm_open(shm->name, O_RDWR | O_CREAT | O_EXCL, 0666)) < 0)
+			return VI_ERROR_FILE_ACCESS;
+		if(flock(fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(fd, (off_t)size) != 0 ||
+		   (shm->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+		{
+			shm->base = NULL;
+			close(fd);
+			shm_unlink(shm->name);
+			return VI_ERROR_ALLOC;
+		}
+		shm->fd = fd;
+	}
+#endif
+	memset(shm->base, 0, size);
+	shm->size  = size;
+	shm->owner = VI_TRUE;
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMPlat_shmOpen(PMPlatShm *shm, const char *name)
+{
+	memset(shm, 0, sizeof(*shm));
+#ifdef _WIN32
+	{
+		char                     path[96];
+		MEMORY_BASIC_INFORMATION info;
+
+		_snprintf(path, sizeof(path) - 1, "Local\\%s", name);
+		path[sizeof(path) - 1] = '\0';
+		if((shm->mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path)) == NULL)
+			return VI_ERROR_RSRC_NFOUND;
+		if((shm->base = MapViewOfFile(shm->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)) == NULL)
+		{
+			CloseHandle(shm->mapping);
+			return VI_ERROR_ALLOC;
+		}
+		VirtualQuery(shm->base, &info, sizeof(info));
+		shm->size = info.RegionSize;
+	}
+#else
+	{
+		struct stat st;
+		int         fd;
+
+		snprintf(shm->name, sizeof(shm->name), "/%s", name);
+		if((fd = shm_open(shm->name, O_RDWR, 0)) < 0)
+			return VI_ERROR_RSRC_NFOUND;
+		if(fstat(fd, &st) != 0 ||
+		   (shm->base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+		{
+			shm->base = NULL;
+			close(fd);
+			return VI_ERROR_ALLOC;
+		}
+		close(fd);
+		shm->size = (size_t)st.st_size;
+	}
+#endif
+	shm->owner = VI_FALSE;
+	return VI_SUCCESS;
+}
+
+
+void PMPlat_shmClose(PMPlatShm *shm)
+{
+	if(shm->base == NULL)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(shm->base);
+	CloseHandle(shm->mapping);
+#else
+	munmap(shm->base, shm->size);
+	if(shm->owner)
+	{
+		shm_unlink(shm->name);
+		close(shm->fd);
+	}
+#endif
+	shm->base = NULL;
+}
+
+
+/*---------------------------------------------------------------------------
+  Shared libraries (DLL / .so), e.g. the real driver behind a shim
+---------------------------------------------------------------------------*/
+void *PMPlat_libraryOpen(const char *path)
+{
+#ifdef _WIN32
+	return (void*)LoadLibraryA(path);
+#else
+	return dlopen(path, RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+
+void *PMPlat_librarySymbol(void *library, const char *name)
+{
+	if(library == NULL)
+		return NULL;
+#ifdef _WIN32
+	return (void*)GetProcAddress((HMODULE)library, name);
+#else
+	return dlsym(library, name);
+#endif
+}
+
+
+void PMPlat_libraryClose(void *library)
+{
+	if(library == NULL)
+		return;
+#ifdef _WIN32
+	FreeLibrary((HMODULE)library);
+#else
+	dlclose(library);
+#endif
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,288 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Platform abstraction
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Thin wrappers for threads, atomics, clocks, aligned memory, memory
+   mapped files, shared memory and shared libraries so the acquisition
+   modules build with CVI/MSVC on Windows and GCC/Clang on Linux without
+   further changes.
+
+****************************************************************************/
+#ifndef _PM_PLATFORM_HEADER_
+#define _PM_PLATFORM_HEADER_
+
+#ifdef _WIN32
+	#ifndef _WIN32_WINNT
+		#define _WIN32_WINNT 0x600
+	#endif
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "visatype.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_CACHE_LINE         64
+#define PM_MAP_GRANULARITY    65536    // file map offsets must be a multiple (Windows allocation granularity)
+
+#if defined(_MSC_VER) || defined(_CVI_)
+	#define PM_INLINE         static __inline
+#else
+	#define PM_INLINE         static inline
+#endif
+
+// x86 SIMD kernels are compiled in with per-function target attributes and
+// selected at runtime with PMPlat_cpuFeatures(), so no global -mavx2 is needed.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define PM_HAVE_X86_SIMD  1
+	#if defined(__GNUC__) || defined(__clang__)
+		#define PM_TARGET_AVX2  __attribute__((target("avx2,fma")))
+		#define PM_TARGET_SSE2  __attribute__((target("sse2")))
+	#else
+		#define PM_TARGET_AVX2
+		#define PM_TARGET_SSE2
+	#endif
+#else
+	#define PM_HAVE_X86_SIMD  0
+#endif
+
+#define PM_CPU_SSE2           0x0001
+#define PM_CPU_AVX2           0x0002   // AVX2 + FMA, enabled by the OS
+
+// VISA status codes used by the toolkit (normally provided by visa.h)
+#ifndef VI_ERROR_SYSTEM_ERROR
+#define VI_ERROR_SYSTEM_ERROR    ((ViStatus)0xBFFF0000L)
+#endif
+#ifndef VI_ERROR_INV_OBJECT
+#define VI_ERROR_INV_OBJECT      ((ViStatus)0xBFFF000EL)
+#endif
+#ifndef VI_ERROR_RSRC_NFOUND
+#define VI_ERROR_RSRC_NFOUND     ((ViStatus)0xBFFF0011L)
+#endif
+#ifndef VI_ERROR_TMO
+#define VI_ERROR_TMO             ((ViStatus)0xBFFF0015L)
+#endif
+#ifndef VI_ERROR_QUEUE_OVERFLOW
+#define VI_ERROR_QUEUE_OVERFLOW  ((ViStatus)0xBFFF002DL)
+#endif
+#ifndef VI_ERROR_ABORT
+#define VI_ERROR_ABORT           ((ViStatus)0xBFFF0030L)
+#endif
+#ifndef VI_ERROR_INV_SETUP
+#define VI_ERROR_INV_SETUP       ((ViStatus)0xBFFF003AL)
+#endif
+#ifndef VI_ERROR_ALLOC
+#define VI_ERROR_ALLOC           ((ViStatus)0xBFFF003CL)
+#endif
+#ifndef VI_ERROR_IO
+#define VI_ERROR_IO              ((ViStatus)0xBFFF003EL)
+#endif
+#ifndef VI_ERROR_INV_FMT
+#define VI_ERROR_INV_FMT         ((ViStatus)0xBFFF003FL)
+#endif
+#ifndef VI_ERROR_INV_OFFSET
+#define VI_ERROR_INV_OFFSET      ((ViStatus)0xBFFF0051L)
+#endif
+#ifndef VI_ERROR_NSUP_OPER
+#define VI_ERROR_NSUP_OPER       ((ViStatus)0xBFFF0067L)
+#endif
+#ifndef VI_ERROR_USER_BUF
+#define VI_ERROR_USER_BUF        ((ViStatus)0xBFFF0071L)
+#endif
+#ifndef VI_ERROR_FILE_ACCESS
+#define VI_ERROR_FILE_ACCESS     ((ViStatus)0xBFFF00A1L)
+#endif
+#ifndef VI_ERROR_FILE_IO
+#define VI_ERROR_FILE_IO         ((ViStatus)0xBFFF00A2L)
+#endif
+#ifndef VI_ERROR_CONN_LOST
+#define VI_ERROR_CONN_LOST       ((ViStatus)0xBFFF00A6L)
+#endif
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef void (*PMThreadFunc)(void *arg);
+
+#ifdef _WIN32
+typedef HANDLE    PMThread;
+#else
+typedef pthread_t PMThread;
+#endif
+
+typedef struct
+{
+#ifdef _WIN32
+	HANDLE    handle;
+#else
+	int       fd;
+#endif
+	ViBoolean writable;
+} PMPlatFile;
+
+typedef struct
+{
+	void      *base;
+	size_t    size;
+#ifdef _WIN32
+	HANDLE    mapping;
+#endif
+} PMPlatMap;
+
+// Named shared memory, removed by the creator on close
+typedef struct
+{
+	void      *base;
+	size_t    size;
+	ViBoolean owner;
+#ifdef _WIN32
+	HANDLE    mapping;
+#else
+	int       fd;             // owner: kept open and locked while the server runs
+	char      name[64];
+#endif
+} PMPlatShm;
+
+/*===========================================================================
+ Atomics
+ Only what the lock-free structures need: acquire loads, release stores,
+ fetch-add for shared counters, compare-exchange for multi-producer
+ queues and a full fence for sequence locks.
+===========================================================================*/
+#ifdef _WIN32
+
+PM_INLINE uint32_t PMPlat_load32(volatile uint32_t *p)
+{
+	uint32_t v = *p;
+	MemoryBarrier();
+	return v;
+}
+
+PM_INLINE void PMPlat_store32(volatile uint32_t *p, uint32_t v)
+{
+	MemoryBarrier();
+	*p = v;
+}
+
+PM_INLINE uint64_t PMPlat_load64(volatile uint64_t *p)
+{
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+}
+
+PM_INLINE void PMPlat_store64(volatile uint64_t *p, uint64_t v)
+{
+	InterlockedExchange64((volatile LONG64*)p, (LONG64)v);
+}
+
+PM_INLINE uint32_t PMPlat_fetchAdd32(volatile uint32_t *p, uint32_t v)
+{
+	return (uint32_t)InterlockedExchangeAdd((volatile LONG*)p, (LONG)v);
+}
+
+PM_INLINE uint64_t PMPlat_fetchAdd64(volatile uint64_t *p, uint64_t v)
+{
+	return (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)p, (LONG64)v);
+}
+
+// Returns VI_TRUE and stores desired if *p still equals expected
+PM_INLINE ViBoolean PMPlat_cas64(volatile uint64_t *p, uint64_t expected, uint64_t desired)
+{
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)p, (LONG64)desired, (LONG64)expected) == expected;
+}
+
+PM_INLINE void PMPlat_fence(void)
+{
+	MemoryBarrier();
+}
+
+#else
+
+PM_INLINE uint32_t PMPlat_load32(volatile uint32_t *p)             { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+PM_INLINE void     PMPlat_store32(volatile uint32_t *p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+PM_INLINE uint64_t PMPlat_load64(volatile uint64_t *p)             { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+PM_INLINE void     PMPlat_store64(volatile uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+PM_INLINE uint32_t PMPlat_fetchAdd32(volatile uint32_t *p, uint32_t v) { return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL); }
+PM_INLINE uint64_t PMPlat_fetchAdd64(volatile uint64_t *p, uint64_t v) { return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL); }
+PM_INLINE ViBoolean PMPlat_cas64(volatile uint64_t *p, uint64_t expected, uint64_t desired)
+{
+	return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ? VI_TRUE : VI_FALSE;
+}
+PM_INLINE void     PMPlat_fence(void)                              { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+#endif
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus PMPlat_threadCreate(PMThread *thread, PMThreadFunc func, void *arg);
+void     PMPlat_threadJoin(PMThread thread);
+void     PMPlat_yield(void);
+uint32_t PMPlat_cpuCount(void);
+ViStatus PMPlat_pinThread(uint32_t cpu);
+int      PMPlat_isolatedCpu(void);
+
+// Real-time operation
+ViStatus PMPlat_setRealtime(int priority);
+ViStatus PMPlat_lockMemory(void);
+void     PMPlat_prefault(void *ptr, size_t size);
+
+uint64_t PMPlat_timeNs(void);
+uint64_t PMPlat_unixTimeUs(void);
+uint64_t PMPlat_cpuTimeNs(void);
+void     PMPlat_sleepUs(uint32_t us);
+void     PMPlat_sleepUntilNs(uint64_t ns);
+
+uint32_t PMPlat_cpuFeatures(void);
+
+void    *PMPlat_alignedAlloc(size_t size, size_t alignment);
+void     PMPlat_alignedFree(void *ptr);
+
+// Memory mapped files
+ViStatus PMPlat_fileOpen(PMPlatFile *file, const char *path, ViBoolean writable, ViBoolean create);
+ViStatus PMPlat_fileSize(PMPlatFile *file, uint64_t *size);
+ViStatus PMPlat_fileResize(PMPlatFile *file, uint64_t size);
+void     PMPlat_fileClose(PMPlatFile *file);
+ViStatus PMPlat_fileMap(PMPlatFile *file, uint64_t offset, size_t size, PMPlatMap *map);
+ViStatus PMPlat_fileFlush(PMPlatMap *map, size_t offset, size_t size, ViBoolean wait);
+void     PMPlat_fileUnmap(PMPlatMap *map);
+
+// Shared memory between processes
+ViStatus PMPlat_shmCreate(PMPlatShm *shm, const char *name, size_t size);
+ViStatus PMPlat_shmOpen(PMPlatShm *shm, const char *name);
+void     PMPlat_shmClose(PMPlatShm *shm);
+
+// Shared libraries
+void    *PMPlat_libraryOpen(const char *path);
+void    *PMPlat_librarySymbol(void *library, const char *name);
+void     PMPlat_libraryClose(void *library);
+
+#endif /* _PM_PLATFORM_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,486 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Pulse detection
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_pulse.h"
+
+#include <string.h>
+
+#if PM_HAVE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Index of the first sample beyond the threshold (count if none); the
+// samples before it are added to sum (and max)
+typedef uint32_t (*ScanAboveKernel)(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum);
+typedef uint32_t (*ScanBelowKernel)(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum, ViReal32 *max);
+
+/*===========================================================================
+ Kernels
+ Between pulses the kernels only compare and sum. A vector with a sample
+ beyond the threshold ends the vector loop; the scalar tail then finds
+ the exact sample.
+===========================================================================*/
+static uint32_t scanAboveScalar(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum)
+{
+	double   s = 0.0;
+	uint32_t i;
+
+	for(i = 0; i < count && !(values[i] > threshold); i++)
+		s += values[i];
+	*sum += s;
+	return i;
+}
+
+
+static uint32_t scanBelowScalar(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum, ViReal32 *max)
+{
+	double   s = 0.0;
+	ViReal32 m = *max;
+	uint32_t i;
+
+	for(i = 0; i < count && !(values[i] < threshold); i++)
+	{
+		if(values[i] > m) m = values[i];
+		s += values[i];
+	}
+	*sum += s;
+	*max  = m;
+	return i;
+}
+
+
+#if PM_HAVE_X86_SIMD
+
+PM_TARGET_SSE2 static uint32_t scanAboveSse2(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum)
+{
+	__m128   vthr = _mm_set1_ps(threshold);
+	__m128d  sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+	double   dl[2];
+	uint32_t i;
+
+	for(i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&values[i]);
+
+		if(_mm_movemask_ps(_mm_cmpgt_ps(x, vthr)))
+			break;
+		sum0 = _mm_add_pd(sum0, _mm_cvtps_pd(x));
+		sum1 = _mm_add_pd(sum1, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+	}
+	_mm_storeu_pd(dl, _mm_add_pd(sum0, sum1));
+	*sum += dl[0] + dl[1];
+	return i + scanAboveScalar(&values[i], count - i, threshold, sum);
+}
+
+
+PM_TARGET_SSE2 static uint32_t scanBelowSse2(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum, ViReal32 *max)
+{
+	__m128   vthr = _mm_set1_ps(threshold);
+	__m128   vmax = _mm_set1_ps(*max);
+	__m128d  sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+	float    lanes[4];
+	double   dl[2];
+	uint32_t i;
+
+	for(i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&values[i]);
+
+		if(_mm_movemask_ps(_mm_cmplt_ps(x, vthr)))
+			break;
+		vmax = _mm_max_ps(vmax, x);
+		sum0 = _mm_add_pd(sum0, _mm_cvtps_pd(x));
+		sum1 = _mm_add_pd(sum1, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+	}
+	_mm_storeu_pd(dl, _mm_add_pd(sum0, sum1));
+	*sum += dl[0] + dl[1];
+	_mm_storeu_ps(lanes, vmax);
+	if(lanes[0] > *max) *max = lanes[0];
+	if(lanes[1] > *max) *max = lanes[1];
+	if(lanes[2] > *max) *max = lanes[2];
+	if(lanes[3] > *max) *max = lanes[3];
+	return i + scanBelowScalar(&values[i], count - i, threshold, sum, max);
+}
+
+
+PM_TARGET_AVX2 static uint32_t scanAboveAvx2(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum)
+{
+	__m256   vthr = _mm256_set1_ps(threshold);
+	__m256d  sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+	__m128d  hd;
+	uint32_t i;
+
+	for(i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&values[i]);
+
+		if(_mm256_movemask_ps(_mm256_cmp_ps(x, vthr, _CMP_GT_OQ)))
+			break;
+		sum0 = _mm256_add_pd(sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+		sum1 = _mm256_add_pd(sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+	}
+	sum0 = _mm256_add_pd(sum0, sum1);
+	hd   = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+	*sum += _mm_cvtsd_f64(_mm_add_sd(hd, _mm_unpackhi_pd(hd, hd)));
+	return i + scanAboveScalar(&values[i], count - i, threshold, sum);
+}
+
+
+PM_TARGET_AVX2 static uint32_t scanBelowAvx2(const ViReal32 values[], uint32_t count, ViReal32 threshold, double *sum, ViReal32 *max)
+{
+	__m256   vthr = _mm256_set1_ps(threshold);
+	__m256   vmax = _mm256_set1_ps(*max);
+	__m256d  sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+	__m128   h;
+	__m128d  hd;
+	uint32_t i;
+
+	for(i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&values[i]);
+
+		if(_mm256_movemask_ps(_mm256_cmp_ps(x, vthr, _CMP_LT_OQ)))
+			break;
+		vmax = _mm256_max_ps(vmax, x);
+		sum0 = _mm256_add_pd(sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+		sum1 = _mm256_add_pd(sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+	}
+	sum0 = _mm256_add_pd(sum0, sum1);
+	hd   = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+	*sum += _mm_cvtsd_f64(_mm_add_sd(hd, _mm_unpackhi_pd(hd, hd)));
+
+	h    = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+	h    = _mm_max_ps(h, _mm_movehl_ps(h, h));
+	h    = _mm_max_ss(h, _mm_shuffle_ps(h, h, 1));
+	*max = _mm_cvtss_f32(h);
+	return i + scanBelowScalar(&values[i], count - i, threshold, sum, max);
+}
+
+#endif
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static ScanAboveKernel scanAbove = NULL;
+static ScanBelowKernel scanBelow = NULL;
+static int             kernelId  = PM_PULSE_KERNEL_AUTO;
+
+
+/*---------------------------------------------------------------------------
+  Choose the scan kernels. PM_PULSE_KERNEL_AUTO picks the fastest one the
+  CPU supports. Returns the kernel in use (unsupported requests fall back).
+---------------------------------------------------------------------------*/
+int PMPulse_selectKernel(int kernel)
+{
+	uint32_t cpu = PMPlat_cpuFeatures();
+
+	if(kernel == PM_PULSE_KERNEL_AUTO)
+		kernel = PM_PULSE_KERNEL_AVX2;
+
+#if PM_HAVE_X86_SIMD
+	if(kernel == PM_PULSE_KERNEL_AVX2 && (cpu & PM_CPU_AVX2))
+	{
+		scanAbove = scanAboveAvx2;
+		scanBelow = scanBelowAvx2;
+		return kernelId = PM_PULSE_KERNEL_AVX2;
+	}
+	if(kernel >= PM_PULSE_KERNEL_SSE2 && (cpu & PM_CPU_SSE2))
+	{
+		scanAbove = scanAboveSse2;
+		scanBelow = scanBelowSse2;
+		return kernelId = PM_PULSE_KERNEL_SSE2;
+	}
+#else
+	(void)cpu;
+#endif
+
+	scanAbove = scanAboveScalar;
+	scanBelow = scanBelowScalar;
+	return kernelId = PM_PULSE_KERNEL_SCALAR;
+}
+
+
+int PMPulse_kernel(void)
+{
+	if(scanAbove == NULL)
+		PMPulse_selectKernel(PM_PULSE_KERNEL_AUTO);
+	return kernelId;
+}
+
+
+const char *PMPulse_kernelName(int kernel)
+{
+	switch(kernel)
+	{
+		case PM_PULSE_KERNEL_SCALAR: return "scalar";
+		case PM_PULSE_KERNEL_SSE2:   return "SSE2";
+		case PM_PULSE_KERNEL_AVX2:   return "AVX2";
+		default:                     return "auto";
+	}
+}
+
+
+void PMPulse_defaultConfig(PMPulseConfig *cfg, ViReal32 highThreshold, ViReal32 lowThreshold)
+{
+	memset(cfg, 0, sizeof(PMPulseConfig));
+	cfg->highThreshold  = highThreshold;
+	cfg->lowThreshold   = (lowThreshold <= highThreshold) ? lowThreshold : highThreshold;
+	cfg->periodUs       = PM_PULSE_DEFAULT_PERIOD_US;
+	cfg->autoBaseline   = VI_TRUE;
+	cfg->baselineWeight = 0.01;
+}
+
+
+void PMPulse_init(PMPulseDetector *det, const PMPulseConfig *cfg, PMPulseFunc onPulse, void *ctx)
+{
+	memset(det, 0, sizeof(PMPulseDetector));
+	det->cfg      = *cfg;
+	det->onPulse  = onPulse;
+	det->ctx      = ctx;
+	det->baseline = cfg->baseline;
+	if(det->cfg.periodUs == 0)
+		det->cfg.periodUs = PM_PULSE_DEFAULT_PERIOD_US;
+	if(scanAbove == NULL)
+		PMPulse_selectKernel(PM_PULSE_KERNEL_AUTO);
+}
+
+
+/*---------------------------------------------------------------------------
+  Position where the shape crosses level, interpolated between samples.
+  Searches forward from the start or backward from the end.
+---------------------------------------------------------------------------*/
+static double crossing(const ViReal32 shape[], uint32_t count, double level, ViBoolean fromEnd)
+{
+	uint32_t i;
+
+	if(!fromEnd)
+	{
+		if(shape[0] >= level)
+			return 0.0;
+		for(i = 1; i < count; i++)
+			if(shape[i] >= level)
+				return (double)(i - 1) + (level - shape[i - 1]) / (double)(shape[i] - shape[i - 1]);
+		return (double)(count - 1);
+	}
+
+	if(shape[count - 1] >= level)
+		return (double)(count - 1);
+	for(i = count - 1; i > 0; i--)
+		if(shape[i - 1] >= level)
+			return (double)(i - 1) + (shape[i - 1] - level) / (double)(shape[i - 1] - shape[i]);
+	return 0.0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Moves the tracked baseline towards the mean of a stretch between pulses
+---------------------------------------------------------------------------*/
+static void updateBaseline(PMPulseDetector *det, double *idleSum, uint32_t *idleCount)
+{
+	double mean;
+
+	if(!det->cfg.autoBaseline || *idleCount == 0)
+		return;
+
+	mean = *idleSum / (double)*idleCount;
+	if(!det->baselineValid)
+		det->baseline = (ViReal32)mean;
+	else
+		det->baseline += (ViReal32)((mean - det->baseline) * det->cfg.baselineWeight);
+	det->baselineValid = VI_TRUE;
+	*idleSum   = 0.0;
+	*idleCount = 0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Pulse start at values[at]. Takes the rising edge above the low threshold
+  from the samples before it, in this block or in the history, and closes
+  the stretch between pulses (idleSum, idleCount) without the edge.
+---------------------------------------------------------------------------*/
+static void startPulse(PMPulseDetector *det, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t at,
+					   double *idleSum, uint32_t *idleCount)
+{
+	ViReal32 edge[PM_PULSE_PRETRIGGER];
+	uint32_t n = 0, i;
+
+	while(n < PM_PULSE_PRETRIGGER)
+	{
+		ViReal32 v;
+
+		if(n < at)
+			v = values[at - 1 - n];
+		else if(n - at < det->historyCount)
+			v = det->history[det->historyCount - 1 - (n - at)];
+		else
+			break;
+		if(!(v > det->cfg.lowThreshold))
+			break;
+		edge[n++] = v;
+	}
+
+	// The edge samples of this block were counted as baseline
+	for(i = 0; i < n && i < at && *idleCount > 0; i++)
+	{
+		*idleSum -= edge[i];
+		(*idleCount)--;
+	}
+	updateBaseline(det, idleSum, idleCount);
+
+	memset(&det->pulse, 0, sizeof(PMPulse));
+	det->pulse.index     = det->index + at - n;
+	det->pulse.timestamp = timestamps[at] - n * det->cfg.periodUs;
+	det->pulse.baseline  = det->baseline;
+	if(n == PM_PULSE_PRETRIGGER)
+		det->pulse.flags |= PM_PULSE_EDGE_CUT;
+
+	det->inPulse = VI_TRUE;
+	det->sum     = 0.0;
+	det->max     = values[at];
+	for(i = 0; i < n; i++)
+	{
+		ViReal32 v = edge[n - 1 - i];
+
+		det->shape[i] = v;
+		det->sum     += v;
+	}
+	det->pulse.samples = n;
+}
+
+
+/*---------------------------------------------------------------------------
+  Pulse end; last is the timestamp of the last pulse sample
+---------------------------------------------------------------------------*/
+static void endPulse(PMPulseDetector *det, ViUInt32 last)
+{
+	PMPulse  *p = &det->pulse;
+	double   base = p->baseline;
+	double   amplitude = (double)det->max - base;
+	uint32_t shapeCount = (p->samples < PM_PULSE_MAX_SHAPE) ? p->samples : PM_PULSE_MAX_SHAPE;
+
+	p->peak   = (ViReal32)amplitude;
+	p->energy = (det->sum - base * (double)p->samples) * (double)det->cfg.periodUs * 1.0e-6;
+
+	// Span on the device clock longer than the sample count: samples lost
+	if((uint64_t)(ViUInt32)(last - p->timestamp) > (uint64_t)(p->samples - 1) * det->cfg.periodUs + det->cfg.periodUs / 2)
+		p->flags |= PM_PULSE_GAP;
+	if(p->samples > PM_PULSE_MAX_SHAPE)
+		p->flags |= PM_PULSE_TRUNCATED;
+
+	if(amplitude > 0.0 && shapeCount > 0)
+	{
+		double rise10 = crossing(det->shape, shapeCount, base + 0.1 * amplitude, VI_FALSE);
+		double rise90 = crossing(det->shape, shapeCount, base + 0.9 * amplitude, VI_FALSE);
+
+		p->riseUs = (ViReal32)((rise90 - rise10) * det->cfg.periodUs);
+		if(!(p->flags & PM_PULSE_TRUNCATED))
+		{
+			double half0 = crossing(det->shape, shapeCount, base + 0.5 * amplitude, VI_FALSE);
+			double half1 = crossing(det->shape, shapeCount, base + 0.5 * amplitude, VI_TRUE);
+
+			p->widthUs = (ViReal32)((half1 - half0) * det->cfg.periodUs);
+		}
+	}
+
+	det->inPulse = VI_FALSE;
+	det->pulses++;
+	det->pulseSamples += p->samples;
+	if(det->onPulse != NULL)
+		det->onPulse(det->ctx, p);
+}
+
+
+/*---------------------------------------------------------------------------
+  Feed the next count samples of the stream. Calls onPulse for every pulse
+  that ends in this block.
+---------------------------------------------------------------------------*/
+void PMPulse_process(PMPulseDetector *det, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count)
+{
+	double   idleSum = 0.0;
+	uint32_t idleCount = 0;
+	uint32_t i = 0;
+
+	while(i < count)
+	{
+		uint32_t n;
+
+		if(!det->inPulse)
+		{
+			n = scanAbove(&values[i], count - i, det->cfg.highThreshold, &idleSum);
+			idleCount += n;
+			i         += n;
+			if(i < count)
+				startPulse(det, timestamps, values, i, &idleSum, &idleCount);
+		}
+		else
+		{
+			n = scanBelow(&values[i], count - i, det->cfg.lowThreshold, &det->sum, &det->max);
+			if(det->pulse.samples < PM_PULSE_MAX_SHAPE)
+			{
+				uint32_t keep = PM_PULSE_MAX_SHAPE - det->pulse.samples;
+
+				memcpy(&det->shape[det->pulse.samples], &values[i], ((n < keep) ? n : keep) * sizeof(ViReal32));
+			}
+			det->pulse.samples += n;
+			i                  += n;
+			if(i < count)
+				endPulse(det, (i > 0) ? timestamps[i - 1] : det->lastTimestamp);
+		}
+	}
+
+	updateBaseline(det, &idleSum, &idleCount);
+
+	// Keep the tail for the rising edge of a pulse starting in the next block
+	if(count >= PM_PULSE_PRETRIGGER)
+	{
+		memcpy(det->history, &values[count - PM_PULSE_PRETRIGGER], sizeof(det->history));
+		det->historyCount = PM_PULSE_PRETRIGGER;
+	}
+	else if(count > 0)
+	{
+		uint32_t keep = PM_PULSE_PRETRIGGER - count;
+
+		if(det->historyCount < keep)
+			keep = det->historyCount;
+		memmove(det->history, &det->history[det->historyCount - keep], keep * sizeof(ViReal32));
+		memcpy(&det->history[keep], values, count * sizeof(ViReal32));
+		det->historyCount = keep + count;
+	}
+	if(count > 0)
+		det->lastTimestamp = timestamps[count - 1];
+	det->index += count;
+}
+
+
+void PMPulse_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMPulse_process((PMPulseDetector*)ctx, block->timestamps, block->values, block->count);
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
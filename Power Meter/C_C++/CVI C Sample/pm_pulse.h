@@ -0,0 +1,138 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Pulse detection
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Streaming pulse detector for the fast measure stream. Turns the raw
+   power samples of a pulsed source into one compact PMPulse record per
+   pulse (start, peak, width, rise time, energy) while the stream runs,
+   so nothing but the records has to be kept.
+
+   A pulse starts with the first sample above the high threshold and
+   ends with the first sample below the low threshold (hysteresis), even
+   when the edges fall on different blocks. The rising edge between the
+   low and the high threshold is taken from the last PM_PULSE_PRETRIGGER
+   samples before the trigger. Energy is the integral of the power above
+   the baseline, which is either fixed or follows the mean of the
+   samples between pulses.
+
+   The search for the next threshold crossing and the per-pulse sums run
+   on a vectorized kernel (AVX2, SSE2 or scalar, chosen once at runtime),
+   so baseline samples cost about as much as reading them. Rise time and
+   width are measured on a copy of the pulse samples when the pulse has
+   ended; pulses longer than PM_PULSE_MAX_SHAPE samples are flagged
+   PM_PULSE_TRUNCATED and report no width.
+
+   For accurate rise times put the low threshold below 10 % of the pulse
+   height above the baseline.
+
+****************************************************************************/
+#ifndef _PM_PULSE_HEADER_
+#define _PM_PULSE_HEADER_
+
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_PULSE_KERNEL_AUTO      0
+#define PM_PULSE_KERNEL_SCALAR    1
+#define PM_PULSE_KERNEL_SSE2      2
+#define PM_PULSE_KERNEL_AVX2      3
+
+#define PM_PULSE_PRETRIGGER       32        // samples searched back for the rising edge
+#define PM_PULSE_MAX_SHAPE        4096      // samples kept for rise time and width
+#define PM_PULSE_DEFAULT_PERIOD_US  10      // 100 kHz
+
+// PMPulse flags
+#define PM_PULSE_TRUNCATED        0x0001    // longer than PM_PULSE_MAX_SHAPE, no width
+#define PM_PULSE_GAP              0x0002    // the device dropped samples inside the pulse
+#define PM_PULSE_EDGE_CUT         0x0004    // rising edge longer than the pretrigger
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint64_t  index;              // stream sample index of the first pulse sample
+	ViUInt32  timestamp;          // device timestamp of the first pulse sample, us
+	uint32_t  samples;
+	ViReal32  peak;               // W above baseline
+	ViReal32  baseline;           // W
+	ViReal32  widthUs;            // full width at half maximum
+	ViReal32  riseUs;             // 10 % to 90 % of the peak
+	double    energy;             // J above baseline
+	uint32_t  flags;              // PM_PULSE_TRUNCATED, ...
+	uint32_t  reserved;
+} PMPulse;
+
+typedef void (*PMPulseFunc)(void *ctx, const PMPulse *pulse);
+
+typedef struct
+{
+	ViReal32  highThreshold;      // W, starts a pulse
+	ViReal32  lowThreshold;       // W, ends it; <= highThreshold
+	uint32_t  periodUs;           // sample period
+	ViBoolean autoBaseline;       // track the mean between pulses
+	ViReal32  baseline;           // fixed baseline, start value with autoBaseline
+	double    baselineWeight;     // share of each stretch between pulses in the tracked baseline
+} PMPulseConfig;
+
+typedef struct
+{
+	PMPulseConfig cfg;
+	PMPulseFunc   onPulse;
+	void          *ctx;
+
+	uint64_t      index;          // stream samples processed
+	ViReal32      baseline;
+	ViBoolean     baselineValid;
+	ViReal32      history[PM_PULSE_PRETRIGGER];   // last samples of the previous blocks
+	uint32_t      historyCount;
+	ViUInt32      lastTimestamp;
+
+	// pulse in progress
+	ViBoolean     inPulse;
+	PMPulse       pulse;
+	double        sum;
+	ViReal32      max;
+	ViReal32      shape[PM_PULSE_MAX_SHAPE];
+
+	uint64_t      pulses;         // records emitted
+	uint64_t      pulseSamples;   // samples inside pulses
+} PMPulseDetector;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+int      PMPulse_selectKernel(int kernel);
+int      PMPulse_kernel(void);
+const char *PMPulse_kernelName(int kernel);
+
+void     PMPulse_defaultConfig(PMPulseConfig *cfg, ViReal32 highThreshold, ViReal32 lowThreshold);
+void     PMPulse_init(PMPulseDetector *det, const PMPulseConfig *cfg, PMPulseFunc onPulse, void *ctx);
+void     PMPulse_process(PMPulseDetector *det, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count);
+void     PMPulse_consumer(void *ctx, const PMFastBlock *block);
+
+#endif /* _PM_PULSE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
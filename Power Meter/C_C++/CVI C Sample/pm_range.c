@@ -0,0 +1,376 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Managed ranging
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_range.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "TLPM.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define SLOPE_WEIGHT    0.25        // smoothing of the peak trend per block
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMRange_defaultConfig(PMRangeConfig *cfg)
+{
+	uint32_t i;
+
+	memset(cfg, 0, sizeof(PMRangeConfig));
+	for(i = 0; i < PM_RANGE_MAX_RANGES; i++)
+		cfg->gain[i] = 1.0;
+	cfg->upFraction   = PM_RANGE_DEFAULT_UP;
+	cfg->downFraction = PM_RANGE_DEFAULT_DOWN;
+	cfg->holdUs       = PM_RANGE_DEFAULT_HOLD_US;
+	cfg->predictUs    = PM_RANGE_DEFAULT_PREDICT_US;
+	cfg->periodUs     = 10;
+}
+
+
+/*---------------------------------------------------------------------------
+  Switches the device to manual ranging in the highest range and starts
+  the fast array measurement. Without configured ranges the device
+  limits are read and every decade in between is used.
+---------------------------------------------------------------------------*/
+ViStatus PMRange_init(PMRange *range, ViSession session, const PMRangeConfig *cfg, PMRangeFunc func, void *ctx)
+{
+	PMRangeConfig *c;
+	ViStatus      err;
+	uint32_t      i;
+
+	memset(range, 0, sizeof(PMRange));
+	range->session = session;
+	range->cfg     = *cfg;
+	range->func    = func;
+	range->ctx     = ctx;
+	c = &range->cfg;
+	if(c->periodUs == 0)
+		c->periodUs = 10;
+	if(c->upFraction <= 0.0 || c->upFraction > PM_RANGE_SATURATION)
+		c->upFraction = PM_RANGE_DEFAULT_UP;
+	if(c->downFraction <= 0.0 || c->downFraction >= c->upFraction)
+		c->downFraction = c->upFraction * 0.5;
+
+	if(c->rangeCount == 0)
+	{
+		ViReal64 minW, maxW, w;
+
+		if((err = TLPM_getPowerRange(session, TLPM_ATTR_MIN_VAL, &minW)) != VI_SUCCESS)
+			return err;
+		if((err = TLPM_getPowerRange(session, TLPM_ATTR_MAX_VAL, &maxW)) != VI_SUCCESS)
+			return err;
+		for(w = minW; w <= maxW * 1.0001 && c->rangeCount < PM_RANGE_MAX_RANGES; w *= 10.0)
+			c->range[c->rangeCount++] = w;
+	}
+	if(c->rangeCount == 0 || c->rangeCount > PM_RANGE_MAX_RANGES)
+		return VI_ERROR_INV_SETUP;
+	for(i = 1; i < c->rangeCount; i++)
+		if(!(c->range[i] > c->range[i - 1]))
+			return VI_ERROR_INV_SETUP;
+
+	// Start high: saturation is certain to be noticed, an overly high range is not
+	range->current = c->rangeCount - 1;
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_setPowerAutoRange(session, TLPM_AUTORANGE_POWER_OFF));
+	if(err != VI_SUCCESS)
+		return err;
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_setPowerRange(session, c->range[range->current]));
+	if(err != VI_SUCCESS)
+		return err;
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_confPowerFastArrayMeasurement(session));
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Smallest range that holds power below upFraction
+---------------------------------------------------------------------------*/
+static uint32_t fittingRange(const PMRangeConfig *cfg, double power)
+{
+	uint32_t i;
+
+	for(i = 0; i + 1 < cfg->rangeCount; i++)
+		if(power < cfg->range[i] * cfg->upFraction)
+			break;
+	return i;
+}
+
+
+static ViStatus doSwitch(PMRange *range)
+{
+	PMRangeSwitch *sw = &range->sw;
+	ViStatus      err;
+
+	sw->index++;
+	sw->reason    = range->pendingReason;
+	sw->fromRange = range->current;
+	sw->toRange   = range->pendingRange;
+	sw->lastRaw   = range->lastRaw;
+	sw->hostNs    = PMPlat_timeNs();
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_setPowerRange(range->session, range->cfg.range[sw->toRange]));
+	if(err == VI_SUCCESS)
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_confPowerFastArrayMeasurement(range->session));
+	sw->switchNs = PMPlat_timeNs() - sw->hostNs;
+	if(err != VI_SUCCESS)
+		return err;
+
+	PMPlat_store32(&range->current, sw->toRange);
+	if(sw->toRange > sw->fromRange)
+		PMPlat_store64(&range->switchesUp, range->switchesUp + 1);
+	else
+		PMPlat_store64(&range->switchesDown, range->switchesDown + 1);
+	range->pending       = VI_FALSE;
+	range->low           = VI_FALSE;
+	range->awaitingFirst = VI_TRUE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  First block after a switch: keep the timestamps monotonic and report
+  the switch with the length of the interruption
+---------------------------------------------------------------------------*/
+static void finishSwitch(PMRange *range, ViUInt16 count, ViUInt32 timestamps[])
+{
+	PMRangeSwitch *sw = &range->sw;
+	uint32_t      period = range->cfg.periodUs;
+	ViUInt32      step = timestamps[0] - range->lastRaw;
+	ViUInt16      i;
+
+	// The device clock restarted: continue after the time the switch took on the host
+	if(range->started && (step == 0 || step >= 0x80000000u))
+	{
+		ViUInt32 delta = range->lastRaw + period + (ViUInt32)((PMPlat_timeNs() - sw->hostNs) / 1000) - timestamps[0];
+
+		range->rebase += delta;
+		for(i = 0; i < count; i++)
+			timestamps[i] += delta;
+		step = timestamps[0] - range->lastRaw;
+		PMPlat_store64(&range->rebases, range->rebases + 1);
+	}
+
+	sw->firstRaw = timestamps[0];
+	sw->deadUs   = (range->started && step > period) ? step - period : 0;
+	PMPlat_store64(&range->deadUs, range->deadUs + sw->deadUs);
+	if(sw->deadUs > range->maxDeadUs)
+		PMPlat_store64(&range->maxDeadUs, sw->deadUs);
+	range->awaitingFirst = VI_FALSE;
+
+	if(range->func != NULL)
+		range->func(range->ctx, sw);
+}
+
+
+/*---------------------------------------------------------------------------
+  Range decision on the raw block of the current range
+---------------------------------------------------------------------------*/
+static void evaluate(PMRange *range, ViUInt16 count, const ViUInt32 timestamps[], const ViReal32 values[])
+{
+	const PMRangeConfig *cfg = &range->cfg;
+	uint32_t current = range->current;
+	double   top = cfg->range[current];
+	double   limit = top * PM_RANGE_SATURATION;
+	double   peak = values[0], predicted;
+	uint64_t saturated = 0;
+	ViUInt16 i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(values[i] > peak)
+			peak = values[i];
+		if(values[i] >= limit)
+			saturated++;
+	}
+
+	// Trend of the peak in W/us; a new range gives a new start
+	if(range->started && range->lastPeak >= 0.0)
+	{
+		ViUInt32 dt = timestamps[count - 1] - range->lastRaw;
+
+		if(dt > 0)
+			range->slope += ((peak - range->lastPeak) / (double)dt - range->slope) * SLOPE_WEIGHT;
+	}
+	range->lastPeak = peak;
+	predicted = peak + ((range->slope > 0.0) ? range->slope * (double)cfg->predictUs : 0.0);
+
+	if(saturated > 0)
+	{
+		uint32_t target = fittingRange(cfg, peak);
+
+		PMPlat_store64(&range->saturated, range->saturated + saturated);
+		if(current + 1 < cfg->rangeCount)
+		{
+			range->pending       = VI_TRUE;
+			range->pendingRange  = (target > current) ? target : current + 1;
+			range->pendingReason = PM_RANGE_UP_SATURATED;
+		}
+		range->low = VI_FALSE;
+		return;
+	}
+
+	if(predicted >= top * cfg->upFraction && current + 1 < cfg->rangeCount)
+	{
+		uint32_t target = fittingRange(cfg, predicted);
+
+		if(!range->pending || range->pendingRange < target || range->pendingReason == PM_RANGE_DOWN)
+		{
+			range->pending       = VI_TRUE;
+			range->pendingRange  = (target > current) ? target : current + 1;
+			range->pendingReason = PM_RANGE_UP_PREDICTED;
+		}
+		range->low = VI_FALSE;
+		return;
+	}
+	if(range->pending && range->pendingReason != PM_RANGE_DOWN)
+		return;                       // an up switch waits for the drained buffer
+
+	// Down: the lowest range whose down threshold the peak stayed below for holdUs
+	{
+		uint32_t target = current;
+
+		while(target > 0 && predicted < cfg->range[target - 1] * cfg->downFraction)
+			target--;
+
+		if(target == current)
+		{
+			range->low     = VI_FALSE;
+			range->pending = VI_FALSE;
+			return;
+		}
+		if(!range->low)
+		{
+			range->low       = VI_TRUE;
+			range->lowSince  = timestamps[0];
+			range->lowTarget = target;
+		}
+		else if(target > range->lowTarget)
+		{
+			range->lowTarget = target;
+		}
+		if(timestamps[count - 1] - range->lowSince >= cfg->holdUs)
+		{
+			range->pending       = VI_TRUE;
+			range->pendingRange  = range->lowTarget;
+			range->pendingReason = PM_RANGE_DOWN;
+		}
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  PMReadBlockFunc of the managed range source. A pending switch runs at
+  the next poll that finds the device buffer empty, or before the next
+  read when samples saturated.
+---------------------------------------------------------------------------*/
+ViStatus PMRange_readBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMRange  *range = (PMRange*)source;
+	double   gain, offset;
+	ViStatus err;
+	ViUInt16 i;
+
+	if(range->pending && range->pendingReason == PM_RANGE_UP_SATURATED)
+	{
+		if((err = doSwitch(range)) != VI_SUCCESS)
+			return err;
+	}
+
+	PM_TRACE_CALL(PM_TRACE_FAST_ARRAY, err, TLPM_getNextFastArrayMeasurement(range->session, count, timestamps, values));
+	PM_TRACE_VALUE(PM_TRACE_FAST_ARRAY_COUNT, *count);
+	if(err != VI_SUCCESS)
+		return err;
+
+	if(*count == 0)
+	{
+		if(range->pending)
+			err = doSwitch(range);
+		return err;
+	}
+
+	if(range->rebase != 0)
+		for(i = 0; i < *count; i++)
+			timestamps[i] += range->rebase;
+	if(range->awaitingFirst)
+	{
+		finishSwitch(range, *count, timestamps);
+		range->lastPeak = -1.0;
+		range->slope    = 0.0;
+	}
+
+	evaluate(range, *count, timestamps, values);
+	range->lastRaw = timestamps[*count - 1];
+	range->started = VI_TRUE;
+
+	// Every block after a switch is of the new range: it runs on an empty buffer only
+	gain   = range->cfg.gain[range->current];
+	offset = range->cfg.offset[range->current];
+	if(gain != 1.0 || offset != 0.0)
+		for(i = 0; i < *count; i++)
+			values[i] = (ViReal32)(values[i] * gain + offset);
+	return VI_SUCCESS;
+}
+
+
+PMBlockSource PMRange_source(PMRange *range)
+{
+	PMBlockSource src;
+
+	src.readBlock = PMRange_readBlock;
+	src.source    = range;
+	return src;
+}
+
+
+void PMRange_getStats(PMRange *range, PMRangeStats *stats)
+{
+	stats->current      = PMPlat_load32(&range->current);
+	stats->currentW     = range->cfg.range[stats->current];
+	stats->switchesUp   = PMPlat_load64(&range->switchesUp);
+	stats->switchesDown = PMPlat_load64(&range->switchesDown);
+	stats->deadUs       = PMPlat_load64(&range->deadUs);
+	stats->maxDeadUs    = PMPlat_load64(&range->maxDeadUs);
+	stats->saturated    = PMPlat_load64(&range->saturated);
+	stats->rebases      = PMPlat_load64(&range->rebases);
+}
+
+
+const char *PMRange_reasonName(uint32_t reason)
+{
+	switch(reason)
+	{
+		case PM_RANGE_UP_PREDICTED: return "up (predicted)";
+		case PM_RANGE_UP_SATURATED: return "up (saturated)";
+		case PM_RANGE_DOWN:         return "down";
+		default:                    return "?";
+	}
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,161 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Managed ranging
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Wide dynamic range on the fast measure stream without the device
+   auto-ranging, which stops the measurement for milliseconds at
+   moments nobody sees.
+
+   PMRange is a block source (PMBlockSource) wrapping a TLPM session with
+   auto-ranging off. It watches the peak of every block and its trend
+   and picks the power range itself:
+
+   - up as soon as the peak, extrapolated predictUs ahead, would pass
+     upFraction of the range, or at once when samples saturate;
+   - down only after the peak has stayed below downFraction of a lower
+     range for holdUs (hysteresis).
+
+   Both directions go straight to the final range, so a fast change
+   costs one interruption instead of one per decade. A switch that is
+   not forced by saturation waits until the device buffer is drained,
+   so no valid sample of the old range is thrown away.
+
+   A switch is setPowerRange plus confPowerFastArrayMeasurement. The
+   interruption appears as a gap in the timestamps; should the device
+   clock restart the timestamps are rebased so they stay monotonic.
+   Every switch is reported through a callback on the reader thread
+   before the first sample after it is handed out, with the raw
+   timestamps on both sides of the gap - ready for PMTimeline_mark, so
+   consumers see it as PM_GAP_RANGE_SWITCH, not as loss.
+
+   Values are the device power readings, optionally trimmed by a per
+   range gain and offset so the ranges join without a step.
+
+****************************************************************************/
+#ifndef _PM_RANGE_HEADER_
+#define _PM_RANGE_HEADER_
+
+#include "pm_acquisition.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_RANGE_MAX_RANGES           16
+#define PM_RANGE_DEFAULT_UP           0.9       // of the range
+#define PM_RANGE_DEFAULT_DOWN         0.5       // of the lower range
+#define PM_RANGE_DEFAULT_HOLD_US      200000
+#define PM_RANGE_DEFAULT_PREDICT_US   5000      // about one switch
+#define PM_RANGE_SATURATION           0.999     // of the range
+
+// PMRangeSwitch reasons
+#define PM_RANGE_UP_PREDICTED         0
+#define PM_RANGE_UP_SATURATED         1
+#define PM_RANGE_DOWN                 2
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint32_t  rangeCount;                       // 0: decades between the device limits
+	double    range[PM_RANGE_MAX_RANGES];       // W, ascending
+	double    gain[PM_RANGE_MAX_RANGES];        // trim per range, value * gain + offset
+	double    offset[PM_RANGE_MAX_RANGES];      // W
+	double    upFraction;
+	double    downFraction;
+	uint32_t  holdUs;
+	uint32_t  predictUs;
+	uint32_t  periodUs;                         // timestamp step of consecutive samples
+} PMRangeConfig;
+
+typedef struct
+{
+	uint64_t  index;                            // switch number
+	uint32_t  reason;                           // PM_RANGE_UP_* / PM_RANGE_DOWN
+	uint32_t  fromRange, toRange;               // indices into cfg.range
+	ViUInt32  lastRaw;                          // last timestamp before the switch (as handed out)
+	ViUInt32  firstRaw;                         // first timestamp after it
+	uint32_t  deadUs;                           // time without samples
+	uint64_t  hostNs;                           // host clock at the start of the switch
+	uint64_t  switchNs;                         // time spent in the driver calls
+} PMRangeSwitch;
+
+// Called on the reader thread for every switch, before its first block is handed out
+typedef void (*PMRangeFunc)(void *ctx, const PMRangeSwitch *sw);
+
+typedef struct
+{
+	ViSession         session;
+	PMRangeConfig     cfg;
+	PMRangeFunc       func;
+	void              *ctx;
+	volatile uint32_t current;                  // range index in use
+
+	// Reader thread only
+	ViBoolean         started;
+	ViUInt32          lastRaw;                  // last timestamp handed out
+	ViUInt32          rebase;                   // added to the device timestamps
+	double            lastPeak;
+	double            slope;                    // W/us, smoothed peak trend
+	ViBoolean         low;                      // below the down threshold since lowSince
+	ViUInt32          lowSince;
+	uint32_t          lowTarget;
+	ViBoolean         pending;
+	uint32_t          pendingRange;
+	uint32_t          pendingReason;
+	ViBoolean         awaitingFirst;
+	PMRangeSwitch     sw;
+
+	volatile uint64_t switchesUp;
+	volatile uint64_t switchesDown;
+	volatile uint64_t deadUs;
+	volatile uint64_t maxDeadUs;
+	volatile uint64_t saturated;                // samples at the top of their range
+	volatile uint64_t rebases;
+} PMRange;
+
+typedef struct
+{
+	uint32_t  current;
+	double    currentW;
+	uint64_t  switchesUp;
+	uint64_t  switchesDown;
+	uint64_t  deadUs;
+	uint64_t  maxDeadUs;
+	uint64_t  saturated;
+	uint64_t  rebases;
+} PMRangeStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void          PMRange_defaultConfig(PMRangeConfig *cfg);
+ViStatus      PMRange_init(PMRange *range, ViSession session, const PMRangeConfig *cfg, PMRangeFunc func, void *ctx);
+ViStatus      PMRange_readBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[]);
+PMBlockSource PMRange_source(PMRange *range);
+void          PMRange_getStats(PMRange *range, PMRangeStats *stats);
+const char   *PMRange_reasonName(uint32_t reason);
+
+#endif /* _PM_RANGE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,150 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Block ring
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_ring.h"
+
+#include <string.h>
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+
+/*---------------------------------------------------------------------------
+  Allocate the ring. capacity is rounded up to a power of two.
+---------------------------------------------------------------------------*/
+ViStatus PMRing_init(PMRing *ring, uint32_t capacity)
+{
+	uint32_t size = 2;
+
+	memset(ring, 0, sizeof(PMRing));
+	while(size < capacity)
+		size <<= 1;
+
+	ring->slots = (PMFastBlock*)PMPlat_alignedAlloc(size * sizeof(PMFastBlock), PM_CACHE_LINE);
+	if(ring->slots == NULL)
+		return VI_ERROR_ALLOC;
+
+	// touch every slot now so the poll loop never takes a page fault
+	memset(ring->slots, 0, size * sizeof(PMFastBlock));
+	ring->capacity = size;
+	ring->mask     = size - 1;
+	return VI_SUCCESS;
+}
+
+
+void PMRing_free(PMRing *ring)
+{
+	if(ring->slots != NULL)
+		PMPlat_alignedFree(ring->slots);
+	ring->slots = NULL;
+}
+
+
+/*---------------------------------------------------------------------------
+  Producer: get the next free slot or NULL if the ring is full. A full
+  ring is not an overflow yet: the producer reports the block it could
+  not store with PMRing_drop.
+---------------------------------------------------------------------------*/
+PMFastBlock *PMRing_beginWrite(PMRing *ring)
+{
+	uint64_t head = ring->head;
+
+	if(head - ring->tailCache >= ring->capacity)
+	{
+		ring->tailCache = PMPlat_load64(&ring->tail);
+		if(head - ring->tailCache >= ring->capacity)
+			return NULL;
+	}
+	return &ring->slots[head & ring->mask];
+}
+
+
+/*---------------------------------------------------------------------------
+  Producer: count a block lost because PMRing_beginWrite found no slot
+---------------------------------------------------------------------------*/
+void PMRing_drop(PMRing *ring)
+{
+	PMPlat_store64(&ring->overflows, ring->overflows + 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Producer: publish the slot returned by PMRing_beginWrite
+---------------------------------------------------------------------------*/
+void PMRing_endWrite(PMRing *ring)
+{
+	uint64_t head = ring->head + 1;
+	uint32_t fill = (uint32_t)(head - ring->tailCache);
+
+	if(fill > ring->highWater)
+	{
+		ring->tailCache = PMPlat_load64(&ring->tail);
+		fill = (uint32_t)(head - ring->tailCache);
+		if(fill > ring->highWater)
+			PMPlat_store32(&ring->highWater, fill);
+	}
+	PMPlat_store64(&ring->head, head);
+}
+
+
+/*---------------------------------------------------------------------------
+  Consumer: get the oldest published slot or NULL if the ring is empty
+---------------------------------------------------------------------------*/
+PMFastBlock *PMRing_beginRead(PMRing *ring)
+{
+	uint64_t tail = ring->tail;
+
+	if(tail == ring->headCache)
+	{
+		ring->headCache = PMPlat_load64(&ring->head);
+		if(tail == ring->headCache)
+			return NULL;
+	}
+	return &ring->slots[tail & ring->mask];
+}
+
+
+/*---------------------------------------------------------------------------
+  Consumer: hand the slot returned by PMRing_beginRead back to the producer
+---------------------------------------------------------------------------*/
+void PMRing_endRead(PMRing *ring)
+{
+	PMPlat_store64(&ring->tail, ring->tail + 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Current number of published but not yet consumed blocks
+---------------------------------------------------------------------------*/
+uint32_t PMRing_fill(PMRing *ring)
+{
+	uint64_t tail = PMPlat_load64(&ring->tail);
+	uint64_t head = PMPlat_load64(&ring->head);
+
+	return (uint32_t)(head - tail);
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
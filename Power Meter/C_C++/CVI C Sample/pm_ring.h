@@ -0,0 +1,97 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Block ring
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Lock-free single-producer/single-consumer ring of preallocated fast
+   measure stream blocks. The producer never waits: if the ring is full
+   the block is counted as overflow and dropped.
+
+****************************************************************************/
+#ifndef _PM_RING_HEADER_
+#define _PM_RING_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+// TLPM_getNextFastArrayMeasurement returns up to 200 pairs. Two spare entries
+// keep the driver from writing out of bounds (same as the original sample).
+#define PM_FAST_BLOCK_SIZE    202
+#define PM_FAST_BLOCK_STRIDE  208      // column length, whole cache lines
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Columns first and padded to whole cache lines, so both start aligned in
+// every slot of a cache line aligned ring
+typedef struct
+{
+	ViUInt32    timestamps[PM_FAST_BLOCK_STRIDE]; // raw device timestamps in us (wrap around)
+	ViReal32    values[PM_FAST_BLOCK_STRIDE];
+	uint64_t    sequence;                         // block number assigned by the reader
+	uint64_t    hostTimeNs;                       // host clock when the block was received
+	ViUInt16    count;                            // valid entries in timestamps/values
+	char        pad[PM_CACHE_LINE - 2 * sizeof(uint64_t) - sizeof(ViUInt16)];
+} PMFastBlock;
+
+typedef struct
+{
+	// producer side
+	volatile uint64_t head;
+	uint64_t          tailCache;
+	volatile uint64_t overflows;                  // blocks dropped because the ring was full
+	volatile uint32_t highWater;                  // maximum fill level seen by the producer
+	char              padProducer[PM_CACHE_LINE];
+
+	// consumer side
+	volatile uint64_t tail;
+	uint64_t          headCache;
+	char              padConsumer[PM_CACHE_LINE];
+
+	PMFastBlock       *slots;
+	uint32_t          capacity;
+	uint32_t          mask;
+} PMRing;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+ViStatus     PMRing_init(PMRing *ring, uint32_t capacity);
+void         PMRing_free(PMRing *ring);
+
+// Producer
+PMFastBlock *PMRing_beginWrite(PMRing *ring);
+void         PMRing_endWrite(PMRing *ring);
+void         PMRing_drop(PMRing *ring);
+
+// Consumer
+PMFastBlock *PMRing_beginRead(PMRing *ring);
+void         PMRing_endRead(PMRing *ring);
+
+// Any thread
+uint32_t     PMRing_fill(PMRing *ring);
+
+#endif /* _PM_RING_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,526 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Shared memory stream
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_shmstream.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPM.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+// Query slot states
+#define QUERY_FREE            0
+#define QUERY_CLAIMED         1         // client writes the request
+#define QUERY_PENDING         2         // waits for the server
+#define QUERY_BUSY            3         // server executes it
+#define QUERY_DONE            4         // answer ready for the client
+
+#define QUERY_POLL_US         50
+#define ACTIVE_READER_NS      1000000000ull
+
+#define ALIGN_UP(x, a)        (((x) + (a) - 1) & ~((uint64_t)(a) - 1))
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+
+/*---------------------------------------------------------------------------
+  Sets up the pointers into a mapped stream.
+---------------------------------------------------------------------------*/
+static void mapLayout(PMShmHeader *hdr, PMShmReaderEntry **readers, PMShmQuerySlot **queries, PMShmSlot **slots)
+{
+	uint8_t *base = (uint8_t*)hdr;
+
+	*readers = (PMShmReaderEntry*)(base + hdr->readerOffset);
+	*queries = (PMShmQuerySlot*)(base + hdr->queryOffset);
+	*slots   = (PMShmSlot*)(base + hdr->slotOffset);
+}
+
+
+/*---------------------------------------------------------------------------
+  Creates the named stream. Fails with VI_ERROR_INV_SETUP if another
+  server already publishes under this name.
+---------------------------------------------------------------------------*/
+ViStatus PMShmServer_create(PMShmServer *srv, const char *name, uint32_t capacity, const PMShmStreamInfo *info)
+{
+	PMShmHeader *hdr;
+	uint64_t    readerOffset, queryOffset, slotOffset;
+	uint32_t    slots = 2;
+	ViStatus    err;
+
+	memset(srv, 0, sizeof(*srv));
+	while(slots < capacity)
+		slots <<= 1;
+
+	readerOffset = ALIGN_UP(sizeof(PMShmHeader), PM_CACHE_LINE);
+	queryOffset  = ALIGN_UP(readerOffset + PM_SHM_MAX_READERS * sizeof(PMShmReaderEntry), PM_CACHE_LINE);
+	slotOffset   = ALIGN_UP(queryOffset + PM_SHM_MAX_QUERIES * sizeof(PMShmQuerySlot), PM_CACHE_LINE);
+
+	if((err = PMPlat_shmCreate(&srv->shm, name, (size_t)(slotOffset + (uint64_t)slots * sizeof(PMShmSlot)))) != VI_SUCCESS)
+		return err;
+
+	// The memory comes zeroed: all slots, reader entries and queries are free
+	hdr = (PMShmHeader*)srv->shm.base;
+	hdr->version      = PM_SHM_VERSION;
+	hdr->headerSize   = (uint32_t)sizeof(PMShmHeader);
+	hdr->capacity     = slots;
+	hdr->slotSize     = (uint32_t)sizeof(PMShmSlot);
+	hdr->readerOffset = readerOffset;
+	hdr->queryOffset  = queryOffset;
+	hdr->slotOffset   = slotOffset;
+	hdr->startUnixUs  = PMPlat_unixTimeUs();
+	if(info != NULL)
+		hdr->info = *info;
+
+	srv->hdr  = hdr;
+	srv->mask = slots - 1;
+	mapLayout(hdr, &srv->readers, &srv->queries, &srv->slots);
+
+	// Readers check the magic first, so it goes in last
+	PMPlat_fence();
+	memcpy(hdr->magic, PM_SHM_MAGIC, sizeof(hdr->magic));
+	PMPlat_store32(&hdr->state, PM_SHM_RUNNING);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Publishes one block. Single producer, never waits for readers.
+---------------------------------------------------------------------------*/
+void PMShmServer_publish(PMShmServer *srv, const PMFastBlock *block)
+{
+	uint64_t  seq = srv->hdr->head;
+	PMShmSlot *slot = &srv->slots[seq & srv->mask];
+
+	// Odd stamp while the block is rewritten, readers of the old block see the change
+	PMPlat_store64(&slot->stamp, 2 * seq + 1);
+	PMPlat_fence();
+	memcpy(&slot->block, block, sizeof(PMFastBlock));
+	PMPlat_store64(&slot->stamp, 2 * seq + 2);
+
+	PMPlat_store64(&srv->hdr->samples, srv->hdr->samples + block->count);
+	PMPlat_store64(&srv->hdr->head, seq + 1);
+}
+
+
+void PMShmServer_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMShmServer_publish((PMShmServer*)ctx, block);
+}
+
+
+/*---------------------------------------------------------------------------
+  Runs one control query on the session.
+---------------------------------------------------------------------------*/
+static void executeQuery(ViSession vi, PMShmQuery *q)
+{
+	ViInt16 unit = 0;
+	ViChar  manufacturer[TLPM_BUFFER_SIZE] = "";
+	ViChar  device[TLPM_BUFFER_SIZE] = "";
+	ViChar  serial[TLPM_BUFFER_SIZE] = "";
+	ViChar  firmware[TLPM_BUFFER_SIZE] = "";
+
+	q->value   = 0.0;
+	q->text[0] = '\0';
+	if(vi == VI_NULL)
+	{
+		q->status = VI_ERROR_NSUP_OPER;
+		return;
+	}
+
+	switch(q->op)
+	{
+		case PM_SHM_GET_WAVELENGTH:
+			q->status = TLPM_getWavelength(vi, q->attribute, &q->value);
+			break;
+		case PM_SHM_SET_WAVELENGTH:
+			q->status = TLPM_setWavelength(vi, q->arg);
+			break;
+		case PM_SHM_GET_POWER_RANGE:
+			q->status = TLPM_getPowerRange(vi, q->attribute, &q->value);
+			break;
+		case PM_SHM_SET_POWER_RANGE:
+			q->status = TLPM_setPowerRange(vi, q->arg);
+			break;
+		case PM_SHM_GET_POWER_UNIT:
+			q->status = TLPM_getPowerUnit(vi, &unit);
+			q->value  = unit;
+			break;
+		case PM_SHM_IDENTIFY:
+			q->status = TLPM_identificationQuery(vi, manufacturer, device, serial, firmware);
+			if(q->status == VI_SUCCESS)
+				snprintf(q->text, sizeof(q->text), "%s;%s;%s;%s", manufacturer, device, serial, firmware);
+			break;
+		default:
+			q->status = VI_ERROR_NSUP_OPER;
+			break;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Answers pending control queries and discards answers nobody picked up.
+  Must run on the thread that reads the stream.
+---------------------------------------------------------------------------*/
+void PMShmServer_serviceQueries(PMShmServer *srv)
+{
+	uint32_t i;
+	uint64_t now = 0;
+
+	for(i = 0; i < PM_SHM_MAX_QUERIES; i++)
+	{
+		PMShmQuerySlot *slot = &srv->queries[i];
+		uint64_t       state = PMPlat_load64(&slot->state);
+
+		if(state == QUERY_PENDING && PMPlat_cas64(&slot->state, QUERY_PENDING, QUERY_BUSY))
+		{
+			PMShmQuery q = slot->query;
+
+			executeQuery(srv->session, &q);
+			slot->query = q;
+			PMPlat_store64(&slot->doneNs, PMPlat_timeNs());
+			PMPlat_store64(&slot->state, QUERY_DONE);
+			srv->queriesServed++;
+		}
+		else if(state == QUERY_DONE)
+		{
+			// The client timed out while the query ran
+			if(now == 0)
+				now = PMPlat_timeNs();
+			if(now - PMPlat_load64(&slot->doneNs) > PM_SHM_REPLY_TIMEOUT_NS)
+				PMPlat_cas64(&slot->state, QUERY_DONE, QUERY_FREE);
+		}
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Stream source that answers the control queries between two reads of the
+  device, so the session is only ever used by the acquisition reader thread.
+---------------------------------------------------------------------------*/
+static ViStatus serverReadBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMShmServer *srv = (PMShmServer*)source;
+
+	PMShmServer_serviceQueries(srv);
+	return srv->device.readBlock(srv->device.source, count, timestamps, values);
+}
+
+
+PMBlockSource PMShmServer_source(PMShmServer *srv, PMBlockSource device, ViSession session)
+{
+	PMBlockSource src;
+
+	srv->device  = device;
+	srv->session = session;
+	src.readBlock = serverReadBlock;
+	src.source    = srv;
+	return src;
+}
+
+
+/*---------------------------------------------------------------------------
+  Lists the connected readers and frees entries of readers that stopped
+  reading (crashed or hung) for PM_SHM_READER_TIMEOUT_NS.
+---------------------------------------------------------------------------*/
+uint32_t PMShmServer_readers(PMShmServer *srv, PMShmReaderStats stats[], uint32_t max)
+{
+	uint64_t now = PMPlat_timeNs();
+	uint64_t head = PMPlat_load64(&srv->hdr->head);
+	uint32_t i, n = 0;
+
+	for(i = 0; i < PM_SHM_MAX_READERS; i++)
+	{
+		PMShmReaderEntry *entry = &srv->readers[i];
+		uint64_t         id = PMPlat_load64(&entry->id);
+		uint64_t         heartbeat, cursor;
+
+		if(id == 0)
+			continue;
+		heartbeat = PMPlat_load64(&entry->heartbeatNs);
+		if(now > heartbeat && now - heartbeat > PM_SHM_READER_TIMEOUT_NS)
+		{
+			PMPlat_cas64(&entry->id, id, 0);
+			continue;
+		}
+		if(n >= max)
+			continue;
+
+		cursor = PMPlat_load64(&entry->cursor);
+		stats[n].id     = i;
+		stats[n].lag    = head > cursor ? head - cursor : 0;
+		stats[n].lost   = PMPlat_load64(&entry->lost);
+		stats[n].active = (now <= heartbeat || now - heartbeat < ACTIVE_READER_NS);
+		n++;
+	}
+	return n;
+}
+
+
+/*---------------------------------------------------------------------------
+  Marks the stream stopped and removes the name. Connected readers keep
+  their mapping and see the state change.
+---------------------------------------------------------------------------*/
+void PMShmServer_close(PMShmServer *srv, ViStatus status)
+{
+	if(srv->hdr == NULL)
+		return;
+
+	srv->hdr->status = status;
+	PMPlat_fence();
+	PMPlat_store32(&srv->hdr->state, PM_SHM_STOPPED);
+	PMPlat_shmClose(&srv->shm);
+	srv->hdr = NULL;
+}
+
+
+/*---------------------------------------------------------------------------
+  Takes a free entry of the reader table. The table is for monitoring
+  only, a reader without entry still reads.
+---------------------------------------------------------------------------*/
+static void claimEntry(PMShmReader *reader)
+{
+	PMShmReaderEntry *readers = (PMShmReaderEntry*)((uint8_t*)reader->hdr + reader->hdr->readerOffset);
+	uint32_t         i;
+
+	reader->entry = NULL;
+	for(i = 0; i < PM_SHM_MAX_READERS; i++)
+	{
+		PMShmReaderEntry *entry = &readers[i];
+
+		if(PMPlat_load64(&entry->id) == 0 && PMPlat_cas64(&entry->id, 0, reader->id))
+		{
+			PMPlat_store64(&entry->cursor, reader->cursor);
+			PMPlat_store64(&entry->lost, reader->lost);
+			PMPlat_store64(&entry->heartbeatNs, PMPlat_timeNs());
+			reader->entry = entry;
+			return;
+		}
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Connects to a running stream. Reading starts at the newest block.
+---------------------------------------------------------------------------*/
+ViStatus PMShmReader_open(PMShmReader *reader, const char *name)
+{
+	PMShmHeader      *hdr;
+	PMShmReaderEntry *readers;
+	ViStatus         err;
+
+	memset(reader, 0, sizeof(*reader));
+	if((err = PMPlat_shmOpen(&reader->shm, name)) != VI_SUCCESS)
+		return err;
+
+	hdr = (PMShmHeader*)reader->shm.base;
+	if(reader->shm.size < sizeof(PMShmHeader) ||
+	   memcmp(hdr->magic, PM_SHM_MAGIC, sizeof(hdr->magic)) != 0 ||
+	   hdr->version != PM_SHM_VERSION || hdr->headerSize != sizeof(PMShmHeader) ||
+	   hdr->slotSize != sizeof(PMShmSlot) || hdr->capacity < 2 || (hdr->capacity & (hdr->capacity - 1)) != 0 ||
+	   reader->shm.size < hdr->slotOffset + (uint64_t)hdr->capacity * hdr->slotSize)
+	{
+		PMPlat_shmClose(&reader->shm);
+		return VI_ERROR_INV_FMT;
+	}
+	PMPlat_fence();
+
+	reader->hdr   = hdr;
+	reader->mask  = hdr->capacity - 1;
+	reader->guard = hdr->capacity / 8;
+	mapLayout(hdr, &readers, &reader->queries, &reader->slots);
+
+	// Unique over all processes: server run, reader start time and address
+	reader->id     = (PMPlat_timeNs() ^ (uint64_t)(uintptr_t)reader ^ hdr->startUnixUs) | 1;
+	reader->cursor = PMPlat_load64(&hdr->head);
+	claimEntry(reader);
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Returns the block at the cursor in place, or NULL if there is no new
+  block. A reader that fell behind the writer skips ahead to guard blocks
+  behind the newest block and counts the skipped blocks as lost. The
+  block stays valid until PMShmReader_endRead.
+---------------------------------------------------------------------------*/
+const PMFastBlock *PMShmReader_beginRead(PMShmReader *reader)
+{
+	uint32_t capacity = reader->mask + 1;
+
+	reader->current = NULL;
+	for(;;)
+	{
+		uint64_t  head = PMPlat_load64(&reader->hdr->head);
+		PMShmSlot *slot;
+		uint64_t  stamp;
+
+		if(reader->cursor >= head)
+		{
+			if(reader->entry != NULL)
+				PMPlat_store64(&reader->entry->heartbeatNs, PMPlat_timeNs());
+			return NULL;
+		}
+		if(head - reader->cursor > capacity - reader->guard)
+		{
+			reader->lost  += head - reader->guard - reader->cursor;
+			reader->cursor = head - reader->guard;
+		}
+
+		slot  = &reader->slots[reader->cursor & reader->mask];
+		stamp = PMPlat_load64(&slot->stamp);
+		if(stamp == 2 * reader->cursor + 2)
+		{
+			reader->current = slot;
+			return &slot->block;
+		}
+
+		// Overwritten between the head load and the stamp load
+		reader->lost++;
+		reader->cursor++;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Releases the block of beginRead. Returns VI_ERROR_QUEUE_OVERFLOW if the
+  writer overwrote the block while it was used; the data read from it
+  must then be discarded.
+---------------------------------------------------------------------------*/
+ViStatus PMShmReader_endRead(PMShmReader *reader)
+{
+	ViStatus err = VI_SUCCESS;
+	uint64_t stamp;
+
+	if(reader->current == NULL)
+		return VI_SUCCESS;
+
+	PMPlat_fence();
+	stamp = PMPlat_load64(&reader->current->stamp);
+	if(stamp != 2 * reader->cursor + 2)
+	{
+		reader->torn++;
+		err = VI_ERROR_QUEUE_OVERFLOW;
+	}
+	else
+		reader->blocks++;
+	reader->cursor++;
+	reader->current = NULL;
+
+	// Server may have reclaimed the entry after a long stall
+	if(reader->entry != NULL && PMPlat_load64(&reader->entry->id) != reader->id)
+		reader->entry = NULL;
+	if(reader->entry == NULL)
+		claimEntry(reader);
+	if(reader->entry != NULL)
+	{
+		PMPlat_store64(&reader->entry->cursor, reader->cursor);
+		PMPlat_store64(&reader->entry->lost, reader->lost + reader->torn);
+		PMPlat_store64(&reader->entry->heartbeatNs, PMPlat_timeNs());
+	}
+	return err;
+}
+
+
+uint32_t PMShmReader_state(PMShmReader *reader)
+{
+	return PMPlat_load32(&reader->hdr->state);
+}
+
+
+/*---------------------------------------------------------------------------
+  Sends a control query to the server and waits for the answer. Returns
+  VI_ERROR_TMO if no query slot got free or the server did not answer in
+  time, otherwise the status of the driver call.
+---------------------------------------------------------------------------*/
+ViStatus PMShmReader_query(PMShmReader *reader, PMShmQuery *query, uint32_t timeoutUs)
+{
+	uint64_t       deadline = PMPlat_timeNs() + (uint64_t)timeoutUs * 1000;
+	PMShmQuerySlot *slot = NULL;
+	uint32_t       i;
+
+	while(slot == NULL)
+	{
+		if(PMShmReader_state(reader) != PM_SHM_RUNNING)
+			return VI_ERROR_INV_SETUP;
+		for(i = 0; i < PM_SHM_MAX_QUERIES && slot == NULL; i++)
+		{
+			if(PMPlat_load64(&reader->queries[i].state) == QUERY_FREE &&
+			   PMPlat_cas64(&reader->queries[i].state, QUERY_FREE, QUERY_CLAIMED))
+				slot = &reader->queries[i];
+		}
+		if(slot == NULL)
+		{
+			if(PMPlat_timeNs() > deadline)
+				return VI_ERROR_TMO;
+			PMPlat_sleepUs(QUERY_POLL_US);
+		}
+	}
+
+	slot->query = *query;
+	PMPlat_store64(&slot->state, QUERY_PENDING);
+
+	for(;;)
+	{
+		if(PMPlat_load64(&slot->state) == QUERY_DONE)
+		{
+			*query = slot->query;
+			PMPlat_store64(&slot->state, QUERY_FREE);
+			return query->status;
+		}
+		if(PMPlat_timeNs() > deadline || PMShmReader_state(reader) != PM_SHM_RUNNING)
+			break;
+		PMPlat_sleepUs(QUERY_POLL_US);
+	}
+
+	// Withdraw it; a query the server already runs is discarded by the server
+	if(PMPlat_cas64(&slot->state, QUERY_PENDING, QUERY_FREE))
+		return VI_ERROR_TMO;
+	if(PMPlat_load64(&slot->state) == QUERY_DONE && PMPlat_cas64(&slot->state, QUERY_DONE, QUERY_CLAIMED))
+	{
+		*query = slot->query;
+		PMPlat_store64(&slot->state, QUERY_FREE);
+		return query->status;
+	}
+	return VI_ERROR_TMO;
+}
+
+
+void PMShmReader_close(PMShmReader *reader)
+{
+	if(reader->hdr == NULL)
+		return;
+
+	if(reader->entry != NULL)
+		PMPlat_cas64(&reader->entry->id, reader->id, 0);
+	PMPlat_shmClose(&reader->shm);
+	reader->hdr = NULL;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
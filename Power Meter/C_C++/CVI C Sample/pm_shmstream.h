@@ -0,0 +1,208 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Shared memory stream
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Fan-out of one fast measure stream to several local processes. Only
+   one process can own the instrument session; this stream server
+   publishes every block into a named shared memory ring that any number
+   of reader processes map.
+
+   The ring is single-producer/multi-reader and never waits for readers.
+   Slots are overwritten in order, and each reader keeps its own cursor.
+   Readers access the blocks in place (zero copy). A per-slot stamp,
+   written before and after the block (sequence lock), tells a reader
+   that it has fallen behind: either the block at its cursor has already
+   been overwritten, or it was overwritten while the reader was using it.
+   The reader then skips ahead and counts the lost blocks.
+
+   Clients send scalar queries (wavelength, range, ...) through a small
+   control area in the same memory. The server answers them on its
+   acquisition reader thread between two polls of the stream, so queries
+   never run concurrently with the stream readout on the session and the
+   stream keeps flowing.
+
+   Layout: PMShmHeader, PMShmReaderEntry[], PMShmQuerySlot[], then
+   PMShmSlot[capacity]; all parts start on a cache line.
+
+****************************************************************************/
+#ifndef _PM_SHMSTREAM_HEADER_
+#define _PM_SHMSTREAM_HEADER_
+
+#include "pm_acquisition.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_SHM_MAGIC              "TLPMSHM"
+#define PM_SHM_VERSION            1
+#define PM_SHM_DEFAULT_NAME       "pm_stream"
+#define PM_SHM_DEFAULT_CAPACITY   1024      // blocks, ~2 s at 100 kHz
+#define PM_SHM_MAX_READERS        16
+#define PM_SHM_MAX_QUERIES        8         // concurrent control requests
+#define PM_SHM_TEXT_SIZE          256
+#define PM_SHM_READER_TIMEOUT_NS  10000000000ull  // reader entries without reads are reclaimed
+#define PM_SHM_REPLY_TIMEOUT_NS   1000000000ull   // answers nobody picks up are discarded
+
+// Server state
+#define PM_SHM_STARTING           0
+#define PM_SHM_RUNNING            1
+#define PM_SHM_STOPPED            2
+
+// Control channel operations (TLPM functions on the streaming session)
+#define PM_SHM_GET_WAVELENGTH     1         // attribute -> value (nm)
+#define PM_SHM_SET_WAVELENGTH     2         // arg (nm)
+#define PM_SHM_GET_POWER_RANGE    3         // attribute -> value (W)
+#define PM_SHM_SET_POWER_RANGE    4         // arg (W)
+#define PM_SHM_GET_POWER_UNIT     5         // -> value
+#define PM_SHM_IDENTIFY           6         // -> text "manufacturer;device;serial;firmware"
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViChar   device[PM_SHM_TEXT_SIZE];
+	ViChar   serial[PM_SHM_TEXT_SIZE];
+	ViChar   unit[16];
+	double   sampleRate;          // Hz
+} PMShmStreamInfo;
+
+typedef struct
+{
+	char              magic[8];   // PM_SHM_MAGIC
+	uint32_t          version;
+	uint32_t          headerSize;
+	uint32_t          capacity;   // slots, power of two
+	uint32_t          slotSize;
+	uint64_t          readerOffset;
+	uint64_t          queryOffset;
+	uint64_t          slotOffset;
+	uint64_t          startUnixUs; // identifies the server run
+	PMShmStreamInfo   info;
+
+	volatile uint32_t state;      // PM_SHM_STARTING, ...
+	volatile ViStatus status;     // acquisition status once stopped
+	char              pad0[PM_CACHE_LINE];
+
+	volatile uint64_t head;       // blocks published so far
+	volatile uint64_t samples;
+	char              pad1[PM_CACHE_LINE - 2 * sizeof(uint64_t)];
+} PMShmHeader;
+
+typedef struct
+{
+	volatile uint64_t id;         // 0 = free
+	volatile uint64_t cursor;     // next block the reader will read
+	volatile uint64_t lost;       // blocks skipped after falling behind
+	volatile uint64_t heartbeatNs;
+	char              pad[PM_CACHE_LINE - 4 * sizeof(uint64_t)];
+} PMShmReaderEntry;
+
+typedef struct
+{
+	uint32_t  op;                 // PM_SHM_GET_WAVELENGTH, ...
+	ViInt16   attribute;          // TLPM_ATTR_SET_VAL, ...
+	double    arg;
+	ViStatus  status;
+	double    value;
+	ViChar    text[PM_SHM_TEXT_SIZE];
+} PMShmQuery;
+
+typedef struct
+{
+	volatile uint64_t state;      // see pm_shmstream.c
+	volatile uint64_t doneNs;
+	PMShmQuery        query;
+} PMShmQuerySlot;
+
+typedef struct
+{
+	volatile uint64_t stamp;      // 2 * sequence + 1 while written, 2 * sequence + 2 when complete
+	char              pad[PM_CACHE_LINE - sizeof(uint64_t)];
+	PMFastBlock       block;
+} PMShmSlot;
+
+typedef struct
+{
+	PMPlatShm         shm;
+	PMShmHeader       *hdr;
+	PMShmReaderEntry  *readers;
+	PMShmQuerySlot    *queries;
+	PMShmSlot         *slots;
+	uint32_t          mask;
+
+	ViSession         session;    // answers control queries, VI_NULL: not supported
+	PMBlockSource     device;     // wrapped by PMShmServer_source
+	uint64_t          queriesServed;
+} PMShmServer;
+
+typedef struct
+{
+	PMPlatShm         shm;
+	PMShmHeader       *hdr;
+	PMShmReaderEntry  *entry;     // NULL if the reader table was full
+	PMShmQuerySlot    *queries;
+	PMShmSlot         *slots;
+	uint32_t          mask;
+	uint32_t          guard;      // distance kept from the writer after falling behind
+	uint64_t          id;
+
+	uint64_t          cursor;
+	PMShmSlot         *current;   // block handed out by beginRead
+	uint64_t          blocks;     // blocks read intact
+	uint64_t          lost;       // blocks skipped after falling behind
+	uint64_t          torn;       // blocks overwritten while in use
+} PMShmReader;
+
+typedef struct
+{
+	uint32_t          id;         // reader table index
+	uint64_t          lag;        // blocks behind the writer
+	uint64_t          lost;
+	ViBoolean         active;     // read within the last second
+} PMShmReaderStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+// Server
+ViStatus      PMShmServer_create(PMShmServer *srv, const char *name, uint32_t capacity, const PMShmStreamInfo *info);
+PMBlockSource PMShmServer_source(PMShmServer *srv, PMBlockSource device, ViSession session);
+void          PMShmServer_publish(PMShmServer *srv, const PMFastBlock *block);
+void          PMShmServer_consumer(void *ctx, const PMFastBlock *block);
+void          PMShmServer_serviceQueries(PMShmServer *srv);
+uint32_t      PMShmServer_readers(PMShmServer *srv, PMShmReaderStats stats[], uint32_t max);
+void          PMShmServer_close(PMShmServer *srv, ViStatus status);
+
+// Reader
+ViStatus      PMShmReader_open(PMShmReader *reader, const char *name);
+const PMFastBlock *PMShmReader_beginRead(PMShmReader *reader);
+ViStatus      PMShmReader_endRead(PMShmReader *reader);
+uint32_t      PMShmReader_state(PMShmReader *reader);
+ViStatus      PMShmReader_query(PMShmReader *reader, PMShmQuery *query, uint32_t timeoutUs);
+void          PMShmReader_close(PMShmReader *reader);
+
+#endif /* _PM_SHMSTREAM_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
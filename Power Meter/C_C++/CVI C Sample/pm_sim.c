@@ -0,0 +1,251 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated fast measure stream
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_sim.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Delays shorter than this are spun, longer ones sleep all but the rest
+#define SPIN_US               200
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static uint32_t nextRandom(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+
+void PMSim_defaultConfig(PMSimConfig *cfg)
+{
+	memset(cfg, 0, sizeof(PMSimConfig));
+	cfg->sampleRate      = PM_SIM_SAMPLE_RATE;
+	cfg->blockSamples    = PM_SIM_BLOCK_SAMPLES;
+	cfg->deviceBufferUs  = PM_SIM_DEVICE_BUFFER_US;
+	cfg->realTime        = VI_TRUE;
+	cfg->signalMean      = 1.0e-3;
+	cfg->signalAmplitude = 0.1e-3;
+	cfg->signalFreq      = 50.0;
+	cfg->noise           = 0.01e-3;
+	cfg->seed            = 0x1313u;
+}
+
+
+void PMSim_init(PMSim *sim, const PMSimConfig *cfg)
+{
+	memset(sim, 0, sizeof(PMSim));
+	sim->cfg = *cfg;
+	if(sim->cfg.blockSamples > PM_FAST_BLOCK_SIZE)
+		sim->cfg.blockSamples = PM_FAST_BLOCK_SIZE;
+	sim->rng       = cfg->seed ? cfg->seed : 1;
+	sim->phaseStep = 2.0 * M_PI * cfg->signalFreq / (double)cfg->sampleRate;
+	sim->startNs   = PMPlat_timeNs();
+}
+
+
+/*---------------------------------------------------------------------------
+  Override configuration from PM_SIM_* environment variables, so programs
+  linked against the simulated driver can be tuned without rebuilding
+---------------------------------------------------------------------------*/
+void PMSim_configFromEnv(PMSimConfig *cfg)
+{
+	const char *v;
+
+	if((v = getenv("PM_SIM_LATENCY_US")) != NULL)
+		cfg->callLatencyUs = (uint32_t)strtoul(v, NULL, 0);
+	if((v = getenv("PM_SIM_JITTER_US")) != NULL)
+		cfg->callJitterUs = (uint32_t)strtoul(v, NULL, 0);
+	if((v = getenv("PM_SIM_GAP_PROBABILITY")) != NULL)
+		cfg->gapProbability = atof(v);
+	if((v = getenv("PM_SIM_GAP_SAMPLES")) != NULL)
+		cfg->gapSamples = (uint32_t)strtoul(v, NULL, 0);
+	if((v = getenv("PM_SIM_TIMESTAMP_START")) != NULL)
+		cfg->timestampStart = (uint32_t)strtoul(v, NULL, 0);
+	if((v = getenv("PM_SIM_UNPACED")) != NULL)
+		cfg->realTime = (atoi(v) != 0) ? VI_FALSE : VI_TRUE;
+	if((v = getenv("PM_SIM_PULSE_RATE")) != NULL)
+		cfg->pulseRate = atof(v);
+	if((v = getenv("PM_SIM_PULSE_WIDTH_US")) != NULL)
+		cfg->pulseWidthUs = atof(v);
+	if((v = getenv("PM_SIM_PULSE_AMPLITUDE")) != NULL)
+		cfg->pulseAmplitude = atof(v);
+	if((v = getenv("PM_SIM_SWEEP_DECADES")) != NULL)
+		cfg->sweepDecades = atof(v);
+	if((v = getenv("PM_SIM_SWEEP_PERIOD_S")) != NULL)
+		cfg->sweepPeriodSec = atof(v);
+	if((v = getenv("PM_SIM_SEED")) != NULL)
+		cfg->seed = (uint32_t)strtoul(v, NULL, 0);
+}
+
+
+/*---------------------------------------------------------------------------
+  Spend the configured per call latency plus jitter
+---------------------------------------------------------------------------*/
+void PMSim_callDelay(PMSim *sim)
+{
+	uint64_t us = sim->cfg.callLatencyUs;
+	uint64_t endNs;
+
+	if(sim->cfg.callJitterUs > 0)
+		us += nextRandom(&sim->rng) % (sim->cfg.callJitterUs + 1);
+	if(us == 0)
+		return;
+
+	endNs = PMPlat_timeNs() + us * 1000;
+	if(us > SPIN_US)
+		PMPlat_sleepUs((uint32_t)(us - SPIN_US));
+	while(PMPlat_timeNs() < endNs)
+		;
+}
+
+
+/*---------------------------------------------------------------------------
+  Index of the next sample the device takes; in paced mode this follows
+  the host clock, otherwise it is what has been handed out so far
+---------------------------------------------------------------------------*/
+uint64_t PMSim_now(PMSim *sim)
+{
+	if(!sim->cfg.realTime)
+		return sim->produced;
+	return (PMPlat_timeNs() - sim->startNs) / 1000 * sim->cfg.sampleRate / 1000000;
+}
+
+
+ViReal32 PMSim_sample(PMSim *sim, uint64_t index)
+{
+	double noise = ((double)(nextRandom(&sim->rng) & 0xFFFF) / 32768.0 - 1.0) * sim->cfg.noise;
+	double pulse = 0.0, scale = 1.0;
+
+	// Pulse train: sin^2 pulses of pulseWidthUs every 1 / pulseRate
+	if(sim->cfg.pulseRate > 0.0 && sim->cfg.pulseWidthUs > 0.0)
+	{
+		double t = (double)index / (double)sim->cfg.sampleRate;
+		double p = fmod(t * sim->cfg.pulseRate, 1.0) / sim->cfg.pulseRate * 1.0e6;
+
+		if(p < sim->cfg.pulseWidthUs)
+		{
+			double s = sin(M_PI * p / sim->cfg.pulseWidthUs);
+			pulse = sim->cfg.pulseAmplitude * s * s;
+		}
+	}
+
+	// Sweep: cosine in decades, top at the start of every period
+	if(sim->cfg.sweepDecades > 0.0 && sim->cfg.sweepPeriodSec > 0.0)
+	{
+		double t = (double)index / (double)sim->cfg.sampleRate;
+
+		scale = pow(10.0, -sim->cfg.sweepDecades * (0.5 - 0.5 * cos(2.0 * M_PI * t / sim->cfg.sweepPeriodSec)));
+	}
+
+	return (ViReal32)((sim->cfg.signalMean + sim->cfg.signalAmplitude * sin(sim->phaseStep * (double)index) + pulse + noise) * scale);
+}
+
+
+ViUInt32 PMSim_timestamp(PMSim *sim, uint64_t index)
+{
+	return (ViUInt32)(sim->cfg.timestampStart + index * 1000000 / sim->cfg.sampleRate);
+}
+
+
+/*---------------------------------------------------------------------------
+  PMReadBlockFunc: hand out the next block if the simulated device has one
+---------------------------------------------------------------------------*/
+ViStatus PMSim_readBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMSim    *sim = (PMSim*)source;
+	uint32_t n = sim->cfg.blockSamples;
+	uint32_t i;
+
+	PMSim_callDelay(sim);
+
+	if(sim->cfg.realTime)
+	{
+		uint64_t taken     = PMSim_now(sim);
+		uint64_t buffered  = (uint64_t)sim->cfg.deviceBufferUs * sim->cfg.sampleRate / 1000000;
+		uint64_t available = (taken > sim->produced) ? taken - sim->produced : 0;
+
+		// device buffer overrun: the oldest samples are gone
+		if(available > buffered)
+		{
+			sim->lost     += available - buffered;
+			sim->produced += available - buffered;
+			available      = buffered;
+		}
+
+		if(available < n)
+		{
+			*count = 0;
+			return VI_SUCCESS;
+		}
+	}
+
+	for(i = 0; i < n; i++)
+	{
+		timestamps[i] = PMSim_timestamp(sim, sim->produced + i);
+		values[i]     = PMSim_sample(sim, sim->produced + i);
+	}
+
+	sim->produced += n;
+
+	// injected gap: the samples after this block never reach the host
+	if(sim->cfg.gapProbability > 0.0 && sim->cfg.gapSamples > 0 &&
+			(double)nextRandom(&sim->rng) < sim->cfg.gapProbability * 4294967296.0)
+	{
+		sim->gapped   += sim->cfg.gapSamples;
+		sim->produced += sim->cfg.gapSamples;
+	}
+
+	*count = (ViUInt16)n;
+	return VI_SUCCESS;
+}
+
+
+PMBlockSource PMSim_source(PMSim *sim)
+{
+	PMBlockSource src;
+
+	src.readBlock = PMSim_readBlock;
+	src.source    = sim;
+	return src;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
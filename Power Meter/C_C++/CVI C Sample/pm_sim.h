@@ -0,0 +1,106 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Simulated fast measure stream
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Behaves like a PM103 in fast measure stream mode: samples are taken at
+   100 kHz against the host clock, handed out 200 at a time and the
+   device side buffer holds 10 ms. Polling too slowly loses the oldest
+   samples, which shows up as a jump in the timestamps - exactly like
+   the real instrument.
+
+   For load tests every call can additionally take callLatencyUs plus a
+   random 0..callJitterUs (a USB round trip) and blocks can randomly
+   lose gapSamples on the device side. A train of sin^2 pulses can be
+   added on top of the signal to test pulse detection, and the whole
+   signal can sweep down over sweepDecades and back every sweepPeriodSec
+   to test ranging.
+
+****************************************************************************/
+#ifndef _PM_SIM_HEADER_
+#define _PM_SIM_HEADER_
+
+#include "pm_acquisition.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_SIM_SAMPLE_RATE        100000
+#define PM_SIM_BLOCK_SAMPLES      200
+#define PM_SIM_DEVICE_BUFFER_US   10000
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint32_t  sampleRate;         // Hz
+	uint32_t  blockSamples;       // samples returned per call when data is ready
+	uint32_t  deviceBufferUs;     // device side buffer; older samples are lost
+	uint32_t  timestampStart;     // first raw timestamp in us (set near 2^32 to test wrap around)
+	ViBoolean realTime;           // VI_TRUE: pace to the host clock, VI_FALSE: as fast as polled
+	uint32_t  callLatencyUs;      // fixed time every call takes
+	uint32_t  callJitterUs;       // additional uniform random call time 0..callJitterUs
+	double    gapProbability;     // chance per block that the device drops gapSamples first
+	uint32_t  gapSamples;
+
+	double    signalMean;         // W
+	double    signalAmplitude;    // W, sine modulation
+	double    signalFreq;         // Hz
+	double    noise;              // W, uniform noise amplitude
+	double    pulseRate;          // Hz, 0: no pulses
+	double    pulseWidthUs;       // sin^2 pulses, full width at half maximum is half of it
+	double    pulseAmplitude;     // W, peak above the signal
+	double    sweepDecades;       // signal scaled by 10^-sweepDecades at the bottom of the sweep, 0: off
+	double    sweepPeriodSec;
+	uint32_t  seed;
+} PMSimConfig;
+
+typedef struct
+{
+	PMSimConfig cfg;
+	uint64_t    startNs;
+	uint64_t    produced;         // samples handed out or lost so far
+	uint64_t    lost;             // samples dropped by the simulated device buffer
+	uint64_t    gapped;           // samples dropped by injected gaps
+	uint32_t    rng;
+	double      phaseStep;
+} PMSim;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void          PMSim_defaultConfig(PMSimConfig *cfg);
+void          PMSim_init(PMSim *sim, const PMSimConfig *cfg);
+void          PMSim_configFromEnv(PMSimConfig *cfg);
+ViStatus      PMSim_readBlock(void *sim, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[]);
+PMBlockSource PMSim_source(PMSim *sim);
+
+// Scalar access for simulated drivers
+void          PMSim_callDelay(PMSim *sim);
+uint64_t      PMSim_now(PMSim *sim);
+ViReal32      PMSim_sample(PMSim *sim, uint64_t index);
+ViUInt32      PMSim_timestamp(PMSim *sim, uint64_t index);
+
+#endif /* _PM_SIM_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,326 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Spectral analysis
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_spectrum.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMSpectrum_defaultConfig(PMSpectrumConfig *cfg)
+{
+	memset(cfg, 0, sizeof(PMSpectrumConfig));
+	cfg->length     = PM_SPECTRUM_DEFAULT_LENGTH;
+	cfg->hop        = PM_SPECTRUM_DEFAULT_LENGTH / 2;
+	cfg->averages   = PM_SPECTRUM_DEFAULT_AVERAGES;
+	cfg->sampleRate = 100000.0;
+	cfg->periodUs   = 10;
+}
+
+
+/*---------------------------------------------------------------------------
+  plan may be shared by several analyzers of the same length; NULL creates
+  a plan for this analyzer.
+---------------------------------------------------------------------------*/
+ViStatus PMSpectrum_init(PMSpectrum *spec, const PMSpectrumConfig *cfg, const PMFft *plan)
+{
+	uint32_t n = cfg->length;
+	double   power = 0.0;
+	ViStatus err;
+	uint32_t i;
+
+	memset(spec, 0, sizeof(PMSpectrum));
+	spec->cfg = *cfg;
+	if(spec->cfg.hop == 0 || spec->cfg.hop > n)
+		spec->cfg.hop = n / 2;
+	if(spec->cfg.averages == 0)
+		spec->cfg.averages = 1;
+	if(spec->cfg.periodUs == 0)
+		spec->cfg.periodUs = 10;
+
+	if(plan != NULL)
+	{
+		if(plan->length != n)
+			return VI_ERROR_INV_SETUP;
+		spec->plan = plan;
+	}
+	else
+	{
+		if((err = PMFft_init(&spec->ownPlan, n)) != VI_SUCCESS)
+			return err;
+		spec->plan = &spec->ownPlan;
+	}
+
+	spec->bins      = n / 2 + 1;
+	spec->binHz     = cfg->sampleRate / (double)n;
+	spec->window    = (double*)PMPlat_alignedAlloc(n * sizeof(double), PM_CACHE_LINE);
+	spec->segment   = (double*)PMPlat_alignedAlloc(n * sizeof(double), PM_CACHE_LINE);
+	spec->work      = (double*)PMPlat_alignedAlloc(n * sizeof(double), PM_CACHE_LINE);
+	spec->re        = (double*)PMPlat_alignedAlloc(spec->bins * sizeof(double), PM_CACHE_LINE);
+	spec->im        = (double*)PMPlat_alignedAlloc(spec->bins * sizeof(double), PM_CACHE_LINE);
+	spec->average   = (double*)PMPlat_alignedAlloc(spec->bins * sizeof(double), PM_CACHE_LINE);
+	spec->published = (double*)PMPlat_alignedAlloc(spec->bins * sizeof(double), PM_CACHE_LINE);
+	if(spec->window == NULL || spec->segment == NULL || spec->work == NULL || spec->re == NULL ||
+	   spec->im == NULL || spec->average == NULL || spec->published == NULL)
+	{
+		PMSpectrum_free(spec);
+		return VI_ERROR_ALLOC;
+	}
+	memset(spec->average, 0, spec->bins * sizeof(double));
+	memset(spec->published, 0, spec->bins * sizeof(double));
+
+	// Periodic Hann window; the PSD is normalized to its power
+	for(i = 0; i < n; i++)
+	{
+		double w = 0.5 - 0.5 * cos(2.0 * M_PI * (double)i / (double)n);
+
+		spec->window[i] = w;
+		power += w * w;
+	}
+	spec->scale = 1.0 / (cfg->sampleRate * power);
+	return VI_SUCCESS;
+}
+
+
+void PMSpectrum_free(PMSpectrum *spec)
+{
+	PMPlat_alignedFree(spec->window);
+	PMPlat_alignedFree(spec->segment);
+	PMPlat_alignedFree(spec->work);
+	PMPlat_alignedFree(spec->re);
+	PMPlat_alignedFree(spec->im);
+	PMPlat_alignedFree(spec->average);
+	PMPlat_alignedFree(spec->published);
+	if(spec->plan == &spec->ownPlan)
+		PMFft_free(&spec->ownPlan);
+	memset(spec, 0, sizeof(PMSpectrum));
+}
+
+
+/*---------------------------------------------------------------------------
+  Transforms the full segment, adds it to the average and publishes it
+---------------------------------------------------------------------------*/
+static void processSegment(PMSpectrum *spec)
+{
+	uint32_t n = spec->cfg.length;
+	uint32_t half = n / 2;
+	uint64_t startNs = PMPlat_timeNs();
+	double   mean = 0.0, weight;
+	uint32_t i;
+
+	for(i = 0; i < n; i++)
+		mean += spec->segment[i];
+	mean /= (double)n;
+	for(i = 0; i < n; i++)
+		spec->work[i] = (spec->segment[i] - mean) * spec->window[i];
+
+	PMFft_real(spec->plan, spec->work, spec->re, spec->im);
+
+	spec->segments++;
+	weight = (spec->segments < spec->cfg.averages) ? 1.0 / (double)spec->segments : 1.0 / (double)spec->cfg.averages;
+	for(i = 0; i <= half; i++)
+	{
+		double p = (spec->re[i] * spec->re[i] + spec->im[i] * spec->im[i]) * spec->scale;
+
+		if(i > 0 && i < half)
+			p *= 2.0;               // one-sided: negative frequencies folded in
+		spec->average[i] += (p - spec->average[i]) * weight;
+	}
+
+	while(!PMPlat_cas64(&spec->lock, 0, 1))
+		PMPlat_yield();
+	memcpy(spec->published, spec->average, spec->bins * sizeof(double));
+	spec->publishedSegments = spec->segments;
+	PMPlat_store64(&spec->lock, 0);
+
+	// Keep the overlap for the next segment
+	memmove(spec->segment, &spec->segment[spec->cfg.hop], (n - spec->cfg.hop) * sizeof(double));
+	spec->fill = n - spec->cfg.hop;
+	spec->busyNs += PMPlat_timeNs() - startNs;
+}
+
+
+/*---------------------------------------------------------------------------
+  Feed the next count samples of the stream
+---------------------------------------------------------------------------*/
+void PMSpectrum_process(PMSpectrum *spec, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count)
+{
+	uint32_t period = spec->cfg.periodUs;
+	uint32_t limit = period + period / 2;
+	uint32_t i = 0;
+
+	while(i < count)
+	{
+		uint32_t end, j;
+
+		// Gap before sample i: a segment must not mix both sides of it
+		if(spec->started && (ViUInt32)(timestamps[i] - spec->lastTimestamp) > limit)
+		{
+			spec->gaps++;
+			spec->dropped += spec->fill;
+			spec->fill     = 0;
+		}
+
+		// Run of samples without gap; a regular block (the usual case) takes one check
+		if((ViUInt32)(timestamps[count - 1] - timestamps[i]) <= (count - 1 - i) * period + period / 2)
+			end = count;
+		else
+			for(end = i + 1; end < count && (ViUInt32)(timestamps[end] - timestamps[end - 1]) <= limit; end++)
+				;
+
+		// Transform every full segment
+		while(i < end)
+		{
+			uint32_t take = spec->cfg.length - spec->fill;
+
+			if(take > end - i)
+				take = end - i;
+			for(j = 0; j < take; j++)
+				spec->segment[spec->fill + j] = values[i + j];
+			spec->fill += take;
+			i          += take;
+			if(spec->fill == spec->cfg.length)
+				processSegment(spec);
+		}
+		spec->lastTimestamp = timestamps[end - 1];
+		spec->started       = VI_TRUE;
+	}
+}
+
+
+void PMSpectrum_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMSpectrum_process((PMSpectrum*)ctx, block->timestamps, block->values, block->count);
+}
+
+
+/*---------------------------------------------------------------------------
+  Copies the current estimate (bins entries, W^2/Hz) and the number of
+  segments it contains. Returns the number of bins.
+---------------------------------------------------------------------------*/
+uint32_t PMSpectrum_get(PMSpectrum *spec, double psd[], uint64_t *segments)
+{
+	while(!PMPlat_cas64(&spec->lock, 0, 1))
+		PMPlat_yield();
+	memcpy(psd, spec->published, spec->bins * sizeof(double));
+	if(segments != NULL)
+		*segments = spec->publishedSegments;
+	PMPlat_store64(&spec->lock, 0);
+	return spec->bins;
+}
+
+
+static int compareDouble(const void *a, const void *b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+
+static int comparePeak(const void *a, const void *b)
+{
+	double x = ((const PMSpectrumPeak*)a)->amplitude, y = ((const PMSpectrumPeak*)b)->amplitude;
+
+	return (x > y) ? -1 : (x < y) ? 1 : 0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Strongest tones of a PSD and its noise floor (median density, returned
+  as W/sqrt(Hz)). A tone is a local maximum PM_SPECTRUM_PEAK_RATIO above
+  the floor; its power is summed over the window main lobe. The bins next
+  to DC are skipped, they hold the leakage of the removed mean. Returns
+  the number of peaks, strongest first.
+---------------------------------------------------------------------------*/
+uint32_t PMSpectrum_analyze(const double psd[], uint32_t bins, double binHz, PMSpectrumPeak peaks[], uint32_t maxPeaks,
+							double *noiseFloor)
+{
+	PMSpectrumPeak *found;
+	double         *sorted;
+	double         floor;
+	uint32_t       count = 0, first = PM_SPECTRUM_LOBE_BINS + 1, k;
+
+	if(noiseFloor != NULL)
+		*noiseFloor = 0.0;
+	if(bins <= 2 * first)
+		return 0;
+
+	sorted = (double*)malloc((bins - first) * sizeof(double));
+	found  = (PMSpectrumPeak*)malloc(bins * sizeof(PMSpectrumPeak));
+	if(sorted == NULL || found == NULL)
+	{
+		free(sorted);
+		free(found);
+		return 0;
+	}
+
+	memcpy(sorted, &psd[first], (bins - first) * sizeof(double));
+	qsort(sorted, bins - first, sizeof(double), compareDouble);
+	floor = sorted[(bins - first) / 2];
+	if(noiseFloor != NULL)
+		*noiseFloor = sqrt(floor);
+
+	for(k = first; k + 1 < bins; k++)
+	{
+		double   power = 0.0, moment = 0.0;
+		uint32_t j;
+
+		if(!(psd[k] > psd[k - 1] && psd[k] >= psd[k + 1] && psd[k] > floor * PM_SPECTRUM_PEAK_RATIO))
+			continue;
+
+		for(j = k - PM_SPECTRUM_LOBE_BINS; j <= k + PM_SPECTRUM_LOBE_BINS && j < bins; j++)
+		{
+			power  += psd[j];
+			moment += psd[j] * (double)j;
+		}
+		found[count].frequency = moment / power * binHz;
+		found[count].amplitude = sqrt(power * binHz);
+		found[count].density   = psd[k];
+		count++;
+	}
+
+	qsort(found, count, sizeof(PMSpectrumPeak), comparePeak);
+	if(count > maxPeaks)
+		count = maxPeaks;
+	memcpy(peaks, found, count * sizeof(PMSpectrumPeak));
+
+	free(sorted);
+	free(found);
+	return count;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
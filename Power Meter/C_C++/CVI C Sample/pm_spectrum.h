@@ -0,0 +1,123 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Spectral analysis
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Online power spectral density of the fast measure stream (Welch's
+   method), to find laser modulation and mains pickup while measuring.
+
+   The stream is cut into segments of 'length' samples that overlap by
+   length - hop samples. Every segment has its mean removed, is Hann
+   windowed and transformed (pm_fft); the one-sided PSD (W^2/Hz) of the
+   segments is averaged, cumulative for the first 'averages' segments and
+   exponentially afterwards, so the estimate follows slow changes.
+
+   Segments never span a gap in the device timestamps: the samples
+   collected so far are dropped and the next segment starts after the
+   gap. The analysis runs on the thread that feeds the stream (usually a
+   PMAcq consumer) and publishes a copy of the estimate after every
+   segment; other threads read it with PMSpectrum_get and evaluate it
+   with PMSpectrum_analyze (dominant frequencies, noise floor).
+
+   Cost at the default length of 16384 and 50 % overlap: one real FFT of
+   16384 points per 8192 samples, about 12 FFTs per second and stream at
+   100 kHz.
+
+****************************************************************************/
+#ifndef _PM_SPECTRUM_HEADER_
+#define _PM_SPECTRUM_HEADER_
+
+#include "pm_fft.h"
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_SPECTRUM_DEFAULT_LENGTH    16384     // 6.1 Hz resolution at 100 kHz
+#define PM_SPECTRUM_DEFAULT_AVERAGES  16
+#define PM_SPECTRUM_PEAK_RATIO        10.0      // peaks stand 10 dB above the noise floor
+#define PM_SPECTRUM_LOBE_BINS         2         // Hann main lobe half width
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint32_t  length;             // segment samples, power of two
+	uint32_t  hop;                // new samples per segment, length / 2: 50 % overlap
+	uint32_t  averages;           // segments in the running average
+	double    sampleRate;         // Hz
+	uint32_t  periodUs;           // timestamp step of consecutive samples
+} PMSpectrumConfig;
+
+typedef struct
+{
+	double    frequency;          // Hz, power weighted over the main lobe
+	double    amplitude;          // W rms of the tone
+	double    density;            // W^2/Hz at the peak bin
+} PMSpectrumPeak;
+
+typedef struct
+{
+	PMSpectrumConfig cfg;
+	const PMFft *plan;
+	PMFft       ownPlan;          // used unless a shared plan was given
+	uint32_t    bins;             // length / 2 + 1
+	double      binHz;
+	double      *window;
+	double      scale;            // |X|^2 to one-sided W^2/Hz
+
+	double      *segment;         // samples of the segment in progress
+	uint32_t    fill;
+	double      *work;            // windowed segment
+	double      *re, *im;
+	double      *average;
+
+	ViBoolean   started;
+	ViUInt32    lastTimestamp;
+	uint64_t    segments;
+	uint64_t    gaps;
+	uint64_t    dropped;          // samples discarded at gaps
+	uint64_t    busyNs;           // time spent in transforms
+
+	// Published estimate
+	volatile uint64_t lock;
+	double      *published;
+	uint64_t    publishedSegments;
+} PMSpectrum;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void     PMSpectrum_defaultConfig(PMSpectrumConfig *cfg);
+ViStatus PMSpectrum_init(PMSpectrum *spec, const PMSpectrumConfig *cfg, const PMFft *plan);
+void     PMSpectrum_free(PMSpectrum *spec);
+void     PMSpectrum_process(PMSpectrum *spec, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count);
+void     PMSpectrum_consumer(void *ctx, const PMFastBlock *block);
+
+uint32_t PMSpectrum_get(PMSpectrum *spec, double psd[], uint64_t *segments);
+uint32_t PMSpectrum_analyze(const double psd[], uint32_t bins, double binHz, PMSpectrumPeak peaks[], uint32_t maxPeaks,
+							double *noiseFloor);
+
+#endif /* _PM_SPECTRUM_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,400 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Block statistics
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_stats.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if PM_HAVE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef void (*BlockKernel)(PMStats *stats, const ViReal32 values[], uint32_t count);
+
+/*===========================================================================
+ Kernels
+ All kernels do two passes over the block: min/max/sum, then the squared
+ deviations from the block mean. Blocks are small enough to stay in L1.
+===========================================================================*/
+static void blockScalar(PMStats *stats, const ViReal32 values[], uint32_t count)
+{
+	ViReal32 min = values[0], max = values[0];
+	double   sum = 0.0, m2 = 0.0, mean;
+	uint32_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		ViReal32 v = values[i];
+
+		if(v < min) min = v;
+		if(v > max) max = v;
+		sum += v;
+	}
+
+	mean = sum / (double)count;
+	for(i = 0; i < count; i++)
+	{
+		double d = (double)values[i] - mean;
+		m2 += d * d;
+	}
+
+	stats->count = count;
+	stats->mean  = mean;
+	stats->m2    = m2;
+	stats->min   = min;
+	stats->max   = max;
+}
+
+
+#if PM_HAVE_X86_SIMD
+
+PM_TARGET_SSE2 static void blockSse2(PMStats *stats, const ViReal32 values[], uint32_t count)
+{
+	__m128   vmin = _mm_set1_ps(values[0]);
+	__m128   vmax = vmin;
+	__m128d  sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+	__m128d  vmean;
+	float    lanes[4];
+	double   dl[2];
+	double   sum, m2, mean;
+	ViReal32 min, max;
+	uint32_t i;
+
+	for(i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&values[i]);
+
+		vmin = _mm_min_ps(vmin, x);
+		vmax = _mm_max_ps(vmax, x);
+		sum0 = _mm_add_pd(sum0, _mm_cvtps_pd(x));
+		sum1 = _mm_add_pd(sum1, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+	}
+
+	_mm_storeu_ps(lanes, vmin);
+	min = lanes[0];
+	if(lanes[1] < min) min = lanes[1];
+	if(lanes[2] < min) min = lanes[2];
+	if(lanes[3] < min) min = lanes[3];
+	_mm_storeu_ps(lanes, vmax);
+	max = lanes[0];
+	if(lanes[1] > max) max = lanes[1];
+	if(lanes[2] > max) max = lanes[2];
+	if(lanes[3] > max) max = lanes[3];
+	_mm_storeu_pd(dl, _mm_add_pd(sum0, sum1));
+	sum = dl[0] + dl[1];
+
+	for(; i < count; i++)
+	{
+		if(values[i] < min) min = values[i];
+		if(values[i] > max) max = values[i];
+		sum += values[i];
+	}
+
+	mean  = sum / (double)count;
+	vmean = _mm_set1_pd(mean);
+	sum0  = _mm_setzero_pd();
+	sum1  = _mm_setzero_pd();
+	for(i = 0; i + 4 <= count; i += 4)
+	{
+		__m128  x  = _mm_loadu_ps(&values[i]);
+		__m128d d0 = _mm_sub_pd(_mm_cvtps_pd(x), vmean);
+		__m128d d1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), vmean);
+
+		sum0 = _mm_add_pd(sum0, _mm_mul_pd(d0, d0));
+		sum1 = _mm_add_pd(sum1, _mm_mul_pd(d1, d1));
+	}
+	_mm_storeu_pd(dl, _mm_add_pd(sum0, sum1));
+	m2 = dl[0] + dl[1];
+	for(; i < count; i++)
+	{
+		double d = (double)values[i] - mean;
+		m2 += d * d;
+	}
+
+	stats->count = count;
+	stats->mean  = mean;
+	stats->m2    = m2;
+	stats->min   = min;
+	stats->max   = max;
+}
+
+
+PM_TARGET_AVX2 static void blockAvx2(PMStats *stats, const ViReal32 values[], uint32_t count)
+{
+	__m256   vmin = _mm256_set1_ps(values[0]);
+	__m256   vmax = vmin;
+	__m256d  sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+	__m256d  vmean;
+	__m128   h;
+	__m128d  hd;
+	double   sum, m2, mean;
+	ViReal32 min, max;
+	uint32_t i;
+
+	for(i = 0; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&values[i]);
+
+		vmin = _mm256_min_ps(vmin, x);
+		vmax = _mm256_max_ps(vmax, x);
+		sum0 = _mm256_add_pd(sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+		sum1 = _mm256_add_pd(sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+	}
+
+	h   = _mm_min_ps(_mm256_castps256_ps128(vmin), _mm256_extractf128_ps(vmin, 1));
+	h   = _mm_min_ps(h, _mm_movehl_ps(h, h));
+	h   = _mm_min_ss(h, _mm_shuffle_ps(h, h, 1));
+	min = _mm_cvtss_f32(h);
+	h   = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+	h   = _mm_max_ps(h, _mm_movehl_ps(h, h));
+	h   = _mm_max_ss(h, _mm_shuffle_ps(h, h, 1));
+	max = _mm_cvtss_f32(h);
+
+	sum0 = _mm256_add_pd(sum0, sum1);
+	hd   = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+	sum  = _mm_cvtsd_f64(_mm_add_sd(hd, _mm_unpackhi_pd(hd, hd)));
+
+	for(; i < count; i++)
+	{
+		if(values[i] < min) min = values[i];
+		if(values[i] > max) max = values[i];
+		sum += values[i];
+	}
+
+	mean  = sum / (double)count;
+	vmean = _mm256_set1_pd(mean);
+	sum0  = _mm256_setzero_pd();
+	sum1  = _mm256_setzero_pd();
+	for(i = 0; i + 8 <= count; i += 8)
+	{
+		__m256  x  = _mm256_loadu_ps(&values[i]);
+		__m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(x)), vmean);
+		__m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)), vmean);
+
+		sum0 = _mm256_fmadd_pd(d0, d0, sum0);
+		sum1 = _mm256_fmadd_pd(d1, d1, sum1);
+	}
+	sum0 = _mm256_add_pd(sum0, sum1);
+	hd   = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+	m2   = _mm_cvtsd_f64(_mm_add_sd(hd, _mm_unpackhi_pd(hd, hd)));
+	for(; i < count; i++)
+	{
+		double d = (double)values[i] - mean;
+		m2 += d * d;
+	}
+
+	stats->count = count;
+	stats->mean  = mean;
+	stats->m2    = m2;
+	stats->min   = min;
+	stats->max   = max;
+}
+
+#endif
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+static BlockKernel blockKernel = NULL;
+static int         kernelId    = PM_STATS_KERNEL_AUTO;
+
+
+/*---------------------------------------------------------------------------
+  Choose the block kernel. PM_STATS_KERNEL_AUTO picks the fastest one the
+  CPU supports. Returns the kernel in use (unsupported requests fall back).
+---------------------------------------------------------------------------*/
+int PMStats_selectKernel(int kernel)
+{
+	uint32_t cpu = PMPlat_cpuFeatures();
+
+	if(kernel == PM_STATS_KERNEL_AUTO)
+		kernel = PM_STATS_KERNEL_AVX2;
+
+#if PM_HAVE_X86_SIMD
+	if(kernel == PM_STATS_KERNEL_AVX2 && (cpu & PM_CPU_AVX2))
+	{
+		blockKernel = blockAvx2;
+		return kernelId = PM_STATS_KERNEL_AVX2;
+	}
+	if(kernel >= PM_STATS_KERNEL_SSE2 && (cpu & PM_CPU_SSE2))
+	{
+		blockKernel = blockSse2;
+		return kernelId = PM_STATS_KERNEL_SSE2;
+	}
+#else
+	(void)cpu;
+#endif
+
+	blockKernel = blockScalar;
+	return kernelId = PM_STATS_KERNEL_SCALAR;
+}
+
+
+int PMStats_kernel(void)
+{
+	if(blockKernel == NULL)
+		PMStats_selectKernel(PM_STATS_KERNEL_AUTO);
+	return kernelId;
+}
+
+
+const char *PMStats_kernelName(int kernel)
+{
+	switch(kernel)
+	{
+		case PM_STATS_KERNEL_SCALAR: return "scalar";
+		case PM_STATS_KERNEL_SSE2:   return "SSE2";
+		case PM_STATS_KERNEL_AVX2:   return "AVX2";
+		default:                     return "auto";
+	}
+}
+
+
+void PMStats_reset(PMStats *stats)
+{
+	memset(stats, 0, sizeof(PMStats));
+}
+
+
+/*---------------------------------------------------------------------------
+  Statistics of one block (replaces the content of stats)
+---------------------------------------------------------------------------*/
+void PMStats_block(PMStats *stats, const ViReal32 values[], uint32_t count)
+{
+	if(count == 0)
+	{
+		PMStats_reset(stats);
+		return;
+	}
+	if(blockKernel == NULL)
+		PMStats_selectKernel(PM_STATS_KERNEL_AUTO);
+	blockKernel(stats, values, count);
+}
+
+
+/*---------------------------------------------------------------------------
+  acc += part (Chan et al. parallel variance update)
+---------------------------------------------------------------------------*/
+void PMStats_merge(PMStats *acc, const PMStats *part)
+{
+	uint64_t n;
+	double   delta;
+
+	if(part->count == 0)
+		return;
+	if(acc->count == 0)
+	{
+		*acc = *part;
+		return;
+	}
+
+	n     = acc->count + part->count;
+	delta = part->mean - acc->mean;
+
+	acc->mean += delta * (double)part->count / (double)n;
+	acc->m2   += part->m2 + delta * delta * ((double)acc->count * (double)part->count / (double)n);
+	acc->count = n;
+	if(part->min < acc->min) acc->min = part->min;
+	if(part->max > acc->max) acc->max = part->max;
+}
+
+
+void PMStats_add(PMStats *acc, const ViReal32 values[], uint32_t count)
+{
+	PMStats part;
+
+	PMStats_block(&part, values, count);
+	PMStats_merge(acc, &part);
+}
+
+
+// Population variance
+double PMStats_variance(const PMStats *stats)
+{
+	return (stats->count > 0) ? stats->m2 / (double)stats->count : 0.0;
+}
+
+
+double PMStats_stdDev(const PMStats *stats)
+{
+	return sqrt(PMStats_variance(stats));
+}
+
+
+double PMStats_rms(const PMStats *stats)
+{
+	return sqrt(PMStats_variance(stats) + stats->mean * stats->mean);
+}
+
+
+/*---------------------------------------------------------------------------
+  Rolling window over the last 'blocks' pushed partials
+---------------------------------------------------------------------------*/
+ViStatus PMStatsWindow_init(PMStatsWindow *win, uint32_t blocks)
+{
+	memset(win, 0, sizeof(PMStatsWindow));
+	if(blocks == 0)
+		return VI_ERROR_INV_SETUP;
+
+	win->parts = (PMStats*)calloc(blocks, sizeof(PMStats));
+	if(win->parts == NULL)
+		return VI_ERROR_ALLOC;
+	win->capacity = blocks;
+	return VI_SUCCESS;
+}
+
+
+void PMStatsWindow_push(PMStatsWindow *win, const PMStats *part)
+{
+	win->parts[win->next] = *part;
+	win->next = (win->next + 1) % win->capacity;
+	if(win->used < win->capacity)
+		win->used++;
+}
+
+
+void PMStatsWindow_get(const PMStatsWindow *win, PMStats *result)
+{
+	uint32_t i;
+
+	PMStats_reset(result);
+	for(i = 0; i < win->used; i++)
+		PMStats_merge(result, &win->parts[i]);
+}
+
+
+void PMStatsWindow_free(PMStatsWindow *win)
+{
+	free(win->parts);
+	memset(win, 0, sizeof(PMStatsWindow));
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
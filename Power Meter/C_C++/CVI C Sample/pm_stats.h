@@ -0,0 +1,91 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Block statistics
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Min/max/mean/RMS/standard deviation of ViReal32 sample blocks.
+
+   Each block is reduced by a vectorized two-pass kernel (AVX2, SSE2 or
+   scalar, chosen once at runtime) into a partial holding count, mean and
+   the sum of squared deviations (M2). Partials are combined with the
+   parallel Welford update of Chan et al., which stays accurate for
+   captures of any length, unlike sum / sum-of-squares accumulation.
+
+****************************************************************************/
+#ifndef _PM_STATS_HEADER_
+#define _PM_STATS_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_STATS_KERNEL_AUTO      0
+#define PM_STATS_KERNEL_SCALAR    1
+#define PM_STATS_KERNEL_SSE2      2
+#define PM_STATS_KERNEL_AVX2      3
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint64_t  count;
+	double    mean;
+	double    m2;           // sum of squared deviations from the mean
+	ViReal32  min;
+	ViReal32  max;
+} PMStats;
+
+// Rolling window over the last 'capacity' block partials
+typedef struct
+{
+	PMStats   *parts;
+	uint32_t  capacity;
+	uint32_t  next;
+	uint32_t  used;
+} PMStatsWindow;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+int      PMStats_selectKernel(int kernel);
+int      PMStats_kernel(void);
+const char *PMStats_kernelName(int kernel);
+
+void     PMStats_reset(PMStats *stats);
+void     PMStats_block(PMStats *stats, const ViReal32 values[], uint32_t count);
+void     PMStats_merge(PMStats *acc, const PMStats *part);
+void     PMStats_add(PMStats *acc, const ViReal32 values[], uint32_t count);
+
+double   PMStats_variance(const PMStats *stats);
+double   PMStats_stdDev(const PMStats *stats);
+double   PMStats_rms(const PMStats *stats);
+
+ViStatus PMStatsWindow_init(PMStatsWindow *win, uint32_t blocks);
+void     PMStatsWindow_push(PMStatsWindow *win, const PMStats *part);
+void     PMStatsWindow_get(const PMStatsWindow *win, PMStats *result);
+void     PMStatsWindow_free(PMStatsWindow *win);
+
+#endif /* _PM_STATS_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,383 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Acquisition supervisor
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_supervisor.h"
+
+#include <string.h>
+
+#include "TLPM.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define RECONNECT_POLL_US     1000      // reader sleep while the session is reopened
+#define BACKOFF_SLICE_US      10000     // abort latency of the backoff wait
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMSup_defaultConfig(PMSupConfig *cfg)
+{
+	memset(cfg, 0, sizeof(PMSupConfig));
+	cfg->retries      = PM_SUP_DEFAULT_RETRIES;
+	cfg->backoffMinUs = PM_SUP_DEFAULT_BACKOFF_MIN_US;
+	cfg->backoffMaxUs = PM_SUP_DEFAULT_BACKOFF_MAX_US;
+	cfg->stallUs      = PM_SUP_DEFAULT_STALL_US;
+	cfg->periodUs     = 10;
+}
+
+
+/*---------------------------------------------------------------------------
+  Error class of a driver status: PM_SUP_FATAL, PM_SUP_TRANSIENT or
+  PM_SUP_SESSION_LOST
+---------------------------------------------------------------------------*/
+int PMSup_classify(ViStatus status)
+{
+	switch(status)
+	{
+		case VI_ERROR_TMO:
+		case VI_ERROR_IO:
+			return PM_SUP_TRANSIENT;
+
+		case VI_ERROR_CONN_LOST:
+		case VI_ERROR_INV_OBJECT:
+		case VI_ERROR_RSRC_NFOUND:
+			return PM_SUP_SESSION_LOST;
+
+		default:
+			return PM_SUP_FATAL;
+	}
+}
+
+
+const char *PMSup_stateName(uint32_t state)
+{
+	switch(state)
+	{
+		case PM_SUP_STREAMING:    return "streaming";
+		case PM_SUP_RECONNECTING: return "reconnecting";
+		case PM_SUP_RESUMED:      return "resumed";
+		case PM_SUP_FAILED:       return "failed";
+		default:                  return "?";
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Open the session, apply the settings and start the fast measure stream
+---------------------------------------------------------------------------*/
+static ViStatus openSession(PMSupervisor *sup, ViSession *vi)
+{
+	ViStatus err;
+
+	*vi = VI_NULL;
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_init(sup->resource, VI_TRUE, VI_FALSE, vi));
+	if(err != VI_SUCCESS)
+		return err;
+
+	if(sup->cfg.setup != NULL)
+		err = sup->cfg.setup(sup->cfg.setupCtx, *vi);
+	if(err == VI_SUCCESS)
+		PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPM_confPowerFastArrayMeasurement(*vi));
+	sup->confNs = PMPlat_timeNs();
+
+	if(err != VI_SUCCESS)
+	{
+		TLPM_close(*vi);
+		*vi = VI_NULL;
+	}
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Background reopen with exponential backoff
+---------------------------------------------------------------------------*/
+static void reconnectThread(void *arg)
+{
+	PMSupervisor *sup = (PMSupervisor*)arg;
+	uint32_t     backoff = sup->cfg.backoffMinUs;
+
+	if(sup->session != VI_NULL)
+	{
+		TLPM_close(sup->session);
+		sup->session = VI_NULL;
+	}
+
+	while(!PMPlat_load32(&sup->abort))
+	{
+		ViSession vi;
+		ViStatus  err;
+		uint32_t  waited;
+
+		PMPlat_fetchAdd64(&sup->reconnects, 1);
+		PMPlat_fetchAdd32(&sup->attempts, 1);
+		if((err = openSession(sup, &vi)) == VI_SUCCESS)
+		{
+			sup->session = vi;
+			PMPlat_store32(&sup->state, PM_SUP_RESUMED);
+			return;
+		}
+		if(PMSup_classify(err) == PM_SUP_FATAL)
+		{
+			sup->fatalStatus = err;
+			PMPlat_store32(&sup->state, PM_SUP_FAILED);
+			return;
+		}
+
+		for(waited = 0; waited < backoff && !PMPlat_load32(&sup->abort); waited += BACKOFF_SLICE_US)
+			PMPlat_sleepUs(BACKOFF_SLICE_US);
+		backoff = (backoff > sup->cfg.backoffMaxUs / 2) ? sup->cfg.backoffMaxUs : backoff * 2;
+	}
+
+	sup->fatalStatus = VI_ERROR_ABORT;
+	PMPlat_store32(&sup->state, PM_SUP_FAILED);
+}
+
+
+/*---------------------------------------------------------------------------
+  Opens the session and starts the stream. An instrument that is not
+  there at the start is an error of the caller, not an outage.
+---------------------------------------------------------------------------*/
+ViStatus PMSup_open(PMSupervisor *sup, ViRsrc resource, const PMSupConfig *cfg)
+{
+	ViStatus err;
+
+	memset(sup, 0, sizeof(PMSupervisor));
+	sup->cfg = *cfg;
+	if(sup->cfg.periodUs == 0)
+		sup->cfg.periodUs = 10;
+	if(sup->cfg.backoffMinUs == 0)
+		sup->cfg.backoffMinUs = BACKOFF_SLICE_US;
+	if(sup->cfg.backoffMaxUs < sup->cfg.backoffMinUs)
+		sup->cfg.backoffMaxUs = sup->cfg.backoffMinUs;
+	if(resource == NULL || strlen(resource) >= PM_SUP_RESOURCE_SIZE)
+		return VI_ERROR_RSRC_NFOUND;
+	strcpy(sup->resource, resource);
+
+	if((err = openSession(sup, &sup->session)) != VI_SUCCESS)
+		return err;
+	sup->openNs     = PMPlat_timeNs();
+	sup->lastDataNs = sup->openNs;
+	sup->state      = PM_SUP_STREAMING;
+	return VI_SUCCESS;
+}
+
+
+static ViStatus beginOutage(PMSupervisor *sup, ViStatus cause)
+{
+	ViStatus err;
+
+	sup->outage.index++;
+	sup->outage.cause    = cause;
+	sup->outage.attempts = 0;
+	sup->outage.lastRaw  = sup->lastRaw;
+	sup->outage.firstRaw = sup->lastRaw;
+	sup->outage.downUs   = 0;
+	sup->failures        = 0;
+
+	PMPlat_store32(&sup->attempts, 0);
+	PMPlat_store32(&sup->lastCause, (uint32_t)cause);
+	PMPlat_store64(&sup->outages, sup->outages + 1);
+	PMPlat_store64(&sup->outageStartNs, sup->lastDataNs);
+	PMPlat_store32(&sup->state, PM_SUP_RECONNECTING);
+
+	if((err = PMPlat_threadCreate(&sup->thread, reconnectThread, sup)) != VI_SUCCESS)
+		return err;
+	sup->threadRunning = VI_TRUE;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  First block of the reopened stream: continue the timeline after the
+  host time that passed since the last sample and report the outage
+---------------------------------------------------------------------------*/
+static void finishOutage(PMSupervisor *sup, ViUInt16 count, ViUInt32 timestamps[])
+{
+	PMSupOutage *outage = &sup->outage;
+	uint32_t    period = sup->cfg.periodUs;
+	ViUInt16    i;
+
+	if(sup->started)
+	{
+		uint64_t gapUs = (sup->confNs > sup->outageStartNs) ? (sup->confNs - sup->outageStartNs) / 1000 : 0;
+		ViUInt32 delta;
+
+		if(gapUs < period)
+			gapUs = period;
+		delta = sup->lastRaw + (ViUInt32)gapUs - timestamps[0];
+		sup->rebase += delta;
+		for(i = 0; i < count; i++)
+			timestamps[i] += delta;
+		outage->downUs = gapUs - period;
+	}
+	outage->firstRaw = timestamps[0];
+	outage->attempts = PMPlat_load32(&sup->attempts);
+
+	PMPlat_store64(&sup->downUs, sup->downUs + outage->downUs);
+	if(outage->downUs > sup->maxDownUs)
+		PMPlat_store64(&sup->maxDownUs, outage->downUs);
+	PMPlat_store64(&sup->outageStartNs, 0);
+	sup->awaitingFirst = VI_FALSE;
+
+	if(sup->cfg.onOutage != NULL)
+		sup->cfg.onOutage(sup->cfg.outageCtx, outage);
+}
+
+
+/*---------------------------------------------------------------------------
+  PMReadBlockFunc of the supervised stream. Only fatal errors are
+  returned; during an outage the source delivers no samples.
+---------------------------------------------------------------------------*/
+ViStatus PMSup_readBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[])
+{
+	PMSupervisor *sup = (PMSupervisor*)source;
+	uint32_t     state = PMPlat_load32(&sup->state);
+	uint64_t     now;
+	ViStatus     err;
+	ViUInt16     i;
+
+	*count = 0;
+	if(state == PM_SUP_RECONNECTING)
+	{
+		PMPlat_sleepUs(RECONNECT_POLL_US);
+		return VI_SUCCESS;
+	}
+	if(state != PM_SUP_STREAMING)
+	{
+		PMPlat_threadJoin(sup->thread);
+		sup->threadRunning = VI_FALSE;
+		if(state == PM_SUP_FAILED)
+			return sup->fatalStatus;
+		sup->awaitingFirst = VI_TRUE;
+		sup->lastDataNs    = PMPlat_timeNs();
+		PMPlat_store32(&sup->state, PM_SUP_STREAMING);
+	}
+
+	PM_TRACE_CALL(PM_TRACE_FAST_ARRAY, err, TLPM_getNextFastArrayMeasurement(sup->session, count, timestamps, values));
+	PM_TRACE_VALUE(PM_TRACE_FAST_ARRAY_COUNT, *count);
+	now = PMPlat_timeNs();
+
+	if(err != VI_SUCCESS)
+	{
+		*count = 0;
+		switch(PMSup_classify(err))
+		{
+			case PM_SUP_FATAL:
+				return err;
+			case PM_SUP_TRANSIENT:
+				if(++sup->failures <= sup->cfg.retries)
+					return VI_SUCCESS;
+				break;
+		}
+		return beginOutage(sup, err);
+	}
+	if(sup->failures > 0)
+	{
+		PMPlat_store64(&sup->retried, sup->retried + 1);
+		sup->failures = 0;
+	}
+
+	if(*count == 0)
+	{
+		if(sup->cfg.stallUs > 0 && now - sup->lastDataNs > (uint64_t)sup->cfg.stallUs * 1000)
+			return beginOutage(sup, VI_ERROR_TMO);
+		return VI_SUCCESS;
+	}
+
+	if(sup->rebase != 0)
+		for(i = 0; i < *count; i++)
+			timestamps[i] += sup->rebase;
+	if(sup->awaitingFirst)
+		finishOutage(sup, *count, timestamps);
+
+	sup->lastRaw    = timestamps[*count - 1];
+	sup->lastDataNs = now;
+	sup->started    = VI_TRUE;
+	PMPlat_store64(&sup->samples, sup->samples + *count);
+	return VI_SUCCESS;
+}
+
+
+PMBlockSource PMSup_source(PMSupervisor *sup)
+{
+	PMBlockSource src;
+
+	src.readBlock = PMSup_readBlock;
+	src.source    = sup;
+	return src;
+}
+
+
+void PMSup_getStats(PMSupervisor *sup, PMSupStats *stats)
+{
+	uint64_t now = PMPlat_timeNs();
+	uint64_t outageStart = PMPlat_load64(&sup->outageStartNs);
+	double   elapsedUs = (double)(now - sup->openNs) / 1000.0;
+
+	memset(stats, 0, sizeof(PMSupStats));
+	stats->state      = PMPlat_load32(&sup->state);
+	stats->samples    = PMPlat_load64(&sup->samples);
+	stats->retried    = PMPlat_load64(&sup->retried);
+	stats->outages    = PMPlat_load64(&sup->outages);
+	stats->reconnects = PMPlat_load64(&sup->reconnects);
+	stats->downUs     = PMPlat_load64(&sup->downUs);
+	stats->maxDownUs  = PMPlat_load64(&sup->maxDownUs);
+	stats->lastCause  = (ViStatus)PMPlat_load32(&sup->lastCause);
+	if(outageStart != 0 && now > outageStart)
+		stats->downUs += (now - outageStart) / 1000;
+
+	stats->elapsedSec = elapsedUs / 1e6;
+	if(elapsedUs > 0.0)
+	{
+		stats->availability  = 1.0 - (double)stats->downUs / elapsedUs;
+		stats->samplesPerSec = (double)stats->samples / stats->elapsedSec;
+	}
+}
+
+
+/*---------------------------------------------------------------------------
+  Stops a running reopen and closes the session. The acquisition must be
+  stopped first.
+---------------------------------------------------------------------------*/
+void PMSup_close(PMSupervisor *sup)
+{
+	PMPlat_store32(&sup->abort, 1);
+	if(sup->threadRunning)
+	{
+		PMPlat_threadJoin(sup->thread);
+		sup->threadRunning = VI_FALSE;
+	}
+	if(sup->session != VI_NULL)
+	{
+		TLPM_close(sup->session);
+		sup->session = VI_NULL;
+	}
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
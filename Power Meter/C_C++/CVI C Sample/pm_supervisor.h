@@ -0,0 +1,171 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Acquisition supervisor
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Fast measure stream source that survives driver errors, for captures
+   running for hours or days.
+
+   PMSupervisor owns the TLPM session. Every driver error is classified:
+
+   - fatal (wrong setup, unsupported, out of memory): handed to PMAcq,
+     which stops as before;
+   - transient (timeout, I/O): the read is repeated on the same session,
+     up to 'retries' times in a row;
+   - session lost (connection lost, invalid session, instrument gone),
+     or transient errors beyond the retries, or no samples for stallUs:
+     an outage. A background thread closes the session and opens it
+     again with exponential backoff, runs the setup callback and
+     re-issues confPowerFastArrayMeasurement. The reader keeps polling
+     (no samples) meanwhile, so consumers, captures and PMAcq_stop are
+     not held up.
+
+   A reopened instrument has its own timestamp clock. The timestamps
+   after an outage are rebased onto the host time that passed, so the
+   stream timeline stays monotonic with one gap of about the outage
+   length (host clock accuracy, about a millisecond). Before the first
+   block after the gap is handed out, the outage callback gets the raw
+   timestamps around it - for PMTimeline_mark (PM_GAP_RECONNECT) and
+   PMCapture_markGap, so the gap is recorded in the running capture.
+
+****************************************************************************/
+#ifndef _PM_SUPERVISOR_HEADER_
+#define _PM_SUPERVISOR_HEADER_
+
+#include "pm_acquisition.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_SUP_DEFAULT_RETRIES        3
+#define PM_SUP_DEFAULT_BACKOFF_MIN_US 100000
+#define PM_SUP_DEFAULT_BACKOFF_MAX_US 5000000
+#define PM_SUP_DEFAULT_STALL_US       2000000
+#define PM_SUP_RESOURCE_SIZE          256       // TLPM_BUFFER_SIZE
+
+// Error classes
+#define PM_SUP_FATAL                  0
+#define PM_SUP_TRANSIENT              1         // repeat on the same session
+#define PM_SUP_SESSION_LOST           2         // reopen the session
+
+// States
+#define PM_SUP_STREAMING              0
+#define PM_SUP_RECONNECTING           1
+#define PM_SUP_RESUMED                2         // reopened, reader takes over the new session
+#define PM_SUP_FAILED                 3
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Device settings on a newly opened session, before the stream is configured
+typedef ViStatus (*PMSupSetupFunc)(void *ctx, ViSession vi);
+
+typedef struct
+{
+	uint64_t  index;                            // outage number
+	ViStatus  cause;                            // error that started it
+	uint32_t  attempts;                         // open attempts until the session was back
+	ViUInt32  lastRaw;                          // last timestamp before the outage (as handed out)
+	ViUInt32  firstRaw;                         // first timestamp after it
+	uint64_t  downUs;                           // time without samples
+} PMSupOutage;
+
+// Called on the reader thread for every outage, before its first block is handed out
+typedef void (*PMSupOutageFunc)(void *ctx, const PMSupOutage *outage);
+
+typedef struct
+{
+	uint32_t         retries;
+	uint32_t         backoffMinUs;
+	uint32_t         backoffMaxUs;
+	uint32_t         stallUs;                   // no samples for this long is an outage, 0: off
+	uint32_t         periodUs;                  // timestamp step of consecutive samples
+	PMSupSetupFunc   setup;
+	void             *setupCtx;
+	PMSupOutageFunc  onOutage;
+	void             *outageCtx;
+} PMSupConfig;
+
+typedef struct
+{
+	PMSupConfig       cfg;
+	ViChar            resource[PM_SUP_RESOURCE_SIZE];
+	volatile uint32_t state;                    // PM_SUP_*
+	ViSession         session;                  // owned by the reader, by the thread while reconnecting
+	PMThread          thread;
+	ViBoolean         threadRunning;
+	volatile uint32_t abort;
+	ViStatus          fatalStatus;
+	volatile uint32_t attempts;
+
+	// Reader thread
+	ViBoolean         started;
+	ViBoolean         awaitingFirst;
+	ViUInt32          lastRaw;
+	ViUInt32          rebase;
+	uint32_t          failures;                 // transient errors in a row
+	uint64_t          lastDataNs;               // host time of the last block
+	uint64_t          confNs;                   // host time the reopened stream was started
+	PMSupOutage       outage;
+
+	uint64_t          openNs;
+	volatile uint64_t samples;
+	volatile uint64_t retried;                  // transient errors cured by a retry
+	volatile uint64_t outages;
+	volatile uint64_t reconnects;               // open attempts, successful or not
+	volatile uint64_t downUs;
+	volatile uint64_t maxDownUs;
+	volatile uint64_t outageStartNs;            // 0: streaming
+	volatile uint32_t lastCause;
+} PMSupervisor;
+
+typedef struct
+{
+	uint32_t  state;
+	uint64_t  samples;
+	uint64_t  retried;
+	uint64_t  outages;
+	uint64_t  reconnects;
+	uint64_t  downUs;                           // including a running outage
+	uint64_t  maxDownUs;
+	ViStatus  lastCause;
+	double    elapsedSec;                       // since PMSup_open
+	double    availability;                     // fraction of the time the stream delivered
+	double    samplesPerSec;                    // sustained over the whole run
+} PMSupStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void          PMSup_defaultConfig(PMSupConfig *cfg);
+int           PMSup_classify(ViStatus status);
+const char   *PMSup_stateName(uint32_t state);
+
+ViStatus      PMSup_open(PMSupervisor *sup, ViRsrc resource, const PMSupConfig *cfg);
+ViStatus      PMSup_readBlock(void *source, ViUInt16 *count, ViUInt32 timestamps[], ViReal32 values[]);
+PMBlockSource PMSup_source(PMSupervisor *sup);
+void          PMSup_getStats(PMSupervisor *sup, PMSupStats *stats);
+void          PMSup_close(PMSupervisor *sup);
+
+#endif /* _PM_SUPERVISOR_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,215 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Timeline reconstruction
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_timeline.h"
+
+#include <string.h>
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+// Steps of half the counter range or more are treated as a jump backwards
+#define BACKWARD_STEP         0x80000000u
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMTimeline_init(PMTimeline *tl, uint32_t periodUs, PMGapFunc onGap, void *ctx)
+{
+	memset(tl, 0, sizeof(PMTimeline));
+	tl->periodUs    = periodUs ? periodUs : PM_TIMELINE_DEFAULT_PERIOD_US;
+	tl->toleranceUs = tl->periodUs / 2;
+	tl->onGap       = onGap;
+	tl->gapCtx      = ctx;
+}
+
+
+/*---------------------------------------------------------------------------
+  Forget the stream position and counters, keep configuration
+---------------------------------------------------------------------------*/
+void PMTimeline_reset(PMTimeline *tl)
+{
+	PMTimeline_init(tl, tl->periodUs, tl->onGap, tl->gapCtx);
+}
+
+
+/*---------------------------------------------------------------------------
+  Announce an interruption between two raw timestamps. Returns VI_FALSE
+  if too many marks are pending; that gap then counts as loss.
+---------------------------------------------------------------------------*/
+ViBoolean PMTimeline_mark(PMTimeline *tl, ViUInt32 lastRaw, ViUInt32 firstRaw, uint32_t cause)
+{
+	uint32_t head = tl->markHead;
+	PMTimelineMark *m;
+
+	if(head - PMPlat_load32(&tl->markTail) >= PM_TIMELINE_MAX_MARKS)
+	{
+		PMPlat_fetchAdd32(&tl->markOverflows, 1);
+		return VI_FALSE;
+	}
+	m = &tl->marks[head & (PM_TIMELINE_MAX_MARKS - 1)];
+	m->lastRaw  = lastRaw;
+	m->firstRaw = firstRaw;
+	m->cause    = cause;
+	PMPlat_store32(&tl->markHead, head + 1);
+	return VI_TRUE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Cause of the gap ending at raw timestamp r. Marks of interruptions
+  already passed (their samples never arrived here) are discarded.
+---------------------------------------------------------------------------*/
+static uint32_t gapCause(PMTimeline *tl, ViUInt32 lastRaw, ViUInt32 r)
+{
+	uint32_t tail = tl->markTail;
+
+	while(tail != PMPlat_load32(&tl->markHead))
+	{
+		PMTimelineMark *m = &tl->marks[tail & (PM_TIMELINE_MAX_MARKS - 1)];
+
+		if(m->firstRaw == r)
+		{
+			PMPlat_store32(&tl->markTail, tail + 1);
+			return m->cause;
+		}
+		if((ViUInt32)(lastRaw - m->firstRaw) >= BACKWARD_STEP)
+			break;                    // still ahead
+		tail++;
+		PMPlat_store32(&tl->markTail, tail);
+	}
+	return PM_GAP_DROPPED;
+}
+
+
+/*---------------------------------------------------------------------------
+  Unwrap count raw timestamps. time[] receives the 64 bit timeline in us
+  and may be NULL if only gap detection and counters are wanted.
+---------------------------------------------------------------------------*/
+void PMTimeline_process(PMTimeline *tl, const ViUInt32 raw[], uint32_t count, uint64_t time[])
+{
+	uint32_t maxStep = tl->periodUs + tl->toleranceUs;
+	ViUInt32 lastRaw = tl->lastRaw;
+	uint64_t last = tl->lastTime;
+	uint32_t i = 0;
+
+	if(count == 0)
+		return;
+
+	if(!tl->started)
+	{
+		// the timeline starts at the first raw timestamp
+		tl->started   = VI_TRUE;
+		tl->firstTime = raw[0];
+		lastRaw = raw[0];
+		last    = raw[0];
+		if(time != NULL)
+			time[0] = last;
+		i = 1;
+	}
+
+	for(; i < count; i++)
+	{
+		ViUInt32 r = raw[i];
+		ViUInt32 d = r - lastRaw;     // modulo 2^32, handles the wrap around
+
+		if(r < lastRaw && d < BACKWARD_STEP)
+			tl->wraps++;
+
+		if(d - 1 < maxStep)
+		{
+			last += d;                // regular step
+		}
+		else if(d == 0)
+		{
+			tl->duplicates++;
+		}
+		else if(d < BACKWARD_STEP)
+		{
+			PMGap gap;
+
+			gap.startUs        = last;
+			gap.lengthUs       = d - tl->periodUs;
+			gap.missingSamples = (d + tl->periodUs / 2) / tl->periodUs - 1;
+			gap.sampleIndex    = tl->samples + i;
+			gap.cause          = gapCause(tl, lastRaw, r);
+
+			if(gap.cause != PM_GAP_DROPPED)
+			{
+				tl->interruptions++;
+				tl->interruptedUs      += gap.lengthUs;
+				tl->interruptedSamples += gap.missingSamples;
+			}
+			else
+			{
+				tl->gaps++;
+				tl->missing += gap.missingSamples;
+				if(gap.lengthUs > tl->maxGapUs)
+					tl->maxGapUs = gap.lengthUs;
+			}
+			if(tl->onGap != NULL)
+				tl->onGap(tl->gapCtx, &gap);
+
+			last += d;
+		}
+		else
+		{
+			// counter restarted; keep the timeline monotonic
+			tl->backSteps++;
+			last += tl->periodUs;
+		}
+
+		lastRaw = r;
+		if(time != NULL)
+			time[i] = last;
+	}
+
+	tl->lastRaw  = lastRaw;
+	tl->lastTime = last;
+	tl->samples += count;
+}
+
+
+void PMTimeline_getStats(const PMTimeline *tl, PMTimelineStats *stats)
+{
+	uint64_t expected = tl->samples + tl->missing;
+
+	memset(stats, 0, sizeof(PMTimelineStats));
+	stats->samples    = tl->samples;
+	stats->missing    = tl->missing;
+	stats->gaps       = tl->gaps;
+	stats->wraps      = tl->wraps;
+	stats->duplicates = tl->duplicates;
+	stats->backSteps  = tl->backSteps;
+	stats->maxGapUs   = tl->maxGapUs;
+	stats->interruptions      = tl->interruptions;
+	stats->interruptedUs      = tl->interruptedUs;
+	stats->interruptedSamples = tl->interruptedSamples;
+	stats->dropRate   = (expected > 0) ? (double)tl->missing / (double)expected : 0.0;
+	stats->spanUs     = tl->started ? tl->lastTime - tl->firstTime : 0;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,133 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Timeline reconstruction
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   The fast measure stream stamps every sample with a 32 bit microsecond
+   counter that wraps around every ~71.6 minutes. PMTimeline extends it
+   to a monotonic 64 bit timeline across blocks, detects samples the
+   device dropped (timestamp step larger than the sample period) and
+   keeps running drop counters. Cost is constant per sample, so it can
+   run inline on any consumer of the 100 kHz stream.
+
+   Interruptions the host caused on purpose (a range change) are not
+   drops: whoever caused one marks it with PMTimeline_mark, from any one
+   thread, before the first sample after it reaches PMTimeline_process.
+   The gap ending at that sample then carries the cause of the mark and
+   is counted as interruption instead of loss.
+
+****************************************************************************/
+#ifndef _PM_TIMELINE_HEADER_
+#define _PM_TIMELINE_HEADER_
+
+#include "pm_ring.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_TIMELINE_DEFAULT_PERIOD_US   10     // 100 kHz
+#define PM_TIMELINE_MAX_MARKS           16     // power of two
+
+// PMGap causes
+#define PM_GAP_DROPPED                  0      // samples lost by the device or the host
+#define PM_GAP_RANGE_SWITCH             1      // measurement stopped for a range change
+#define PM_GAP_RECONNECT                2      // session lost and reopened (pm_supervisor)
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	uint64_t  startUs;          // timeline time of the last sample before the gap
+	uint64_t  lengthUs;         // time without samples beyond the regular period
+	uint64_t  missingSamples;   // estimated number of dropped samples
+	uint64_t  sampleIndex;      // index of the first sample after the gap
+	uint32_t  cause;            // PM_GAP_*
+} PMGap;
+
+typedef void (*PMGapFunc)(void *ctx, const PMGap *gap);
+
+typedef struct
+{
+	ViUInt32  lastRaw;          // last sample before the interruption
+	ViUInt32  firstRaw;         // first sample after it
+	uint32_t  cause;
+} PMTimelineMark;
+
+typedef struct
+{
+	uint32_t  periodUs;
+	uint32_t  toleranceUs;      // steps up to periodUs + toleranceUs are not a gap
+	PMGapFunc onGap;
+	void      *gapCtx;
+
+	ViBoolean started;
+	ViUInt32  lastRaw;
+	uint64_t  firstTime;
+	uint64_t  lastTime;
+
+	uint64_t  samples;          // samples seen
+	uint64_t  missing;          // samples estimated lost in gaps
+	uint64_t  gaps;
+	uint64_t  wraps;            // 32 bit timestamp wrap arounds
+	uint64_t  duplicates;       // timestamp did not advance
+	uint64_t  backSteps;        // timestamp jumped backwards (device restart)
+	uint64_t  maxGapUs;
+	uint64_t  interruptions;    // marked gaps, not part of gaps/missing
+	uint64_t  interruptedUs;
+	uint64_t  interruptedSamples;
+
+	// Marks: written by PMTimeline_mark, consumed by PMTimeline_process
+	PMTimelineMark    marks[PM_TIMELINE_MAX_MARKS];
+	volatile uint32_t markHead;
+	volatile uint32_t markTail;
+	volatile uint32_t markOverflows;
+} PMTimeline;
+
+typedef struct
+{
+	uint64_t  samples;
+	uint64_t  missing;
+	uint64_t  gaps;
+	uint64_t  wraps;
+	uint64_t  duplicates;
+	uint64_t  backSteps;
+	uint64_t  maxGapUs;
+	uint64_t  interruptions;
+	uint64_t  interruptedUs;
+	uint64_t  interruptedSamples;
+	uint64_t  spanUs;           // first to last sample on the timeline
+	double    dropRate;         // missing / (samples + missing)
+} PMTimelineStats;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void PMTimeline_init(PMTimeline *tl, uint32_t periodUs, PMGapFunc onGap, void *ctx);
+void PMTimeline_reset(PMTimeline *tl);
+void PMTimeline_process(PMTimeline *tl, const ViUInt32 raw[], uint32_t count, uint64_t time[]);
+void PMTimeline_getStats(const PMTimeline *tl, PMTimelineStats *stats);
+ViBoolean PMTimeline_mark(PMTimeline *tl, ViUInt32 lastRaw, ViUInt32 firstRaw, uint32_t cause);
+
+#endif /* _PM_TIMELINE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,261 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Driver call tracing
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_trace.h"
+
+#include <string.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+/*===========================================================================
+ Global variables
+===========================================================================*/
+volatile uint32_t pmTraceEnabled = 0;
+
+static PMHist traceHist[PM_TRACE_POINTS];
+
+static const char *const traceNames[PM_TRACE_POINTS] =
+{
+	"getNextFastArrayMeas",
+	"measPower",
+	"getMeasurementSequence",
+	"getBurstArraySamples",
+	"other measurements",
+	"configuration",
+	"poll loop iteration",
+	"block processing",
+	"samples/fast array call",
+	"samples/burst call",
+};
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+PM_INLINE uint32_t highestBit(uint64_t v)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long idx;
+
+	_BitScanReverse64(&idx, v);
+	return (uint32_t)idx;
+#elif defined(_MSC_VER)
+	unsigned long idx;
+
+	if(_BitScanReverse(&idx, (unsigned long)(v >> 32)))
+		return (uint32_t)idx + 32;
+	_BitScanReverse(&idx, (unsigned long)v);
+	return (uint32_t)idx;
+#else
+	return 63 - (uint32_t)__builtin_clzll(v);
+#endif
+}
+
+
+/*---------------------------------------------------------------------------
+  Values below PM_HIST_SUB_BUCKETS are exact, every power of two above is
+  split into PM_HIST_SUB_BUCKETS equal buckets
+---------------------------------------------------------------------------*/
+PM_INLINE uint32_t bucketIndex(uint64_t v)
+{
+	uint32_t msb;
+
+	if(v < PM_HIST_SUB_BUCKETS)
+		return (uint32_t)v;
+	msb = highestBit(v);
+	return (msb - PM_HIST_SUB_BITS + 1) * PM_HIST_SUB_BUCKETS +
+		   (uint32_t)((v >> (msb - PM_HIST_SUB_BITS)) & (PM_HIST_SUB_BUCKETS - 1));
+}
+
+
+// Largest value that falls into bucket 'index'
+static uint64_t bucketHigh(uint32_t index)
+{
+	uint32_t shift;
+
+	if(index < PM_HIST_SUB_BUCKETS)
+		return index;
+	shift = index / PM_HIST_SUB_BUCKETS - 1;
+	return (((uint64_t)(PM_HIST_SUB_BUCKETS + index % PM_HIST_SUB_BUCKETS) << shift) - 1) + ((uint64_t)1 << shift);
+}
+
+
+void PMHist_record(PMHist *hist, uint64_t value)
+{
+	PMPlat_fetchAdd64(&hist->buckets[bucketIndex(value)], 1);
+	PMPlat_fetchAdd64(&hist->sum, value);
+	PMPlat_fetchAdd64(&hist->count, 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  Copy a histogram that may be recorded to concurrently. count is taken
+  from the copied buckets, so the snapshot is self consistent.
+---------------------------------------------------------------------------*/
+void PMHist_snapshot(PMHist *hist, PMHist *copy)
+{
+	uint64_t count = 0;
+	uint32_t i;
+
+	for(i = 0; i < PM_HIST_BUCKETS; i++)
+	{
+		copy->buckets[i] = PMPlat_load64(&hist->buckets[i]);
+		count += copy->buckets[i];
+	}
+	copy->sum   = PMPlat_load64(&hist->sum);
+	copy->count = count;
+}
+
+
+/*---------------------------------------------------------------------------
+  Upper bound of the bucket holding the given percentile (0..100)
+---------------------------------------------------------------------------*/
+uint64_t PMHist_percentile(const PMHist *snapshot, double percent)
+{
+	uint64_t target, seen = 0;
+	uint32_t i;
+
+	if(snapshot->count == 0)
+		return 0;
+
+	target = (uint64_t)((double)snapshot->count * percent / 100.0 + 0.5);
+	if(target < 1)
+		target = 1;
+	if(target > snapshot->count)
+		target = snapshot->count;
+
+	for(i = 0; i < PM_HIST_BUCKETS; i++)
+	{
+		seen += snapshot->buckets[i];
+		if(seen >= target)
+			return bucketHigh(i);
+	}
+	return bucketHigh(PM_HIST_BUCKETS - 1);
+}
+
+
+uint64_t PMHist_max(const PMHist *snapshot)
+{
+	uint32_t i = PM_HIST_BUCKETS;
+
+	while(i-- > 0)
+		if(snapshot->buckets[i] != 0)
+			return bucketHigh(i);
+	return 0;
+}
+
+
+void PMHist_reset(PMHist *hist)
+{
+	uint32_t i;
+
+	for(i = 0; i < PM_HIST_BUCKETS; i++)
+		PMPlat_store64(&hist->buckets[i], 0);
+	PMPlat_store64(&hist->sum, 0);
+	PMPlat_store64(&hist->count, 0);
+}
+
+
+void PMTrace_enable(ViBoolean enable)
+{
+	PMPlat_store32(&pmTraceEnabled, enable ? 1 : 0);
+}
+
+
+void PMTrace_record(uint32_t point, uint64_t value)
+{
+	if(point < PM_TRACE_POINTS)
+		PMHist_record(&traceHist[point], value);
+}
+
+
+/*---------------------------------------------------------------------------
+  Record the time since the previous call with the same lastNs
+---------------------------------------------------------------------------*/
+void PMTrace_interval(uint32_t point, uint64_t *lastNs)
+{
+	uint64_t now = PMPlat_timeNs();
+
+	if(*lastNs != 0)
+		PMTrace_record(point, now - *lastNs);
+	*lastNs = now;
+}
+
+
+void PMTrace_snapshot(uint32_t point, PMHist *copy)
+{
+	if(point < PM_TRACE_POINTS)
+		PMHist_snapshot(&traceHist[point], copy);
+	else
+		memset(copy, 0, sizeof(PMHist));
+}
+
+
+const char *PMTrace_pointName(uint32_t point)
+{
+	return (point < PM_TRACE_POINTS) ? traceNames[point] : "?";
+}
+
+
+void PMTrace_reset(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < PM_TRACE_POINTS; i++)
+		PMHist_reset(&traceHist[i]);
+}
+
+
+/*---------------------------------------------------------------------------
+  Print every trace point that recorded something. Latencies are shown in
+  us, sample counts as they are. Safe while other threads are recording.
+---------------------------------------------------------------------------*/
+void PMTrace_dump(FILE *out)
+{
+	PMHist   snap;
+	uint32_t i;
+
+	fprintf(out, "%-24s %10s %10s %10s %10s %10s %10s %10s\n",
+			"Trace point", "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+	for(i = 0; i < PM_TRACE_POINTS; i++)
+	{
+		double scale = (i < PM_TRACE_FAST_ARRAY_COUNT) ? 1.0e-3 : 1.0;
+
+		PMTrace_snapshot(i, &snap);
+		if(snap.count == 0)
+			continue;
+
+		fprintf(out, "%-24s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f%s\n", traceNames[i],
+				(unsigned long long)snap.count, (double)snap.sum / (double)snap.count * scale,
+				(double)PMHist_percentile(&snap, 50.0) * scale, (double)PMHist_percentile(&snap, 90.0) * scale,
+				(double)PMHist_percentile(&snap, 99.0) * scale, (double)PMHist_percentile(&snap, 99.9) * scale,
+				(double)PMHist_max(&snap) * scale, (i < PM_TRACE_FAST_ARRAY_COUNT) ? " us" : "");
+	}
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
@@ -0,0 +1,132 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Driver call tracing
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Opt-in latency instrumentation of driver calls and poll loops.
+
+   Build with PM_TRACE defined (and pm_trace.c, pm_platform.c added) to
+   compile the trace points in; without it every PM_TRACE_xxx macro is
+   the plain call or nothing, so the cost is exactly zero. Compiled in,
+   recording still has to be switched on with PMTrace_enable(); while
+   off a trace point costs one load and a branch.
+
+   Every trace point owns a log-linear histogram (HDR style, 16 sub
+   buckets per power of two, <= 6.25 % relative error) updated with
+   atomic adds only, so any number of threads can record while another
+   thread takes snapshots with PMTrace_dump().
+
+****************************************************************************/
+#ifndef _PM_TRACE_HEADER_
+#define _PM_TRACE_HEADER_
+
+#include <stdio.h>
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+// Trace points. Latencies are recorded in ns, counts as plain values.
+#define PM_TRACE_FAST_ARRAY       0    // getNextFastArrayMeasurement
+#define PM_TRACE_MEAS_POWER       1    // measPower
+#define PM_TRACE_MEAS_SEQUENCE    2    // getMeasurementSequence
+#define PM_TRACE_BURST_SAMPLES    3    // getBurstArraySamples
+#define PM_TRACE_MEAS_OTHER       4    // other measurements (energy, frequency, 4Q, ...)
+#define PM_TRACE_CONFIG           5    // get/set/configure/start calls
+#define PM_TRACE_POLL_LOOP        6    // one poll loop iteration
+#define PM_TRACE_PROCESS          7    // one consumer call on a block
+#define PM_TRACE_FAST_ARRAY_COUNT 8    // samples per getNextFastArrayMeasurement
+#define PM_TRACE_BURST_COUNT      9    // samples per getBurstArraySamples
+#define PM_TRACE_POINTS           10
+
+#define PM_HIST_SUB_BITS          4
+#define PM_HIST_SUB_BUCKETS       (1 << PM_HIST_SUB_BITS)
+#define PM_HIST_BUCKETS           ((64 - PM_HIST_SUB_BITS + 1) * PM_HIST_SUB_BUCKETS)
+
+#ifdef PM_TRACE
+	// run statement, timed on trace point 'point'
+	#define PM_TRACE_TIMED(point, statement) \
+		do { \
+			if(pmTraceEnabled) \
+			{ \
+				uint64_t pmTraceT0_ = PMPlat_timeNs(); \
+				statement; \
+				PMTrace_record((point), PMPlat_timeNs() - pmTraceT0_); \
+			} \
+			else \
+			{ \
+				statement; \
+			} \
+		} while(0)
+
+	#define PM_TRACE_VALUE(point, value) \
+		do { if(pmTraceEnabled) PMTrace_record((point), (uint64_t)(value)); } while(0)
+
+	// time since the previous pass; last is a uint64_t owned by the loop, initially 0
+	#define PM_TRACE_INTERVAL(point, last) \
+		do { if(pmTraceEnabled) PMTrace_interval((point), &(last)); } while(0)
+#else
+	#define PM_TRACE_TIMED(point, statement)   do { statement; } while(0)
+	#define PM_TRACE_VALUE(point, value)       ((void)0)
+	#define PM_TRACE_INTERVAL(point, last)     ((void)(last))
+#endif
+
+// stat = call, timed on trace point 'point'
+#define PM_TRACE_CALL(point, stat, call)       PM_TRACE_TIMED((point), (stat) = (call))
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	volatile uint64_t count;
+	volatile uint64_t sum;
+	volatile uint64_t buckets[PM_HIST_BUCKETS];
+} PMHist;
+
+/*===========================================================================
+ Global variables
+===========================================================================*/
+extern volatile uint32_t pmTraceEnabled;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void        PMHist_record(PMHist *hist, uint64_t value);
+void        PMHist_snapshot(PMHist *hist, PMHist *copy);
+uint64_t    PMHist_percentile(const PMHist *snapshot, double percent);
+uint64_t    PMHist_max(const PMHist *snapshot);
+void        PMHist_reset(PMHist *hist);
+
+void        PMTrace_enable(ViBoolean enable);
+void        PMTrace_record(uint32_t point, uint64_t value);
+void        PMTrace_interval(uint32_t point, uint64_t *lastNs);
+void        PMTrace_snapshot(uint32_t point, PMHist *copy);
+const char *PMTrace_pointName(uint32_t point);
+void        PMTrace_reset(void);
+void        PMTrace_dump(FILE *out);
+
+#endif /* _PM_TRACE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
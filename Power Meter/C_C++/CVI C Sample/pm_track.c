@@ -0,0 +1,359 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - 4Q position tracking
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_track.h"
+
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define SPIN_US               100       // pacing: sleep until this close to the slot, then spin
+#define ERROR_BACKOFF_US      1000      // pause after a failed call, so a lost device does not spin
+#define MIN_CALIBRATION_SPAN  1.0e-3    // normalized difference range below which the gain is kept
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMTrack_defaultConfig(PMTrackConfig *cfg)
+{
+	memset(cfg, 0, sizeof(PMTrackConfig));
+	cfg->channel = 1;
+	cfg->gainX   = 1.0;
+	cfg->gainY   = 1.0;
+	cfg->minSum  = PM_TRACK_DEFAULT_MIN_SUM;
+	cfg->alpha   = PM_TRACK_DEFAULT_ALPHA;
+	cfg->beta    = PM_TRACK_DEFAULT_BETA;
+	cfg->cpu     = PM_TRACK_CPU_NONE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Position of one set of quadrant voltages. x and y are left untouched if
+  the sum is below minSum.
+---------------------------------------------------------------------------*/
+void PMTrack_position(const PMTrackConfig *cfg, const double voltage[4], double *x, double *y, double *sum)
+{
+	double s = voltage[0] + voltage[1] + voltage[2] + voltage[3];
+
+	*sum = s;
+	if(s < cfg->minSum)
+		return;
+	*x = cfg->gainX * ((voltage[0] + voltage[3]) - (voltage[1] + voltage[2])) / s + cfg->offsetX;
+	*y = cfg->gainY * ((voltage[0] + voltage[1]) - (voltage[2] + voltage[3])) / s + cfg->offsetY;
+}
+
+
+/*---------------------------------------------------------------------------
+  Fits gain and offset of both axes to the positions the driver reports,
+  from samples pairs of TLPMX_meas4QPositions and TLPMX_meas4QVoltages
+  (0: PM_TRACK_CALIBRATION_SAMPLES). The spot should move over the range
+  of interest meanwhile; if it stays put only the offsets are fitted.
+---------------------------------------------------------------------------*/
+ViStatus PMTrack_calibrate(ViSession session, PMTrackConfig *cfg, uint32_t samples)
+{
+	PMTrackConfig unit = *cfg;
+	double        sn[2] = { 0 }, sp[2] = { 0 }, snn[2] = { 0 }, snp[2] = { 0 };
+	double        lo[2] = { 1.0, 1.0 }, hi[2] = { -1.0, -1.0 };
+	uint32_t      used = 0, i, a;
+
+	if(samples == 0)
+		samples = PM_TRACK_CALIBRATION_SAMPLES;
+
+	// normalized differences: unit gain, no offset
+	unit.gainX = unit.gainY = 1.0;
+	unit.offsetX = unit.offsetY = 0.0;
+
+	for(i = 0; i < samples; i++)
+	{
+		ViReal64 pos[2], v[4];
+		double   n[2], sum;
+		ViStatus err;
+
+		PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_meas4QPositions(session, &pos[0], &pos[1], cfg->channel));
+		if(err != VI_SUCCESS)
+			return err;
+		PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_meas4QVoltages(session, &v[0], &v[1], &v[2], &v[3], cfg->channel));
+		if(err != VI_SUCCESS)
+			return err;
+
+		PMTrack_position(&unit, v, &n[0], &n[1], &sum);
+		if(sum < cfg->minSum)
+			continue;
+		for(a = 0; a < 2; a++)
+		{
+			sn[a]  += n[a];
+			sp[a]  += pos[a];
+			snn[a] += n[a] * n[a];
+			snp[a] += n[a] * pos[a];
+			if(n[a] < lo[a]) lo[a] = n[a];
+			if(n[a] > hi[a]) hi[a] = n[a];
+		}
+		used++;
+	}
+	if(used == 0)
+		return VI_ERROR_INV_SETUP;      // no beam on the sensor
+
+	for(a = 0; a < 2; a++)
+	{
+		double *gain   = (a == 0) ? &cfg->gainX : &cfg->gainY;
+		double *offset = (a == 0) ? &cfg->offsetX : &cfg->offsetY;
+		double var = snn[a] - sn[a] * sn[a] / (double)used;
+
+		if(used > 1 && hi[a] - lo[a] > MIN_CALIBRATION_SPAN && var > 0.0)
+			*gain = (snp[a] - sn[a] * sp[a] / (double)used) / var;
+		*offset = (sp[a] - *gain * sn[a]) / (double)used;
+	}
+	return VI_SUCCESS;
+}
+
+
+void PMTrack_init(PMTrack *track, ViSession session, const PMTrackConfig *cfg, PMTrackFunc func, void *ctx)
+{
+	memset(track, 0, sizeof(PMTrack));
+	track->session = session;
+	track->cfg     = *cfg;
+	track->func    = func;
+	track->ctx     = ctx;
+	if(track->cfg.alpha <= 0.0 || track->cfg.alpha > 1.0)
+		track->cfg.alpha = PM_TRACK_DEFAULT_ALPHA;
+	if(track->cfg.beta < 0.0 || track->cfg.beta >= 2.0)
+		track->cfg.beta = 0.0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Alpha-beta filter step for a new measured position
+---------------------------------------------------------------------------*/
+static void filter(PMTrack *track, PMTrackSample *s)
+{
+	double horizon = (double)track->cfg.predictUs * 1.0e-6;
+
+	if(!track->tracking)
+	{
+		track->stateX   = s->x;
+		track->stateY   = s->y;
+		track->velX     = 0.0;
+		track->velY     = 0.0;
+		track->tracking = VI_TRUE;
+		s->flags       |= PM_TRACK_FLAG_RESTART;
+	}
+	else
+	{
+		double dt = (double)(s->timeNs - track->lastNs) * 1.0e-9;
+		double px = track->stateX + track->velX * dt;
+		double py = track->stateY + track->velY * dt;
+		double rx = s->x - px, ry = s->y - py;
+
+		track->stateX = px + track->cfg.alpha * rx;
+		track->stateY = py + track->cfg.alpha * ry;
+		if(dt > 0.0)
+		{
+			track->velX += track->cfg.beta * rx / dt;
+			track->velY += track->cfg.beta * ry / dt;
+		}
+	}
+	track->lastNs = s->timeNs;
+
+	s->filteredX  = track->stateX;
+	s->filteredY  = track->stateY;
+	s->velocityX  = track->velX;
+	s->velocityY  = track->velY;
+	s->predictedX = track->stateX + track->velX * horizon;
+	s->predictedY = track->stateY + track->velY * horizon;
+}
+
+
+static void publish(PMTrack *track, const PMTrackSample *s)
+{
+	uint64_t stamp = track->stamp;
+
+	PMPlat_store64(&track->stamp, stamp + 1);
+	PMPlat_fence();
+	track->latest = *s;
+	PMPlat_store64(&track->stamp, stamp + 2);
+}
+
+
+/*---------------------------------------------------------------------------
+  Tracking thread: one voltage reading per loop
+---------------------------------------------------------------------------*/
+static void trackThread(void *arg)
+{
+	PMTrack  *track = (PMTrack*)arg;
+	uint64_t intervalNs = (uint64_t)track->cfg.intervalUs * 1000;
+	uint64_t nextNs;
+	uint64_t sequence = 0;
+
+	if(track->cfg.cpu >= 0)
+		PMPlat_store32((volatile uint32_t*)&track->pinStatus, (uint32_t)PMPlat_pinThread((uint32_t)track->cfg.cpu));
+
+	nextNs = PMPlat_timeNs();
+	while(PMPlat_load32(&track->running))
+	{
+		PMTrackSample s;
+		ViReal64      v[4] = { 0 };
+		uint64_t      t0, t1;
+
+		if(intervalNs > 0)
+		{
+			uint64_t now = PMPlat_timeNs();
+
+			if(nextNs > now + (uint64_t)SPIN_US * 1000)
+				PMPlat_sleepUs((uint32_t)((nextNs - now) / 1000 - SPIN_US));
+			while(PMPlat_timeNs() < nextNs)
+				;
+			nextNs += intervalNs;
+		}
+
+		memset(&s, 0, sizeof(PMTrackSample));
+		t0 = PMPlat_timeNs();
+		PM_TRACE_CALL(PM_TRACE_MEAS_OTHER, s.status, TLPMX_meas4QVoltages(track->session, &v[0], &v[1], &v[2], &v[3], track->cfg.channel));
+		t1 = PMPlat_timeNs();
+
+		s.sequence  = sequence++;
+		s.timeNs    = t0 + (t1 - t0) / 2;
+		s.latencyNs = t1 - t0;
+		memcpy(s.voltage, v, sizeof(s.voltage));
+
+		// hold the last filtered position while there is nothing to measure
+		s.x = track->stateX;
+		s.y = track->stateY;
+		if(s.status != VI_SUCCESS)
+			s.flags |= PM_TRACK_FLAG_ERROR;
+		else
+		{
+			PMTrack_position(&track->cfg, s.voltage, &s.x, &s.y, &s.sum);
+			if(s.sum < track->cfg.minSum)
+				s.flags |= PM_TRACK_FLAG_NO_BEAM;
+		}
+
+		if(s.flags)
+		{
+			track->tracking = VI_FALSE;
+			s.filteredX = s.predictedX = s.x;
+			s.filteredY = s.predictedY = s.y;
+		}
+		else
+			filter(track, &s);
+
+		publish(track, &s);
+		if(track->func != NULL)
+			track->func(track->ctx, &s);
+
+		PMPlat_store64(&track->samples, track->samples + 1);
+		PMPlat_store64(&track->latencySumNs, track->latencySumNs + s.latencyNs);
+		if(s.latencyNs > track->latencyMaxNs)
+			PMPlat_store64(&track->latencyMaxNs, s.latencyNs);
+		if(s.flags & PM_TRACK_FLAG_NO_BEAM)
+			PMPlat_store64(&track->noBeam, track->noBeam + 1);
+		if(s.flags & PM_TRACK_FLAG_ERROR)
+		{
+			PMPlat_store64(&track->errors, track->errors + 1);
+			PMPlat_store32((volatile uint32_t*)&track->lastError, (uint32_t)s.status);
+			PMPlat_sleepUs(ERROR_BACKOFF_US);
+		}
+	}
+}
+
+
+ViStatus PMTrack_start(PMTrack *track)
+{
+	ViStatus err;
+
+	if(track->started)
+		return VI_ERROR_INV_SETUP;
+
+	track->startNs = PMPlat_timeNs();
+	PMPlat_store32(&track->running, 1);
+	if((err = PMPlat_threadCreate(&track->thread, trackThread, track)) != VI_SUCCESS)
+	{
+		PMPlat_store32(&track->running, 0);
+		return err;
+	}
+	track->started = 1;
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMTrack_stop(PMTrack *track)
+{
+	if(!track->started)
+		return VI_SUCCESS;
+
+	PMPlat_store32(&track->running, 0);
+	PMPlat_threadJoin(track->thread);
+	track->started = 0;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Copy of the most recent sample, from any thread. VI_FALSE if there is
+  none yet.
+---------------------------------------------------------------------------*/
+ViBoolean PMTrack_latest(PMTrack *track, PMTrackSample *sample)
+{
+	for(;;)
+	{
+		uint64_t stamp = PMPlat_load64(&track->stamp);
+
+		if(stamp == 0)
+			return VI_FALSE;
+		if(stamp & 1)
+		{
+			PMPlat_yield();
+			continue;
+		}
+		*sample = track->latest;
+		PMPlat_fence();
+		if(PMPlat_load64(&track->stamp) == stamp)
+			return VI_TRUE;
+	}
+}
+
+
+void PMTrack_getStats(PMTrack *track, PMTrackStats *stats)
+{
+	uint64_t elapsedNs = PMPlat_timeNs() - track->startNs;
+
+	memset(stats, 0, sizeof(PMTrackStats));
+	stats->samples   = PMPlat_load64(&track->samples);
+	stats->errors    = PMPlat_load64(&track->errors);
+	stats->noBeam    = PMPlat_load64(&track->noBeam);
+	stats->lastError = (ViStatus)PMPlat_load32((volatile uint32_t*)&track->lastError);
+	stats->pinStatus = (ViStatus)PMPlat_load32((volatile uint32_t*)&track->pinStatus);
+	if(track->startNs != 0 && elapsedNs > 0)
+		stats->rate = (double)stats->samples * 1.0e9 / (double)elapsedNs;
+	if(stats->samples > 0)
+		stats->meanLatencyUs = (double)PMPlat_load64(&track->latencySumNs) / (double)stats->samples / 1000.0;
+	stats->maxLatencyUs = (double)PMPlat_load64(&track->latencyMaxNs) / 1000.0;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
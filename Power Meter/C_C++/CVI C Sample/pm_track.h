@@ -0,0 +1,160 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - 4Q position tracking
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Continuous beam position tracking with a four quadrant sensor, for
+   closed-loop beam steering.
+
+   TLPMX_meas4QPositions and TLPMX_meas4QVoltages are separate round
+   trips. The tracker reads only the four quadrant voltages, back to back
+   on its own thread, and computes the position locally:
+
+     nx = ((V1 + V4) - (V2 + V3)) / sum,  ny = ((V1 + V2) - (V3 + V4)) / sum
+     x  = gainX * nx + offsetX,           y  = gainY * ny + offsetY
+
+   with quadrants 1 to 4 counted counter-clockwise from +x/+y as in the
+   driver. The gain follows from the sensor geometry and the spot size
+   (about w * sqrt(pi / 8) for a Gaussian spot of 1/e^2 radius w near the
+   center) or is fitted against the driver positions by PMTrack_calibrate.
+
+   Every sample is timestamped at the middle of its round trip and passes
+   an alpha-beta filter (alpha smooths the position, beta the velocity;
+   alpha 1, beta 0 passes the raw position). The filter extrapolates the
+   position predictUs ahead, to cover the latency of the control loop.
+
+   Samples go to a callback on the tracking thread as soon as they are
+   computed - the lowest latency path - and the latest one can be read
+   by any thread with PMTrack_latest.
+
+****************************************************************************/
+#ifndef _PM_TRACK_HEADER_
+#define _PM_TRACK_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_TRACK_DEFAULT_ALPHA        0.5
+#define PM_TRACK_DEFAULT_BETA         (1.0 / 6.0)  // alpha^2 / (2 - alpha): critically damped
+#define PM_TRACK_DEFAULT_MIN_SUM      1.0e-4       // V, less is no beam
+#define PM_TRACK_CALIBRATION_SAMPLES  100
+#define PM_TRACK_CPU_NONE             (-1)
+
+// Sample flags
+#define PM_TRACK_FLAG_NO_BEAM         0x01         // sum below minSum, position held
+#define PM_TRACK_FLAG_ERROR           0x02         // driver call failed, see status
+#define PM_TRACK_FLAG_RESTART         0x04         // first sample of the filter after start, no beam or error
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	ViUInt16  channel;
+	double    gainX, gainY;       // position units per unit of normalized difference
+	double    offsetX, offsetY;
+	double    minSum;             // V
+	double    alpha;              // 0 < alpha <= 1
+	double    beta;               // 0 <= beta < 2
+	uint32_t  predictUs;          // extrapolation of the filtered position
+	uint32_t  intervalUs;         // 0: back to back, as fast as the device answers
+	int       cpu;                // tracking thread CPU, PM_TRACK_CPU_NONE: not pinned
+} PMTrackConfig;
+
+typedef struct
+{
+	uint64_t  sequence;
+	uint64_t  timeNs;             // host clock at the middle of the round trip
+	uint64_t  latencyNs;          // round trip of the driver call
+	ViStatus  status;
+	uint32_t  flags;
+	double    voltage[4];
+	double    sum;                // V
+	double    x, y;               // from this sample only
+	double    filteredX, filteredY;
+	double    velocityX, velocityY;   // position units per s
+	double    predictedX, predictedY; // predictUs after timeNs
+} PMTrackSample;
+
+// Called on the tracking thread for every sample; must return quickly
+typedef void (*PMTrackFunc)(void *ctx, const PMTrackSample *sample);
+
+typedef struct
+{
+	uint64_t  samples;
+	uint64_t  errors;
+	uint64_t  noBeam;
+	double    rate;               // samples per second since start
+	double    meanLatencyUs;
+	double    maxLatencyUs;
+	ViStatus  lastError;
+	ViStatus  pinStatus;          // of the tracking thread, if cfg.cpu was set
+} PMTrackStats;
+
+typedef struct
+{
+	ViSession         session;
+	PMTrackConfig     cfg;
+	PMTrackFunc       func;
+	void              *ctx;
+
+	PMThread          thread;
+	uint32_t          started;
+	volatile uint32_t running;
+	volatile ViStatus pinStatus;
+
+	// Tracking thread only
+	ViBoolean         tracking;   // filter state valid
+	uint64_t          lastNs;
+	double            stateX, stateY, velX, velY;
+
+	// Latest sample; stamp is odd while it is written
+	volatile uint64_t stamp;
+	PMTrackSample     latest;
+
+	volatile uint64_t samples;
+	volatile uint64_t errors;
+	volatile uint64_t noBeam;
+	volatile uint64_t latencySumNs;
+	volatile uint64_t latencyMaxNs;
+	volatile ViStatus lastError;
+	uint64_t          startNs;
+} PMTrack;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void     PMTrack_defaultConfig(PMTrackConfig *cfg);
+ViStatus PMTrack_calibrate(ViSession session, PMTrackConfig *cfg, uint32_t samples);
+void     PMTrack_position(const PMTrackConfig *cfg, const double voltage[4], double *x, double *y, double *sum);
+
+void     PMTrack_init(PMTrack *track, ViSession session, const PMTrackConfig *cfg, PMTrackFunc func, void *ctx);
+ViStatus PMTrack_start(PMTrack *track);
+ViStatus PMTrack_stop(PMTrack *track);
+ViBoolean PMTrack_latest(PMTrack *track, PMTrackSample *sample);
+void     PMTrack_getStats(PMTrack *track, PMTrackStats *stats);
+
+#endif /* _PM_TRACK_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
@@ -0,0 +1,303 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Completion waiting
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#include "pm_wait.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TLPMX.h"
+#include "pm_trace.h"
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+void PMWaitHistory_init(PMWaitHistory *history)
+{
+	memset(history, 0, sizeof(PMWaitHistory));
+}
+
+
+/*---------------------------------------------------------------------------
+  Profile for model and operation, created on first use. When the table
+  is full the least used profile is recycled.
+---------------------------------------------------------------------------*/
+PMWaitProfile *PMWaitHistory_profile(PMWaitHistory *history, const char *model, const char *operation)
+{
+	PMWaitProfile *p;
+	uint32_t      i, victim = 0;
+
+	for(i = 0; i < history->count; i++)
+	{
+		p = &history->profile[i];
+		if(strcmp(p->model, model) == 0 && strcmp(p->operation, operation) == 0)
+			return p;
+		if(p->samples < history->profile[victim].samples)
+			victim = i;
+	}
+
+	p = (history->count < PM_WAIT_MAX_PROFILES) ? &history->profile[history->count++] : &history->profile[victim];
+	memset(p, 0, sizeof(PMWaitProfile));
+	snprintf(p->model, PM_WAIT_KEY_SIZE, "%s", model);
+	snprintf(p->operation, PM_WAIT_KEY_SIZE, "%s", operation);
+	return p;
+}
+
+
+/*---------------------------------------------------------------------------
+  Text file, one profile per line: model, operation, samples, mean and
+  deviation in us, separated by tabs
+---------------------------------------------------------------------------*/
+ViStatus PMWaitHistory_load(PMWaitHistory *history, const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char model[PM_WAIT_KEY_SIZE], operation[PM_WAIT_KEY_SIZE];
+	unsigned int samples;
+	double       mean, deviation;
+
+	if(f == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	while(fscanf(f, " %63[^\t]\t%63[^\t]\t%u\t%lf\t%lf", model, operation, &samples, &mean, &deviation) == 5)
+	{
+		PMWaitProfile *p = PMWaitHistory_profile(history, model, operation);
+
+		p->samples     = samples;
+		p->meanUs      = mean;
+		p->deviationUs = deviation;
+	}
+
+	fclose(f);
+	return VI_SUCCESS;
+}
+
+
+ViStatus PMWaitHistory_save(const PMWaitHistory *history, const char *path)
+{
+	FILE     *f = fopen(path, "w");
+	uint32_t i;
+	int      ok = 1;
+
+	if(f == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	for(i = 0; i < history->count && ok; i++)
+	{
+		const PMWaitProfile *p = &history->profile[i];
+
+		ok = fprintf(f, "%s\t%s\t%u\t%.1f\t%.1f\n", p->model, p->operation, (unsigned int)p->samples,
+				p->meanUs, p->deviationUs) > 0;
+	}
+
+	if(fclose(f) != 0)
+		ok = 0;
+	return ok ? VI_SUCCESS : VI_ERROR_FILE_IO;
+}
+
+
+static void learn(PMWaitProfile *p, double us)
+{
+	double err;
+
+	if(p->samples == 0)
+	{
+		p->meanUs      = us;
+		p->deviationUs = us / 4.0;
+	}
+	else
+	{
+		err = us - p->meanUs;
+		p->meanUs      += PM_WAIT_LEARN_WEIGHT * err;
+		p->deviationUs += PM_WAIT_LEARN_WEIGHT * (fabs(err) - p->deviationUs);
+	}
+	p->samples++;
+}
+
+
+void PMWait_item(PMWaitItem *item, PMWaitPollFunc poll, void *ctx, PMWaitProfile *profile, uint32_t timeoutUs)
+{
+	memset(item, 0, sizeof(PMWaitItem));
+	item->poll      = poll;
+	item->ctx       = ctx;
+	item->profile   = profile;
+	item->timeoutUs = timeoutUs;
+}
+
+
+static void begin(PMWaitItem *item, uint64_t now)
+{
+	double firstUs = PM_WAIT_FIRST_POLL_US;
+	double stepUs  = PM_WAIT_FIRST_POLL_US;
+
+	// aim just before the usual completion, then back off from its spread
+	if(item->profile != NULL && item->profile->samples > 0)
+	{
+		firstUs = item->profile->meanUs - 2.0 * item->profile->deviationUs;
+		stepUs  = item->profile->deviationUs;
+	}
+	if(firstUs < PM_WAIT_MIN_POLL_US)
+		firstUs = PM_WAIT_MIN_POLL_US;
+	if(stepUs < PM_WAIT_MIN_POLL_US)
+		stepUs = PM_WAIT_MIN_POLL_US;
+
+	item->status     = VI_SUCCESS;
+	item->done       = VI_FALSE;
+	item->polls      = 0;
+	item->lastPollNs = now;
+	item->deadlineNs = now + (uint64_t)item->timeoutUs * 1000;
+	item->nextPollNs = now + (uint64_t)firstUs * 1000;
+	item->intervalNs = (uint64_t)stepUs * 1000;
+	if(item->nextPollNs > item->deadlineNs)
+		item->nextPollNs = item->deadlineNs;
+}
+
+
+/*---------------------------------------------------------------------------
+  Poll one item that is due. Returns VI_TRUE once it is finished.
+---------------------------------------------------------------------------*/
+static ViBoolean pollItem(PMWaitItem *item, uint64_t startNs)
+{
+	uint64_t  now;
+	ViBoolean done = VI_FALSE;
+
+	item->status = item->poll(item->ctx, &done);
+	item->polls++;
+	now = PMPlat_timeNs();
+
+	if(item->status != VI_SUCCESS)
+		return VI_TRUE;
+
+	if(done)
+	{
+		item->done      = VI_TRUE;
+		item->elapsedUs = (now - startNs) / 1000;
+
+		// completion happened between the last two polls
+		if(item->profile != NULL)
+			learn(item->profile, (item->polls > 1) ? (double)((item->lastPollNs + now) / 2 - startNs) / 1000.0
+			                                        : (double)item->elapsedUs);
+		return VI_TRUE;
+	}
+
+	if(now >= item->deadlineNs)
+	{
+		item->status = VI_ERROR_TMO;
+		return VI_TRUE;
+	}
+
+	item->lastPollNs = now;
+	item->nextPollNs = now + item->intervalNs;
+	if(item->nextPollNs > item->deadlineNs)
+		item->nextPollNs = item->deadlineNs;
+	item->intervalNs *= 2;
+	if(item->intervalNs > (uint64_t)PM_WAIT_MAX_POLL_US * 1000)
+		item->intervalNs = (uint64_t)PM_WAIT_MAX_POLL_US * 1000;
+	return VI_FALSE;
+}
+
+
+/*---------------------------------------------------------------------------
+  Wait for all items. Returns VI_SUCCESS when all completed, otherwise the
+  status of the first item that failed or timed out; every item has its
+  own status.
+---------------------------------------------------------------------------*/
+ViStatus PMWait_all(PMWaitItem items[], uint32_t count)
+{
+	uint64_t startNs = PMPlat_timeNs();
+	uint32_t pending = count;
+	uint32_t i;
+	uint8_t  finished[64] = { 0 };
+	ViStatus err = VI_SUCCESS;
+
+	if(count > sizeof(finished))
+		return VI_ERROR_USER_BUF;
+
+	for(i = 0; i < count; i++)
+		begin(&items[i], startNs);
+
+	while(pending > 0)
+	{
+		uint64_t now = PMPlat_timeNs();
+		uint64_t next = UINT64_MAX;
+
+		for(i = 0; i < count; i++)
+			if(!finished[i] && items[i].nextPollNs < next)
+				next = items[i].nextPollNs;
+		if(next > now)
+			PMPlat_sleepUs((uint32_t)((next - now + 999) / 1000));
+
+		now = PMPlat_timeNs();
+		for(i = 0; i < count; i++)
+		{
+			if(finished[i] || items[i].nextPollNs > now)
+				continue;
+			if(pollItem(&items[i], startNs))
+			{
+				finished[i] = 1;
+				pending--;
+				if(items[i].status != VI_SUCCESS && err == VI_SUCCESS)
+					err = items[i].status;
+			}
+		}
+	}
+	return err;
+}
+
+
+ViStatus PMWait_one(PMWaitItem *item)
+{
+	return PMWait_all(item, 1);
+}
+
+
+/*---------------------------------------------------------------------------
+  TLPMX status queries
+---------------------------------------------------------------------------*/
+ViStatus PMWait_pollPeakDetector(void *ctx, ViBoolean *done)
+{
+	PMWaitTarget *t = (PMWaitTarget*)ctx;
+	ViBoolean    running = VI_TRUE;
+	ViStatus     err;
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_isPeakDetectorRunning(t->vi, &running, t->channel));
+	*done = running ? VI_FALSE : VI_TRUE;
+	return err;
+}
+
+
+ViStatus PMWait_pollBurst(void *ctx, ViBoolean *done)
+{
+	PMWaitTarget *t = (PMWaitTarget*)ctx;
+	ViUInt32     samples = 0;
+	ViStatus     err;
+
+	PM_TRACE_CALL(PM_TRACE_CONFIG, err, TLPMX_getBurstArraySamplesCount(t->vi, &samples));
+	*done = (samples >= t->samples) ? VI_TRUE : VI_FALSE;
+	return err;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
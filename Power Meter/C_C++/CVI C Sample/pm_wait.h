@@ -0,0 +1,122 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Completion waiting
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+
+   Waits for instrument operations that finish on their own (peak
+   detector search, burst acquisition, ...) by polling a status query
+   with exponential backoff up to a deadline.
+
+   The first poll is placed just before the completion time learned for
+   the device model and operation (running mean and mean deviation of
+   past waits), so typical waits take one or two queries instead of a
+   fixed worst case sleep or a busy loop. PMWait_all waits for several
+   sessions at once on the calling thread and always sleeps until the
+   next poll that is due.
+
+****************************************************************************/
+#ifndef _PM_WAIT_HEADER_
+#define _PM_WAIT_HEADER_
+
+#include "pm_platform.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_WAIT_MAX_PROFILES      32
+#define PM_WAIT_KEY_SIZE          64
+#define PM_WAIT_FIRST_POLL_US     1000      // first poll without history
+#define PM_WAIT_MIN_POLL_US       500
+#define PM_WAIT_MAX_POLL_US       200000    // backoff limit
+#define PM_WAIT_LEARN_WEIGHT      0.25      // weight of a new observation
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+// Set *done to VI_TRUE once the operation has completed
+typedef ViStatus (*PMWaitPollFunc)(void *ctx, ViBoolean *done);
+
+// Learned completion time of one operation on one device model
+typedef struct
+{
+	char      model[PM_WAIT_KEY_SIZE];
+	char      operation[PM_WAIT_KEY_SIZE];
+	uint32_t  samples;
+	double    meanUs;
+	double    deviationUs;        // mean absolute deviation
+} PMWaitProfile;
+
+typedef struct
+{
+	PMWaitProfile profile[PM_WAIT_MAX_PROFILES];
+	uint32_t      count;
+} PMWaitHistory;
+
+typedef struct
+{
+	// set up by PMWait_item
+	PMWaitPollFunc poll;
+	void           *ctx;
+	PMWaitProfile  *profile;      // NULL: no learning
+	uint32_t       timeoutUs;
+
+	// result
+	ViStatus       status;        // VI_ERROR_TMO if the deadline passed
+	ViBoolean      done;
+	uint32_t       polls;
+	uint64_t       elapsedUs;     // start to the poll that saw completion
+
+	// internal
+	uint64_t       nextPollNs;
+	uint64_t       lastPollNs;
+	uint64_t       deadlineNs;
+	uint64_t       intervalNs;
+} PMWaitItem;
+
+// Poll context for the TLPMX status helpers
+typedef struct
+{
+	ViSession vi;
+	ViUInt16  channel;
+	ViUInt32  samples;            // PMWait_pollBurst: samples to wait for
+} PMWaitTarget;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+void           PMWaitHistory_init(PMWaitHistory *history);
+PMWaitProfile *PMWaitHistory_profile(PMWaitHistory *history, const char *model, const char *operation);
+ViStatus       PMWaitHistory_load(PMWaitHistory *history, const char *path);
+ViStatus       PMWaitHistory_save(const PMWaitHistory *history, const char *path);
+
+void           PMWait_item(PMWaitItem *item, PMWaitPollFunc poll, void *ctx, PMWaitProfile *profile, uint32_t timeoutUs);
+ViStatus       PMWait_one(PMWaitItem *item);
+ViStatus       PMWait_all(PMWaitItem items[], uint32_t count);
+
+// Status queries for PMWaitPollFunc, ctx is a PMWaitTarget
+ViStatus       PMWait_pollPeakDetector(void *ctx, ViBoolean *done);
+ViStatus       PMWait_pollBurst(void *ctx, ViBoolean *done);
+
+#endif /* _PM_WAIT_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
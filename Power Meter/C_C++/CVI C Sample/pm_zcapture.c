@@ -0,0 +1,712 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Compressed capture
+
+   Source file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+****************************************************************************/
+#ifndef _WIN32
+	#define _FILE_OFFSET_BITS 64
+	#define _GNU_SOURCE
+#endif
+
+#include "pm_zcapture.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define INDEX_INITIAL         1024
+#define STREAM_BYTES(samples) ((size_t)(samples) * 6 + 16)    // worst case of both columns
+#define NO_WINDOW             32                               // no previous XOR window yet
+
+/*===========================================================================
+ Functions
+===========================================================================*/
+PM_INLINE uint32_t leadingZeros(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+
+	_BitScanReverse(&idx, v);
+	return 31 - (uint32_t)idx;
+#else
+	return (uint32_t)__builtin_clz(v);
+#endif
+}
+
+
+PM_INLINE uint32_t trailingZeros(uint32_t v)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+
+	_BitScanForward(&idx, v);
+	return (uint32_t)idx;
+#else
+	return (uint32_t)__builtin_ctz(v);
+#endif
+}
+
+
+static int seekFile(FILE *f, uint64_t offset)
+{
+#if defined(_MSC_VER)
+	return _fseeki64(f, (__int64)offset, SEEK_SET);
+#elif defined(_WIN32)
+	return fseek(f, (long)offset, SEEK_SET);
+#else
+	return fseeko(f, (off_t)offset, SEEK_SET);
+#endif
+}
+
+
+static uint64_t fileLength(FILE *f)
+{
+#if defined(_MSC_VER)
+	_fseeki64(f, 0, SEEK_END);
+	return (uint64_t)_ftelli64(f);
+#elif defined(_WIN32)
+	fseek(f, 0, SEEK_END);
+	return (uint64_t)ftell(f);
+#else
+	fseeko(f, 0, SEEK_END);
+	return (uint64_t)ftello(f);
+#endif
+}
+
+
+static void copyString(char *dst, size_t size, const char *src)
+{
+	if(src == NULL)
+		src = "";
+	strncpy(dst, src, size - 1);
+	dst[size - 1] = '\0';
+}
+
+
+/*---------------------------------------------------------------------------
+  Bit writer, up to 32 bits per call
+---------------------------------------------------------------------------*/
+PM_INLINE void putBits(PMZBitWriter *w, uint32_t value, uint32_t n)
+{
+	w->acc   = (w->acc << n) | (value & (uint32_t)(0xFFFFFFFFu >> (32 - n)));
+	w->bits += n;
+	if(w->bits >= 32)
+	{
+		uint32_t out = (uint32_t)(w->acc >> (w->bits - 32));
+
+		w->data[w->bytes + 0] = (uint8_t)(out >> 24);
+		w->data[w->bytes + 1] = (uint8_t)(out >> 16);
+		w->data[w->bytes + 2] = (uint8_t)(out >> 8);
+		w->data[w->bytes + 3] = (uint8_t)out;
+		w->bytes += 4;
+		w->bits  -= 32;
+	}
+}
+
+
+static void finishBits(PMZBitWriter *w)
+{
+	while(w->bits >= 8)
+	{
+		w->data[w->bytes++] = (uint8_t)(w->acc >> (w->bits - 8));
+		w->bits -= 8;
+	}
+	if(w->bits > 0)
+		w->data[w->bytes++] = (uint8_t)(w->acc << (8 - w->bits));
+	w->bits = 0;
+	w->acc  = 0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Bit reader. Reading past the end yields zero bits.
+---------------------------------------------------------------------------*/
+typedef struct
+{
+	const uint8_t *p;
+	const uint8_t *end;
+	uint64_t      acc;
+	uint32_t      bits;
+} BitReader;
+
+PM_INLINE uint32_t getBits(BitReader *r, uint32_t n)
+{
+	if(r->bits < n)
+	{
+		while(r->bits <= 56)
+		{
+			r->acc   = (r->acc << 8) | ((r->p < r->end) ? *r->p++ : 0);
+			r->bits += 8;
+		}
+	}
+	r->bits -= n;
+	return (uint32_t)(r->acc >> r->bits) & (uint32_t)(0xFFFFFFFFu >> (32 - n));
+}
+
+
+static ViReal32 bitsToFloat(uint32_t bits)
+{
+	ViReal32 v;
+
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+
+static uint32_t floatToBits(ViReal32 v)
+{
+	uint32_t bits;
+
+	memcpy(&bits, &v, sizeof(bits));
+	return bits;
+}
+
+
+/*---------------------------------------------------------------------------
+  Writer
+---------------------------------------------------------------------------*/
+static void beginBlock(PMZCapture *cap, ViUInt32 timestamp, ViReal32 value)
+{
+	memset(&cap->block, 0, sizeof(PMZCaptureBlockHeader));
+	cap->block.magic          = PM_ZCAPTURE_BLOCK_MAGIC;
+	cap->block.firstSample    = cap->samples;
+	cap->block.firstTimeUs    = cap->timeUs;
+	cap->block.firstTimestamp = timestamp;
+	cap->block.firstDelta     = cap->prevDelta;
+	cap->block.min            = value;
+	cap->block.max            = value;
+
+	cap->time.bytes  = 0;
+	cap->value.bytes = 0;
+	cap->prevLead    = NO_WINDOW;
+	cap->prevTrail   = 0;
+}
+
+
+static ViStatus flushBlock(PMZCapture *cap)
+{
+	PMZCaptureIndex *entry;
+
+	if(cap->block.count == 0)
+		return VI_SUCCESS;
+
+	finishBits(&cap->time);
+	finishBits(&cap->value);
+	cap->block.timeBytes  = cap->time.bytes;
+	cap->block.valueBytes = cap->value.bytes;
+
+	if(cap->blocks == cap->indexCapacity)
+	{
+		uint64_t        capacity = cap->indexCapacity ? cap->indexCapacity * 2 : INDEX_INITIAL;
+		PMZCaptureIndex *index = (PMZCaptureIndex*)realloc(cap->index, (size_t)capacity * sizeof(PMZCaptureIndex));
+
+		if(index == NULL)
+			return VI_ERROR_ALLOC;
+		cap->index         = index;
+		cap->indexCapacity = capacity;
+	}
+
+	entry = &cap->index[cap->blocks];
+	memset(entry, 0, sizeof(PMZCaptureIndex));
+	entry->offset      = cap->fileBytes;
+	entry->firstSample = cap->block.firstSample;
+	entry->firstTimeUs = cap->block.firstTimeUs;
+	entry->count       = cap->block.count;
+	entry->min         = cap->block.min;
+	entry->max         = cap->block.max;
+
+	if(fwrite(&cap->block, sizeof(PMZCaptureBlockHeader), 1, cap->file) != 1 ||
+	   fwrite(cap->time.data, 1, cap->time.bytes, cap->file) != cap->time.bytes ||
+	   fwrite(cap->value.data, 1, cap->value.bytes, cap->file) != cap->value.bytes)
+		return VI_ERROR_FILE_IO;
+
+	cap->fileBytes += sizeof(PMZCaptureBlockHeader) + cap->time.bytes + cap->value.bytes;
+	cap->blocks++;
+	cap->block.count = 0;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Create a compressed capture file
+---------------------------------------------------------------------------*/
+ViStatus PMZCapture_create(PMZCapture *cap, const char *path, const PMCaptureInfo *info, uint32_t blockSamples)
+{
+	PMZCaptureHeader header;
+
+	memset(cap, 0, sizeof(PMZCapture));
+	if(blockSamples == 0)
+		blockSamples = PM_ZCAPTURE_BLOCK_SAMPLES;
+	if(blockSamples > PM_ZCAPTURE_MAX_BLOCK)
+		return VI_ERROR_INV_SETUP;
+
+	cap->blockSamples = blockSamples;
+	cap->sampleRate   = (info && info->sampleRate) ? info->sampleRate : 100000;
+	cap->prevDelta    = (int32_t)(1000000 / cap->sampleRate);
+	cap->time.data    = (uint8_t*)malloc(STREAM_BYTES(blockSamples));
+	cap->value.data   = (uint8_t*)malloc(STREAM_BYTES(blockSamples));
+	if(cap->time.data == NULL || cap->value.data == NULL)
+	{
+		free(cap->time.data);
+		free(cap->value.data);
+		return VI_ERROR_ALLOC;
+	}
+
+	if((cap->file = fopen(path, "wb")) == NULL)
+	{
+		free(cap->time.data);
+		free(cap->value.data);
+		return VI_ERROR_FILE_ACCESS;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PM_ZCAPTURE_MAGIC, sizeof(PM_ZCAPTURE_MAGIC));
+	header.version      = PM_ZCAPTURE_VERSION;
+	header.headerSize   = PM_ZCAPTURE_HEADER_SIZE;
+	header.blockSamples = blockSamples;
+	header.sampleRate   = info ? info->sampleRate : 0;
+	header.startTimeUs  = PMPlat_unixTimeUs();
+	header.channel      = info ? info->channel : 0;
+	copyString(header.device, sizeof(header.device), info ? info->device : NULL);
+	copyString(header.serial, sizeof(header.serial), info ? info->serial : NULL);
+	copyString(header.unit,   sizeof(header.unit),   info ? info->unit   : NULL);
+
+	{
+		uint8_t raw[PM_ZCAPTURE_HEADER_SIZE];
+
+		memset(raw, 0, sizeof(raw));
+		memcpy(raw, &header, sizeof(header));
+		if(fwrite(raw, sizeof(raw), 1, cap->file) != 1)
+			cap->writeStatus = VI_ERROR_FILE_IO;
+	}
+	cap->fileBytes = PM_ZCAPTURE_HEADER_SIZE;
+	return cap->writeStatus;
+}
+
+
+/*---------------------------------------------------------------------------
+  Encode samples. Full blocks go to the file (buffered stdio).
+---------------------------------------------------------------------------*/
+ViStatus PMZCapture_append(PMZCapture *cap, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count)
+{
+	uint64_t t0 = PMPlat_timeNs();
+	uint32_t i;
+
+	if(cap->writeStatus != VI_SUCCESS)
+		return cap->writeStatus;
+
+	for(i = 0; i < count; i++)
+	{
+		ViUInt32 t = timestamps[i];
+		ViReal32 v = values[i];
+		uint32_t bits = floatToBits(v);
+
+		if(cap->block.count == 0)
+		{
+			if(cap->samples > 0)
+			{
+				cap->prevDelta = (int32_t)(t - cap->prevTimestamp);
+				cap->timeUs   += (ViUInt32)(t - cap->prevTimestamp);
+			}
+			beginBlock(cap, t, v);
+			putBits(&cap->value, bits, 32);
+		}
+		else
+		{
+			// timestamp: delta of delta
+			int32_t delta = (int32_t)(t - cap->prevTimestamp);
+			int64_t dod   = (int64_t)delta - cap->prevDelta;
+			uint32_t x;
+
+			if(dod == 0)
+				putBits(&cap->time, 0, 1);
+			else if(dod >= -63 && dod <= 64)
+				putBits(&cap->time, (0x2u << 7) | (uint32_t)(dod + 63), 9);
+			else if(dod >= -255 && dod <= 256)
+				putBits(&cap->time, (0x6u << 9) | (uint32_t)(dod + 255), 12);
+			else if(dod >= -2047 && dod <= 2048)
+				putBits(&cap->time, (0xEu << 12) | (uint32_t)(dod + 2047), 16);
+			else
+			{
+				putBits(&cap->time, 0xF, 4);
+				putBits(&cap->time, (uint32_t)delta, 32);
+			}
+			cap->prevDelta = delta;
+			cap->timeUs   += (ViUInt32)delta;
+
+			// value: XOR with the previous one
+			x = bits ^ cap->prevValue;
+			if(x == 0)
+				putBits(&cap->value, 0, 1);
+			else
+			{
+				uint32_t lead  = leadingZeros(x);
+				uint32_t trail = trailingZeros(x);
+
+				if(lead > 31)
+					lead = 31;
+				if(cap->prevLead != NO_WINDOW && lead >= cap->prevLead && trail >= cap->prevTrail)
+				{
+					uint32_t len = 32 - cap->prevLead - cap->prevTrail;
+
+					putBits(&cap->value, 0x2, 2);
+					putBits(&cap->value, x >> cap->prevTrail, len);
+				}
+				else
+				{
+					uint32_t len = 32 - lead - trail;
+
+					putBits(&cap->value, (0x3u << 10) | (lead << 5) | (len - 1), 12);
+					putBits(&cap->value, x >> trail, len);
+					cap->prevLead  = lead;
+					cap->prevTrail = trail;
+				}
+			}
+
+			if(v < cap->block.min)
+				cap->block.min = v;
+			if(v > cap->block.max)
+				cap->block.max = v;
+		}
+
+		cap->prevTimestamp = t;
+		cap->prevValue     = bits;
+		cap->block.count++;
+		cap->samples++;
+
+		if(cap->block.count == cap->blockSamples && (cap->writeStatus = flushBlock(cap)))
+			break;
+	}
+
+	cap->encodeNs += PMPlat_timeNs() - t0;
+	return cap->writeStatus;
+}
+
+
+/*---------------------------------------------------------------------------
+  PMConsumerFunc adapter for PMAcq_addConsumer (ctx = PMZCapture*)
+---------------------------------------------------------------------------*/
+void PMZCapture_consumer(void *ctx, const PMFastBlock *block)
+{
+	PMZCapture_append((PMZCapture*)ctx, block->timestamps, block->values, block->count);
+}
+
+
+/*---------------------------------------------------------------------------
+  Write the last block, the index and the footer
+---------------------------------------------------------------------------*/
+ViStatus PMZCapture_close(PMZCapture *cap)
+{
+	PMZCaptureFooter footer;
+	ViStatus         err = cap->writeStatus;
+
+	if(cap->file == NULL)
+		return VI_ERROR_INV_OBJECT;
+
+	if(err == VI_SUCCESS)
+		err = flushBlock(cap);
+
+	if(err == VI_SUCCESS)
+	{
+		memset(&footer, 0, sizeof(footer));
+		footer.indexOffset = cap->fileBytes;
+		footer.blockCount  = cap->blocks;
+		footer.sampleCount = cap->samples;
+		memcpy(footer.magic, PM_ZCAPTURE_INDEX_MAGIC, sizeof(PM_ZCAPTURE_INDEX_MAGIC));
+
+		if((cap->blocks > 0 && fwrite(cap->index, sizeof(PMZCaptureIndex), (size_t)cap->blocks, cap->file) != cap->blocks) ||
+		   fwrite(&footer, sizeof(footer), 1, cap->file) != 1)
+			err = VI_ERROR_FILE_IO;
+		cap->fileBytes += cap->blocks * sizeof(PMZCaptureIndex) + sizeof(footer);
+	}
+
+	if(fclose(cap->file) != 0 && err == VI_SUCCESS)
+		err = VI_ERROR_FILE_IO;
+	cap->file = NULL;
+
+	free(cap->time.data);
+	free(cap->value.data);
+	free(cap->index);
+	cap->time.data  = NULL;
+	cap->value.data = NULL;
+	cap->index      = NULL;
+	return err;
+}
+
+
+double PMZCapture_bytesPerSample(const PMZCapture *cap)
+{
+	return cap->samples ? (double)cap->fileBytes / (double)cap->samples : 0.0;
+}
+
+
+/*---------------------------------------------------------------------------
+  Reader
+---------------------------------------------------------------------------*/
+static ViStatus addIndex(PMZCaptureReader *reader, uint64_t *capacity, const PMZCaptureIndex *entry)
+{
+	if(reader->blocks == *capacity)
+	{
+		uint64_t        grown = *capacity ? *capacity * 2 : INDEX_INITIAL;
+		PMZCaptureIndex *index = (PMZCaptureIndex*)realloc(reader->index, (size_t)grown * sizeof(PMZCaptureIndex));
+
+		if(index == NULL)
+			return VI_ERROR_ALLOC;
+		reader->index = index;
+		*capacity     = grown;
+	}
+	reader->index[reader->blocks++] = *entry;
+	reader->samples = entry->firstSample + entry->count;
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  No valid footer: walk the block headers up to the last complete block
+---------------------------------------------------------------------------*/
+static ViStatus scanBlocks(PMZCaptureReader *reader, uint64_t size)
+{
+	PMZCaptureBlockHeader bh;
+	PMZCaptureIndex       entry;
+	uint64_t              offset = reader->header.headerSize;
+	uint64_t              capacity = 0;
+	ViStatus              err;
+
+	while(offset + sizeof(bh) <= size)
+	{
+		if(seekFile(reader->file, offset) != 0 || fread(&bh, sizeof(bh), 1, reader->file) != 1)
+			break;
+		if(bh.magic != PM_ZCAPTURE_BLOCK_MAGIC || bh.count == 0 || bh.count > reader->header.blockSamples ||
+		   offset + sizeof(bh) + bh.timeBytes + bh.valueBytes > size)
+			break;
+
+		memset(&entry, 0, sizeof(entry));
+		entry.offset      = offset;
+		entry.firstSample = bh.firstSample;
+		entry.firstTimeUs = bh.firstTimeUs;
+		entry.count       = bh.count;
+		entry.min         = bh.min;
+		entry.max         = bh.max;
+		if((err = addIndex(reader, &capacity, &entry)))
+			return err;
+
+		offset += sizeof(bh) + bh.timeBytes + bh.valueBytes;
+	}
+	return VI_SUCCESS;
+}
+
+
+/*---------------------------------------------------------------------------
+  Open a compressed capture file. The index is loaded into memory.
+---------------------------------------------------------------------------*/
+ViStatus PMZCaptureReader_open(PMZCaptureReader *reader, const char *path)
+{
+	PMZCaptureFooter footer;
+	uint64_t         size;
+	ViStatus         err = VI_SUCCESS;
+
+	memset(reader, 0, sizeof(PMZCaptureReader));
+	if((reader->file = fopen(path, "rb")) == NULL)
+		return VI_ERROR_FILE_ACCESS;
+
+	if(fread(&reader->header, sizeof(PMZCaptureHeader), 1, reader->file) != 1 ||
+	   memcmp(reader->header.magic, PM_ZCAPTURE_MAGIC, sizeof(PM_ZCAPTURE_MAGIC)) != 0 ||
+	   reader->header.version != PM_ZCAPTURE_VERSION || reader->header.blockSamples == 0 ||
+	   reader->header.blockSamples > PM_ZCAPTURE_MAX_BLOCK)
+	{
+		fclose(reader->file);
+		reader->file = NULL;
+		return VI_ERROR_INV_FMT;
+	}
+
+	size = fileLength(reader->file);
+	if(size >= reader->header.headerSize + sizeof(footer) &&
+	   seekFile(reader->file, size - sizeof(footer)) == 0 && fread(&footer, sizeof(footer), 1, reader->file) == 1 &&
+	   memcmp(footer.magic, PM_ZCAPTURE_INDEX_MAGIC, sizeof(PM_ZCAPTURE_INDEX_MAGIC)) == 0 &&
+	   footer.indexOffset + footer.blockCount * sizeof(PMZCaptureIndex) + sizeof(footer) == size)
+	{
+		reader->index = (PMZCaptureIndex*)malloc((size_t)(footer.blockCount ? footer.blockCount : 1) * sizeof(PMZCaptureIndex));
+		if(reader->index == NULL)
+			err = VI_ERROR_ALLOC;
+		else if(seekFile(reader->file, footer.indexOffset) != 0 ||
+				fread(reader->index, sizeof(PMZCaptureIndex), (size_t)footer.blockCount, reader->file) != footer.blockCount)
+			err = VI_ERROR_FILE_IO;
+		reader->blocks  = footer.blockCount;
+		reader->samples = footer.sampleCount;
+		reader->closed  = VI_TRUE;
+	}
+	else
+	{
+		err = scanBlocks(reader, size);
+	}
+
+	if(err != VI_SUCCESS)
+		PMZCaptureReader_close(reader);
+	return err;
+}
+
+
+/*---------------------------------------------------------------------------
+  Block holding sample / time (us since the first sample). Values past the
+  end return the last block.
+---------------------------------------------------------------------------*/
+uint64_t PMZCaptureReader_findSample(const PMZCaptureReader *reader, uint64_t sample)
+{
+	uint64_t lo = 0, hi = reader->blocks;
+
+	while(hi - lo > 1)
+	{
+		uint64_t mid = (lo + hi) / 2;
+
+		if(reader->index[mid].firstSample <= sample)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+
+uint64_t PMZCaptureReader_findTime(const PMZCaptureReader *reader, uint64_t timeUs)
+{
+	uint64_t lo = 0, hi = reader->blocks;
+
+	while(hi - lo > 1)
+	{
+		uint64_t mid = (lo + hi) / 2;
+
+		if(reader->index[mid].firstTimeUs <= timeUs)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+
+/*---------------------------------------------------------------------------
+  Decode one block into a sample block of at least blockSamples capacity
+---------------------------------------------------------------------------*/
+ViStatus PMZCaptureReader_readBlock(PMZCaptureReader *reader, uint64_t block, PMSampleBlock *samples)
+{
+	PMZCaptureBlockHeader bh;
+	BitReader             tr, vr;
+	uint32_t              payload, i;
+	uint32_t              t, bits, lead = 0, trail = 0;
+	int32_t               delta;
+	uint64_t              t0 = PMPlat_timeNs();
+	ViUInt32              *ts = samples->timestamps;
+	ViReal32              *vs = samples->channel[0];
+
+	if(block >= reader->blocks)
+		return VI_ERROR_INV_OFFSET;
+	if(seekFile(reader->file, reader->index[block].offset) != 0 || fread(&bh, sizeof(bh), 1, reader->file) != 1)
+		return VI_ERROR_FILE_IO;
+	if(bh.magic != PM_ZCAPTURE_BLOCK_MAGIC || bh.count == 0 || bh.count > reader->header.blockSamples)
+		return VI_ERROR_INV_FMT;
+	if(bh.count > samples->capacity)
+		return VI_ERROR_USER_BUF;
+
+	payload = bh.timeBytes + bh.valueBytes;
+	if(payload > reader->bufferSize)
+	{
+		uint8_t *buffer = (uint8_t*)realloc(reader->buffer, payload);
+
+		if(buffer == NULL)
+			return VI_ERROR_ALLOC;
+		reader->buffer     = buffer;
+		reader->bufferSize = payload;
+	}
+	if(fread(reader->buffer, 1, payload, reader->file) != payload)
+		return VI_ERROR_FILE_IO;
+
+	memset(&tr, 0, sizeof(tr));
+	tr.p   = reader->buffer;
+	tr.end = reader->buffer + bh.timeBytes;
+	memset(&vr, 0, sizeof(vr));
+	vr.p   = tr.end;
+	vr.end = tr.end + bh.valueBytes;
+
+	t     = bh.firstTimestamp;
+	delta = bh.firstDelta;
+	bits  = getBits(&vr, 32);
+	ts[0] = t;
+	vs[0] = bitsToFloat(bits);
+
+	for(i = 1; i < bh.count; i++)
+	{
+		if(getBits(&tr, 1))
+		{
+			if(!getBits(&tr, 1))
+				delta += (int32_t)getBits(&tr, 7) - 63;
+			else if(!getBits(&tr, 1))
+				delta += (int32_t)getBits(&tr, 9) - 255;
+			else if(!getBits(&tr, 1))
+				delta += (int32_t)getBits(&tr, 12) - 2047;
+			else
+				delta = (int32_t)getBits(&tr, 32);
+		}
+		t    += (uint32_t)delta;
+		ts[i] = t;
+
+		if(getBits(&vr, 1))
+		{
+			if(getBits(&vr, 1))
+			{
+				uint32_t head = getBits(&vr, 10);
+
+				lead  = head >> 5;
+				trail = 32 - lead - ((head & 0x1F) + 1);
+			}
+			bits ^= getBits(&vr, 32 - lead - trail) << trail;
+		}
+		vs[i] = bitsToFloat(bits);
+	}
+
+	PMBlock_setCount(samples, bh.count);
+	samples->first    = bh.firstSample;
+	reader->decodeNs += PMPlat_timeNs() - t0;
+	reader->decoded  += bh.count;
+	return VI_SUCCESS;
+}
+
+
+void PMZCaptureReader_close(PMZCaptureReader *reader)
+{
+	if(reader->file != NULL)
+		fclose(reader->file);
+	free(reader->index);
+	free(reader->buffer);
+	reader->file   = NULL;
+	reader->index  = NULL;
+	reader->buffer = NULL;
+}
+
+
+/****************************************************************************
+  End of Source file
+****************************************************************************/
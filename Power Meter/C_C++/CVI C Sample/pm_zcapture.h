@@ -0,0 +1,187 @@
+/****************************************************************************
+
+   Thorlabs Powermeter Fast Stream Toolkit - Compressed capture
+
+   Header file
+
+   Date:          Oct-17-2026
+   Version:       1.0.0
+   Copyright:     Copyright(c) 2026, Thorlabs GmbH (www.thorlabs.com)
+
+   Disclaimer:
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   Block compressed capture of the fast measure stream, about 3 to 4 bytes
+   per sample instead of 8.
+
+   File layout (little endian):
+      PMZCaptureHeader              PM_ZCAPTURE_HEADER_SIZE bytes
+      block 0, block 1, ...         PMZCaptureBlockHeader, timestamp bits,
+                                    value bits
+      PMZCaptureIndex[blocks]       written by PMZCapture_close
+      PMZCaptureFooter
+
+   Every block holds up to blockSamples samples and decodes on its own.
+   Timestamps are stored as delta-of-delta against the previous interval,
+   which costs a single bit for the regular 10 us spacing and a few bits
+   around gaps. Values are XOR coded against the previous value (Gorilla):
+   repeats cost one bit, otherwise only the bits that changed are stored.
+
+   The index at the end holds offset, first sample, unwrapped start time
+   and min/max of every block, so readers seek by time or sample with a
+   binary search and draw overviews without decoding. Files that were not
+   closed (still recording, crashed writer) are indexed by walking the
+   block headers.
+
+****************************************************************************/
+#ifndef _PM_ZCAPTURE_HEADER_
+#define _PM_ZCAPTURE_HEADER_
+
+#include <stdio.h>
+
+#include "pm_block.h"
+#include "pm_capture.h"
+
+/*===========================================================================
+ Macros
+===========================================================================*/
+#define PM_ZCAPTURE_MAGIC         "TLPMZCP"
+#define PM_ZCAPTURE_INDEX_MAGIC   "TLPMZIX"
+#define PM_ZCAPTURE_BLOCK_MAGIC   0x4B4C425AUL     // "ZBLK"
+#define PM_ZCAPTURE_VERSION       1
+#define PM_ZCAPTURE_HEADER_SIZE   256
+#define PM_ZCAPTURE_BLOCK_SAMPLES 4096             // ~41 ms at 100 kHz
+#define PM_ZCAPTURE_MAX_BLOCK     65536
+
+/*===========================================================================
+ Type definitions
+===========================================================================*/
+typedef struct
+{
+	char              magic[8];
+	uint32_t          version;
+	uint32_t          headerSize;
+	uint32_t          blockSamples;
+	uint32_t          sampleRate;        // Hz, nominal
+	uint64_t          startTimeUs;       // host wall clock at creation, us since 1970 UTC
+	uint16_t          channel;
+	uint16_t          reserved;
+	char              device[64];
+	char              serial[32];
+	char              unit[16];
+} PMZCaptureHeader;
+
+typedef struct
+{
+	uint32_t          magic;
+	uint32_t          count;
+	uint64_t          firstSample;
+	uint64_t          firstTimeUs;       // unwrapped device time since the first sample of the file
+	uint32_t          firstTimestamp;    // raw device timestamp of the first sample
+	int32_t           firstDelta;        // interval the first delta-of-delta refers to
+	uint32_t          timeBytes;
+	uint32_t          valueBytes;
+	ViReal32          min;
+	ViReal32          max;
+} PMZCaptureBlockHeader;
+
+typedef struct
+{
+	uint64_t          offset;            // file offset of the block header
+	uint64_t          firstSample;
+	uint64_t          firstTimeUs;
+	uint32_t          count;
+	uint32_t          reserved;
+	ViReal32          min;
+	ViReal32          max;
+} PMZCaptureIndex;
+
+typedef struct
+{
+	uint64_t          indexOffset;
+	uint64_t          blockCount;
+	uint64_t          sampleCount;
+	char              magic[8];
+} PMZCaptureFooter;
+
+// Bit stream of one block column, most significant bit first
+typedef struct
+{
+	uint8_t           *data;
+	uint32_t          bytes;
+	uint64_t          acc;
+	uint32_t          bits;              // pending bits in acc
+} PMZBitWriter;
+
+typedef struct
+{
+	FILE              *file;
+	uint32_t          blockSamples;
+	uint32_t          sampleRate;
+	ViStatus          writeStatus;
+
+	// block being encoded
+	PMZCaptureBlockHeader block;
+	PMZBitWriter      time;
+	PMZBitWriter      value;
+	uint32_t          prevTimestamp;
+	int32_t           prevDelta;
+	uint32_t          prevValue;
+	uint32_t          prevLead;
+	uint32_t          prevTrail;
+
+	// whole file
+	PMZCaptureIndex   *index;
+	uint64_t          indexCapacity;
+	uint64_t          blocks;
+	uint64_t          samples;
+	uint64_t          timeUs;            // unwrapped time of the last sample
+	uint64_t          fileBytes;
+	uint64_t          encodeNs;
+} PMZCapture;
+
+typedef struct
+{
+	FILE              *file;
+	PMZCaptureHeader  header;
+	PMZCaptureIndex   *index;
+	uint64_t          blocks;
+	uint64_t          samples;
+	ViBoolean         closed;            // VI_FALSE: index rebuilt from the block headers
+	uint8_t           *buffer;           // compressed block
+	uint32_t          bufferSize;
+	uint64_t          decodeNs;
+	uint64_t          decoded;           // samples decoded so far
+} PMZCaptureReader;
+
+/*===========================================================================
+ Prototypes
+===========================================================================*/
+// Writer. blockSamples 0 = PM_ZCAPTURE_BLOCK_SAMPLES.
+ViStatus PMZCapture_create(PMZCapture *cap, const char *path, const PMCaptureInfo *info, uint32_t blockSamples);
+ViStatus PMZCapture_append(PMZCapture *cap, const ViUInt32 timestamps[], const ViReal32 values[], uint32_t count);
+void     PMZCapture_consumer(void *ctx, const PMFastBlock *block);
+ViStatus PMZCapture_close(PMZCapture *cap);
+double   PMZCapture_bytesPerSample(const PMZCapture *cap);
+
+// Reader
+ViStatus PMZCaptureReader_open(PMZCaptureReader *reader, const char *path);
+uint64_t PMZCaptureReader_findSample(const PMZCaptureReader *reader, uint64_t sample);
+uint64_t PMZCaptureReader_findTime(const PMZCaptureReader *reader, uint64_t timeUs);
+ViStatus PMZCaptureReader_readBlock(PMZCaptureReader *reader, uint64_t block, PMSampleBlock *samples);
+void     PMZCaptureReader_close(PMZCaptureReader *reader);
+
+#endif /* _PM_ZCAPTURE_HEADER_ */
+
+/****************************************************************************
+  End of Header file
+****************************************************************************/
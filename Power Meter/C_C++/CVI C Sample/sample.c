@@ -80,6 +80,20 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+
+// Driver call latency histograms: define PM_TRACE and add pm_trace.c and pm_platform.c to the project
+#include "pm_trace.h"
+// Completion waits with learned settle times: pm_wait.c and pm_platform.c (in sample.prj)
+#include "pm_wait.h"
+// Chunked burst readout and sample blocks: pm_burst.c, pm_block.c and pm_stats.c (in sample.prj)
+#include "pm_block.h"
+#include "pm_burst.h"
+#include "pm_stats.h"
+// Cached background instrument discovery: pm_discovery.c (in sample.prj)
+#include "pm_discovery.h"
+// Readers specialized on the instrument model: pm_model.c (in sample.prj)
+#include "pm_model.h"
 
 /*===========================================================================
  Type definitions
@@ -89,16 +103,40 @@
  Macros
 ===========================================================================*/
 #define NUM_MULTI_READING  1000
+#define BATCH_PROGRESS_SEC 0.1      // console update interval while logging
+#define BATCH_TIMEOUT_SEC  1.0      // give up if the stream delivers nothing
+#define PEAK_SETTLE_US     2000000  // settle time after switching to peak mode
+#define PEAK_TIMEOUT_US    5000000  // peak detector search deadline
+#define BURST_TIMEOUT_US   2000000  // wait this long for the burst to complete
+#define BURST_TRIGGER      3        // trigger source: front AUX
+#define BURST_INIT_DELAY   1        // in 10 us
+#define BURST_COUNT        2        // samples per trigger (sequence count)
+#define BURST_AVERAGING    3        // per sample, in 10 us
+#define WAIT_HISTORY_FILE  "pm_wait.txt"
+#define BURST_CHUNK_SIZE   0        // burst readout chunk size, 0 = tuned
+#define DEVICE_CACHE_FILE  "pm_devices.txt"
+#define REOPEN_SESSION     0        // 1: close and reopen the session once at startup
+
+// Driver calls of the menu hold the discovery driver lock one at a time, a
+// Bluetooth scan may still be running. Prompts and waits run without it.
+#define DRIVER_LOCKED(stmt)               do { PMDiscovery_lockDriver(&discovery); stmt; PMDiscovery_unlockDriver(&discovery); } while(0)
+#define DRIVER_CALL(point, stat, call)    DRIVER_LOCKED(PM_TRACE_CALL(point, stat, call))
 
 
 #ifndef VI_ERROR_RSRC_NFOUND
 #define VI_ERROR_RSRC_NFOUND 111
 #endif
 
+/*===========================================================================
+ Global variables
+===========================================================================*/
+static const PMModel *instrModel;   // resolved once when the session is opened
+static PMDiscovery   discovery;     // background scans, shares the driver with the menu
+
 /*===========================================================================
  Prototypes
 ===========================================================================*/
-ViStatus findInstrument(ViChar **resource);
+ViStatus findInstrument(PMDiscovery *disc, ViBoolean useCache, ViChar **resource, ViBoolean *fromCache);
 void error_exit(ViSession instrHdl, ViStatus err);
 void waitKeypress(void);
 
@@ -112,6 +150,7 @@ ViStatus get_line_frequency(ViSession ihdl);
 ViStatus set_line_frequency(ViSession ihdl);
 ViStatus get_power(ViSession ihdl);
 ViStatus get_power_multi(ViSession ihdl);
+ViStatus get_power_batched(ViSession ihdl);
 ViStatus get_energy(ViSession ihdl); 
 ViStatus get_frequency(ViSession ihdl);
 ViStatus get_power_density(ViSession ihdl);
@@ -120,6 +159,7 @@ ViStatus get_sensor_information(ViSession ihdl);
 ViStatus get_4QPositions(ViSession ihdl);
 ViStatus get_arrayMeasurment(ViSession ihdl);   
 ViStatus get_burstArrayMeasurement(ViSession ihdl);   
+ViStatus wait_completion(ViSession ihdl, const char *operation, PMWaitPollFunc poll, ViUInt32 samples, uint32_t timeoutUs);
 ViStatus userPowerCalibration(ViSession ihdl); 
 
 /*===========================================================================
@@ -131,17 +171,28 @@ int main(int argc, char **argv)
    ViChar      *rscPtr;
    ViSession   instrHdl = VI_NULL;
    int         c, done;
+   ViBoolean   fromCache = VI_FALSE;
+   uint64_t    startNs = PMPlat_timeNs();
    
    printf("---------------------------------------------------------\n");
    printf(" PM100x/PM160/PM200/PM5020/PM60 Driver Sample Application\n");
    printf("-------------------------------------------------------\n\n"); 
+
+#ifdef PM_TRACE
+   PMTrace_enable(VI_TRUE);
+#endif
    
    
+   // Instrument discovery runs in the background, the cache lists the instruments of the last run
+   PMDiscovery_init(&discovery, NULL);
+   PMDiscovery_load(&discovery, DEVICE_CACHE_FILE);
+   if((err = PMDiscovery_start(&discovery))) error_exit(VI_NULL, err);
+
    // Parameter checking / Resource scanning
    if(argc < 2)
    {
 		// Find resources
-		if((err = findInstrument(&rscPtr)))  error_exit(VI_NULL, err);
+		if((err = findInstrument(&discovery, VI_TRUE, &rscPtr, &fromCache)))  error_exit(VI_NULL, err);
 			if(rscPtr == NULL) exit(EXIT_SUCCESS); // No instrument found
    }
    else
@@ -150,10 +201,29 @@ int main(int argc, char **argv)
       	rscPtr = argv[1];
    }
    
-   // Open session to PM100x/PM160/PM200 instrument
+   // Open session to PM100x/PM160/PM200 instrument. Driver calls hold the
+   // discovery driver lock, the refresh may still be scanning
    printf("Opening session to '%s' ...\n\n", rscPtr);
-   if((err = TLPMX_init(rscPtr, VI_ON, VI_OFF, &instrHdl))) error_exit(instrHdl, err);
+   DRIVER_LOCKED(err = TLPMX_init(rscPtr, VI_ON, VI_OFF, &instrHdl));
+   if(err && fromCache)
+   {
+      // The instrument of the last run is gone, use the scan results
+      printf("Opening '%s' failed, scanning for instruments ...\n", rscPtr);
+      if((err = findInstrument(&discovery, VI_FALSE, &rscPtr, &fromCache)))  error_exit(VI_NULL, err);
+      printf("Opening session to '%s' ...\n\n", rscPtr);
+      DRIVER_LOCKED(err = TLPMX_init(rscPtr, VI_ON, VI_OFF, &instrHdl));
+   }
+   if(err) error_exit(instrHdl, err);
+   PMDiscovery_setLastUsed(&discovery, rscPtr);
+   printf("Session open after %.1f ms%s\n\n", (PMPlat_timeNs() - startNs) / 1e6, fromCache ? " (instrument of the last run)" : "");
+
+   // All array reads below go through the readers of this model
+   DRIVER_LOCKED(err = PMModel_identify(instrHdl, &instrModel));
+   if(err) error_exit(instrHdl, err);
+   printf("Model %s: %u channel(s), %u us sample period\n\n", instrModel->name, (unsigned int)instrModel->channels,
+          (unsigned int)instrModel->periodUs);
 
+#if REOPEN_SESSION
    printf("Closing session to '%s' ...\n\n", rscPtr);
    err = TLPMX_close (instrHdl);
    printf("Closing session to '%s' returned 0x%08X\n\n", rscPtr, (unsigned int)err);
@@ -161,6 +231,7 @@ int main(int argc, char **argv)
    printf("Re-Opening session to '%s' ...\n\n", rscPtr);
    err = TLPMX_init(rscPtr, VI_ON, VI_OFF, &instrHdl);
    printf("Re-Opening session to '%s' returned 0x%08X\n\n", rscPtr, (unsigned int)err);
+#endif
    
    // Operations
    done = 0;
@@ -181,6 +252,7 @@ int main(int argc, char **argv)
       printf("f: Get Frequency\n");
       printf("s: Get Sensor Information\n"); 
       printf("w: Read Power %d times\n", NUM_MULTI_READING);
+      printf("v: Log Power %d times, batched\n", NUM_MULTI_READING);
       printf("r: USB488 Deassert REN line               (VI_GPIB_REN_DEASSERT)\n");
       printf("R: USB488 Assert REN line                 (VI_GPIB_REN_ASSERT)\n");
       printf("G: USB488 Go To Local                     (VI_GPIB_REN_DEASSERT_GTL)\n");
@@ -192,6 +264,9 @@ int main(int argc, char **argv)
 	  printf("x: Get Positions of 4Q sensor\n");
 	  printf("a: Get Power Array Measurement\n");  
 	  printf("m: Get Burst Array Measurement\n");
+#ifdef PM_TRACE
+	  printf("t: Dump driver call latencies\n");
+#endif
       printf("Q: Quit\n");
       printf("\n");
    
@@ -239,6 +314,11 @@ int main(int argc, char **argv)
          case 'W':
             if((err = get_power_multi(instrHdl))) error_exit(instrHdl, err);
             break;
+
+         case 'v':
+         case 'V':
+            if((err = get_power_batched(instrHdl))) error_exit(instrHdl, err);
+            break;
          
          case 'P':
             if((err = get_power_density(instrHdl))) error_exit(instrHdl, err);
@@ -276,10 +356,16 @@ int main(int argc, char **argv)
             if((err = get_burstArrayMeasurement(instrHdl))) error_exit(instrHdl, err);
             break;
 
+#ifdef PM_TRACE
+		case 't':
+            PMTrace_dump(stdout);
+            break;
+#endif
+
          case 'q':
          case 'Q':
             done = 1;
-            if(instrHdl != VI_NULL) TLPMX_close(instrHdl);
+            if(instrHdl != VI_NULL) DRIVER_LOCKED(TLPMX_close(instrHdl));
             break;
 
          default:
@@ -287,6 +373,11 @@ int main(int argc, char **argv)
             break;      
       }
    } while(!done);
+
+   // Discovery report; waits for a Bluetooth scan that is still running
+   PMDiscovery_free(&discovery);
+   PMDiscovery_printReport(&discovery);
+   PMDiscovery_save(&discovery, DEVICE_CACHE_FILE);
    
    return VI_SUCCESS;
 }
@@ -301,10 +392,10 @@ ViStatus get_beam_diameter(ViSession ihdl)
    ViReal64 beam_diameter_set, beam_diameter_min, beam_diameter_max, beam_diameter_default;
    
    printf("Get Beam Diameter ...\n");
-   err = TLPMX_getBeamDia (ihdl, TLPM_ATTR_SET_VAL,  &beam_diameter_set, TLPM_DEFAULT_CHANNEL);  
-   err = TLPMX_getBeamDia (ihdl, TLPM_ATTR_MIN_VAL,  &beam_diameter_min, TLPM_DEFAULT_CHANNEL);
-   err = TLPMX_getBeamDia (ihdl, TLPM_ATTR_MAX_VAL,  &beam_diameter_max, TLPM_DEFAULT_CHANNEL);
-   err = TLPMX_getBeamDia (ihdl, TLPM_ATTR_DFLT_VAL, &beam_diameter_default, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getBeamDia (ihdl, TLPM_ATTR_SET_VAL,  &beam_diameter_set, TLPM_DEFAULT_CHANNEL));
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getBeamDia (ihdl, TLPM_ATTR_MIN_VAL,  &beam_diameter_min, TLPM_DEFAULT_CHANNEL));
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getBeamDia (ihdl, TLPM_ATTR_MAX_VAL,  &beam_diameter_max, TLPM_DEFAULT_CHANNEL));
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getBeamDia (ihdl, TLPM_ATTR_DFLT_VAL, &beam_diameter_default, TLPM_DEFAULT_CHANNEL));
    if(!err) printf("Beam Diameter: Set: %.3f Min: %.3f Max: %.3f Default: %.3f mm\r",beam_diameter_set, beam_diameter_min, beam_diameter_max, beam_diameter_default);
    printf("\n\n");
    fflush(stdin);
@@ -325,7 +416,7 @@ ViStatus set_beam_diameter(ViSession ihdl)
    printf("Enter new Beam Diameter\n");   
    scanf("%s", buf);
    sscanf(buf, "%lf\n", &beam_diameter);
-   err = TLPMX_setBeamDia (ihdl, beam_diameter, TLPM_DEFAULT_CHANNEL);     
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setBeamDia (ihdl, beam_diameter, TLPM_DEFAULT_CHANNEL));
    printf("\n\n");
    fflush(stdin);
    return (err);
@@ -341,7 +432,7 @@ ViStatus get_date(ViSession ihdl)
    ViInt16  year, month, day, hour, minute, second;
    
    printf("Get Date and Time ...\n");                 
-   err = TLPMX_getTime (ihdl, &year, &month, &day, &hour, &minute, &second);
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getTime (ihdl, &year, &month, &day, &hour, &minute, &second));
 
    if(!err) printf("Date and Time %02d.%02d.%02d %02d:%02d:%02d\r", day, month, year, hour, minute, second);
    printf("\n\n");
@@ -364,7 +455,7 @@ ViStatus set_date(ViSession ihdl)
    scanf("%s", buf);
    sscanf(buf, "%hd,%hd,%hd,%hd,%hd,%hd\n", &year, &month, &day, &hour, &minute, &second);
    
-   err = TLPMX_setTime (ihdl, year, month, day, hour, minute, second);
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setTime (ihdl, year, month, day, hour, minute, second));
    printf("\n\n");
    fflush(stdin);
    return (err);
@@ -380,7 +471,7 @@ ViStatus get_line_frequency(ViSession ihdl)
    ViInt16  line_frequency;
    
    printf("Get Line Frequency ...\n");
-   err = TLPMX_getLineFrequency (ihdl, &line_frequency);      
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getLineFrequency (ihdl, &line_frequency));
    if(!err) printf("Line Frequency %d Hz\r",line_frequency);
    printf("\n\n");
    fflush(stdin);
@@ -401,7 +492,7 @@ ViStatus set_line_frequency(ViSession ihdl)
    printf("Enter new Line Frequency\n");  
    scanf("%s", buf);
    sscanf(buf, "%hd\n", &line_frequency);
-   err = TLPMX_setLineFrequency (ihdl, line_frequency);    
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setLineFrequency (ihdl, line_frequency));
    printf("\n\n");
    fflush(stdin);
    return (err);
@@ -418,13 +509,13 @@ ViStatus get_power(ViSession ihdl)
 	ViInt16        power_unit;
 	char           *unit;
 
-	err = TLPMX_getPowerUnit(ihdl, &power_unit, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerUnit(ihdl, &power_unit, TLPM_DEFAULT_CHANNEL));
 	switch(power_unit)
 	{
 	  	case TLPM_POWER_UNIT_DBM: unit = "dBm";break;
 	  	default: unit = "W";break;
 	}
-	if(!err) err = TLPMX_measPower(ihdl, &power, TLPM_DEFAULT_CHANNEL);
+	if(!err) DRIVER_CALL(PM_TRACE_MEAS_POWER, err, TLPMX_measPower(ihdl, &power, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Power reading : %15.9f %s\n\n", power, unit);
 	return (err);
 }
@@ -441,7 +532,7 @@ ViStatus get_power_multi(ViSession ihdl)
    char        *unit;
    int         i;
 
-   err = TLPMX_getPowerUnit(ihdl, &power_unit, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerUnit(ihdl, &power_unit, TLPM_DEFAULT_CHANNEL));
    if(!err)
    {
       switch(power_unit)
@@ -456,7 +547,7 @@ ViStatus get_power_multi(ViSession ihdl)
    i = 0;
    while ((i < NUM_MULTI_READING) && !err)
    {
-      err = TLPMX_measPower(ihdl, &power, TLPM_DEFAULT_CHANNEL);
+      DRIVER_CALL(PM_TRACE_MEAS_POWER, err, TLPMX_measPower(ihdl, &power, TLPM_DEFAULT_CHANNEL));
       if(!err) printf("Power reading #%04d: %15.9f %s\r", i+1, power, unit);
       i++;
    }
@@ -465,6 +556,157 @@ ViStatus get_power_multi(ViSession ihdl)
 }
 
 
+/*---------------------------------------------------------------------------
+  Log Power, batched
+  Same readings as get_power_multi, fetched in bulk: from the fast measure
+  stream (100 kHz, up to 200 readings per call) if the meter has one, else
+  from measurement sequences, else one measPower call per reading.
+  The console is only updated every BATCH_PROGRESS_SEC.
+---------------------------------------------------------------------------*/
+static double   batchTime[NUM_MULTI_READING];     // s since the first reading
+static ViReal64 batchPower[NUM_MULTI_READING];
+
+static double host_seconds(void)
+{
+#ifdef _WIN32
+   LARGE_INTEGER freq, now;
+
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&now);
+   return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void batch_progress(int n, const char *unit, double *lastPrint)
+{
+   double now = host_seconds();
+
+   if(n > 0 && (now - *lastPrint >= BATCH_PROGRESS_SEC || n == NUM_MULTI_READING))
+   {
+      printf("Power reading #%04d: %15.9f %s\r", n, batchPower[n - 1], unit);
+      fflush(stdout);
+      *lastPrint = now;
+   }
+}
+
+// Switches to the stream of the given mode; VI_FALSE if the model or the instrument lacks it
+static ViBoolean conf_stream(ViSession ihdl, int mode)
+{
+   ViStatus err = VI_SUCCESS;
+
+   if(!(instrModel->modes & mode)) return VI_FALSE;
+   if(mode == PM_MODEL_FAST) DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_confPowerFastArrayMeasurement(ihdl, TLPM_DEFAULT_CHANNEL));
+   else                      DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_confPowerMeasurementSequence(ihdl, 1, TLPM_DEFAULT_CHANNEL));
+   return (err == VI_SUCCESS);
+}
+
+ViStatus get_power_batched(ViSession ihdl)
+{
+   ViStatus    err = VI_SUCCESS;
+   ViInt16     power_unit;
+   char        *unit = "W";
+   const char  *method;
+   double      start, end, lastPrint = 0.0, min, max, sum;
+   int         n = 0, i;
+
+   start = host_seconds();
+
+   // 1. Fast measure stream, always in W
+   if(conf_stream(ihdl, PM_MODEL_FAST))
+   {
+      PMSampleBlock block;
+      ViUInt16 count;
+      ViUInt32 first = 0;
+      double   lastData = start;
+
+      method = "fast measure stream";
+      err = PMModel_initBlock(instrModel, &block, PM_MODEL_FAST);
+      while(n < NUM_MULTI_READING && !err)
+      {
+         PMBlock_clear(&block, n);
+         DRIVER_LOCKED(err = instrModel->readFast(&block, ihdl, TLPM_DEFAULT_CHANNEL, &count));
+         if(err) break;
+         if(count == 0)
+         {
+            if(host_seconds() - lastData > BATCH_TIMEOUT_SEC) err = VI_ERROR_TMO;
+            continue;
+         }
+         lastData = host_seconds();
+         if(n == 0) first = block.timestamps[0];
+         for(i = 0; i < count && n < NUM_MULTI_READING; i++, n++)
+         {
+            batchTime[n]  = (double)(ViUInt32)(block.timestamps[i] - first) * 1e-6;   // wrap around safe
+            batchPower[n] = block.channel[0][i];
+         }
+         batch_progress(n, unit, &lastPrint);
+      }
+      PMBlock_free(&block);
+
+      // leave the fast measure stream, back to normal measurement
+      DRIVER_LOCKED(TLPMX_writeRaw(ihdl, "ABOR"));
+   }
+   // 2. Measurement sequences of sequenceBase x 100 readings, in W
+   else if(conf_stream(ihdl, PM_MODEL_SEQUENCE))
+   {
+      PMSampleBlock   block;
+      ViBoolean       triggerForced;
+      double          seqStart;
+
+      method = "measurement sequence";
+      err = PMModel_initBlock(instrModel, &block, PM_MODEL_SEQUENCE);
+      while(n < NUM_MULTI_READING && !err)
+      {
+         seqStart = host_seconds() - start;
+         DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_startMeasurementSequence(ihdl, 0, &triggerForced, TLPM_DEFAULT_CHANNEL));
+         if(!err) DRIVER_LOCKED(err = instrModel->readSequence(&block, ihdl, TLPM_DEFAULT_CHANNEL));
+         for(i = 0; !err && i < (int)block.count && n < NUM_MULTI_READING; i++, n++)
+         {
+            batchTime[n]  = seqStart + block.timestamps[i] * 1e-6;
+            batchPower[n] = block.channel[0][i];
+         }
+         batch_progress(n, unit, &lastPrint);
+      }
+      PMBlock_free(&block);
+   }
+   // 3. One reading per call, in the configured unit
+   else
+   {
+      method = "single readings";
+      DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerUnit(ihdl, &power_unit, TLPM_DEFAULT_CHANNEL));
+      if(!err && power_unit == TLPM_POWER_UNIT_DBM) unit = "dBm";
+      while(n < NUM_MULTI_READING && !err)
+      {
+         DRIVER_CALL(PM_TRACE_MEAS_POWER, err, TLPMX_measPower(ihdl, &batchPower[n], TLPM_DEFAULT_CHANNEL));
+         if(err) break;
+         batchTime[n] = host_seconds() - start;
+         n++;
+         batch_progress(n, unit, &lastPrint);
+      }
+   }
+
+   end = host_seconds();
+   printf("\n\n");
+   if(n == 0) return (err);
+
+   min = max = sum = batchPower[0];
+   for(i = 1; i < n; i++)
+   {
+      if(batchPower[i] < min) min = batchPower[i];
+      if(batchPower[i] > max) max = batchPower[i];
+      sum += batchPower[i];
+   }
+   printf("%d readings via %s in %.3f s: %.0f readings/s\n", n, method, end - start, n / (end - start));
+   printf("Readings span %.6f s, min %15.9f, mean %15.9f, max %15.9f %s\n\n", batchTime[n - 1] - batchTime[0],
+          min, sum / n, max, unit);
+   return (err);
+}
+
+
 /*---------------------------------------------------------------------------
   Measure Energy
 ---------------------------------------------------------------------------*/
@@ -476,7 +718,7 @@ ViStatus get_energy(ViSession ihdl)
    
 	do
    	{
-		err = TLPMX_measEnergy(ihdl, &energy, TLPM_DEFAULT_CHANNEL);  
+		DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measEnergy(ihdl, &energy, TLPM_DEFAULT_CHANNEL));
 		if (VI_SUCCESS != err )
 		{
 			printf("Energy code: %d\n", (int)err);
@@ -498,7 +740,7 @@ ViStatus get_frequency(ViSession ihdl)
    ViStatus       err = VI_SUCCESS; 
    ViReal64       frequency;
    
-   err = TLPMX_measFreq(ihdl, &frequency, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measFreq(ihdl, &frequency, TLPM_DEFAULT_CHANNEL));
    if(!err) printf("Frequency reading: %15.9f Hz\n\n", frequency);
    return (err);
 }
@@ -512,7 +754,7 @@ ViStatus get_power_density(ViSession ihdl)
    ViStatus       err = VI_SUCCESS; 
    ViReal64       power_density;
 
-   err = TLPMX_measPowerDens(ihdl, &power_density, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measPowerDens(ihdl, &power_density, TLPM_DEFAULT_CHANNEL));
    if(!err) printf("Power Density reading: %15.9f W/cm*cm\n\n", power_density);
    return (err);
 }
@@ -526,7 +768,7 @@ ViStatus get_energy_density(ViSession ihdl)
    ViStatus       err = VI_SUCCESS; 
    ViReal64       energy_density;
    
-   err = TLPMX_measEnergyDens(ihdl, &energy_density, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_measEnergyDens(ihdl, &energy_density, TLPM_DEFAULT_CHANNEL));
    if(!err) printf("Energy Density reading: %15.9f J/cm*cm\n\n", energy_density);
    return (err);
 }
@@ -542,7 +784,7 @@ ViStatus get_sensor_information(ViSession ihdl)
    ViInt16        sens_type, sens_subtype, flags;
 
    printf("Get Sensor Information...\n");                ;
-   err = TLPMX_getSensorInfo(ihdl, sensor_name, serial_number, cal_message, &sens_type, &sens_subtype, &flags, TLPM_DEFAULT_CHANNEL);
+   DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getSensorInfo(ihdl, sensor_name, serial_number, cal_message, &sens_type, &sens_subtype, &flags, TLPM_DEFAULT_CHANNEL));
    if(!err) printf("Sensor Name: %s \r\n", sensor_name);
    if(!err) printf("Serial Number: %s \r\n", serial_number); 
    if(!err) printf("Calibration Message: %s \r\n", cal_message);
@@ -576,7 +818,7 @@ ViStatus userPowerCalibration(ViSession ihdl)
 	printf("User Power Calibration...\n");   
 
 	// get the calibration at the first memory position
-	err = TLPMX_getPowerCalibrationPointsInformation(ihdl, memoryPosition, sensorSerialNumber, calibrationDate, &calibrationPointsCount, author, &sensorPosition, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerCalibrationPointsInformation(ihdl, memoryPosition, sensorSerialNumber, calibrationDate, &calibrationPointsCount, author, &sensorPosition, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Sensor Serial Number: %s \r\n", sensorSerialNumber); 
 	if(!err) printf("Calibration Date: %s \r\n", calibrationDate);
 	if(!err) printf("Author: %s \r\n", author);  
@@ -584,11 +826,11 @@ ViStatus userPowerCalibration(ViSession ihdl)
 	if(!err) printf("Sensor Position: %d \r\n", sensorPosition);
 	fflush(stdin);
 
-	err = TLPMX_getPowerCalibrationPointsState(ihdl, memoryPosition, &state, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerCalibrationPointsState(ihdl, memoryPosition, &state, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Calibration State: %s \r\n", state == VI_ON? "ON" : "OFF"); 
 	fflush(stdin);
 
-	err = TLPMX_getPowerCalibrationPoints(ihdl, memoryPosition, calibrationPointsCount, wavelength, power, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPowerCalibrationPoints(ihdl, memoryPosition, calibrationPointsCount, wavelength, power, TLPM_DEFAULT_CHANNEL));
 	for(point = 0; point < calibrationPointsCount; point++)
 	{
 	  if(!err) printf("Wavelength: %.2f, Power: %f \r\n", wavelength[point], power[point]);
@@ -596,11 +838,11 @@ ViStatus userPowerCalibration(ViSession ihdl)
 	fflush(stdin);
 
 	// get the currently used wavelength
-	err = TLPMX_getWavelength(ihdl, TLPM_ATTR_SET_VAL, &actWvelength, TLPM_DEFAULT_CHANNEL); 
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getWavelength(ihdl, TLPM_ATTR_SET_VAL, &actWvelength, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Wavelength: %f \r\n", actWvelength); 
 
 	// get the currently used power factor
-	err = TLPMX_getPhotodiodeResponsivity(ihdl, TLPM_ATTR_SET_VAL, &responsitivity, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPhotodiodeResponsivity(ihdl, TLPM_ATTR_SET_VAL, &responsitivity, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Responsitivity before calibration: %f \r\n", responsitivity); 
 
 	// overwrite the first memory position with a new calibration
@@ -610,22 +852,22 @@ ViStatus userPowerCalibration(ViSession ihdl)
 	power[0] = 0.87;
 	wavelength[1] = 725.0;
 	power[1] = 0.95;
-	err = TLPMX_setPowerCalibrationPoints(ihdl, memoryPosition, 2, wavelength, power, author, SENSOR_SWITCH_POS_1, TLPM_DEFAULT_CHANNEL); 
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setPowerCalibrationPoints(ihdl, memoryPosition, 2, wavelength, power, author, SENSOR_SWITCH_POS_1, TLPM_DEFAULT_CHANNEL));
 	if(VI_SUCCESS != err) return err; 
 
 	printf("\nUser Power Calibration finished.\n"); 
    
 	// activate the user power calibration for this sensor
-	err = TLPMX_setPowerCalibrationPointsState(ihdl, memoryPosition, VI_ON, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setPowerCalibrationPointsState(ihdl, memoryPosition, VI_ON, TLPM_DEFAULT_CHANNEL));
 
 	// the sensor has to be reinitialized to use the power calibration
-	err = TLPMX_reinitSensor(ihdl, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_reinitSensor(ihdl, TLPM_DEFAULT_CHANNEL));
 
 	// wait until the sensor has been reinitialized
 	Sleep(3000);
 
 	// get the currently used power factor
-	err = TLPMX_getPhotodiodeResponsivity(ihdl, TLPM_ATTR_SET_VAL, &responsitivity, TLPM_DEFAULT_CHANNEL);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getPhotodiodeResponsivity(ihdl, TLPM_ATTR_SET_VAL, &responsitivity, TLPM_DEFAULT_CHANNEL));
 	if(!err) printf("Responsitivity after calibration: %f \r\n", responsitivity); 
    
 	printf("\n\n");
@@ -643,100 +885,190 @@ ViStatus get_4QPositions(ViSession instrHdl)
 	ViReal64	voltage3;
 	ViReal64	voltage4;
    
-	err = TLPMX_meas4QPositions(instrHdl, &positionX, &positionY, 1);
+	DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_meas4QPositions(instrHdl, &positionX, &positionY, 1));
 	if(!err) printf("4Q Position x: %.2f um, y: %.2f um \n\n", positionX, positionY);
 	
-	err = TLPMX_meas4QVoltages(instrHdl, &voltage1, &voltage2, &voltage3, &voltage4, 1);
+	DRIVER_CALL(PM_TRACE_MEAS_OTHER, err, TLPMX_meas4QVoltages(instrHdl, &voltage1, &voltage2, &voltage3, &voltage4, 1));
 	if(!err) printf("4Q Voltages: %f V, %f V, %f V, %f V \n\n", voltage1, voltage2, voltage3, voltage4);
 	
 	return (err);
 }
 
-#define BaseTime 10
-#define DataSizeBaseTime BaseTime*100
+//Status poll under the driver lock, the backoff between polls runs without it
+typedef struct
+{
+	PMWaitPollFunc poll;
+	PMWaitTarget   target;
+} LockedPoll;
+
+static ViStatus locked_poll(void *ctx, ViBoolean *done)
+{
+	LockedPoll *locked = (LockedPoll*)ctx;
+	ViStatus   err;
+
+	DRIVER_LOCKED(err = locked->poll(&locked->target, done));
+	return err;
+}
+
+/*---------------------------------------------------------------------------
+  Wait for an operation that completes on its own. Settle times are learned
+  per instrument model (instrModel, resolved at open) and kept in
+  WAIT_HISTORY_FILE between runs.
+---------------------------------------------------------------------------*/
+ViStatus wait_completion(ViSession ihdl, const char *operation, PMWaitPollFunc poll, ViUInt32 samples, uint32_t timeoutUs)
+{
+	static PMWaitHistory history;
+	static ViBoolean     loaded = VI_FALSE;
+	LockedPoll   locked;
+	PMWaitItem   item;
+	ViStatus     err;
+
+	if(!loaded)
+	{
+		PMWaitHistory_init(&history);
+		PMWaitHistory_load(&history, WAIT_HISTORY_FILE);
+		loaded = VI_TRUE;
+	}
+
+	locked.poll           = poll;
+	locked.target.vi      = ihdl;
+	locked.target.channel = TLPM_DEFAULT_CHANNEL;
+	locked.target.samples = samples;
+	PMWait_item(&item, locked_poll, &locked, PMWaitHistory_profile(&history, instrModel->name, operation), timeoutUs);
+	err = PMWait_one(&item);
+
+	if(item.done)
+	{
+		printf("%s done after %.1f ms, %u polls\n", operation, (double)item.elapsedUs / 1000.0, (unsigned int)item.polls);
+		PMWaitHistory_save(&history, WAIT_HISTORY_FILE);
+	}
+	return err;
+}
+
 ViStatus get_arrayMeasurment(ViSession instrHdl)
 {
 	ViStatus	err = VI_SUCCESS;
 	ViUInt32 	measurementIndex = 0;
-	ViReal32 timeStamps[DataSizeBaseTime];  
-	ViReal32 powerValues[DataSizeBaseTime]; 
-	ViBoolean isRunning = VI_TRUE;
+	PMSampleBlock block;
 	ViUInt32 averaging = 1;
 	ViUInt32 autoTriggerDelay = 0;
 	ViBoolean triggerForced = VI_FALSE;
 
+	if(!(instrModel->modes & PM_MODEL_SEQUENCE))
+	{
+		printf("%s has no measurement sequence\n", instrModel->name);
+		return VI_SUCCESS;
+	}
+
 	//search trigger level and range								 
-   	err = TLPMX_setFreqMode(instrHdl, TLPM_FREQ_MODE_PEAK, TLPM_DEFAULT_CHANNEL);
+   	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_setFreqMode(instrHdl, TLPM_FREQ_MODE_PEAK, TLPM_DEFAULT_CHANNEL));
 	if(err < 0) return err;  
 
-	Sleep(2000);   
-   
-	err = TLPMX_startPeakDetector(instrHdl, TLPM_DEFAULT_CHANNEL);			 
+	//the mode switch has to settle before the search starts, the adaptive wait below only covers the search
+	PMPlat_sleepUs(PEAK_SETTLE_US);
+
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_startPeakDetector(instrHdl, TLPM_DEFAULT_CHANNEL));
 	if(err < 0) return err;  
 
-   	Sleep(1000);   	  							 
-			 
-	while (isRunning)
-	{
-		err = TLPMX_isPeakDetectorRunning(instrHdl, &isRunning, TLPM_DEFAULT_CHANNEL);			 
-		if(err < 0) return err;  
-	}
+	//poll with backoff, starting shortly before the usual search time of this model
+	err = wait_completion(instrHdl, "peak detector", PMWait_pollPeakDetector, 0, PEAK_TIMEOUT_US);
+	if(err < 0) return err;  
 
     //Set to CW mode for normal measurement
-   	TLPMX_setFreqMode(instrHdl, TLPM_FREQ_MODE_CW, TLPM_DEFAULT_CHANNEL);		
+   	DRIVER_LOCKED(TLPMX_setFreqMode(instrHdl, TLPM_FREQ_MODE_CW, TLPM_DEFAULT_CHANNEL));		
 	
-	TLPMX_confPowerMeasurementSequence(instrHdl, averaging, TLPM_DEFAULT_CHANNEL);	
+	DRIVER_LOCKED(TLPMX_confPowerMeasurementSequence(instrHdl, averaging, TLPM_DEFAULT_CHANNEL));	
 
-	TLPMX_startMeasurementSequence(instrHdl, autoTriggerDelay, &triggerForced, TLPM_DEFAULT_CHANNEL);
+	DRIVER_LOCKED(TLPMX_startMeasurementSequence(instrHdl, autoTriggerDelay, &triggerForced, TLPM_DEFAULT_CHANNEL));
 					 
-	err = TLPMX_getMeasurementSequence(instrHdl, BaseTime, timeStamps, powerValues, VI_NULL, TLPM_DEFAULT_CHANNEL);
+	if((err = PMModel_initBlock(instrModel, &block, PM_MODEL_SEQUENCE))) return err;
+	DRIVER_LOCKED(err = instrModel->readSequence(&block, instrHdl, TLPM_DEFAULT_CHANNEL));
 	if(!err)
 	{
-		for(measurementIndex = 0; measurementIndex < DataSizeBaseTime; measurementIndex++) 
-			printf("Power Value %u: %f ; %E W\n", (unsigned int)measurementIndex, timeStamps[measurementIndex], powerValues[measurementIndex]);
+		for(measurementIndex = 0; measurementIndex < block.count; measurementIndex++) 
+			printf("Power Value %u: %u us ; %E W\n", (unsigned int)measurementIndex, (unsigned int)block.timestamps[measurementIndex], block.channel[0][measurementIndex]);
 	}
+	PMBlock_free(&block);
 	
 	return (err); 
 }
 
+//Burst chunk consumer: statistics of both channels
+typedef struct
+{
+	PMStats channel1;
+	PMStats channel2;
+} BurstTotals;
+
+static void burst_chunk(void *ctx, const PMSampleBlock *chunk)
+{
+	BurstTotals *totals = (BurstTotals*)ctx;
+	PMStats     part;
+
+	PMStats_block(&part, chunk->channel[0], chunk->count);
+	PMStats_merge(&totals->channel1, &part);
+	PMStats_block(&part, chunk->channel[1], chunk->count);
+	PMStats_merge(&totals->channel2, &part);
+	printf("Samples %llu..%llu: timestamp %u us, %E W ; %E W\n", (unsigned long long)chunk->first,
+			(unsigned long long)(chunk->first + chunk->count - 1), (unsigned int)chunk->timestamps[0],
+			chunk->channel[0][0], chunk->channel[1][0]);
+}
+
 ViStatus get_burstArrayMeasurement(ViSession instrHdl)
 {
 	ViStatus err = VI_SUCCESS;
-	ViUInt32 timeStamps[DataSizeBaseTime];  
-	ViReal32 powerValues[DataSizeBaseTime]; 
-	ViReal32 powerValues2[DataSizeBaseTime]; 
 	ViUInt32 samplesCount = 0;
+	PMBurstReader reader;
+	PMBurstStats  stats;
+	BurstTotals   totals;
 
+	if(!(instrModel->modes & PM_MODEL_BURST))
+	{
+		printf("%s has no burst array measurement\n", instrModel->name);
+		return VI_SUCCESS;
+	}
 
 	// 1. Configure unit for channel 1. Skip if not connected or not needed. (will automatically abort ongoing measurements)
-	err = TLPMX_confBurstArrayMeasPowerChannel(instrHdl, 1);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_confBurstArrayMeasPowerChannel(instrHdl, 1));
 	if(err < 0) return err;  
 
 	// 2. Configure unit for channel 2. Skip if not connected or not needed. (will automatically abort ongoing measurements)
-	err = TLPMX_confBurstArrayMeasPowerChannel(instrHdl, 2);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_confBurstArrayMeasPowerChannel(instrHdl, 2));
 	if(err < 0) return err;  
 
 	// 3. Configure hardware front AUX triggered burst mode with initDelay = 1, BustCount = 2 and Averaging = 3.
-	err = TLPMX_confBurstArrayMeasTrigger(instrHdl, 3, 1, 2, 3);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_confBurstArrayMeasTrigger(instrHdl, BURST_TRIGGER, BURST_INIT_DELAY, BURST_COUNT, BURST_AVERAGING));
 	if(err < 0) return err;  
 	
 	// 4. Starts a burst measurement 
-	err = TLPMX_startBurstArrayMeasurement(instrHdl);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_startBurstArrayMeasurement(instrHdl));
 	if(err < 0) return err;  
 
-	// 5. Trigger is active and burst sequences are stored in device buffer
+	// 5. Trigger is active and burst sequences are stored in device buffer. Wait until the burst is complete.
+	err = wait_completion(instrHdl, "burst", PMWait_pollBurst, BURST_COUNT, BURST_TIMEOUT_US);
+	if(err == VI_ERROR_TMO) printf("Burst not complete within %u ms\n", (unsigned int)(BURST_TIMEOUT_US / 1000));
+	else if(err < 0) return err;
 
 	// 6.  Stops burst measurement. Triggers are not longer observed
-	err = TLPMX_writeRaw(instrHdl, "ABOR");
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_writeRaw(instrHdl, "ABOR"));
 	if(err < 0) return err;  
 	
 	// 7. Reads amount of samples in buffer
-	err = TLPMX_getBurstArraySamplesCount(instrHdl, &samplesCount);
+	DRIVER_CALL(PM_TRACE_CONFIG, err, TLPMX_getBurstArraySamplesCount(instrHdl, &samplesCount));
 	if(samplesCount == 0 || err < 0) return err;
 	
-	// 8. Reads all samples of burst sequence
-	err = TLPMX_getBurstArraySamples(instrHdl, 0, samplesCount, timeStamps, powerValues, powerValues2);
+	// 8. Reads all samples of burst sequence in chunks, any buffer size works with the same memory
+	PMStats_reset(&totals.channel1);
+	PMStats_reset(&totals.channel2);
+	if((err = PMBurst_init(&reader, instrModel, instrHdl, BURST_CHUNK_SIZE, burst_chunk, &totals))) return err;
+	DRIVER_LOCKED(err = PMBurst_read(&reader, samplesCount, VI_FALSE, 0));
+	PMBurst_getStats(&reader, &stats);
+	PMBurst_free(&reader);
 	if(err < 0) return err;
+
+	printf("Channel 1: mean %E W, min %E W, max %E W\n", totals.channel1.mean, totals.channel1.min, totals.channel1.max);
+	printf("Channel 2: mean %E W, min %E W, max %E W\n", totals.channel2.mean, totals.channel2.min, totals.channel2.max);
+	PMBurst_printStats(&stats);
 	
 	return VI_SUCCESS;
 }
@@ -752,7 +1084,7 @@ void error_exit(ViSession instrHdl, ViStatus err)
    TLPMX_errorMessage (instrHdl, err, buf);
    fprintf(stderr, "ERROR: %s\n", buf);
    // Close instrument hande if open
-   if(instrHdl != VI_NULL) TLPMX_close(instrHdl);
+   if(instrHdl != VI_NULL) DRIVER_LOCKED(TLPMX_close(instrHdl));
    // Exit program
    waitKeypress();
    exit (EXIT_FAILURE);
@@ -772,46 +1104,51 @@ void waitKeypress(void)
 /*---------------------------------------------------------------------------
   Find Instruments
 ---------------------------------------------------------------------------*/
-ViStatus findInstrument(ViChar **resource)
+ViStatus findInstrument(PMDiscovery *disc, ViBoolean useCache, ViChar **resource, ViBoolean *fromCache)
 {
-   ViStatus err;
+   ViStatus err, bthErr;
    ViUInt32 deviceCount;
    ViUInt32 done, cnt;
    int i;
    static ViChar rsrcDescr[TLPM_BUFFER_SIZE];
-   ViChar name[TLPM_BUFFER_SIZE], sernr[TLPM_BUFFER_SIZE];
-   ViBoolean available;
+   static PMDiscDevice devices[PM_DISC_MAX_DEVICES];
                       
-   printf("Scanning for instruments ...\n");
-   
    // prepare return value
    rsrcDescr[0] = '\0';
    *resource = rsrcDescr;
+   *fromCache = VI_FALSE;
+
+   // Open the instrument of the last run right away, the background scan validates it
+   if(useCache && PMDiscovery_lastUsed(disc, &devices[0]))
+   {
+      printf("Using instrument of the last run, S/N:%s \t%s\n", devices[0].serial, devices[0].model);
+      strcpy(rsrcDescr, devices[0].resource);
+      *fromCache = VI_TRUE;
+      return VI_SUCCESS;
+   }
 
-   err = TLPMX_setEnableBthSearch(VI_NULL, VI_TRUE);
-   if(VI_SUCCESS != err)
-	   return err;
+   printf("Scanning for instruments ...\n");
 
-   err = TLPMX_findRsrc (0, &deviceCount);
-   switch(err)
+   // List USB, serial and Bluetooth instruments together; a Bluetooth scan
+   // that runs into its timeout leaves the wired instruments to select from
+   err    = PMDiscovery_waitScan(disc, PM_DISC_SCAN_WIRED);
+   bthErr = PMDiscovery_waitScan(disc, PM_DISC_SCAN_BLUETOOTH);
+   if(bthErr == VI_ERROR_TMO)
+      printf("Bluetooth scan timed out, listing the instruments found so far\n");
+   deviceCount = PMDiscovery_list(disc, devices, PM_DISC_MAX_DEVICES, VI_TRUE);
+   if(deviceCount == 0)
    {
-      case VI_SUCCESS:
-         // At least one device was found. Nothing to do here. Continue with device selection menu.
-         break;
-
-      case VI_ERROR_RSRC_NFOUND:
-         printf("No matching instruments found\n\n"); 
-         return (err);
-                 
-      default:
-         return (err);
+      if(err == VI_SUCCESS || err == VI_ERROR_TMO) err = bthErr;
+      if(err != VI_SUCCESS && err != VI_ERROR_TMO) return (err);
+      printf("No matching instruments found\n\n"); 
+      return (VI_ERROR_RSRC_NFOUND);
    }
    
    if(deviceCount < 2)
    {
       // Found only one matching instrument - return this
-      err = TLPMX_getRsrcName (0, 0, rsrcDescr);
-      return (err);
+      strcpy(rsrcDescr, devices[0].resource);
+      return (VI_SUCCESS);
    }
 
    // Found multiple instruments - Display list of instruments
@@ -823,9 +1160,7 @@ ViStatus findInstrument(ViChar **resource)
       // Print device list
       for(cnt = 0; cnt < deviceCount; cnt++)
       {
-         err = TLPMX_getRsrcInfo (0, cnt, name, sernr, VI_NULL, &available);
-         if(err) return (err);         
-         printf("%u(%s): S/N:%s \t%s\n", (unsigned int)(cnt+1), (available) ? "FREE" : "LOCK", sernr, name);
+         printf("%u(%s): S/N:%s \t%s\n", (unsigned int)(cnt+1), (devices[cnt].available) ? "FREE" : "LOCK", devices[cnt].serial, devices[cnt].model);
       }
    
       printf("\nPlease select, press q to exit: ");
@@ -871,9 +1206,10 @@ ViStatus findInstrument(ViChar **resource)
    while(!done);
    
    // Copy resource string to static buffer
-   err = TLPMX_getRsrcName(0, (ViUInt32)(i-1), rsrcDescr);
+   if((i < 1) || ((ViUInt32)i > deviceCount)) return (VI_ERROR_RSRC_NFOUND);
+   strcpy(rsrcDescr, devices[i-1].resource);
    
-   return (err);
+   return (VI_SUCCESS);
 }
 
 
@@ -887,13 +1223,16 @@ ViStatus get_device_id(ViSession ihdl)
    ViChar   snBuf[TLPM_BUFFER_SIZE];
    ViChar   revBuf[TLPM_BUFFER_SIZE];
 
-   if((err = TLPMX_identificationQuery (ihdl, VI_NULL, nameBuf, snBuf, revBuf))) return(err);
+   DRIVER_LOCKED(err = TLPMX_identificationQuery (ihdl, VI_NULL, nameBuf, snBuf, revBuf));
+   if(err) return(err);
    printf("Instrument:    %s\n", nameBuf);
    printf("Serial number: %s\n", snBuf);
    printf("Firmware:      V%s\n", revBuf);
-   if((err = TLPMX_revisionQuery (ihdl, revBuf, VI_NULL))) return(err);
+   DRIVER_LOCKED(err = TLPMX_revisionQuery (ihdl, revBuf, VI_NULL));
+   if(err) return(err);
    printf("Driver:        V%s\n", revBuf);
-   if((err = TLPMX_getCalibrationMsg (ihdl, revBuf, TLPM_DEFAULT_CHANNEL))) return(err);
+   DRIVER_LOCKED(err = TLPMX_getCalibrationMsg (ihdl, revBuf, TLPM_DEFAULT_CHANNEL));
+   if(err) return(err);
    printf("Cal message:   %s\n\n", revBuf);
 
    return VI_SUCCESS;